@@ -30,6 +30,7 @@
 
 #include "itkImage.h"
 #include "itkProcessObject.h"
+#include "itkNUMAGlobalConfiguration.h"
 #include <algorithm>
 
 namespace itk
@@ -51,7 +52,16 @@ Image<TPixel, VImageDimension>::Allocate(bool initializePixels)
   this->ComputeOffsetTable();
   num = static_cast<SizeValueType>(this->GetOffsetTable()[VImageDimension]);
 
-  m_Buffer->Reserve(num, initializePixels);
+  if (m_Buffer->GetBufferPointer() == nullptr && NUMAGlobalConfiguration::UseParallelFirstTouch(num * sizeof(TPixel)))
+  {
+    // Let the threads which will process the pixels write their pages first
+    m_Buffer->Reserve(num, false);
+    NUMAGlobalConfiguration::FirstTouch(this->GetBufferedRegion(), 1, m_Buffer->GetBufferPointer(), initializePixels);
+  }
+  else
+  {
+    m_Buffer->Reserve(num, initializePixels);
+  }
 }
 
 
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferAllocator_h
+#define itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Provides the raw memory of the pixel buffers of images
+ *
+ * ImportImageContainer, and thus Image and VectorImage, obtain the memory
+ * of their pixel buffers from an ImageBufferAllocator. The elements are
+ * constructed and destroyed by the container, the allocator only deals
+ * with uninitialized bytes.
+ *
+ * This class is the default allocator, which uses the global operator
+ * new[], as a new[] expression would. Derived classes implement other
+ * strategies, e.g. AlignedImageBufferAllocator for SIMD friendly and huge
+ * page backed buffers, and RecyclingImageBufferAllocator to reuse buffers
+ * across pipeline updates.
+ *
+ * The allocator of the containers which do not have one set explicitly is
+ * GetGlobalDefault(). It is created with New(), so it may be replaced
+ * through the object factory, with a factory which registers an override
+ * of ImageBufferAllocator, or set with SetGlobalDefault().
+ *
+ * Allocate() and Deallocate() may be called concurrently from several
+ * threads.
+ *
+ * \sa ImportImageContainer
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferAllocator;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Allocate a block of bytes aligned on at least alignment bytes, which
+   * must be a power of two. Returns nullptr when the memory cannot be
+   * allocated. */
+  virtual void *
+  Allocate(SizeValueType numberOfBytes, SizeValueType alignment);
+
+  /** Release a block returned by Allocate(), with the same size and
+   * alignment as used to allocate it. */
+  virtual void
+  Deallocate(void * buffer, SizeValueType numberOfBytes, SizeValueType alignment);
+
+  /** Set/Get the allocator used by the containers without an allocator of
+   * their own. The initial global default is created with New(). Getting
+   * it does not lock, and the allocators set as global default are kept
+   * until the end of the process. */
+  static void
+  SetGlobalDefault(ImageBufferAllocator * allocator);
+  static ImageBufferAllocator *
+  GetGlobalDefault();
+
+protected:
+  ImageBufferAllocator() = default;
+  ~ImageBufferAllocator() override = default;
+
+  /** Aligned allocation, freed with DeallocateAligned(). Does not depend
+   * on the alignment used for the allocation. */
+  static void *
+  AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment);
+  static void
+  DeallocateAligned(void * buffer);
+};
+} // end namespace itk
+
+#endif
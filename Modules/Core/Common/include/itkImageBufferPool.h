@@ -0,0 +1,202 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferPool_h
+#define itkImageBufferPool_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkSingletonMacro.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+
+namespace itk
+{
+
+/**
+ * \class ImageBufferPool
+ * \brief Process-wide cache of released pixel buffers
+ *
+ * Each Update() of a pipeline releases and reallocates the buffers of its
+ * intermediate outputs: DataObject::ReleaseData() drops the pixel
+ * container of an image, and ImageSource::AllocateOutputs() allocates a new
+ * one. When the pool is enabled, the buffers of the destroyed containers
+ * are kept here instead of being freed, and ImportImageContainer takes its
+ * new buffers from here when one of the same pixel type and byte size is
+ * available. A pipeline repeatedly executed on images of the same size
+ * thus reaches a steady state where it allocates no memory.
+ *
+ * Buffers are only reused for containers with the same allocator as the
+ * one which allocated them, and they are returned to that allocator when
+ * they are evicted or purged. The elements are destroyed before a buffer
+ * enters the pool, and constructed again when it leaves it, as for a new
+ * allocation.
+ *
+ * The cache is bounded by MaximumCachedBytes and MaximumNumberOfBuffers.
+ * When a released buffer does not fit, the least recently released
+ * buffers are freed to make room for it.
+ *
+ * The pool is disabled by default. It may be enabled with SetEnabled(),
+ * or with the ITK_IMAGE_BUFFER_POOL=ON environment variable.
+ *
+ * Unlike a RecyclingImageBufferAllocator, which serves the containers it is
+ * explicitly given to, the pool applies to the containers of all
+ * allocators, and collects usage statistics.
+ *
+ * \sa ImageBufferAllocator, RecyclingImageBufferAllocator
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+
+struct ImageBufferPoolGlobals;
+
+class ITKCommon_EXPORT ImageBufferPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferPool);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferPool, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the ImageBufferPool */
+  static Pointer
+  GetInstance();
+
+  /** Counters of the pool activity, since its creation or the last call to
+   * ResetStatistics(). */
+  struct Statistics
+  {
+    /** Allocations served from the pool */
+    SizeValueType Hits{ 0 };
+    /** Allocations for which no buffer was available */
+    SizeValueType Misses{ 0 };
+    /** Released buffers kept by the pool */
+    SizeValueType Returns{ 0 };
+    /** Buffers freed to respect the limits, or because they exceed them */
+    SizeValueType Evictions{ 0 };
+    /** Current number and size of the kept buffers */
+    SizeValueType CachedBuffers{ 0 };
+    SizeValueType CachedBytes{ 0 };
+    /** Maximum of CachedBytes */
+    SizeValueType PeakCachedBytes{ 0 };
+  };
+
+  /** Set/Get whether released buffers are kept. Disabling the pool purges
+   * it. */
+  virtual void
+  SetEnabled(bool enabled);
+  virtual bool
+  GetEnabled() const;
+  itkBooleanMacro(Enabled);
+
+  /** Set/Get the maximum total size of the kept buffers. Defaults to
+   * 1 GiB. */
+  virtual void
+  SetMaximumCachedBytes(SizeValueType maximumCachedBytes);
+  virtual SizeValueType
+  GetMaximumCachedBytes() const;
+
+  /** Set/Get the maximum number of kept buffers. Defaults to 64. */
+  virtual void
+  SetMaximumNumberOfBuffers(SizeValueType maximumNumberOfBuffers);
+  virtual SizeValueType
+  GetMaximumNumberOfBuffers() const;
+
+  /** Take a buffer of numberOfBytes bytes, for elements of type elementType
+   * from allocator. Returns nullptr if there is none. */
+  void *
+  Acquire(const std::type_info & elementType, SizeValueType numberOfBytes, const ImageBufferAllocator * allocator);
+
+  /** Offer a buffer of numberOfBytes bytes, with elements of type
+   * elementType allocated by allocator with the given alignment, to the
+   * pool. Returns false if it was not kept, in which case the caller must
+   * deallocate it. */
+  bool
+  Release(const std::type_info & elementType,
+          void *                 buffer,
+          SizeValueType          numberOfBytes,
+          SizeValueType          alignment,
+          ImageBufferAllocator * allocator);
+
+  /** Free all the kept buffers. */
+  void
+  Purge();
+
+  /** Get a copy of the statistics. */
+  Statistics
+  GetStatistics() const;
+
+  /** Reset the counters of the statistics (not the current cache state). */
+  void
+  ResetStatistics();
+
+protected:
+  ImageBufferPool();
+  ~ImageBufferPool() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(ImageBufferPoolGlobals, PimplGlobals);
+
+  struct Entry
+  {
+    std::type_index               ElementType;
+    SizeValueType                 NumberOfBytes;
+    SizeValueType                 Alignment;
+    ImageBufferAllocator::Pointer Allocator;
+    void *                        Buffer;
+  };
+
+  /** Remove the least recently released buffers, until numberOfBytes more bytes
+   * can be kept, and move them to evicted. Expects m_Mutex to be locked. */
+  void
+  MakeRoom(SizeValueType numberOfBytes, std::list<Entry> & evicted);
+
+  static void
+  Free(std::list<Entry> & entries);
+
+  mutable std::mutex m_Mutex;
+
+  /** Most recently released buffers first */
+  std::list<Entry>  m_Entries;
+  std::atomic<bool> m_Enabled{ false };
+  SizeValueType     m_MaximumCachedBytes{ SizeValueType{ 1 } << 30 };
+  SizeValueType     m_MaximumNumberOfBuffers{ 64 };
+  Statistics        m_Statistics;
+
+  static ImageBufferPoolGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+#endif
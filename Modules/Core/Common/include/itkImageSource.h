@@ -36,6 +36,9 @@
 namespace itk
 {
 
+template <typename TPixel, unsigned int VImageDimension>
+class VectorImage;
+
 /** \class ImageSource
  *  \brief Base class for all process objects that output image data.
  *
@@ -226,6 +229,31 @@ public:
   ProcessObject::DataObjectPointer
   MakeOutput(const ProcessObject::DataObjectIdentifierType &) override;
 
+  /** Approximate size, in bytes of output pixels, of the chunks passed to
+   * DynamicThreadedGenerateData(). When it is not zero, the requested
+   * region is cut into chunks of consecutive lines of about this size,
+   * which are handed out to the work units as they become idle (see
+   * MultiThreaderBase::ParallelizeImageRegionInChunks). A size close to
+   * the per-core cache keeps the working set in cache, and many small
+   * chunks balance filters whose cost per pixel is uneven. When it is zero,
+   * the requested region is split into NumberOfWorkUnits pieces.
+   * It is only used with dynamic multi-threading, and it is initialized
+   * from ImageSourceCommon::GetGlobalDefaultTargetBytesPerChunk(). */
+  itkSetMacro(TargetBytesPerChunk, SizeValueType);
+  itkGetConstMacro(TargetBytesPerChunk, SizeValueType);
+
+  /** Set/Get the initial value of TargetBytesPerChunk for all image sources. */
+  static void
+  SetGlobalDefaultTargetBytesPerChunk(SizeValueType bytes)
+  {
+    ImageSourceCommon::SetGlobalDefaultTargetBytesPerChunk(bytes);
+  }
+  static SizeValueType
+  GetGlobalDefaultTargetBytesPerChunk()
+  {
+    return ImageSourceCommon::GetGlobalDefaultTargetBytesPerChunk();
+  }
+
 protected:
   ImageSource();
   ~ImageSource() override = default;
@@ -400,6 +428,23 @@ protected:
   itkBooleanMacro(DynamicMultiThreading);
 
   bool m_DynamicMultiThreading;
+
+private:
+  /** Size in bytes of one pixel of the output buffer */
+  template <typename TImage>
+  static SizeValueType
+  GetBytesPerPixel(const TImage *)
+  {
+    return sizeof(typename TImage::PixelType);
+  }
+  template <typename TPixel, unsigned int VImageDimension>
+  static SizeValueType
+  GetBytesPerPixel(const VectorImage<TPixel, VImageDimension> * image)
+  {
+    return sizeof(TPixel) * image->GetNumberOfComponentsPerPixel();
+  }
+
+  SizeValueType m_TargetBytesPerChunk;
 };
 } // end namespace itk
 
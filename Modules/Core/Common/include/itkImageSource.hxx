@@ -34,6 +34,7 @@
 #include "itkMultiThreaderBase.h"
 
 #include "itkMath.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -51,6 +52,7 @@ ImageSource<TOutputImage>::ImageSource()
 #else
   m_DynamicMultiThreading = true;
 #endif
+  m_TargetBytesPerChunk = ImageSourceCommon::GetGlobalDefaultTargetBytesPerChunk();
 
   // Set the default behavior of an image source to NOT release its
   // output bulk data prior to GenerateData() in case that bulk data
@@ -228,12 +230,27 @@ ImageSource<TOutputImage>::GenerateData()
   {
     this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
     this->GetMultiThreader()->SetUpdateProgress(this->GetThreaderUpdateProgress());
-    this->GetMultiThreader()->template ParallelizeImageRegion<OutputImageDimension>(
-      this->GetOutput()->GetRequestedRegion(),
-      [this](const OutputImageRegionType & outputRegionForThread) {
-        this->DynamicThreadedGenerateData(outputRegionForThread);
-      },
-      this);
+    const OutputImageType * output = this->GetOutput();
+    if (m_TargetBytesPerChunk > 0)
+    {
+      const SizeValueType bytesPerPixel = std::max<SizeValueType>(GetBytesPerPixel(output), 1);
+      this->GetMultiThreader()->template ParallelizeImageRegionInChunks<OutputImageDimension>(
+        output->GetRequestedRegion(),
+        std::max<SizeValueType>(m_TargetBytesPerChunk / bytesPerPixel, 1),
+        [this](const OutputImageRegionType & outputRegionForThread) {
+          this->DynamicThreadedGenerateData(outputRegionForThread);
+        },
+        this);
+    }
+    else
+    {
+      this->GetMultiThreader()->template ParallelizeImageRegion<OutputImageDimension>(
+        output->GetRequestedRegion(),
+        [this](const OutputImageRegionType & outputRegionForThread) {
+          this->DynamicThreadedGenerateData(outputRegionForThread);
+        },
+        this);
+    }
   }
 
   // Call a method that can be overridden by a subclass to perform
@@ -316,6 +333,7 @@ ImageSource<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "DynamicMultiThreading: " << (m_DynamicMultiThreading ? "On" : "Off") << std::endl;
+  os << indent << "TargetBytesPerChunk: " << m_TargetBytesPerChunk << std::endl;
 }
 
 } // end namespace itk
@@ -20,6 +20,7 @@
 
 #include "ITKCommonExport.h"
 #include "itkImageRegionSplitterBase.h"
+#include "itkIntTypes.h"
 
 namespace itk
 {
@@ -43,6 +44,19 @@ struct ITKCommon_EXPORT ImageSourceCommon
    */
   static const ImageRegionSplitterBase *
   GetGlobalDefaultSplitter();
+
+  /**
+   * Set/Get the default size, in bytes of output pixels, of the chunks
+   * processed by a dynamically multi-threaded ImageSource. It initializes
+   * ImageSource::TargetBytesPerChunk of image sources constructed
+   * afterwards. Zero, the default, splits the requested region into one
+   * piece per work unit. The initial value may be set with the
+   * ITK_GLOBAL_DEFAULT_TARGET_BYTES_PER_CHUNK environment variable.
+   */
+  static void
+  SetGlobalDefaultTargetBytesPerChunk(SizeValueType bytes);
+  static SizeValueType
+  GetGlobalDefaultTargetBytesPerChunk();
 };
 
 } // end namespace itk
@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -151,6 +152,21 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the allocator which provides the memory of the buffers
+   * allocated by this container. When it is nullptr (the default),
+   * ImageBufferAllocator::GetGlobalDefault() is used. Changing it does
+   * not affect the current buffer, which is always released with the
+   * allocator it comes from.
+   *
+   * Only the buffers of elements without a destructor come from the
+   * allocator. The buffers of other elements are allocated by a new[]
+   * expression, so that an owner which takes a buffer with
+   * ContainerManageMemoryOff() may release it with delete[], as before.
+   * Buffers of elements without a destructor which come from an allocator
+   * other than the default one must be released through that allocator. */
+  itkSetObjectMacro(Allocator, ImageBufferAllocator);
+  itkGetModifiableObjectMacro(Allocator, ImageBufferAllocator);
+
 protected:
   ImportImageContainer();
   ~ImportImageContainer() override;
@@ -199,10 +215,39 @@ protected:
   }
 
 private:
+  /** Destroy the elements of a buffer obtained from an allocator. */
+  static void
+  DestroyElements(TElement * data, ElementIdentifier size);
+
   TElement *         m_ImportPointer;
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  ImageBufferAllocator::Pointer m_Allocator;
+
+  /** Allocator of m_ImportPointer, nullptr when the buffer was not
+   * obtained from an allocator (e.g. imported, or allocated by the
+   * AllocateElements() of a derived class). */
+  ImageBufferAllocator::Pointer m_BufferAllocator;
+
+  /** Elements allocated for the buffer, with their allocator. */
+  struct AllocatedElements
+  {
+    TElement *                    data;
+    ImageBufferAllocator::Pointer allocator;
+  };
+
+  /** Allocate the elements of a new buffer through AllocateElements(). The
+   * allocator is nullptr when the elements do not come from an allocator,
+   * e.g. when a derived class overrides AllocateElements(). */
+  AllocatedElements
+  AllocateBuffer(ElementIdentifier size, bool UseDefaultConstructor);
+
+  /** Where AllocateElements() reports its allocator, only during a call of
+   * AllocateBuffer(). Elements allocated outside of it are allocated by a
+   * new[] expression, as they are released with delete[]. */
+  ImageBufferAllocator::Pointer * m_AllocatorOfAllocatedElements{ nullptr };
 };
 } // end namespace itk
 
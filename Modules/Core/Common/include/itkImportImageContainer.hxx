@@ -29,7 +29,11 @@
 #define itkImportImageContainer_hxx
 
 #include "itkImportImageContainer.h"
+#include "itkImageBufferPool.h"
 #include <algorithm> // For copy_n.
+#include <limits>
+#include <new>
+#include <type_traits>
 
 namespace itk
 {
@@ -63,13 +67,14 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   {
     if (size > m_Capacity)
     {
-      TElement * temp = this->AllocateElements(size, UseDefaultConstructor);
+      AllocatedElements temp = this->AllocateBuffer(size, UseDefaultConstructor);
       // only copy the portion of the data used in the old buffer
-      std::copy_n(m_ImportPointer, m_Size, temp);
+      std::copy_n(m_ImportPointer, m_Size, temp.data);
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
+      m_ImportPointer = temp.data;
+      m_BufferAllocator = std::move(temp.allocator);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -83,7 +88,9 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   }
   else
   {
-    m_ImportPointer = this->AllocateElements(size, UseDefaultConstructor);
+    AllocatedElements elements = this->AllocateBuffer(size, UseDefaultConstructor);
+    m_ImportPointer = elements.data;
+    m_BufferAllocator = std::move(elements.allocator);
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -104,12 +111,13 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
     if (m_Size < m_Capacity)
     {
       const TElementIdentifier size = m_Size;
-      TElement *               temp = this->AllocateElements(size, false);
-      std::copy_n(m_ImportPointer, m_Size, temp);
+      AllocatedElements        temp = this->AllocateBuffer(size, false);
+      std::copy_n(m_ImportPointer, m_Size, temp.data);
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
+      m_ImportPointer = temp.data;
+      m_BufferAllocator = std::move(temp.allocator);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -168,22 +176,48 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
   // Encapsulate all image memory allocation here to throw an
   // exception when memory allocation fails even when the compiler
   // does not do this by default.
-  TElement * data;
-
-  try
+  if (!std::is_trivially_destructible<TElement>::value || m_AllocatorOfAllocatedElements == nullptr)
   {
-    if (UseDefaultConstructor)
+    // Elements with a destructor are allocated by a new[] expression, as
+    // before allocators, so that an owner which takes the buffer after
+    // ContainerManageMemoryOff() can still release it with delete[]. So are
+    // the elements allocated outside of AllocateBuffer(), which cannot tell
+    // their allocator.
+    TElement * data;
+    try
     {
-      data = new TElement[size](); // POD types initialized to 0, others use default constructor.
+      if (UseDefaultConstructor)
+      {
+        data = new TElement[size](); // Default constructor for each element.
+      }
+      else
+      {
+        data = new TElement[size];
+      }
     }
-    else
+    catch (...)
+    {
+      data = nullptr;
+    }
+    if (!data)
     {
-      data = new TElement[size]; // Faster but uninitialized
+      throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
     }
+    return data;
   }
-  catch (...)
+
+  ImageBufferAllocator * allocator = m_Allocator ? m_Allocator.GetPointer() : ImageBufferAllocator::GetGlobalDefault();
+  const SizeValueType    numberOfBytes = static_cast<SizeValueType>(size) * sizeof(TElement);
+
+  TElement * data = nullptr;
+  if (static_cast<SizeValueType>(size) <= std::numeric_limits<SizeValueType>::max() / sizeof(TElement))
   {
-    data = nullptr;
+    // Reuse a released buffer of the same size if possible
+    data = static_cast<TElement *>(ImageBufferPool::GetInstance()->Acquire(typeid(TElement), numberOfBytes, allocator));
+    if (!data)
+    {
+      data = static_cast<TElement *>(allocator->Allocate(numberOfBytes, alignof(TElement)));
+    }
   }
   if (!data)
   {
@@ -191,18 +225,94 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
     // of memory.  Do not use the exception macro.
     throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
   }
+
+  ElementIdentifier constructed = 0;
+  try
+  {
+    if (UseDefaultConstructor)
+    {
+      for (; constructed < size; ++constructed)
+      {
+        new (data + constructed) TElement(); // POD types initialized to 0, others use default constructor.
+      }
+    }
+    else if (!std::is_trivially_default_constructible<TElement>::value)
+    {
+      for (; constructed < size; ++constructed)
+      {
+        new (data + constructed) TElement; // Faster but uninitialized
+      }
+    }
+  }
+  catch (...)
+  {
+    DestroyElements(data, constructed);
+    allocator->Deallocate(data, numberOfBytes, alignof(TElement));
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to construct the elements of image.", ITK_LOCATION);
+  }
+  *m_AllocatorOfAllocatedElements = allocator;
   return data;
 }
 
+template <typename TElementIdentifier, typename TElement>
+auto
+ImportImageContainer<TElementIdentifier, TElement>::AllocateBuffer(ElementIdentifier size, bool UseDefaultConstructor)
+  -> AllocatedElements
+{
+  // AllocateElements() of this class reports its allocator, but not the
+  // one of a derived class, whose elements are then released with delete[]
+  // unless it also overrides DeallocateManagedMemory().
+  AllocatedElements elements{ nullptr, nullptr };
+  m_AllocatorOfAllocatedElements = &elements.allocator;
+  try
+  {
+    elements.data = this->AllocateElements(size, UseDefaultConstructor);
+  }
+  catch (...)
+  {
+    m_AllocatorOfAllocatedElements = nullptr;
+    throw;
+  }
+  m_AllocatorOfAllocatedElements = nullptr;
+  return elements;
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::DestroyElements(TElement * data, ElementIdentifier size)
+{
+  if (!std::is_trivially_destructible<TElement>::value)
+  {
+    for (ElementIdentifier i = 0; i < size; ++i)
+    {
+      data[i].~TElement();
+    }
+  }
+}
+
 template <typename TElementIdentifier, typename TElement>
 void
 ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
 {
   // Encapsulate all image memory deallocation here
-  if (m_ContainerManageMemory)
+  if (m_ContainerManageMemory && m_ImportPointer)
   {
-    delete[] m_ImportPointer;
+    if (m_BufferAllocator)
+    {
+      const SizeValueType numberOfBytes = static_cast<SizeValueType>(m_Capacity) * sizeof(TElement);
+      DestroyElements(m_ImportPointer, m_Capacity);
+      if (!ImageBufferPool::GetInstance()->Release(
+            typeid(TElement), m_ImportPointer, numberOfBytes, alignof(TElement), m_BufferAllocator))
+      {
+        m_BufferAllocator->Deallocate(m_ImportPointer, numberOfBytes, alignof(TElement));
+      }
+    }
+    else
+    {
+      delete[] m_ImportPointer;
+    }
   }
+  m_BufferAllocator = nullptr;
   m_ImportPointer = nullptr;
   m_Capacity = 0;
   m_Size = 0;
@@ -218,6 +328,7 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "Allocator: " << m_Allocator.GetPointer() << std::endl;
 }
 } // end namespace itk
 
@@ -63,7 +63,8 @@ public:
     First = Platform,
     Pool,
     TBB,
-    Last = TBB,
+    WorkStealing,
+    Last = WorkStealing,
     Unknown = -1
   };
 
@@ -163,6 +164,7 @@ public:
   static constexpr ThreaderEnum First = ThreaderEnum::First;
   static constexpr ThreaderEnum Pool = ThreaderEnum::Pool;
   static constexpr ThreaderEnum TBB = ThreaderEnum::TBB;
+  static constexpr ThreaderEnum WorkStealing = ThreaderEnum::WorkStealing;
   static constexpr ThreaderEnum Last = ThreaderEnum::Last;
   static constexpr ThreaderEnum Unknown = ThreaderEnum::Unknown;
 #endif
@@ -186,6 +188,9 @@ public:
       case ThreaderEnum::TBB:
         return "TBB";
         break;
+      case ThreaderEnum::WorkStealing:
+        return "WorkStealing";
+        break;
       case ThreaderEnum::Unknown:
       default:
         return "Unknown";
@@ -418,6 +423,52 @@ ITK_GCC_PRAGMA_DIAG_POP()
                          ThreadingFunctorType funcP,
                          ProcessObject *      filter);
 
+  /** Break up region into chunks of approximately pixelsPerChunk pixels,
+   * and call the function with chunks as parameters. Unlike
+   * ParallelizeImageRegion, the number of chunks does not depend on the
+   * number of work units. Chunks are handed out dynamically to the work
+   * units as they become idle, which balances workloads whose cost per
+   * pixel is uneven (masks, narrow bands). Each chunk is made of
+   * consecutive lines (or of a part of a line), so that it is contiguous
+   * in memory when the region is a buffered region.
+   * If filter argument is not nullptr, this function will update its progress
+   * as each chunk is completed. Delegates work to non-templated version. */
+  template <unsigned int VDimension>
+  ITK_TEMPLATE_EXPORT void
+  ParallelizeImageRegionInChunks(const ImageRegion<VDimension> &           requestedRegion,
+                                 SizeValueType                             pixelsPerChunk,
+                                 TemplatedThreadingFunctorType<VDimension> funcP,
+                                 ProcessObject *                           filter)
+  {
+    this->ParallelizeImageRegionInChunks(
+      VDimension,
+      requestedRegion.GetIndex().m_InternalArray,
+      requestedRegion.GetSize().m_InternalArray,
+      pixelsPerChunk,
+      [funcP](const IndexValueType index[], const SizeValueType size[]) {
+        ImageRegion<VDimension> region;
+        for (unsigned int d = 0; d < VDimension; ++d)
+        {
+          region.SetIndex(d, index[d]);
+          region.SetSize(d, size[d]);
+        }
+        funcP(region);
+      },
+      filter);
+  }
+
+  /** Break up region into chunks of approximately pixelsPerChunk pixels,
+   *  and call the function with chunks as parameters. This implementation
+   *  dispenses the chunks through ParallelizeArray, so it works with all the
+   *  multi-threaders. */
+  virtual void
+  ParallelizeImageRegionInChunks(unsigned int         dimension,
+                                 const IndexValueType index[],
+                                 const SizeValueType  size[],
+                                 SizeValueType        pixelsPerChunk,
+                                 ThreadingFunctorType funcP,
+                                 ProcessObject *      filter);
+
 protected:
   MultiThreaderBase();
   ~MultiThreaderBase() override;
@@ -0,0 +1,201 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNUMAGlobalConfiguration_h
+#define itkNUMAGlobalConfiguration_h
+
+#include "ITKCommonExport.h"
+#include "itkMultiThreaderBase.h"
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace itk
+{
+
+/** \class NUMAGlobalConfiguration
+ * \brief Process-wide settings for non-uniform memory access machines
+ *
+ * On machines with several memory nodes (e.g. dual-socket servers), the
+ * operating system places each page of memory on the node of the thread
+ * which first writes to it. By default, image buffers are allocated and
+ * initialized by a single thread, so all their pages end up on one node,
+ * and every multi-threaded filter is limited by the bandwidth of that node.
+ *
+ * When ParallelFirstTouch is enabled, Image and VectorImage write the pages
+ * of newly allocated buffers in parallel, with the region partition used by
+ * MultiThreaderBase::ParallelizeImageRegion, so that the pages are spread
+ * over the nodes in the way filters later access them.
+ *
+ * When PinWorkerThreads is enabled, the worker threads of the thread pools
+ * (used by PoolMultiThreader and WorkStealingMultiThreader) are bound to the
+ * processors of one node each, distributed round-robin over the nodes. It
+ * must be enabled before the pools are created, e.g. with the
+ * ITK_NUMA_PIN_WORKER_THREADS environment variable. Pinned workers keep
+ * processing the pages they touched first on their own node.
+ *
+ * The initial values of both settings are read from the
+ * ITK_NUMA_PARALLEL_FIRST_TOUCH and ITK_NUMA_PIN_WORKER_THREADS environment
+ * variables (ON/OFF). Both are off by default.
+ *
+ * The topology is currently detected on Linux only. On other systems, a
+ * single node is reported and threads are not pinned.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT NUMAGlobalConfiguration
+{
+public:
+  /** Number of memory nodes of the machine (at least one). */
+  static unsigned int
+  GetNumberOfNodes();
+
+  /** Processors attached to a memory node. */
+  static std::vector<unsigned int>
+  GetProcessorsOfNode(unsigned int node);
+
+  /** Size in bytes of a page of virtual memory. */
+  static SizeValueType
+  GetPageSize();
+
+  /** Bind a thread to the processors of a memory node. Returns false if
+   * the node does not exist, or if binding is not supported. */
+  static bool
+  PinThreadToNode(std::thread & thread, unsigned int node);
+
+  /** Bind a worker thread of a thread pool to a node chosen from its index,
+   * if PinWorkerThreads is enabled. */
+  static void
+  PinWorkerThread(std::thread & thread, ThreadIdType workerIndex);
+
+  /** Set/Get whether new image buffers are first written in parallel. */
+  static void
+  SetParallelFirstTouch(bool parallelFirstTouch);
+  static bool
+  GetParallelFirstTouch();
+
+  /** Set/Get whether the worker threads of the thread pools are pinned
+   * to memory nodes. Only affects the threads created afterwards. */
+  static void
+  SetPinWorkerThreads(bool pinWorkerThreads);
+  static bool
+  GetPinWorkerThreads();
+
+  /** Mark the calling thread as a worker of a thread pool. Called by
+   * ThreadPool and WorkStealingThreadPool when their workers start. */
+  static void
+  RegisterWorkerThread();
+
+  /** Whether the calling thread is a worker of a thread pool. */
+  static bool
+  IsWorkerThread();
+
+  /** Multi-threader used by FirstTouch, created once per calling thread. */
+  static MultiThreaderBase *
+  GetFirstTouchMultiThreader();
+
+  /** Whether a buffer of the given size should be first touched in
+   * parallel. Buffers of less than a few pages per thread are not worth
+   * it. */
+  static bool
+  UseParallelFirstTouch(SizeValueType bufferSizeInBytes);
+
+  /** Write the buffer of an image in parallel, following the partition of
+   * its buffered region used by MultiThreaderBase::ParallelizeImageRegion.
+   * If initialize is true, all the elements are set to their value
+   * initialized state. Otherwise, only one element per page is written,
+   * which leaves the content unspecified, as after an allocation without
+   * initialization. Buffers of types with a non-trivial constructor were
+   * already written when their elements were constructed, so they are
+   * only touched again when initialize is true.
+   *
+   * A buffer allocated by a worker of a thread pool, e.g. within the
+   * function given to ParallelizeImageRegion, is written serially: waiting
+   * for the other workers of the pool from one of its workers may deadlock
+   * when they are all busy. */
+  template <unsigned int VDimension, typename TElement>
+  static void
+  FirstTouch(const ImageRegion<VDimension> & bufferedRegion,
+             SizeValueType                   elementsPerPixel,
+             TElement *                      buffer,
+             bool                            initialize)
+  {
+    if (!initialize && !std::is_trivially_copyable<TElement>::value)
+    {
+      return;
+    }
+    const TElement      value = TElement();
+    const SizeValueType stride = std::max<SizeValueType>(GetPageSize() / sizeof(TElement), 1);
+
+    const auto touch = [&](const ImageRegion<VDimension> & chunk) {
+      const SizeValueType lineLength = chunk.GetSize(0) * elementsPerPixel;
+      if (lineLength == 0)
+      {
+        return;
+      }
+      const SizeValueType numberOfLines = chunk.GetNumberOfPixels() / chunk.GetSize(0);
+      Index<VDimension>   index = chunk.GetIndex();
+      for (SizeValueType line = 0; line < numberOfLines; ++line)
+      {
+        SizeValueType offset = 0;
+        SizeValueType pixelsPerSlice = 1;
+        for (unsigned int d = 0; d < VDimension; ++d)
+        {
+          offset += (index[d] - bufferedRegion.GetIndex(d)) * pixelsPerSlice;
+          pixelsPerSlice *= bufferedRegion.GetSize(d);
+        }
+        TElement * lineStart = buffer + offset * elementsPerPixel;
+        if (initialize)
+        {
+          std::fill_n(lineStart, lineLength, value);
+        }
+        else
+        {
+          for (SizeValueType i = 0; i < lineLength; i += stride)
+          {
+            lineStart[i] = value;
+          }
+        }
+
+        // Move to the next line of the chunk
+        for (unsigned int d = 1; d < VDimension; ++d)
+        {
+          if (++index[d] < chunk.GetIndex(d) + static_cast<IndexValueType>(chunk.GetSize(d)))
+          {
+            break;
+          }
+          index[d] = chunk.GetIndex(d);
+        }
+      }
+    };
+
+    if (IsWorkerThread())
+    {
+      touch(bufferedRegion);
+    }
+    else
+    {
+      GetFirstTouchMultiThreader()->template ParallelizeImageRegion<VDimension>(bufferedRegion, touch, nullptr);
+    }
+  }
+};
+
+} // end namespace itk
+
+#endif
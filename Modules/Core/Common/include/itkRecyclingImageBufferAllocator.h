@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRecyclingImageBufferAllocator_h
+#define itkRecyclingImageBufferAllocator_h
+
+#include "itkAlignedImageBufferAllocator.h"
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace itk
+{
+/** \class RecyclingImageBufferAllocator
+ * \brief Keeps released pixel buffers to reuse them for buffers of the
+ * same size
+ *
+ * Pipelines which are updated repeatedly on images of the same size free
+ * and allocate the same buffers at each update. Freeing large buffers
+ * returns their pages to the operating system, which then has to map and
+ * zero them again at the next allocation. This allocator keeps the
+ * deallocated buffers, up to MaximumCachedBytes, and returns one of them
+ * when a buffer of the same size and alignment is allocated.
+ *
+ * The memory is obtained from an AlignedImageBufferAllocator, available
+ * with GetAllocator() to configure its alignment and huge page use.
+ *
+ * \sa ImageBufferAllocator
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT RecyclingImageBufferAllocator : public ImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(RecyclingImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = RecyclingImageBufferAllocator;
+  using Superclass = ImageBufferAllocator;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RecyclingImageBufferAllocator, ImageBufferAllocator);
+
+  void *
+  Allocate(SizeValueType numberOfBytes, SizeValueType alignment) override;
+
+  void
+  Deallocate(void * buffer, SizeValueType numberOfBytes, SizeValueType alignment) override;
+
+  /** Set/Get the maximum number of bytes of the kept buffers. Buffers which
+   * do not fit are freed. Defaults to 1 GiB. */
+  virtual void
+  SetMaximumCachedBytes(SizeValueType maximumCachedBytes);
+  virtual SizeValueType
+  GetMaximumCachedBytes() const;
+
+  /** Number of bytes of the buffers kept for reuse. */
+  virtual SizeValueType
+  GetCachedBytes() const;
+
+  /** Free all the buffers kept for reuse. */
+  virtual void
+  Purge();
+
+  /** Get the allocator which provides the memory. */
+  AlignedImageBufferAllocator *
+  GetAllocator()
+  {
+    return m_Allocator;
+  }
+
+protected:
+  RecyclingImageBufferAllocator();
+  ~RecyclingImageBufferAllocator() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using KeyType = std::pair<SizeValueType, SizeValueType>; // size and alignment
+
+  AlignedImageBufferAllocator::Pointer m_Allocator;
+  mutable std::mutex                   m_Mutex;
+  std::multimap<KeyType, void *>       m_Buffers;
+  SizeValueType                        m_CachedBytes{ 0 };
+  SizeValueType                        m_MaximumCachedBytes{ SizeValueType{ 1 } << 30 };
+};
+} // end namespace itk
+
+#endif
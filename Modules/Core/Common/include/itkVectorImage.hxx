@@ -29,6 +29,7 @@
 #define itkVectorImage_hxx
 #include "itkVectorImage.h"
 #include "itkProcessObject.h"
+#include "itkNUMAGlobalConfiguration.h"
 
 namespace itk
 {
@@ -56,7 +57,18 @@ VectorImage<TPixel, VImageDimension>::Allocate(const bool UseDefaultConstructor)
   this->ComputeOffsetTable();
   num = this->GetOffsetTable()[VImageDimension];
 
-  m_Buffer->Reserve(num * m_VectorLength, UseDefaultConstructor);
+  if (m_Buffer->GetBufferPointer() == nullptr &&
+      NUMAGlobalConfiguration::UseParallelFirstTouch(num * m_VectorLength * sizeof(InternalPixelType)))
+  {
+    // Let the threads which will process the pixels write their pages first
+    m_Buffer->Reserve(num * m_VectorLength, false);
+    NUMAGlobalConfiguration::FirstTouch(
+      this->GetBufferedRegion(), m_VectorLength, m_Buffer->GetBufferPointer(), UseDefaultConstructor);
+  }
+  else
+  {
+    m_Buffer->Reserve(num * m_VectorLength, UseDefaultConstructor);
+  }
 }
 
 template <typename TPixel, unsigned int VImageDimension>
@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+
+namespace itk
+{
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool with one task deque per worker thread.
+ *
+ * Unlike ThreadPool, which dispatches all jobs from a single queue
+ * guarded by one mutex, each worker owns a deque of tasks. A worker
+ * pushes and pops tasks at the back of its own deque, and idle workers
+ * steal from the front of the other deques. Submitting threads which
+ * are not part of the pool distribute their tasks round-robin over the
+ * worker deques, so contention is limited to the deque being touched.
+ *
+ * Tasks are grouped in a TaskGroup. Wait() does not block the calling
+ * thread while tasks of the group are pending: the caller executes
+ * queued tasks itself. This makes nested parallelism (a task which
+ * submits and waits for further tasks) safe from deadlocks, even when
+ * all workers are busy.
+ *
+ * The pool is used by the WorkStealingMultiThreader.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+
+struct WorkStealingThreadPoolGlobals;
+
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer
+  GetInstance();
+
+  using TaskFunctionType = std::function<void()>;
+
+  /** \class TaskGroup
+   * \brief Set of tasks which can be waited for together.
+   *
+   * The first exception thrown by any task of the group is kept,
+   * and rethrown by WorkStealingThreadPool::Wait().
+   * \ingroup ITKCommon
+   */
+  class TaskGroup
+  {
+  public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &
+    operator=(const TaskGroup &) = delete;
+
+    /** Number of tasks which have been added, but have not yet completed. */
+    SizeValueType
+    GetNumberOfPendingTasks() const
+    {
+      return m_Pending.load();
+    }
+
+  private:
+    friend class WorkStealingThreadPool;
+
+    std::atomic<SizeValueType> m_Pending{ 0 };
+    std::mutex                 m_Mutex;
+    std::condition_variable    m_Condition;
+    std::exception_ptr         m_FirstCaughtException;
+  };
+
+  /** Add a task to the pool. If the calling thread is a worker of this pool,
+   * the task is pushed onto its own deque, otherwise onto the deque of the
+   * next worker in a round-robin fashion. */
+  void
+  AddWork(TaskGroup & group, TaskFunctionType task);
+
+  /** Execute pending tasks in the calling thread until all the tasks
+   * of the group have completed, then rethrow the first exception caught
+   * in the group, if any. If no task is available while tasks of the group
+   * are still running elsewhere, the caller sleeps for at most
+   * pollingInterval, and invokes pollFunction (if set) when it wakes up. */
+  void
+  Wait(TaskGroup &                     group,
+       const std::function<void()> &   pollFunction = nullptr,
+       const std::chrono::milliseconds pollingInterval = std::chrono::milliseconds(10));
+
+  /** Can call this method if we want to add extra threads to the pool.
+   * The total is clamped to ITK_MAX_THREADS. */
+  void
+  AddThreads(ThreadIdType count);
+
+  ThreadIdType
+  GetMaximumNumberOfThreads() const
+  {
+    return m_NumberOfWorkers.load();
+  }
+
+  /** Whether the calling thread is one of the workers of this pool. */
+  bool
+  IsWorkerThread() const;
+
+protected:
+  WorkStealingThreadPool();
+  ~WorkStealingThreadPool() override;
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(WorkStealingThreadPoolGlobals, PimplGlobals);
+
+  struct Task;
+  class WorkerQueue;
+
+  /** Get a task, first from the back of the deque owned by the calling
+   * thread, then from the front of the other deques. */
+  bool
+  PopOrStealTask(Task & task);
+
+  /** Run a task and signal its group. */
+  static void
+  ExecuteTask(Task & task);
+
+  /** The continuously running thread function */
+  void
+  ThreadExecute(ThreadIdType workerIndex);
+
+  /** Start count more workers. Expects the global mutex to be locked, or
+   * to be called from the constructor. */
+  void
+  StartThreads(ThreadIdType count);
+
+  /** One deque per possible worker. These are allocated once, so that
+   * thieves can scan them without synchronizing with AddThreads(). */
+  std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+
+  /** Worker thread handles, used to join the threads. */
+  std::vector<std::thread> m_Threads;
+
+  std::atomic<ThreadIdType>  m_NumberOfWorkers{ 0 };
+  std::atomic<SizeValueType> m_NextQueue{ 0 };
+
+  /** Number of tasks sitting in the deques, used by idle workers to decide
+   * whether to sleep. */
+  std::atomic<SizeValueType> m_QueuedTasks{ 0 };
+  std::atomic<ThreadIdType>  m_SleepingWorkers{ 0 };
+  std::mutex                 m_SleepMutex;
+  std::condition_variable    m_SleepCondition;
+
+  /* Has destruction started? */
+  std::atomic<bool> m_Stopping{ false };
+
+  static WorkStealingThreadPoolGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+#endif
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAlignedImageBufferAllocator.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+bool
+IsPowerOfTwo(SizeValueType value)
+{
+  return value > 0 && (value & (value - 1)) == 0;
+}
+} // namespace
+
+void
+AlignedImageBufferAllocator::SetAlignment(SizeValueType alignment)
+{
+  if (!IsPowerOfTwo(alignment))
+  {
+    itkExceptionMacro("Alignment must be a power of two, not " << alignment);
+  }
+  if (m_Alignment != alignment)
+  {
+    m_Alignment = alignment;
+    this->Modified();
+  }
+}
+
+void
+AlignedImageBufferAllocator::SetHugePageSize(SizeValueType hugePageSize)
+{
+  if (!IsPowerOfTwo(hugePageSize))
+  {
+    itkExceptionMacro("HugePageSize must be a power of two, not " << hugePageSize);
+  }
+  if (m_HugePageSize != hugePageSize)
+  {
+    m_HugePageSize = hugePageSize;
+    this->Modified();
+  }
+}
+
+void *
+AlignedImageBufferAllocator::Allocate(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  alignment = std::max(alignment, m_Alignment);
+  if (!m_UseHugePages || numberOfBytes < m_HugePageSize)
+  {
+    return AllocateAligned(numberOfBytes, alignment);
+  }
+
+  // Whole huge pages, so that the advice covers the entire buffer
+  const SizeValueType hugePageSize = std::max(alignment, m_HugePageSize);
+  const SizeValueType roundedNumberOfBytes = (numberOfBytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+  void *              buffer = AllocateAligned(roundedNumberOfBytes, hugePageSize);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (buffer)
+  {
+    // Only a hint, the buffer is usable even if it is not followed
+    madvise(buffer, roundedNumberOfBytes, MADV_HUGEPAGE);
+  }
+#endif
+  return buffer;
+}
+
+void
+AlignedImageBufferAllocator::Deallocate(void * buffer, SizeValueType, SizeValueType)
+{
+  DeallocateAligned(buffer);
+}
+
+void
+AlignedImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alignment: " << m_Alignment << std::endl;
+  os << indent << "UseHugePages: " << (m_UseHugePages ? "On" : "Off") << std::endl;
+  os << indent << "HugePageSize: " << m_HugePageSize << std::endl;
+}
+
+} // end namespace itk
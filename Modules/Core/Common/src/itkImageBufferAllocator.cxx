@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+// The global default is read on every buffer allocation, without a lock.
+// The allocators which were the global default are kept alive, since a
+// thread may still be using one after it is replaced.
+std::atomic<ImageBufferAllocator *>        globalDefaultAllocator{ nullptr };
+std::mutex                                 globalDefaultAllocatorLock;
+std::vector<ImageBufferAllocator::Pointer> globalDefaultAllocators;
+} // namespace
+
+void *
+ImageBufferAllocator::Allocate(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  if (alignment > alignof(std::max_align_t))
+  {
+    return AllocateAligned(numberOfBytes, alignment);
+  }
+  // Array form, so that buffers of trivial types may be released by their
+  // owner with delete[], as before allocators were introduced
+  return ::operator new[](numberOfBytes, std::nothrow);
+}
+
+void
+ImageBufferAllocator::Deallocate(void * buffer, SizeValueType, SizeValueType alignment)
+{
+  if (alignment > alignof(std::max_align_t))
+  {
+    DeallocateAligned(buffer);
+  }
+  else
+  {
+    ::operator delete[](buffer);
+  }
+}
+
+void
+ImageBufferAllocator::SetGlobalDefault(ImageBufferAllocator * allocator)
+{
+  std::lock_guard<std::mutex> lock(globalDefaultAllocatorLock);
+  if (allocator)
+  {
+    globalDefaultAllocators.emplace_back(allocator);
+  }
+  globalDefaultAllocator.store(allocator, std::memory_order_release);
+}
+
+ImageBufferAllocator *
+ImageBufferAllocator::GetGlobalDefault()
+{
+  ImageBufferAllocator * allocator = globalDefaultAllocator.load(std::memory_order_acquire);
+  if (allocator)
+  {
+    return allocator;
+  }
+
+  std::lock_guard<std::mutex> lock(globalDefaultAllocatorLock);
+  allocator = globalDefaultAllocator.load(std::memory_order_acquire);
+  if (!allocator)
+  {
+    globalDefaultAllocators.push_back(ImageBufferAllocator::New());
+    allocator = globalDefaultAllocators.back();
+    globalDefaultAllocator.store(allocator, std::memory_order_release);
+  }
+  return allocator;
+}
+
+void *
+ImageBufferAllocator::AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  alignment = std::max<SizeValueType>(alignment, sizeof(void *));
+  numberOfBytes = std::max<SizeValueType>(numberOfBytes, 1); // an empty buffer still needs a unique address
+#if defined(_WIN32)
+  return _aligned_malloc(numberOfBytes, alignment);
+#else
+  void * buffer = nullptr;
+  if (posix_memalign(&buffer, alignment, numberOfBytes) != 0)
+  {
+    return nullptr;
+  }
+  return buffer;
+#endif
+}
+
+void
+ImageBufferAllocator::DeallocateAligned(void * buffer)
+{
+#if defined(_WIN32)
+  _aligned_free(buffer);
+#else
+  free(buffer);
+#endif
+}
+
+} // end namespace itk
@@ -0,0 +1,290 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+#include <algorithm>
+#include <iterator>
+
+namespace itk
+{
+
+struct ImageBufferPoolGlobals
+{
+  ImageBufferPoolGlobals() = default;
+  // To lock on the internal variables.
+  std::mutex               m_Mutex;
+  ImageBufferPool::Pointer m_ImageBufferPoolInstance;
+};
+
+itkGetGlobalSimpleMacro(ImageBufferPool, ImageBufferPoolGlobals, PimplGlobals);
+
+ImageBufferPool::Pointer
+ImageBufferPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+ImageBufferPool::Pointer
+ImageBufferPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  if (m_PimplGlobals->m_ImageBufferPoolInstance.IsNull())
+  {
+    std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+    // After we have the lock, double check the initialization
+    // flag to ensure it hasn't been changed by another thread.
+    if (m_PimplGlobals->m_ImageBufferPoolInstance.IsNull())
+    {
+      m_PimplGlobals->m_ImageBufferPoolInstance = ObjectFactory<Self>::Create();
+      if (m_PimplGlobals->m_ImageBufferPoolInstance.IsNull())
+      {
+        new ImageBufferPool(); // constructor sets m_PimplGlobals->m_ImageBufferPoolInstance
+      }
+    }
+  }
+  return m_PimplGlobals->m_ImageBufferPoolInstance;
+}
+
+ImageBufferPool::ImageBufferPool()
+{
+  m_PimplGlobals->m_ImageBufferPoolInstance = this;        // keep the global reference
+  m_PimplGlobals->m_ImageBufferPoolInstance->UnRegister(); // Remove extra reference
+
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL", envVar))
+  {
+    envVar = itksys::SystemTools::UpperCase(envVar);
+    m_Enabled = (envVar == "ON" || envVar == "TRUE" || envVar == "YES" || envVar == "1");
+  }
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+  Free(m_Entries);
+}
+
+void
+ImageBufferPool::SetEnabled(bool enabled)
+{
+  if (m_Enabled != enabled)
+  {
+    m_Enabled = enabled;
+    if (!enabled)
+    {
+      this->Purge();
+    }
+    this->Modified();
+  }
+}
+
+bool
+ImageBufferPool::GetEnabled() const
+{
+  return m_Enabled;
+}
+
+void
+ImageBufferPool::SetMaximumCachedBytes(SizeValueType maximumCachedBytes)
+{
+  std::list<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MaximumCachedBytes == maximumCachedBytes)
+    {
+      return;
+    }
+    m_MaximumCachedBytes = maximumCachedBytes;
+    this->MakeRoom(0, evicted);
+  }
+  Free(evicted);
+  this->Modified();
+}
+
+SizeValueType
+ImageBufferPool::GetMaximumCachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumCachedBytes;
+}
+
+void
+ImageBufferPool::SetMaximumNumberOfBuffers(SizeValueType maximumNumberOfBuffers)
+{
+  std::list<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MaximumNumberOfBuffers == maximumNumberOfBuffers)
+    {
+      return;
+    }
+    m_MaximumNumberOfBuffers = maximumNumberOfBuffers;
+    this->MakeRoom(0, evicted);
+  }
+  Free(evicted);
+  this->Modified();
+}
+
+SizeValueType
+ImageBufferPool::GetMaximumNumberOfBuffers() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumNumberOfBuffers;
+}
+
+void *
+ImageBufferPool::Acquire(const std::type_info &       elementType,
+                         SizeValueType                numberOfBytes,
+                         const ImageBufferAllocator * allocator)
+{
+  if (!m_Enabled)
+  {
+    return nullptr;
+  }
+
+  const std::type_index       type(elementType);
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+  {
+    if (it->NumberOfBytes == numberOfBytes && it->ElementType == type && it->Allocator.GetPointer() == allocator)
+    {
+      void * buffer = it->Buffer;
+      m_Entries.erase(it);
+      ++m_Statistics.Hits;
+      --m_Statistics.CachedBuffers;
+      m_Statistics.CachedBytes -= numberOfBytes;
+      return buffer;
+    }
+  }
+  ++m_Statistics.Misses;
+  return nullptr;
+}
+
+bool
+ImageBufferPool::Release(const std::type_info & elementType,
+                         void *                 buffer,
+                         SizeValueType          numberOfBytes,
+                         SizeValueType          alignment,
+                         ImageBufferAllocator * allocator)
+{
+  if (!m_Enabled || buffer == nullptr || allocator == nullptr)
+  {
+    return false;
+  }
+
+  std::list<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (numberOfBytes > m_MaximumCachedBytes || m_MaximumNumberOfBuffers == 0)
+    {
+      ++m_Statistics.Evictions;
+      return false;
+    }
+    this->MakeRoom(numberOfBytes, evicted);
+    m_Entries.push_front(Entry{ std::type_index(elementType), numberOfBytes, alignment, allocator, buffer });
+    ++m_Statistics.Returns;
+    ++m_Statistics.CachedBuffers;
+    m_Statistics.CachedBytes += numberOfBytes;
+    m_Statistics.PeakCachedBytes = std::max(m_Statistics.PeakCachedBytes, m_Statistics.CachedBytes);
+  }
+  // Free outside of the lock, the allocators may be slow
+  Free(evicted);
+  return true;
+}
+
+void
+ImageBufferPool::MakeRoom(SizeValueType numberOfBytes, std::list<Entry> & evicted)
+{
+  const SizeValueType numberOfBuffers = numberOfBytes > 0 ? 1 : 0;
+  while (!m_Entries.empty() && (m_Statistics.CachedBytes + numberOfBytes > m_MaximumCachedBytes ||
+                                m_Statistics.CachedBuffers + numberOfBuffers > m_MaximumNumberOfBuffers))
+  {
+    const SizeValueType evictedBytes = m_Entries.back().NumberOfBytes;
+    evicted.splice(evicted.end(), m_Entries, std::prev(m_Entries.end()));
+    ++m_Statistics.Evictions;
+    --m_Statistics.CachedBuffers;
+    m_Statistics.CachedBytes -= evictedBytes;
+  }
+}
+
+void
+ImageBufferPool::Free(std::list<Entry> & entries)
+{
+  for (const auto & entry : entries)
+  {
+    entry.Allocator->Deallocate(entry.Buffer, entry.NumberOfBytes, entry.Alignment);
+  }
+  entries.clear();
+}
+
+void
+ImageBufferPool::Purge()
+{
+  std::list<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::swap(entries, m_Entries);
+    m_Statistics.CachedBuffers = 0;
+    m_Statistics.CachedBytes = 0;
+  }
+  Free(entries);
+}
+
+ImageBufferPool::Statistics
+ImageBufferPool::GetStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Statistics;
+}
+
+void
+ImageBufferPool::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Statistics.Hits = 0;
+  m_Statistics.Misses = 0;
+  m_Statistics.Returns = 0;
+  m_Statistics.Evictions = 0;
+  m_Statistics.PeakCachedBytes = m_Statistics.CachedBytes;
+}
+
+void
+ImageBufferPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const Statistics statistics = this->GetStatistics();
+  os << indent << "Enabled: " << (this->GetEnabled() ? "On" : "Off") << std::endl;
+  os << indent << "MaximumCachedBytes: " << this->GetMaximumCachedBytes() << std::endl;
+  os << indent << "MaximumNumberOfBuffers: " << this->GetMaximumNumberOfBuffers() << std::endl;
+  os << indent << "Hits: " << statistics.Hits << std::endl;
+  os << indent << "Misses: " << statistics.Misses << std::endl;
+  os << indent << "Returns: " << statistics.Returns << std::endl;
+  os << indent << "Evictions: " << statistics.Evictions << std::endl;
+  os << indent << "CachedBuffers: " << statistics.CachedBuffers << std::endl;
+  os << indent << "CachedBytes: " << statistics.CachedBytes << std::endl;
+  os << indent << "PeakCachedBytes: " << statistics.PeakCachedBytes << std::endl;
+}
+
+ImageBufferPoolGlobals * ImageBufferPool::m_PimplGlobals;
+
+} // namespace itk
@@ -18,7 +18,10 @@
 
 #include "itkImageRegionSplitterSlowDimension.h"
 #include "itkImageSourceCommon.h"
+#include "itksys/SystemTools.hxx"
+#include <atomic>
 #include <mutex>
+#include <string>
 
 namespace itk
 {
@@ -27,6 +30,26 @@ namespace
 {
 std::mutex                       globalDefaultSplitterLock;
 ImageRegionSplitterBase::Pointer globalDefaultSplitter;
+
+SizeValueType
+GetTargetBytesPerChunkFromEnvironment()
+{
+  std::string value;
+  if (itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_TARGET_BYTES_PER_CHUNK", value))
+  {
+    try
+    {
+      return static_cast<SizeValueType>(std::stoull(value));
+    }
+    catch (...)
+    {
+      // ignore invalid values
+    }
+  }
+  return 0;
+}
+
+std::atomic<SizeValueType> globalDefaultTargetBytesPerChunk(GetTargetBytesPerChunkFromEnvironment());
 } // namespace
 
 const ImageRegionSplitterBase *
@@ -45,5 +68,17 @@ ImageSourceCommon::GetGlobalDefaultSplitter()
   return globalDefaultSplitter;
 }
 
+void
+ImageSourceCommon::SetGlobalDefaultTargetBytesPerChunk(SizeValueType bytes)
+{
+  globalDefaultTargetBytesPerChunk = bytes;
+}
+
+SizeValueType
+ImageSourceCommon::GetGlobalDefaultTargetBytesPerChunk()
+{
+  return globalDefaultTargetBytesPerChunk;
+}
+
 
 } // namespace itk
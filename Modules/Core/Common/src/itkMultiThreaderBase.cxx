@@ -30,6 +30,7 @@
 
 #if defined(ITK_USE_POOL_MULTI_THREADER)
 #  include "itkPoolMultiThreader.h"
+#  include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -42,6 +43,7 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 
 #if defined(ITK_USE_TBB)
@@ -188,6 +190,10 @@ MultiThreaderBase::ThreaderTypeFromString(std::string threaderString)
   {
     return ThreaderEnum::TBB;
   }
+  else if (threaderString == "WORKSTEALING")
+  {
+    return ThreaderEnum::WorkStealing;
+  }
   else
   {
     return ThreaderEnum::Unknown;
@@ -406,6 +412,12 @@ MultiThreaderBase::New()
         return TBBMultiThreader::New();
 #else
         itkGenericExceptionMacro("ITK has been built without TBB support!");
+#endif
+      case ThreaderEnum::WorkStealing:
+#if defined(ITK_USE_POOL_MULTI_THREADER)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
 #endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
@@ -578,6 +590,140 @@ MultiThreaderBase::ParallelizeImageRegionHelper(void * arg)
   return ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
+namespace
+{
+/** Layout of the chunks used by ParallelizeImageRegionInChunks. A chunk
+ * spans the whole region along the dimensions below the split axis,
+ * ValuesPerChunk consecutive indices along the split axis, and a single
+ * index along the dimensions above it. */
+class ImageRegionChunks
+{
+public:
+  ImageRegionChunks(unsigned int dimension, const SizeValueType size[], SizeValueType pixelsPerChunk)
+    : m_Dimension(dimension)
+  {
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      if (size[d] == 0) // empty region, no chunks
+      {
+        return;
+      }
+    }
+    pixelsPerChunk = std::max<SizeValueType>(pixelsPerChunk, 1);
+
+    // Find the outermost axis such that a line along it still fits in a chunk
+    SizeValueType pixelsPerLine = 1;
+    while (m_SplitAxis + 1 < dimension && pixelsPerLine * size[m_SplitAxis] <= pixelsPerChunk)
+    {
+      pixelsPerLine *= size[m_SplitAxis];
+      ++m_SplitAxis;
+    }
+    m_ValuesPerChunk = std::max<SizeValueType>(pixelsPerChunk / pixelsPerLine, 1);
+    m_ValuesPerChunk = std::min(m_ValuesPerChunk, size[m_SplitAxis]);
+
+    m_ChunksAlongSplitAxis = (size[m_SplitAxis] + m_ValuesPerChunk - 1) / m_ValuesPerChunk;
+    m_NumberOfChunks = m_ChunksAlongSplitAxis;
+    for (unsigned int d = m_SplitAxis + 1; d < dimension; ++d)
+    {
+      m_NumberOfChunks *= size[d];
+    }
+  }
+
+  SizeValueType
+  GetNumberOfChunks() const
+  {
+    return m_NumberOfChunks;
+  }
+
+  /** Restrict the region described by index and size to its chunk number i */
+  void
+  GetChunk(SizeValueType i, IndexValueType index[], SizeValueType size[]) const
+  {
+    const SizeValueType chunkAlongSplitAxis = i % m_ChunksAlongSplitAxis;
+    SizeValueType       outerOffset = i / m_ChunksAlongSplitAxis;
+
+    index[m_SplitAxis] += chunkAlongSplitAxis * m_ValuesPerChunk;
+    size[m_SplitAxis] = std::min(m_ValuesPerChunk, size[m_SplitAxis] - chunkAlongSplitAxis * m_ValuesPerChunk);
+    for (unsigned int d = m_SplitAxis + 1; d < m_Dimension; ++d)
+    {
+      index[d] += outerOffset % size[d];
+      outerOffset /= size[d];
+      size[d] = 1;
+    }
+  }
+
+private:
+  unsigned int  m_Dimension;
+  unsigned int  m_SplitAxis{ 0 };
+  SizeValueType m_ValuesPerChunk{ 0 };
+  SizeValueType m_ChunksAlongSplitAxis{ 0 };
+  SizeValueType m_NumberOfChunks{ 0 };
+};
+} // namespace
+
+void
+MultiThreaderBase::ParallelizeImageRegionInChunks(unsigned int                            dimension,
+                                                  const IndexValueType                    index[],
+                                                  const SizeValueType                     size[],
+                                                  SizeValueType                           pixelsPerChunk,
+                                                  MultiThreaderBase::ThreadingFunctorType funcP,
+                                                  ProcessObject *                         filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progress(filter, 0, 1);
+
+  const ImageRegionChunks chunks(dimension, size, pixelsPerChunk);
+  const SizeValueType     numberOfChunks = chunks.GetNumberOfChunks();
+  if (numberOfChunks <= 1)
+  {
+    if (numberOfChunks == 1)
+    {
+      funcP(index, size); // process whole region
+    }
+    return;
+  }
+
+  SizeValueType pixelCount = 1;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    pixelCount *= size[d];
+  }
+
+  // Each work unit keeps taking the next chunk until there are none left,
+  // so faster work units end up processing more chunks.
+  const SizeValueType numberOfWorkUnits =
+    std::min<SizeValueType>(numberOfChunks, std::min(m_NumberOfWorkUnits, m_MaximumNumberOfThreads));
+  std::atomic<SizeValueType> nextChunk(0);
+  this->ParallelizeArray(
+    0,
+    numberOfWorkUnits,
+    [&](SizeValueType) {
+      TotalProgressReporter       reporter(filter, pixelCount);
+      std::vector<IndexValueType> chunkIndex(dimension);
+      std::vector<SizeValueType>  chunkSize(dimension);
+      for (SizeValueType i = nextChunk++; i < numberOfChunks; i = nextChunk++)
+      {
+        reporter.CheckAbortGenerateData();
+        std::copy(index, index + dimension, chunkIndex.begin());
+        std::copy(size, size + dimension, chunkSize.begin());
+        chunks.GetChunk(i, chunkIndex.data(), chunkSize.data());
+
+        funcP(chunkIndex.data(), chunkSize.data());
+
+        SizeValueType chunkPixelCount = 1;
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+          chunkPixelCount *= chunkSize[d];
+        }
+        reporter.Completed(chunkPixelCount);
+      }
+    },
+    nullptr);
+}
+
 // Print method for the multithreader
 void
 MultiThreaderBase::PrintSelf(std::ostream & os, Indent indent) const
@@ -610,6 +756,8 @@ operator<<(std::ostream & out, const MultiThreaderBaseEnums::Threader value)
         return "itk::MultiThreaderBaseEnums::Threader::Pool";
       case MultiThreaderBaseEnums::Threader::TBB:
         return "itk::MultiThreaderBaseEnums::Threader::TBB";
+      case MultiThreaderBaseEnums::Threader::WorkStealing:
+        return "itk::MultiThreaderBaseEnums::Threader::WorkStealing";
         //      TODO    case MultiThreaderBaseEnums::Threader::Last:
         //                    return "itk::MultiThreaderBaseEnums::Threader::Last";
       case MultiThreaderBaseEnums::Threader::Unknown:
@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkNUMAGlobalConfiguration.h"
+#include "itksys/SystemTools.hxx"
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#  include <unistd.h>
+#elif defined(_WIN32)
+#  include "itkWindows.h"
+#else
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+bool
+GetBooleanFromEnvironment(const char * name)
+{
+  std::string value;
+  if (itksys::SystemTools::GetEnv(name, value))
+  {
+    value = itksys::SystemTools::UpperCase(value);
+    return value == "ON" || value == "TRUE" || value == "YES" || value == "1";
+  }
+  return false;
+}
+
+std::atomic<bool> parallelFirstTouch(GetBooleanFromEnvironment("ITK_NUMA_PARALLEL_FIRST_TOUCH"));
+std::atomic<bool> pinWorkerThreads(GetBooleanFromEnvironment("ITK_NUMA_PIN_WORKER_THREADS"));
+
+// Set once by each worker thread of the thread pools.
+thread_local bool isWorkerThread = false;
+
+/** Parse a list in the format of the Linux sysfs, e.g. "0-3,8,10-11". */
+std::vector<unsigned int>
+ParseList(const std::string & list)
+{
+  std::vector<unsigned int> values;
+  std::stringstream         stream(list);
+  std::string               item;
+  while (std::getline(stream, item, ','))
+  {
+    const std::string::size_type dash = item.find('-');
+    try
+    {
+      const unsigned int first = std::stoul(item.substr(0, dash));
+      const unsigned int last = (dash == std::string::npos) ? first : std::stoul(item.substr(dash + 1));
+      for (unsigned int v = first; v <= last; ++v)
+      {
+        values.push_back(v);
+      }
+    }
+    catch (...)
+    {
+      // ignore malformed items, e.g. the trailing newline
+    }
+  }
+  return values;
+}
+
+std::string
+ReadFirstLine(const std::string & fileName)
+{
+  std::ifstream file(fileName);
+  std::string   line;
+  std::getline(file, line);
+  return line;
+}
+
+/** Processors of each memory node, detected once. */
+const std::vector<std::vector<unsigned int>> &
+GetTopology()
+{
+  static const std::vector<std::vector<unsigned int>> topology = [] {
+    std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__)
+    const std::string base = "/sys/devices/system/node/";
+    for (const unsigned int node : ParseList(ReadFirstLine(base + "online")))
+    {
+      std::vector<unsigned int> processors =
+        ParseList(ReadFirstLine(base + "node" + std::to_string(node) + "/cpulist"));
+      if (!processors.empty()) // memory-only nodes have no processors
+      {
+        nodes.push_back(std::move(processors));
+      }
+    }
+#endif
+    if (nodes.empty())
+    {
+      // A single node with all the processors
+      nodes.emplace_back();
+      const unsigned int numberOfProcessors = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned int p = 0; p < numberOfProcessors; ++p)
+      {
+        nodes.back().push_back(p);
+      }
+    }
+    return nodes;
+  }();
+  return topology;
+}
+} // namespace
+
+unsigned int
+NUMAGlobalConfiguration::GetNumberOfNodes()
+{
+  return static_cast<unsigned int>(GetTopology().size());
+}
+
+std::vector<unsigned int>
+NUMAGlobalConfiguration::GetProcessorsOfNode(unsigned int node)
+{
+  const auto & topology = GetTopology();
+  if (node >= topology.size())
+  {
+    return {};
+  }
+  return topology[node];
+}
+
+SizeValueType
+NUMAGlobalConfiguration::GetPageSize()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  const long pageSize = sysconf(_SC_PAGESIZE);
+  return pageSize > 0 ? static_cast<SizeValueType>(pageSize) : 4096;
+#endif
+}
+
+bool
+NUMAGlobalConfiguration::PinThreadToNode(std::thread & thread, unsigned int node)
+{
+#if defined(__linux__)
+  const std::vector<unsigned int> processors = GetProcessorsOfNode(node);
+  if (processors.empty())
+  {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const unsigned int p : processors)
+  {
+    if (p < CPU_SETSIZE)
+    {
+      CPU_SET(p, &set);
+    }
+  }
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+  (void)thread;
+  (void)node;
+  return false;
+#endif
+}
+
+void
+NUMAGlobalConfiguration::PinWorkerThread(std::thread & thread, ThreadIdType workerIndex)
+{
+  if (!pinWorkerThreads)
+  {
+    return;
+  }
+  // Distribute consecutive workers over the nodes, so that a partially
+  // used pool still has access to the bandwidth of all the nodes
+  PinThreadToNode(thread, workerIndex % GetNumberOfNodes());
+}
+
+void
+NUMAGlobalConfiguration::SetParallelFirstTouch(bool value)
+{
+  parallelFirstTouch = value;
+}
+
+bool
+NUMAGlobalConfiguration::GetParallelFirstTouch()
+{
+  return parallelFirstTouch;
+}
+
+void
+NUMAGlobalConfiguration::SetPinWorkerThreads(bool value)
+{
+  pinWorkerThreads = value;
+}
+
+bool
+NUMAGlobalConfiguration::GetPinWorkerThreads()
+{
+  return pinWorkerThreads;
+}
+
+void
+NUMAGlobalConfiguration::RegisterWorkerThread()
+{
+  isWorkerThread = true;
+}
+
+bool
+NUMAGlobalConfiguration::IsWorkerThread()
+{
+  return isWorkerThread;
+}
+
+MultiThreaderBase *
+NUMAGlobalConfiguration::GetFirstTouchMultiThreader()
+{
+  // One multi-threader per calling thread, as a multi-threader is not meant
+  // to run several parallel regions at the same time
+  thread_local const MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  return threader.GetPointer();
+}
+
+bool
+NUMAGlobalConfiguration::UseParallelFirstTouch(SizeValueType bufferSizeInBytes)
+{
+  if (!parallelFirstTouch)
+  {
+    return false;
+  }
+  constexpr SizeValueType pagesPerThread = 4;
+  return bufferSizeInBytes >= pagesPerThread * GetPageSize() * MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+}
+
+} // end namespace itk
@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkRecyclingImageBufferAllocator.h"
+
+namespace itk
+{
+
+RecyclingImageBufferAllocator::RecyclingImageBufferAllocator()
+  : m_Allocator(AlignedImageBufferAllocator::New())
+{}
+
+RecyclingImageBufferAllocator::~RecyclingImageBufferAllocator()
+{
+  this->Purge();
+}
+
+void *
+RecyclingImageBufferAllocator::Allocate(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const auto                  it = m_Buffers.find(KeyType(numberOfBytes, alignment));
+    if (it != m_Buffers.end())
+    {
+      void * buffer = it->second;
+      m_Buffers.erase(it);
+      m_CachedBytes -= numberOfBytes;
+      return buffer;
+    }
+  }
+  return m_Allocator->Allocate(numberOfBytes, alignment);
+}
+
+void
+RecyclingImageBufferAllocator::Deallocate(void * buffer, SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  if (buffer == nullptr)
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_CachedBytes + numberOfBytes <= m_MaximumCachedBytes)
+    {
+      m_Buffers.emplace(KeyType(numberOfBytes, alignment), buffer);
+      m_CachedBytes += numberOfBytes;
+      return;
+    }
+  }
+  m_Allocator->Deallocate(buffer, numberOfBytes, alignment);
+}
+
+void
+RecyclingImageBufferAllocator::SetMaximumCachedBytes(SizeValueType maximumCachedBytes)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MaximumCachedBytes == maximumCachedBytes)
+    {
+      return;
+    }
+    m_MaximumCachedBytes = maximumCachedBytes;
+  }
+  if (this->GetCachedBytes() > maximumCachedBytes)
+  {
+    this->Purge();
+  }
+  this->Modified();
+}
+
+SizeValueType
+RecyclingImageBufferAllocator::GetMaximumCachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumCachedBytes;
+}
+
+SizeValueType
+RecyclingImageBufferAllocator::GetCachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_CachedBytes;
+}
+
+void
+RecyclingImageBufferAllocator::Purge()
+{
+  std::multimap<KeyType, void *> buffers;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::swap(buffers, m_Buffers);
+    m_CachedBytes = 0;
+  }
+  for (const auto & entry : buffers)
+  {
+    m_Allocator->Deallocate(entry.second, entry.first.first, entry.first.second);
+  }
+}
+
+void
+RecyclingImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumCachedBytes: " << this->GetMaximumCachedBytes() << std::endl;
+  os << indent << "CachedBytes: " << this->GetCachedBytes() << std::endl;
+  os << indent << "Allocator: " << m_Allocator.GetPointer() << std::endl;
+}
+
+} // end namespace itk
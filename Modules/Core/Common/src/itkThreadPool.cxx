@@ -22,6 +22,7 @@
 #include "itkThreadSupport.h"
 #include "itkNumericTraits.h"
 #include "itkMultiThreaderBase.h"
+#include "itkNUMAGlobalConfiguration.h"
 #include "itkSingleton.h"
 
 #include <algorithm>
@@ -105,6 +106,7 @@ ThreadPool::ThreadPool()
   for (unsigned int i = 0; i < threadCount; ++i)
   {
     m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    NUMAGlobalConfiguration::PinWorkerThread(m_Threads.back(), static_cast<ThreadIdType>(m_Threads.size() - 1));
   }
 }
 
@@ -116,6 +118,7 @@ ThreadPool::AddThreads(ThreadIdType count)
   for (unsigned int i = 0; i < count; ++i)
   {
     m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    NUMAGlobalConfiguration::PinWorkerThread(m_Threads.back(), static_cast<ThreadIdType>(m_Threads.size() - 1));
   }
 }
 
@@ -160,6 +163,7 @@ ThreadPool::ThreadExecute()
 {
   // plain pointer does not increase reference count
   ThreadPool * threadPool = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  NUMAGlobalConfiguration::RegisterWorkerThread();
 
   while (true)
   {
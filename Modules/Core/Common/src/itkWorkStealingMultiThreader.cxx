@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingMultiThreader.h"
+#include "itkNumericTraits.h"
+#include "itkProcessObject.h"
+#include "itkImageSourceCommon.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+
+WorkStealingMultiThreader::WorkStealingMultiThreader()
+  : m_ThreadPool(WorkStealingThreadPool::GetInstance())
+{
+  ThreadIdType defaultThreads = std::max(1u, GetGlobalDefaultNumberOfThreads());
+#if !defined(ITKV4_COMPATIBILITY)
+  if (defaultThreads > 1) // one work unit for only one thread
+  {
+    defaultThreads *= 4;
+  }
+#endif
+  m_NumberOfWorkUnits = std::min<ThreadIdType>(ITK_MAX_THREADS, defaultThreads);
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+WorkStealingMultiThreader::~WorkStealingMultiThreader() = default;
+
+void
+WorkStealingMultiThreader::SetSingleMethod(ThreadFunctionType f, void * data)
+{
+  m_SingleMethod = f;
+  m_SingleData = data;
+}
+
+void
+WorkStealingMultiThreader::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  Superclass::SetMaximumNumberOfThreads(numberOfThreads);
+  ThreadIdType threadCount = m_ThreadPool->GetMaximumNumberOfThreads();
+  if (threadCount < m_MaximumNumberOfThreads)
+  {
+    m_ThreadPool->AddThreads(m_MaximumNumberOfThreads - threadCount);
+  }
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+void
+WorkStealingMultiThreader::SingleMethodExecute()
+{
+  if (!m_SingleMethod)
+  {
+    itkExceptionMacro(<< "No single method set!");
+  }
+
+  // obey the global maximum number of threads limit
+  m_NumberOfWorkUnits = std::min(this->GetGlobalMaximumNumberOfThreads(), m_NumberOfWorkUnits);
+
+  // Kept local (instead of a member array) so that nested calls are safe
+  std::vector<WorkUnitInfo> workUnitInfo(m_NumberOfWorkUnits);
+
+  WorkStealingThreadPool::TaskGroup group;
+  for (ThreadIdType workUnit = 0; workUnit < m_NumberOfWorkUnits; ++workUnit)
+  {
+    workUnitInfo[workUnit].WorkUnitID = workUnit;
+    workUnitInfo[workUnit].NumberOfWorkUnits = m_NumberOfWorkUnits;
+    workUnitInfo[workUnit].UserData = m_SingleData;
+  }
+  const ThreadFunctionType singleMethod = m_SingleMethod;
+  for (ThreadIdType workUnit = 1; workUnit < m_NumberOfWorkUnits; ++workUnit)
+  {
+    WorkUnitInfo * info = &workUnitInfo[workUnit];
+    m_ThreadPool->AddWork(group, [singleMethod, info] { singleMethod(info); });
+  }
+
+  // Now, the parent thread calls this->SingleMethod() itself
+  std::exception_ptr firstCaughtException;
+  try
+  {
+    singleMethod(&workUnitInfo[0]);
+  }
+  catch (...)
+  {
+    firstCaughtException = std::current_exception();
+  }
+
+  // Help with the other work units, until they are all finished
+  try
+  {
+    m_ThreadPool->Wait(group);
+  }
+  catch (...)
+  {
+    if (firstCaughtException == nullptr)
+    {
+      firstCaughtException = std::current_exception();
+    }
+  }
+
+  if (firstCaughtException != nullptr)
+  {
+    std::rethrow_exception(firstCaughtException);
+  }
+}
+
+void
+WorkStealingMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
+                                            SizeValueType             lastIndexPlus1,
+                                            ArrayThreadingFunctorType aFunc,
+                                            ProcessObject *           filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progressStartEnd(filter, 0, 1);
+
+  if (firstIndex + 1 < lastIndexPlus1)
+  {
+    const SizeValueType count = lastIndexPlus1 - firstIndex;
+    SizeValueType       chunkSize = count / m_NumberOfWorkUnits;
+    if (count % m_NumberOfWorkUnits > 0)
+    {
+      chunkSize++; // we want slightly bigger chunks to be processed first
+    }
+
+    WorkStealingThreadPool::TaskGroup group;
+    for (SizeValueType i = firstIndex; i < lastIndexPlus1; i += chunkSize)
+    {
+      const SizeValueType afterLast = std::min(i + chunkSize, lastIndexPlus1);
+      m_ThreadPool->AddWork(group, [&aFunc, filter, count, i, afterLast] {
+        TotalProgressReporter progress(filter, count, 100);
+        progress.CheckAbortGenerateData();
+        for (SizeValueType ii = i; ii < afterLast; ++ii)
+        {
+          aFunc(ii);
+        }
+        progress.Completed(afterLast - i);
+      });
+    }
+
+    // Execute work units in this thread, until all are finished
+    m_ThreadPool->Wait(group, [filter] {
+      if (filter)
+      {
+        filter->IncrementProgress(0);
+      }
+    });
+  }
+  else if (firstIndex + 1 == lastIndexPlus1)
+  {
+    aFunc(firstIndex);
+  }
+  // else nothing needs to be executed
+}
+
+void
+WorkStealingMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
+                                                  const IndexValueType index[],
+                                                  const SizeValueType  size[],
+                                                  ThreadingFunctorType funcP,
+                                                  ProcessObject *      filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progressStartEnd(filter, 0, 1);
+
+  ImageIORegion region(dimension);
+  for (unsigned d = 0; d < dimension; ++d)
+  {
+    region.SetIndex(d, index[d]);
+    region.SetSize(d, size[d]);
+  }
+
+  if (m_NumberOfWorkUnits == 1 || region.GetNumberOfPixels() <= 1) // no multi-threading wanted or possible
+  {
+    funcP(index, size); // process whole region
+    return;
+  }
+
+  const ImageRegionSplitterBase * splitter = ImageSourceCommon::GetGlobalDefaultSplitter();
+  const ThreadIdType              splitCount = splitter->GetNumberOfSplits(region, m_NumberOfWorkUnits);
+  const SizeValueType             totalCount = region.GetNumberOfPixels();
+
+  WorkStealingThreadPool::TaskGroup group;
+  for (ThreadIdType i = 0; i < splitCount; ++i)
+  {
+    ImageIORegion iRegion = region;
+    if (splitter->GetSplit(i, splitCount, iRegion) <= i)
+    {
+      // Do not leave already queued work units referencing this stack frame
+      m_ThreadPool->Wait(group);
+      itkExceptionMacro("Could not get work unit " << i
+                                                   << " even though we checked possible number of splits beforehand!");
+    }
+    m_ThreadPool->AddWork(group, [&funcP, filter, totalCount, iRegion] {
+      TotalProgressReporter progress(filter, totalCount, 100);
+      progress.CheckAbortGenerateData();
+      funcP(&iRegion.GetIndex()[0], &iRegion.GetSize()[0]);
+      progress.Completed(iRegion.GetNumberOfPixels());
+    });
+  }
+
+  // Execute work units in this thread, until all are finished
+  m_ThreadPool->Wait(group, [filter] {
+    if (filter)
+    {
+      filter->IncrementProgress(0);
+    }
+  });
+}
+
+void
+WorkStealingMultiThreader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ThreadPool: " << m_ThreadPool.GetPointer() << std::endl;
+}
+
+} // namespace itk
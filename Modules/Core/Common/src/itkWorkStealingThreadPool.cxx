@@ -0,0 +1,337 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+#include "itkThreadSupport.h"
+#include "itkMultiThreaderBase.h"
+#include "itkNUMAGlobalConfiguration.h"
+#include "itkSingleton.h"
+
+#include <algorithm>
+#include <deque>
+
+
+namespace itk
+{
+
+namespace
+{
+// Identity of the calling thread, set once by each worker thread.
+thread_local const WorkStealingThreadPool * currentPool = nullptr;
+thread_local ThreadIdType                   currentWorkerIndex = 0;
+} // namespace
+
+struct WorkStealingThreadPoolGlobals
+{
+  WorkStealingThreadPoolGlobals() = default;
+  // To lock on the internal variables.
+  std::mutex                      m_Mutex;
+  WorkStealingThreadPool::Pointer m_ThreadPoolInstance;
+};
+
+itkGetGlobalSimpleMacro(WorkStealingThreadPool, WorkStealingThreadPoolGlobals, PimplGlobals);
+
+struct WorkStealingThreadPool::Task
+{
+  TaskFunctionType Function;
+  TaskGroup *      Group{ nullptr };
+};
+
+class WorkStealingThreadPool::WorkerQueue
+{
+public:
+  void
+  PushBack(Task && task)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Tasks.push_back(std::move(task));
+  }
+
+  /** Used by the owner: most recently added tasks are the hottest in cache. */
+  bool
+  PopBack(Task & task)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Tasks.empty())
+    {
+      return false;
+    }
+    task = std::move(m_Tasks.back());
+    m_Tasks.pop_back();
+    return true;
+  }
+
+  /** Used by thieves: oldest tasks are usually the largest ones. */
+  bool
+  PopFront(Task & task)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Tasks.empty())
+    {
+      return false;
+    }
+    task = std::move(m_Tasks.front());
+    m_Tasks.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex       m_Mutex;
+  std::deque<Task> m_Tasks;
+};
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+  {
+    std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+    // After we have the lock, double check the initialization
+    // flag to ensure it hasn't been changed by another thread.
+    if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+    {
+      m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
+      if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+      {
+        new WorkStealingThreadPool(); // constructor sets m_PimplGlobals->m_ThreadPoolInstance
+      }
+    }
+  }
+  return m_PimplGlobals->m_ThreadPoolInstance;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+{
+  m_PimplGlobals->m_ThreadPoolInstance = this;        // keep the global reference
+  m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
+
+  m_Queues.reserve(ITK_MAX_THREADS);
+  for (ThreadIdType i = 0; i < ITK_MAX_THREADS; ++i)
+  {
+    m_Queues.emplace_back(new WorkerQueue);
+  }
+  // GetInstance() holds the global mutex while constructing the pool
+  this->StartThreads(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  m_Stopping = true;
+  {
+    // Make sure that no worker is between its check of m_Stopping and its wait
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+  }
+  m_SleepCondition.notify_all();
+
+  for (auto & thread : m_Threads)
+  {
+    thread.join();
+  }
+}
+
+void
+WorkStealingThreadPool::AddThreads(ThreadIdType count)
+{
+  std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+  this->StartThreads(count);
+}
+
+void
+WorkStealingThreadPool::StartThreads(ThreadIdType count)
+{
+  count = std::min<ThreadIdType>(count, ITK_MAX_THREADS - m_Threads.size());
+  m_Threads.reserve(m_Threads.size() + count);
+  for (ThreadIdType i = 0; i < count; ++i)
+  {
+    const auto workerIndex = static_cast<ThreadIdType>(m_Threads.size());
+    m_Threads.emplace_back(&WorkStealingThreadPool::ThreadExecute, this, workerIndex);
+    NUMAGlobalConfiguration::PinWorkerThread(m_Threads.back(), workerIndex);
+    m_NumberOfWorkers = workerIndex + 1;
+  }
+}
+
+bool
+WorkStealingThreadPool::IsWorkerThread() const
+{
+  return currentPool == this;
+}
+
+void
+WorkStealingThreadPool::AddWork(TaskGroup & group, TaskFunctionType task)
+{
+  ++group.m_Pending;
+
+  // Count the task before it becomes visible, so that a worker which sees
+  // an empty counter can safely go to sleep.
+  ++m_QueuedTasks;
+  const ThreadIdType queueIndex =
+    this->IsWorkerThread() ? currentWorkerIndex : static_cast<ThreadIdType>(m_NextQueue++ % m_NumberOfWorkers.load());
+  m_Queues[queueIndex]->PushBack(Task{ std::move(task), &group });
+
+  if (m_SleepingWorkers.load() > 0)
+  {
+    {
+      // Serialize with a worker which is about to wait
+      std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_SleepCondition.notify_one();
+  }
+}
+
+bool
+WorkStealingThreadPool::PopOrStealTask(Task & task)
+{
+  const ThreadIdType numberOfWorkers = m_NumberOfWorkers.load();
+  ThreadIdType       first = 0;
+  if (this->IsWorkerThread())
+  {
+    if (m_Queues[currentWorkerIndex]->PopBack(task))
+    {
+      --m_QueuedTasks;
+      return true;
+    }
+    first = currentWorkerIndex + 1;
+  }
+  for (ThreadIdType i = 0; i < numberOfWorkers; ++i)
+  {
+    if (m_Queues[(first + i) % numberOfWorkers]->PopFront(task))
+    {
+      --m_QueuedTasks;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+WorkStealingThreadPool::ExecuteTask(Task & task)
+{
+  std::exception_ptr exception;
+  try
+  {
+    task.Function();
+  }
+  catch (...)
+  {
+    exception = std::current_exception();
+  }
+  task.Function = nullptr; // release captured resources before signaling completion
+
+  TaskGroup &                 group = *task.Group;
+  std::lock_guard<std::mutex> lock(group.m_Mutex);
+  if (exception != nullptr && group.m_FirstCaughtException == nullptr)
+  {
+    group.m_FirstCaughtException = exception;
+  }
+  // The group may be destroyed by its waiter as soon as the lock is released
+  if (--group.m_Pending == 0)
+  {
+    group.m_Condition.notify_all();
+  }
+}
+
+void
+WorkStealingThreadPool::Wait(TaskGroup &                     group,
+                             const std::function<void()> &   pollFunction,
+                             const std::chrono::milliseconds pollingInterval)
+{
+  Task task;
+  while (group.m_Pending.load() > 0)
+  {
+    if (this->PopOrStealTask(task))
+    {
+      ExecuteTask(task);
+      continue;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(group.m_Mutex);
+      group.m_Condition.wait_for(lock, pollingInterval, [&group] { return group.m_Pending.load() == 0; });
+    }
+    if (pollFunction)
+    {
+      try
+      {
+        pollFunction();
+      }
+      catch (...)
+      {
+        // Tasks of the group might still be referencing the caller's
+        // stack, so report the exception only once they are done
+        std::lock_guard<std::mutex> lock(group.m_Mutex);
+        if (group.m_FirstCaughtException == nullptr)
+        {
+          group.m_FirstCaughtException = std::current_exception();
+        }
+      }
+    }
+  }
+
+  // Synchronize with the thread which completed the last task
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> lock(group.m_Mutex);
+    std::swap(exception, group.m_FirstCaughtException);
+  }
+  if (exception != nullptr)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void
+WorkStealingThreadPool::ThreadExecute(ThreadIdType workerIndex)
+{
+  currentPool = this;
+  currentWorkerIndex = workerIndex;
+  NUMAGlobalConfiguration::RegisterWorkerThread();
+
+  Task task;
+  while (true)
+  {
+    if (this->PopOrStealTask(task))
+    {
+      ExecuteTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_SleepMutex);
+    ++m_SleepingWorkers;
+    m_SleepCondition.wait(lock, [this] { return m_Stopping.load() || m_QueuedTasks.load() > 0; });
+    --m_SleepingWorkers;
+    if (m_Stopping.load() && m_QueuedTasks.load() == 0)
+    {
+      return;
+    }
+  }
+}
+
+WorkStealingThreadPoolGlobals * WorkStealingThreadPool::m_PimplGlobals;
+
+} // namespace itk
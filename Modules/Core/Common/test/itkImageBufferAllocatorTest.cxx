@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkRecyclingImageBufferAllocator.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkVersion.h"
+#include "itkTestingMacros.h"
+#include <cstdint>
+#include <string>
+
+namespace
+{
+bool
+IsAligned(const void * pointer, itk::SizeValueType alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+class AlignedAllocatorFactory : public itk::ObjectFactoryBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AlignedAllocatorFactory);
+
+  using Self = AlignedAllocatorFactory;
+  using Superclass = itk::ObjectFactoryBase;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  const char *
+  GetITKSourceVersion() const override
+  {
+    return ITK_SOURCE_VERSION;
+  }
+  const char *
+  GetDescription() const override
+  {
+    return "Aligned image buffer allocator factory";
+  }
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(AlignedAllocatorFactory, itk::ObjectFactoryBase);
+
+private:
+  AlignedAllocatorFactory()
+  {
+    this->RegisterOverride(typeid(itk::ImageBufferAllocator).name(),
+                           typeid(itk::AlignedImageBufferAllocator).name(),
+                           "Aligned image buffer allocator",
+                           true,
+                           itk::CreateObjectFunction<itk::AlignedImageBufferAllocator>::New());
+  }
+};
+/** Container which allocates its elements itself, or through the
+ * AllocateElements() of its superclass. */
+class DerivedContainer : public itk::ImportImageContainer<itk::SizeValueType, float>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(DerivedContainer);
+
+  using Self = DerivedContainer;
+  using Superclass = itk::ImportImageContainer<itk::SizeValueType, float>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(DerivedContainer, ImportImageContainer);
+
+  bool m_UseSuperclass{ false };
+
+protected:
+  DerivedContainer() = default;
+  ~DerivedContainer() override = default;
+
+  float *
+  AllocateElements(ElementIdentifier size, bool UseDefaultConstructor) const override
+  {
+    if (m_UseSuperclass)
+    {
+      return Superclass::AllocateElements(size, UseDefaultConstructor);
+    }
+    return new float[size];
+  }
+};
+} // namespace
+
+int
+itkImageBufferAllocatorTest(int, char *[])
+{
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<float, Dimension>;
+  using VectorImageType = itk::VectorImage<short, Dimension>;
+  const ImageType::SizeType size = { { 64, 63, 17 } };
+
+  // Default allocator
+  itk::ImageBufferAllocator::Pointer defaultAllocator = itk::ImageBufferAllocator::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(defaultAllocator, ImageBufferAllocator, Object);
+  ITK_TEST_EXPECT_EQUAL(std::string(itk::ImageBufferAllocator::GetGlobalDefault()->GetNameOfClass()),
+                        std::string("ImageBufferAllocator"));
+
+  // Aligned allocator, set on the pixel containers
+  itk::AlignedImageBufferAllocator::Pointer alignedAllocator = itk::AlignedImageBufferAllocator::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(alignedAllocator, AlignedImageBufferAllocator, ImageBufferAllocator);
+  ITK_TEST_EXPECT_EQUAL(alignedAllocator->GetAlignment(), 64u);
+  ITK_TRY_EXPECT_EXCEPTION(alignedAllocator->SetAlignment(48));
+  ITK_TRY_EXPECT_EXCEPTION(alignedAllocator->SetHugePageSize(0));
+  alignedAllocator->SetAlignment(128);
+  ITK_TEST_SET_GET_BOOLEAN(alignedAllocator, UseHugePages, false);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->GetPixelContainer()->SetAllocator(alignedAllocator);
+  ITK_TEST_SET_GET_VALUE(alignedAllocator.GetPointer(), image->GetPixelContainer()->GetAllocator());
+  image->Allocate(true);
+  ITK_TEST_EXPECT_TRUE(IsAligned(image->GetBufferPointer(), 128));
+  ITK_TEST_EXPECT_EQUAL(image->GetPixel({ { 63, 62, 16 } }), 0.0f);
+
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(size);
+  vectorImage->SetVectorLength(3);
+  vectorImage->GetPixelContainer()->SetAllocator(alignedAllocator);
+  vectorImage->Allocate();
+  ITK_TEST_EXPECT_TRUE(IsAligned(vectorImage->GetBufferPointer(), 128));
+
+  // Huge pages: large buffers are aligned on whole huge pages
+  alignedAllocator->UseHugePagesOn();
+  alignedAllocator->SetHugePageSize(1 << 16);
+  ImageType::Pointer largeImage = ImageType::New();
+  largeImage->SetRegions(size);
+  largeImage->GetPixelContainer()->SetAllocator(alignedAllocator);
+  largeImage->Allocate();
+  ITK_TEST_EXPECT_TRUE(IsAligned(largeImage->GetBufferPointer(), 1 << 16));
+  largeImage->FillBuffer(1.0f);
+
+  // Growing a buffer keeps its content
+  image->GetPixelContainer()->Reserve(2 * size[0] * size[1] * size[2]);
+  ITK_TEST_EXPECT_EQUAL(image->GetPixelContainer()->GetBufferPointer()[0], 0.0f);
+  image->GetPixelContainer()->Squeeze();
+
+  // Elements with a non-trivial constructor and destructor
+  using StringContainerType = itk::ImportImageContainer<itk::SizeValueType, std::string>;
+  StringContainerType::Pointer strings = StringContainerType::New();
+  strings->SetAllocator(alignedAllocator);
+  strings->Reserve(10, true);
+  (*strings)[9] = "a string long enough to be allocated on the heap";
+  strings->Reserve(20);
+  ITK_TEST_EXPECT_EQUAL((*strings)[9], std::string("a string long enough to be allocated on the heap"));
+  ITK_TEST_EXPECT_TRUE((*strings)[19].empty());
+  strings->Initialize();
+
+  // Buffers of elements with a destructor are still allocated by new[], so
+  // that an owner which takes them may release them with delete[]
+  strings->Reserve(10, true);
+  (*strings)[3] = "another string long enough to be allocated on the heap";
+  std::string * takenStrings = strings->GetBufferPointer();
+  strings->ContainerManageMemoryOff();
+  strings->Initialize();
+  ITK_TEST_EXPECT_EQUAL(takenStrings[3], std::string("another string long enough to be allocated on the heap"));
+  delete[] takenStrings;
+
+  // Recycling allocator, as the global default: the buffers released by
+  // one image are reused by the next one of the same size
+  itk::RecyclingImageBufferAllocator::Pointer recyclingAllocator = itk::RecyclingImageBufferAllocator::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(recyclingAllocator, RecyclingImageBufferAllocator, ImageBufferAllocator);
+  ITK_TEST_EXPECT_TRUE(recyclingAllocator->GetAllocator() != nullptr);
+  itk::ImageBufferAllocator::SetGlobalDefault(recyclingAllocator);
+  ITK_TEST_EXPECT_EQUAL(itk::ImageBufferAllocator::GetGlobalDefault(), recyclingAllocator.GetPointer());
+
+  ImageType::Pointer first = ImageType::New();
+  first->SetRegions(size);
+  first->Allocate();
+  const float * firstBuffer = first->GetBufferPointer();
+  ITK_TEST_EXPECT_TRUE(IsAligned(firstBuffer, 64));
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 0u);
+  first->ReleaseData();
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), size[0] * size[1] * size[2] * sizeof(float));
+
+  ImageType::Pointer second = ImageType::New();
+  second->SetRegions(size);
+  second->Allocate();
+  ITK_TEST_EXPECT_EQUAL(second->GetBufferPointer(), firstBuffer);
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 0u);
+
+  // Buffers beyond the cap are freed
+  recyclingAllocator->SetMaximumCachedBytes(1000);
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetMaximumCachedBytes(), 1000u);
+  second = nullptr;
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 0u);
+
+  recyclingAllocator->SetMaximumCachedBytes(1 << 30);
+  first->SetRegions(size);
+  first->Allocate();
+  first = nullptr;
+  ITK_TEST_EXPECT_TRUE(recyclingAllocator->GetCachedBytes() > 0);
+  recyclingAllocator->Purge();
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 0u);
+
+  // The elements of a derived container are released through the allocator
+  // only when they come from the AllocateElements() of its superclass
+  DerivedContainer::Pointer derived = DerivedContainer::New();
+  derived->m_UseSuperclass = true;
+  derived->Reserve(1000);
+  derived->Initialize();
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 1000 * sizeof(float));
+  recyclingAllocator->Purge();
+  derived->m_UseSuperclass = false;
+  derived->Reserve(1000);
+  derived->Reserve(2000);
+  derived->Initialize();
+  ITK_TEST_EXPECT_EQUAL(recyclingAllocator->GetCachedBytes(), 0u);
+
+  // Selection through the object factory
+  itk::ImageBufferAllocator::SetGlobalDefault(nullptr);
+  AlignedAllocatorFactory::Pointer factory = AlignedAllocatorFactory::New();
+  itk::ObjectFactoryBase::RegisterFactory(factory);
+  ITK_TEST_EXPECT_EQUAL(std::string(itk::ImageBufferAllocator::GetGlobalDefault()->GetNameOfClass()),
+                        std::string("AlignedImageBufferAllocator"));
+  itk::ObjectFactoryBase::UnRegisterFactory(factory);
+  itk::ImageBufferAllocator::SetGlobalDefault(nullptr);
+  ITK_TEST_EXPECT_EQUAL(std::string(itk::ImageBufferAllocator::GetGlobalDefault()->GetNameOfClass()),
+                        std::string("ImageBufferAllocator"));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+#include "itkAbsImageFilter.h"
+#include "itkTestingMacros.h"
+
+int
+itkImageBufferPoolTest(int, char *[])
+{
+  constexpr unsigned int Dimension = 2;
+  using ImageType = itk::Image<float, Dimension>;
+  using IntImageType = itk::Image<int, Dimension>;
+  using FilterType = itk::AbsImageFilter<ImageType, ImageType>;
+  const ImageType::SizeType size = { { 128, 96 } };
+  const itk::SizeValueType  bufferBytes = size[0] * size[1] * sizeof(float);
+
+  itk::ImageBufferPool::Pointer pool = itk::ImageBufferPool::GetInstance();
+  ITK_TEST_EXPECT_EQUAL(pool, itk::ImageBufferPool::New());
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(pool, ImageBufferPool, Object);
+  ITK_TEST_EXPECT_TRUE(!pool->GetEnabled());
+
+  // Disabled: nothing is kept
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  image->ReleaseData();
+  ITK_TEST_EXPECT_EQUAL(pool->GetStatistics().CachedBuffers, 0u);
+
+  pool->EnabledOn();
+  ITK_TEST_EXPECT_TRUE(pool->GetEnabled());
+  pool->ResetStatistics();
+
+  // A released buffer is reused for the next image of the same size and
+  // pixel type
+  image->SetRegions(size);
+  image->Allocate();
+  const float * buffer = image->GetBufferPointer();
+  image->ReleaseData();
+  itk::ImageBufferPool::Statistics statistics = pool->GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.Misses, 1u);
+  ITK_TEST_EXPECT_EQUAL(statistics.Returns, 1u);
+  ITK_TEST_EXPECT_EQUAL(statistics.CachedBuffers, 1u);
+  ITK_TEST_EXPECT_EQUAL(statistics.CachedBytes, bufferBytes);
+
+  // Same size, other pixel type: not reused
+  IntImageType::Pointer intImage = IntImageType::New();
+  intImage->SetRegions(size);
+  intImage->Allocate();
+  ITK_TEST_EXPECT_EQUAL(pool->GetStatistics().Hits, 0u);
+
+  image->SetRegions(size);
+  image->Allocate(true);
+  ITK_TEST_EXPECT_EQUAL(static_cast<const float *>(image->GetBufferPointer()), buffer);
+  ITK_TEST_EXPECT_EQUAL(image->GetPixel({ { 5, 7 } }), 0.0f);
+  statistics = pool->GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.Hits, 1u);
+  ITK_TEST_EXPECT_EQUAL(statistics.CachedBuffers, 0u);
+
+  // Steady state of a pipeline whose intermediate output is released
+  image->FillBuffer(-2.0f);
+  FilterType::Pointer first = FilterType::New();
+  first->SetInput(image);
+  first->ReleaseDataFlagOn();
+  FilterType::Pointer second = FilterType::New();
+  second->SetInput(first->GetOutput());
+  second->Update();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    pool->ResetStatistics();
+    image->Modified();
+    second->Update();
+    statistics = pool->GetStatistics();
+    std::cout << "Update " << i << ": " << statistics.Hits << " hits, " << statistics.Misses << " misses" << std::endl;
+    ITK_TEST_EXPECT_EQUAL(statistics.Misses, 0u);
+    ITK_TEST_EXPECT_EQUAL(statistics.Hits, 1u);
+  }
+  ITK_TEST_EXPECT_EQUAL(second->GetOutput()->GetPixel({ { 3, 3 } }), 2.0f);
+
+  // Limits: the least recently released buffers are evicted
+  pool->Purge();
+  pool->SetMaximumNumberOfBuffers(2);
+  ITK_TEST_EXPECT_EQUAL(pool->GetMaximumNumberOfBuffers(), 2u);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ImageType::Pointer temporary = ImageType::New();
+    temporary->SetRegions(size);
+    temporary->Allocate();
+    ImageType::Pointer other = ImageType::New();
+    other->SetRegions(size);
+    other->Allocate();
+    // both buffers are released here
+  }
+  statistics = pool->GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.CachedBuffers, 2u);
+  ITK_TEST_EXPECT_TRUE(statistics.PeakCachedBytes >= 2 * bufferBytes);
+
+  pool->SetMaximumCachedBytes(bufferBytes);
+  ITK_TEST_EXPECT_EQUAL(pool->GetMaximumCachedBytes(), bufferBytes);
+  statistics = pool->GetStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.CachedBuffers, 1u);
+  ITK_TEST_EXPECT_TRUE(statistics.Evictions > 0);
+
+  // Too large buffers are not kept
+  ImageType::Pointer large = ImageType::New();
+  const ImageType::SizeType largeSize = { { 2 * size[0], size[1] } };
+  large->SetRegions(largeSize);
+  large->Allocate();
+  large = nullptr;
+  ITK_TEST_EXPECT_EQUAL(pool->GetStatistics().CachedBytes, bufferBytes);
+
+  pool->Purge();
+  ITK_TEST_EXPECT_EQUAL(pool->GetStatistics().CachedBuffers, 0u);
+  ITK_TEST_EXPECT_EQUAL(pool->GetStatistics().CachedBytes, 0u);
+
+  pool->SetMaximumNumberOfBuffers(64);
+  pool->SetMaximumCachedBytes(itk::SizeValueType{ 1 } << 30);
+  pool->EnabledOff();
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
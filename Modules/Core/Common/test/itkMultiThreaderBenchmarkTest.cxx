@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compare the throughput of the available multi-threaders, both on many
+// small ParallelizeImageRegion chunks (scheduling overhead dominated) and
+// on a typical pixel-wise filter (memory bandwidth dominated).
+
+#include "itkMultiThreaderBase.h"
+#include "itkAbsImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkTimeProbe.h"
+#include <atomic>
+#include <iomanip>
+#include <vector>
+
+int
+itkMultiThreaderBenchmarkTest(int argc, char * argv[])
+{
+  // Image size along each dimension, and number of repetitions
+  unsigned int imageSize = 128;
+  unsigned int iterations = 10;
+  if (argc > 1)
+  {
+    imageSize = std::stoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    iterations = std::stoi(argv[2]);
+  }
+
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<float, Dimension>;
+  using FilterType = itk::AbsImageFilter<ImageType, ImageType>;
+  using ThreaderEnum = itk::MultiThreaderBase::ThreaderEnum;
+
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size;
+  size.Fill(imageSize);
+  image->SetRegions(size);
+  image->Allocate();
+  float value = -1.0f;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = -value * 1.0001f;
+  }
+
+  std::vector<ThreaderEnum> threaders = { ThreaderEnum::Platform, ThreaderEnum::Pool, ThreaderEnum::WorkStealing };
+#ifdef ITK_USE_TBB
+  threaders.push_back(ThreaderEnum::TBB);
+#endif
+
+  std::cout << "Image size: " << size << ", iterations: " << iterations
+            << ", threads: " << itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() << std::endl;
+  std::cout << std::setw(14) << "Threader" << std::setw(20) << "Chunks (Mpixel/s)" << std::setw(20)
+            << "Filter (Mpixel/s)" << std::endl;
+
+  const double megaPixels = image->GetBufferedRegion().GetNumberOfPixels() * 1e-6;
+  for (const auto threaderType : threaders)
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultThreader(threaderType);
+
+    // Many small chunks, to expose the scheduling overhead
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    threader->SetNumberOfWorkUnits(itk::ITK_MAX_THREADS);
+    std::atomic<itk::SizeValueType> visited(0);
+    itk::TimeProbe                  chunkProbe;
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+      chunkProbe.Start();
+      threader->ParallelizeImageRegion<Dimension>(
+        image->GetBufferedRegion(),
+        [&image, &visited](const ImageType::RegionType & region) {
+          float sum = 0.0f;
+          for (itk::ImageRegionConstIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+          {
+            sum += it.Get();
+          }
+          // use the sum, so that the loop is not optimized away
+          visited += region.GetNumberOfPixels() + (sum == 0.0f ? 1 : 0);
+        },
+        nullptr);
+      chunkProbe.Stop();
+    }
+
+    // A typical filter, recreated for each run as in a pipeline update
+    itk::TimeProbe filterProbe;
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput(image);
+      filterProbe.Start();
+      filter->Update();
+      filterProbe.Stop();
+    }
+
+    std::cout << std::setw(14) << itk::MultiThreaderBase::ThreaderTypeToString(threaderType) << std::setw(20)
+              << megaPixels / chunkProbe.GetMean() << std::setw(20) << megaPixels / filterProbe.GetMean()
+              << std::endl;
+
+    if (visited < iterations * image->GetBufferedRegion().GetNumberOfPixels())
+    {
+      std::cerr << "Threader " << threaderType << " did not visit all pixels!" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMultiThreaderBase.h"
+#include "itkAbsImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+#include <atomic>
+#include <vector>
+
+int
+itkMultiThreaderParallelizeImageRegionInChunksTest(int, char *[])
+{
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  threader->SetMaximumNumberOfThreads(4);
+  threader->SetNumberOfWorkUnits(4);
+  std::cout << "Threader: " << threader->GetNameOfClass() << std::endl;
+
+  int result = EXIT_SUCCESS;
+
+  // Every pixel must be visited exactly once, whether a chunk is a part
+  // of a line, several lines, or several slices
+  constexpr unsigned int Dimension = 3;
+  using RegionType = itk::ImageRegion<Dimension>;
+  RegionType::SizeType  size = { { 31, 17, 13 } };
+  RegionType::IndexType index = { { -5, 2, 7 } };
+  const RegionType      region(index, size);
+
+  const std::vector<itk::SizeValueType> chunkSizes = { 0, 1, 7, 31, 40, 31 * 17, 31 * 17 * 2 + 1, 1000000 };
+  for (const auto pixelsPerChunk : chunkSizes)
+  {
+    std::vector<std::atomic<unsigned int>> visits(region.GetNumberOfPixels());
+    for (auto & v : visits)
+    {
+      v = 0;
+    }
+    std::atomic<itk::SizeValueType> numberOfChunks(0);
+    std::atomic<bool>               chunkTooLarge(false);
+
+    threader->ParallelizeImageRegionInChunks<Dimension>(
+      region,
+      pixelsPerChunk,
+      [&](const RegionType & chunk) {
+        ++numberOfChunks;
+        if (chunk.GetNumberOfPixels() > std::max<itk::SizeValueType>(pixelsPerChunk, 1) &&
+            chunk.GetNumberOfPixels() < region.GetNumberOfPixels())
+        {
+          chunkTooLarge = true;
+        }
+        if (!region.IsInside(chunk))
+        {
+          chunkTooLarge = true;
+        }
+        for (itk::IndexValueType z = chunk.GetIndex(2); z < chunk.GetUpperIndex()[2] + 1; ++z)
+        {
+          for (itk::IndexValueType y = chunk.GetIndex(1); y < chunk.GetUpperIndex()[1] + 1; ++y)
+          {
+            for (itk::IndexValueType x = chunk.GetIndex(0); x < chunk.GetUpperIndex()[0] + 1; ++x)
+            {
+              const itk::SizeValueType offset =
+                (x - index[0]) + size[0] * ((y - index[1]) + size[1] * static_cast<itk::SizeValueType>(z - index[2]));
+              ++visits[offset];
+            }
+          }
+        }
+      },
+      nullptr);
+
+    std::cout << "Pixels per chunk: " << pixelsPerChunk << ", number of chunks: " << numberOfChunks << std::endl;
+    if (chunkTooLarge)
+    {
+      std::cerr << "A chunk is larger than requested, or outside of the region!" << std::endl;
+      result = EXIT_FAILURE;
+    }
+    for (itk::SizeValueType i = 0; i < visits.size(); ++i)
+    {
+      if (visits[i] != 1)
+      {
+        std::cerr << "Pixel at offset " << i << " was visited " << visits[i] << " times!" << std::endl;
+        result = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+
+  // An empty region is not processed
+  RegionType emptyRegion = region;
+  emptyRegion.SetSize(1, 0);
+  bool called = false;
+  threader->ParallelizeImageRegionInChunks<Dimension>(
+    emptyRegion, 10, [&called](const RegionType &) { called = true; }, nullptr);
+  ITK_TEST_EXPECT_TRUE(!called);
+
+  // A filter with a TargetBytesPerChunk gives the same output
+  using ImageType = itk::Image<float, Dimension>;
+  using FilterType = itk::AbsImageFilter<ImageType, ImageType>;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  float value = -1.0f;
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = -value - 1.0f;
+  }
+
+  FilterType::Pointer filter = FilterType::New();
+  ITK_TEST_SET_GET_VALUE(itk::ImageSourceCommon::GetGlobalDefaultTargetBytesPerChunk(),
+                         filter->GetTargetBytesPerChunk());
+  filter->SetInput(image);
+  filter->SetTargetBytesPerChunk(100 * sizeof(float));
+  ITK_TEST_SET_GET_VALUE(100 * sizeof(float), filter->GetTargetBytesPerChunk());
+  ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+  itk::ImageRegionConstIterator<ImageType> inIt(image, region);
+  itk::ImageRegionConstIterator<ImageType> outIt(filter->GetOutput(), region);
+  for (; !inIt.IsAtEnd(); ++inIt, ++outIt)
+  {
+    if (outIt.Get() != std::abs(inIt.Get()))
+    {
+      std::cerr << "Wrong output " << outIt.Get() << " for input " << inIt.Get() << std::endl;
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  if (result == EXIT_SUCCESS)
+  {
+    std::cout << "Test PASSED!" << std::endl;
+  }
+  return result;
+}
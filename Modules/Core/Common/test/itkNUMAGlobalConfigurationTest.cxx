@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkNUMAGlobalConfiguration.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+template <typename TImage>
+bool
+IsZero(const TImage * image)
+{
+  const auto * buffer = image->GetBufferPointer();
+  const auto   count = image->GetPixelContainer()->Size();
+  for (itk::SizeValueType i = 0; i < count; ++i)
+  {
+    if (buffer[i] != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNUMAGlobalConfigurationTest(int, char *[])
+{
+  using NUMA = itk::NUMAGlobalConfiguration;
+
+  // Topology
+  const unsigned int numberOfNodes = NUMA::GetNumberOfNodes();
+  std::cout << "Number of nodes: " << numberOfNodes << std::endl;
+  ITK_TEST_EXPECT_TRUE(numberOfNodes >= 1);
+  for (unsigned int node = 0; node < numberOfNodes; ++node)
+  {
+    const std::vector<unsigned int> processors = NUMA::GetProcessorsOfNode(node);
+    std::cout << "Node " << node << ": " << processors.size() << " processors" << std::endl;
+    ITK_TEST_EXPECT_TRUE(!processors.empty());
+  }
+  ITK_TEST_EXPECT_TRUE(NUMA::GetProcessorsOfNode(numberOfNodes).empty());
+  ITK_TEST_EXPECT_TRUE(NUMA::GetPageSize() > 0);
+
+  // Pinning may be refused (e.g. restricted processor sets), so only its
+  // robustness is checked
+  std::thread thread([] {});
+  std::cout << "Pinned to node 0: " << NUMA::PinThreadToNode(thread, 0) << std::endl;
+  ITK_TEST_EXPECT_TRUE(!NUMA::PinThreadToNode(thread, numberOfNodes));
+  thread.join();
+
+  // Settings
+  NUMA::SetPinWorkerThreads(true);
+  ITK_TEST_EXPECT_TRUE(NUMA::GetPinWorkerThreads());
+  NUMA::SetPinWorkerThreads(false);
+  ITK_TEST_EXPECT_TRUE(!NUMA::GetPinWorkerThreads());
+  NUMA::SetParallelFirstTouch(false);
+  ITK_TEST_EXPECT_TRUE(!NUMA::GetParallelFirstTouch());
+  ITK_TEST_EXPECT_TRUE(!NUMA::UseParallelFirstTouch(1u << 30));
+
+  // Images allocated with parallel first touch are initialized as requested
+  NUMA::SetParallelFirstTouch(true);
+  ITK_TEST_EXPECT_TRUE(NUMA::GetParallelFirstTouch());
+  ITK_TEST_EXPECT_TRUE(!NUMA::UseParallelFirstTouch(1));
+
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<float, Dimension>;
+  ImageType::RegionType region({ { 3, -2, 1 } }, { { 203, 101, 49 } });
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  ITK_TEST_EXPECT_TRUE(NUMA::UseParallelFirstTouch(region.GetNumberOfPixels() * sizeof(float)));
+  image->Allocate(true);
+  ITK_TEST_EXPECT_TRUE(IsZero(image.GetPointer()));
+
+  image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate(false);
+  image->FillBuffer(1.0f);
+  ITK_TEST_EXPECT_EQUAL(image->GetPixel(region.GetUpperIndex()), 1.0f);
+
+  using VectorImageType = itk::VectorImage<short, Dimension>;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate(true);
+  ITK_TEST_EXPECT_TRUE(IsZero(vectorImage.GetPointer()));
+
+  // Small buffers are allocated as usual
+  ImageType::Pointer smallImage = ImageType::New();
+  smallImage->SetRegions(ImageType::SizeType{ { 2, 2, 2 } });
+  smallImage->Allocate(true);
+  ITK_TEST_EXPECT_TRUE(IsZero(smallImage.GetPointer()));
+
+  // Images allocated by the workers of a parallel region are touched
+  // serially, instead of waiting for the other, busy, workers of the pool
+  const itk::ThreadIdType defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(std::max<itk::ThreadIdType>(defaultNumberOfThreads, 4));
+  const itk::ThreadIdType numberOfWorkUnits = 2 * itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  for (const auto threaderType : { itk::MultiThreaderBase::ThreaderEnum::Pool,
+                                   itk::MultiThreaderBase::ThreaderEnum::WorkStealing,
+                                   itk::MultiThreaderBase::ThreaderEnum::Platform })
+  {
+    std::cout << "Allocation within a parallel region of " << threaderType << std::endl;
+    const itk::MultiThreaderBase::ThreaderEnum defaultThreader = itk::MultiThreaderBase::GetGlobalDefaultThreader();
+    itk::MultiThreaderBase::SetGlobalDefaultThreader(threaderType);
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    itk::MultiThreaderBase::SetGlobalDefaultThreader(defaultThreader);
+    threader->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    std::atomic<unsigned int> numberOfZeroImages(0);
+    threader->ParallelizeArray(
+      0,
+      numberOfWorkUnits,
+      [&](itk::SizeValueType) {
+        ImageType::Pointer innerImage = ImageType::New();
+        innerImage->SetRegions(region);
+        innerImage->Allocate(true);
+        if (IsZero(innerImage.GetPointer()))
+        {
+          ++numberOfZeroImages;
+        }
+      },
+      nullptr);
+    ITK_TEST_EXPECT_EQUAL(numberOfZeroImages.load(), numberOfWorkUnits);
+  }
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(defaultNumberOfThreads);
+
+  NUMA::SetParallelFirstTouch(false);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingMultiThreader.h"
+#include "itkTestingMacros.h"
+#include <atomic>
+#include <vector>
+
+namespace
+{
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+CountWorkUnit(void * arg)
+{
+  auto * info = static_cast<itk::MultiThreaderBase::WorkUnitInfo *>(arg);
+  auto * units = static_cast<std::vector<std::atomic<unsigned int>> *>(info->UserData);
+  ++(*units)[info->WorkUnitID];
+  return ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+} // namespace
+
+int
+itkWorkStealingMultiThreaderTest(int, char *[])
+{
+  using ThreaderType = itk::WorkStealingMultiThreader;
+  ThreaderType::Pointer threader = ThreaderType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(threader, WorkStealingMultiThreader, MultiThreaderBase);
+
+  threader->SetMaximumNumberOfThreads(4);
+  threader->SetNumberOfWorkUnits(16);
+
+  int result = EXIT_SUCCESS;
+
+  // Every pixel must be visited exactly once, including when each region
+  // chunk is further parallelized from inside a work unit.
+  constexpr unsigned int Dimension = 3;
+  using RegionType = itk::ImageRegion<Dimension>;
+  RegionType::SizeType size = { { 31, 17, 13 } };
+  RegionType::IndexType index = { { -5, 2, 7 } };
+  const RegionType      region(index, size);
+
+  std::vector<std::atomic<unsigned int>> visits(region.GetNumberOfPixels());
+  for (auto & v : visits)
+  {
+    v = 0;
+  }
+  itk::MultiThreaderBase * base = threader;
+  base->ParallelizeImageRegion<Dimension>(
+    region,
+    [&](const RegionType & chunk) {
+      const itk::SizeValueType firstSlice = chunk.GetIndex(2);
+      threader->ParallelizeArray(
+        firstSlice,
+        firstSlice + chunk.GetSize(2),
+        [&](itk::SizeValueType z) {
+          for (itk::SizeValueType y = chunk.GetIndex(1); y < chunk.GetIndex(1) + chunk.GetSize(1); ++y)
+          {
+            for (itk::IndexValueType x = chunk.GetIndex(0);
+                 x < chunk.GetIndex(0) + static_cast<itk::IndexValueType>(chunk.GetSize(0));
+                 ++x)
+            {
+              const RegionType::IndexType pixel = { { x,
+                                                      static_cast<itk::IndexValueType>(y),
+                                                      static_cast<itk::IndexValueType>(z) } };
+              itk::SizeValueType          offset = 0;
+              itk::SizeValueType          stride = 1;
+              for (unsigned int d = 0; d < Dimension; ++d)
+              {
+                offset += (pixel[d] - index[d]) * stride;
+                stride *= size[d];
+              }
+              ++visits[offset];
+            }
+          }
+        },
+        nullptr);
+    },
+    nullptr);
+
+  for (itk::SizeValueType i = 0; i < visits.size(); ++i)
+  {
+    if (visits[i] != 1)
+    {
+      std::cerr << "Pixel at offset " << i << " was visited " << visits[i] << " times!" << std::endl;
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  // Exceptions thrown by any work unit are propagated to the caller,
+  // after all the other work units have completed.
+  ITK_TRY_EXPECT_EXCEPTION(threader->ParallelizeArray(
+    0,
+    100,
+    [](itk::SizeValueType i) {
+      if (i == 57)
+      {
+        itkGenericExceptionMacro("Expected exception in work unit");
+      }
+    },
+    nullptr));
+
+  // The threader remains usable after an exception
+  std::atomic<unsigned int> count(0);
+  threader->ParallelizeArray(
+    0, 1000, [&count](itk::SizeValueType) { ++count; }, nullptr);
+  ITK_TEST_EXPECT_EQUAL(count.load(), 1000u);
+
+  // SingleMethodExecute runs each work unit exactly once
+  std::vector<std::atomic<unsigned int>> workUnits(threader->GetNumberOfWorkUnits());
+  for (auto & w : workUnits)
+  {
+    w = 0;
+  }
+  threader->SetSingleMethod(&CountWorkUnit, &workUnits);
+  threader->SingleMethodExecute();
+  for (const auto & w : workUnits)
+  {
+    if (w != 1)
+    {
+      std::cerr << "A work unit was executed " << w << " times!" << std::endl;
+      result = EXIT_FAILURE;
+    }
+  }
+
+  if (result == EXIT_SUCCESS)
+  {
+    std::cout << "Test PASSED!" << std::endl;
+  }
+  return result;
+}
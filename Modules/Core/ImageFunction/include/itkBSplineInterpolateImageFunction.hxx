@@ -37,6 +37,8 @@
 
 #include "itkMatrix.h"
 
+#include <algorithm>
+
 namespace itk
 {
 /**
@@ -192,6 +194,197 @@ BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::Evalua
 #endif
 }
 
+template <typename TImageType, typename TCoordRep, typename TCoefficientType>
+void
+BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::EvaluateAtContinuousIndices(
+  const ContinuousIndexBatchType & indices,
+  SizeValueType                    numberOfPositions,
+  OutputType *                     output) const
+{
+  constexpr unsigned int splineOrder = 3;
+  if (m_SplineOrder != splineOrder)
+  {
+    Superclass::EvaluateAtContinuousIndices(indices, numberOfPositions, output);
+    return;
+  }
+
+  const CoefficientDataType * const coefficients = m_Coefficients->GetBufferPointer();
+  const OffsetValueType * const     offsetTable = m_Coefficients->GetOffsetTable();
+  const IndexType &                 bufferedIndex = m_Coefficients->GetBufferedRegion().GetIndex();
+  const IndexType                   startIndex = this->GetStartIndex();
+  const IndexType                   endIndex = this->GetEndIndex();
+
+  double          weights[ImageDimension][splineOrder + 1][BatchBlockSize];
+  OffsetValueType offsets[ImageDimension][splineOrder + 1][BatchBlockSize];
+  double          interpolated[BatchBlockSize];
+
+  for (SizeValueType first = 0; first < numberOfPositions; first += BatchBlockSize)
+  {
+    const SizeValueType count = std::min(SizeValueType{ BatchBlockSize }, numberOfPositions - first);
+
+    // Weights and mirrored coefficient offsets of the positions of the
+    // block, one dimension at a time, computed as in
+    // DetermineRegionOfSupport(), SetInterpolationWeights() and
+    // ApplyMirrorBoundaryConditions()
+    for (unsigned int n = 0; n < ImageDimension; ++n)
+    {
+      const TCoordRep * const coordinates = indices[n] + first;
+      const bool              singleSample = m_DataLength[n] == 1;
+      for (SizeValueType i = 0; i < count; ++i)
+      {
+        const long   firstIndex = static_cast<long>(std::floor(static_cast<float>(coordinates[i]))) - 1;
+        const double w = coordinates[i] - static_cast<double>(firstIndex + 1);
+        weights[n][3][i] = (1.0 / 6.0) * w * w * w;
+        weights[n][0][i] = (1.0 / 6.0) + 0.5 * w * (w - 1.0) - weights[n][3][i];
+        weights[n][2][i] = w + weights[n][0][i] - 2.0 * weights[n][3][i];
+        weights[n][1][i] = 1.0 - weights[n][0][i] - weights[n][2][i] - weights[n][3][i];
+
+        for (unsigned int k = 0; k <= splineOrder; ++k)
+        {
+          long index = firstIndex + k;
+          if (singleSample)
+          {
+            index = 0;
+          }
+          else
+          {
+            if (index < startIndex[n])
+            {
+              index = startIndex[n] + (startIndex[n] - index);
+            }
+            if (index >= endIndex[n])
+            {
+              index = endIndex[n] - (index - endIndex[n]);
+            }
+          }
+          offsets[n][k][i] = (index - bufferedIndex[n]) * offsetTable[n];
+        }
+      }
+    }
+
+    if (!this->EvaluateSeparably(indices, first, count, weights, offsets, interpolated))
+    {
+      // Step through each point in the N-dimensional interpolation cube, for
+      // all the positions of the block
+      std::fill_n(interpolated, count, 0.0);
+      for (unsigned int p = 0; p < m_MaxNumberInterpolationPoints; ++p)
+      {
+        const IndexType & pointIndex = m_PointsToIndex[p];
+        for (SizeValueType i = 0; i < count; ++i)
+        {
+          double          w = 1.0;
+          OffsetValueType offset = 0;
+          for (unsigned int n = 0; n < ImageDimension; ++n)
+          {
+            w *= weights[n][pointIndex[n]][i];
+            offset += offsets[n][pointIndex[n]][i];
+          }
+          interpolated[i] += w * coefficients[offset];
+        }
+      }
+    }
+
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      output[first + i] = static_cast<OutputType>(interpolated[i]);
+    }
+  }
+}
+
+template <typename TImageType, typename TCoordRep, typename TCoefficientType>
+bool
+BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::EvaluateSeparably(
+  const ContinuousIndexBatchType & indices,
+  SizeValueType                    first,
+  SizeValueType                    count,
+  const double                     weights[][4][BatchBlockSize],
+  const OffsetValueType            offsets[][4][BatchBlockSize],
+  double *                         interpolated) const
+{
+  constexpr unsigned int splineOrder = 3;
+  if (ImageDimension == 1 || count < 2)
+  {
+    return false;
+  }
+
+  // The single dimension along which the positions vary
+  unsigned int varyingDimension = 0;
+  unsigned int numberOfVaryingDimensions = 0;
+  for (unsigned int n = 0; n < ImageDimension; ++n)
+  {
+    const TCoordRep * const coordinates = indices[n] + first;
+    const auto              differs = [coordinates](TCoordRep x) { return x != coordinates[0]; };
+    if (std::any_of(coordinates + 1, coordinates + count, differs))
+    {
+      varyingDimension = n;
+      ++numberOfVaryingDimensions;
+    }
+  }
+  if (numberOfVaryingDimensions > 1)
+  {
+    return false;
+  }
+
+  // The coefficients along the varying dimension that the positions use.
+  // Summing them over the other dimensions only pays off when there are not
+  // many more of them than positions, as when up- or moderately downsampling:
+  // 4^(N-1) products per coefficient and 4 per position instead of 4^N.
+  const OffsetValueType stride = m_Coefficients->GetOffsetTable()[varyingDimension];
+  OffsetValueType       minimumOffset = NumericTraits<OffsetValueType>::max();
+  OffsetValueType       maximumOffset = NumericTraits<OffsetValueType>::NonpositiveMin();
+  for (unsigned int k = 0; k <= splineOrder; ++k)
+  {
+    const auto kRange = std::minmax_element(offsets[varyingDimension][k], offsets[varyingDimension][k] + count);
+    minimumOffset = std::min(minimumOffset, *kRange.first);
+    maximumOffset = std::max(maximumOffset, *kRange.second);
+  }
+  const SizeValueType numberOfCollapsed = static_cast<SizeValueType>((maximumOffset - minimumOffset) / stride) + 1;
+  if (numberOfCollapsed > 3 * count)
+  {
+    return false;
+  }
+
+  // Sum the coefficients over the other dimensions, whose weights and
+  // offsets are the same for all the positions
+  const CoefficientDataType * const coefficients = m_Coefficients->GetBufferPointer();
+  double                            collapsed[3 * BatchBlockSize];
+  std::fill_n(collapsed, numberOfCollapsed, 0.0);
+  for (unsigned int p = 0; p < m_MaxNumberInterpolationPoints; ++p)
+  {
+    const IndexType & pointIndex = m_PointsToIndex[p];
+    if (pointIndex[varyingDimension] != 0)
+    {
+      continue;
+    }
+    double          w = 1.0;
+    OffsetValueType offset = minimumOffset;
+    for (unsigned int n = 0; n < ImageDimension; ++n)
+    {
+      if (n != varyingDimension)
+      {
+        w *= weights[n][pointIndex[n]][0];
+        offset += offsets[n][pointIndex[n]][0];
+      }
+    }
+    for (SizeValueType j = 0; j < numberOfCollapsed; ++j)
+    {
+      collapsed[j] += w * coefficients[offset + static_cast<OffsetValueType>(j) * stride];
+    }
+  }
+
+  // Then interpolate along the varying dimension
+  std::fill_n(interpolated, count, 0.0);
+  for (unsigned int k = 0; k <= splineOrder; ++k)
+  {
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      interpolated[i] +=
+        weights[varyingDimension][k][i] * collapsed[(offsets[varyingDimension][k][i] - minimumOffset) / stride];
+    }
+  }
+  return true;
+}
+
 template <typename TImageType, typename TCoordRep, typename TCoefficientType>
 typename BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::CovariantVectorType
 BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::EvaluateDerivativeAtContinuousIndex(
@@ -114,6 +114,36 @@ public:
   OutputType
   EvaluateAtContinuousIndex(const ContinuousIndexType & index) const override = 0;
 
+  /** Positions in structure-of-arrays layout: element d points to the
+   * coordinates of all the positions along dimension d. */
+  using ContinuousIndexBatchType = FixedArray<const TCoordRep *, ImageDimension>;
+
+  /** Interpolate the image at a batch of continuous index positions
+   *
+   * Sets output[i] to the interpolated image intensity at the position
+   * whose coordinates are indices[0][i], ..., indices[ImageDimension-1][i],
+   * for i from 0 to numberOfPositions-1. No bounds checking is done.
+   * The positions are assumed to lie within the image buffer.
+   *
+   * The default implementation calls EvaluateAtContinuousIndex() for each
+   * position. Subclasses may override it with kernels which process
+   * several positions at once. */
+  virtual void
+  EvaluateAtContinuousIndices(const ContinuousIndexBatchType & indices,
+                              SizeValueType                    numberOfPositions,
+                              OutputType *                     output) const
+  {
+    ContinuousIndexType index;
+    for (SizeValueType i = 0; i < numberOfPositions; ++i)
+    {
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        index[j] = indices[j][i];
+      }
+      output[i] = this->EvaluateAtContinuousIndex(index);
+    }
+  }
+
   /** Interpolate the image at an index position.
    *
    * Simply returns the image value at the
@@ -19,7 +19,9 @@
 #define itkLinearInterpolateImageFunction_h
 
 #include "itkInterpolateImageFunction.h"
+#include "itkImage.h"
 #include "itkVariableLengthVector.h"
+#include <type_traits>
 
 namespace itk
 {
@@ -37,6 +39,11 @@ namespace itk
  * This function works for images with scalar and vector pixel
  * types, and for images of type VectorImage.
  *
+ * EvaluateAtContinuousIndices() interpolates a batch of positions of an
+ * Image of scalar pixels of up to three dimensions with a kernel whose
+ * loops over the positions are vectorized by the compiler. It gives the
+ * same values as EvaluateAtContinuousIndex().
+ *
  * \sa VectorLinearInterpolateImageFunction
  *
  * \ingroup ImageFunctions ImageInterpolators
@@ -89,6 +96,9 @@ public:
   using ContinuousIndexType = typename Superclass::ContinuousIndexType;
   using InternalComputationType = typename ContinuousIndexType::ValueType;
 
+  /** ContinuousIndexBatchType type alias support */
+  using ContinuousIndexBatchType = typename Superclass::ContinuousIndexBatchType;
+
   /** Evaluate the function at a ContinuousIndex position
    *
    * Returns the linearly interpolated image intensity at a
@@ -103,6 +113,17 @@ public:
     return this->EvaluateOptimized(Dispatch<ImageDimension>(), index);
   }
 
+  /** Evaluate the function at a batch of ContinuousIndex positions
+   *
+   * \sa InterpolateImageFunction::EvaluateAtContinuousIndices */
+  void
+  EvaluateAtContinuousIndices(const ContinuousIndexBatchType & indices,
+                              SizeValueType                    numberOfPositions,
+                              OutputType *                     output) const override
+  {
+    this->EvaluateBatchOptimized(BatchDispatch<HasBatchKernel>(), indices, numberOfPositions, output);
+  }
+
   SizeType
   GetRadius() const override
   {
@@ -501,6 +522,32 @@ private:
     return this->EvaluateUnoptimized(index);
   }
 
+  /** The batch kernel reads scalar pixels directly from the buffer of an
+   * Image, and reproduces the optimized evaluation of up to three
+   * dimensions. */
+  static constexpr bool HasBatchKernel =
+    ImageDimension <= 3 && std::is_arithmetic<InputPixelType>::value &&
+    std::is_same<TInputImage, Image<InputPixelType, ImageDimension>>::value;
+
+  template <bool>
+  struct BatchDispatch
+  {};
+
+  inline void
+  EvaluateBatchOptimized(const BatchDispatch<false> &,
+                         const ContinuousIndexBatchType & indices,
+                         SizeValueType                    numberOfPositions,
+                         OutputType *                     output) const
+  {
+    Superclass::EvaluateAtContinuousIndices(indices, numberOfPositions, output);
+  }
+
+  void
+  EvaluateBatchOptimized(const BatchDispatch<true> &,
+                         const ContinuousIndexBatchType & indices,
+                         SizeValueType                    numberOfPositions,
+                         OutputType *                     output) const;
+
   /** Evaluate interpolator at image index position. */
   virtual inline OutputType
   EvaluateUnoptimized(const ContinuousIndexType & index) const;
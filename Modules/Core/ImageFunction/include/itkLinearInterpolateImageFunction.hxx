@@ -22,6 +22,7 @@
 #include "itkLinearInterpolateImageFunction.h"
 
 #include "itkMath.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -102,6 +103,85 @@ LinearInterpolateImageFunction<TInputImage, TCoordRep>::EvaluateUnoptimized(cons
   return (static_cast<OutputType>(value));
 }
 
+template <typename TInputImage, typename TCoordRep>
+void
+LinearInterpolateImageFunction<TInputImage, TCoordRep>::EvaluateBatchOptimized(const BatchDispatch<true> &,
+                                                                               const ContinuousIndexBatchType & indices,
+                                                                               SizeValueType numberOfPositions,
+                                                                               OutputType *  output) const
+{
+  constexpr SizeValueType blockSize = 64;
+  constexpr unsigned int  numberOfNeighbors = 1 << ImageDimension;
+
+  const TInputImage * const     inputImagePtr = this->GetInputImage();
+  const InputPixelType * const  buffer = inputImagePtr->GetBufferPointer();
+  const OffsetValueType * const offsetTable = inputImagePtr->GetOffsetTable();
+  const IndexType &             bufferedIndex = inputImagePtr->GetBufferedRegion().GetIndex();
+
+  OffsetValueType         baseOffset[blockSize];
+  OffsetValueType         upperStep[ImageDimension][blockSize];
+  InternalComputationType distance[ImageDimension][blockSize];
+
+  for (SizeValueType first = 0; first < numberOfPositions; first += blockSize)
+  {
+    const SizeValueType count = std::min(blockSize, numberOfPositions - first);
+
+    // Base pixel, distance and step to the upper neighbor of the positions
+    // of the block, one dimension at a time. As in EvaluateOptimized(), the
+    // base index is clamped to the start index and a missing upper neighbor
+    // does not contribute: its distance is set to zero.
+    std::fill_n(baseOffset, count, 0);
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      const TCoordRep * const coordinates = indices[dim] + first;
+      const IndexValueType    startIndex = this->m_StartIndex[dim];
+      const IndexValueType    endIndex = this->m_EndIndex[dim];
+      const OffsetValueType   stride = offsetTable[dim];
+      for (SizeValueType i = 0; i < count; ++i)
+      {
+        const IndexValueType base = std::max(Math::Floor<IndexValueType>(coordinates[i]), startIndex);
+        const bool           hasUpper = base < endIndex;
+        distance[dim][i] = hasUpper ? std::max(coordinates[i] - static_cast<InternalComputationType>(base),
+                                               NumericTraits<InternalComputationType>::ZeroValue())
+                                    : NumericTraits<InternalComputationType>::ZeroValue();
+        upperStep[dim][i] = hasUpper ? stride : 0;
+        baseOffset[i] += (base - bufferedIndex[dim]) * stride;
+      }
+    }
+
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      RealType values[numberOfNeighbors];
+      for (unsigned int neighbor = 0; neighbor < numberOfNeighbors; ++neighbor)
+      {
+        OffsetValueType offset = baseOffset[i];
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          if (neighbor & (1u << dim))
+          {
+            offset += upperStep[dim][i];
+          }
+        }
+        values[neighbor] = static_cast<RealType>(buffer[offset]);
+      }
+
+      // Interpolate across "x", then "y", then "z". As in EvaluateOptimized(),
+      // the upper neighbors are ignored at a zero distance, so that a
+      // non-finite value of either neighbor does not turn the other into NaN.
+      for (unsigned int dim = 0, remaining = numberOfNeighbors / 2; dim < ImageDimension; ++dim, remaining /= 2)
+      {
+        const InternalComputationType dimDistance = distance[dim][i];
+        for (unsigned int k = 0; k < remaining; ++k)
+        {
+          values[k] = dimDistance > 0.0 ? values[2 * k] + (values[2 * k + 1] - values[2 * k]) * dimDistance
+                                        : values[2 * k];
+        }
+      }
+      output[first + i] = static_cast<OutputType>(values[0]);
+    }
+  }
+}
+
 template <typename TInputImage, typename TCoordRep>
 void
 LinearInterpolateImageFunction<TInputImage, TCoordRep>::PrintSelf(std::ostream & os, Indent indent) const
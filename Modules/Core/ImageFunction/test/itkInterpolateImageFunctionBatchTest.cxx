@@ -0,0 +1,218 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkWindowedSincInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size, bool shiftStart = true)
+{
+  typename TImage::IndexType start;
+  for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+  {
+    start[d] = shiftStart ? static_cast<typename TImage::IndexValueType>(d) - 2 : 0;
+  }
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::RegionType(start, size));
+  image->Allocate();
+  unsigned int state = 4321;
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    state = state * 1103515245 + 12345;
+    it.Set(static_cast<typename TImage::PixelType>((state >> 16) % 200));
+  }
+  return image;
+}
+
+// Positions inside the buffer, on its borders, and on grid points
+template <typename TImage>
+std::vector<typename TImage::PointType::ValueType>
+MakePositions(const TImage * image, unsigned int numberOfPositions)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+  const auto &           region = image->GetBufferedRegion();
+
+  std::vector<typename TImage::PointType::ValueType> coordinates(Dimension * numberOfPositions);
+  unsigned int                                       state = 98765;
+  for (unsigned int i = 0; i < numberOfPositions; ++i)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      const double low = region.GetIndex(d) - 0.5;
+      // The upper border is outside the buffer
+      const double high = region.GetIndex(d) + region.GetSize(d) - 0.5001;
+      state = state * 1103515245 + 12345;
+      double x = low + (high - low) * ((state >> 16) % 10000) / 9999.0;
+      switch (i % 5)
+      {
+        case 1:
+          x = low;
+          break;
+        case 2:
+          x = high;
+          break;
+        case 3:
+          x = itk::Math::Round<double>(x);
+          break;
+        default:
+          break;
+      }
+      coordinates[d * numberOfPositions + i] = x;
+    }
+  }
+  return coordinates;
+}
+
+template <typename TInterpolator>
+int
+TestBatch(const std::string & name, TInterpolator * interpolator)
+{
+  using ImageType = typename TInterpolator::InputImageType;
+  using OutputType = typename TInterpolator::OutputType;
+  constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+  std::cout << name << std::endl;
+
+  // More positions than one block of the batch kernels, and a partial block
+  constexpr unsigned int numberOfPositions = 150;
+  const auto             coordinates = MakePositions(interpolator->GetInputImage(), numberOfPositions);
+
+  typename TInterpolator::ContinuousIndexBatchType indices;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    indices[d] = coordinates.data() + d * numberOfPositions;
+  }
+  std::vector<OutputType> output(numberOfPositions);
+  interpolator->EvaluateAtContinuousIndices(indices, numberOfPositions, output.data());
+
+  for (unsigned int i = 0; i < numberOfPositions; ++i)
+  {
+    typename TInterpolator::ContinuousIndexType index;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      index[d] = indices[d][i];
+    }
+    ITK_TEST_EXPECT_TRUE(interpolator->IsInsideBuffer(index));
+    const OutputType expected = interpolator->EvaluateAtContinuousIndex(index);
+    if (output[i] != expected && !(std::isnan(output[i]) && std::isnan(expected)))
+    {
+      std::cerr << "Batch value " << output[i] << " at " << index << " differs from " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // An empty batch is allowed
+  interpolator->EvaluateAtContinuousIndices(indices, 0, output.data());
+  return EXIT_SUCCESS;
+}
+
+template <unsigned int VDimension>
+int
+TestDimension(const itk::Size<VDimension> & size, bool shiftStart = true)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  const auto image = MakeImage<ImageType>(size, shiftStart);
+
+  int status = EXIT_SUCCESS;
+
+  auto linear = itk::LinearInterpolateImageFunction<ImageType>::New();
+  linear->SetInputImage(image);
+  status |= TestBatch("Linear " + std::to_string(VDimension) + "D", linear.GetPointer());
+
+  auto bspline = itk::BSplineInterpolateImageFunction<ImageType>::New();
+  bspline->SetInputImage(image);
+  status |= TestBatch("Cubic B-spline " + std::to_string(VDimension) + "D", bspline.GetPointer());
+  bspline->SetSplineOrder(1);
+  status |= TestBatch("Linear B-spline " + std::to_string(VDimension) + "D", bspline.GetPointer());
+
+  // Evaluated through the default batch implementation
+  auto sinc = itk::WindowedSincInterpolateImageFunction<ImageType, 2>::New();
+  sinc->SetInputImage(image);
+  status |= TestBatch("Windowed sinc " + std::to_string(VDimension) + "D", sinc.GetPointer());
+
+  return status;
+}
+
+// Infinite and NaN pixels, which must not contribute to the positions at a
+// zero distance from their lower neighbors
+template <unsigned int VDimension>
+int
+TestNonFinite(const itk::Size<VDimension> & size)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  const auto    image = MakeImage<ImageType>(size);
+  float * const buffer = image->GetBufferPointer();
+  for (itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i)
+  {
+    if (i % 7 == 3)
+    {
+      buffer[i] = std::numeric_limits<float>::infinity();
+    }
+    else if (i % 11 == 5)
+    {
+      buffer[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+  }
+
+  auto linear = itk::LinearInterpolateImageFunction<ImageType>::New();
+  linear->SetInputImage(image);
+  return TestBatch("Linear non-finite " + std::to_string(VDimension) + "D", linear.GetPointer());
+}
+
+} // namespace
+
+int
+itkInterpolateImageFunctionBatchTest(int, char *[])
+{
+  int status = EXIT_SUCCESS;
+
+  status |= TestDimension<1>(itk::Size<1>{ { 37 } });
+  status |= TestDimension<2>(itk::Size<2>{ { 23, 17 } });
+  status |= TestDimension<3>(itk::Size<3>{ { 11, 9, 7 } });
+
+  // A single pixel along one axis, which the B-spline mirrors onto index 0
+  status |= TestDimension<3>(itk::Size<3>{ { 11, 1, 7 } }, false);
+
+  status |= TestNonFinite<1>(itk::Size<1>{ { 37 } });
+  status |= TestNonFinite<2>(itk::Size<2>{ { 23, 17 } });
+  status |= TestNonFinite<3>(itk::Size<3>{ { 11, 9, 7 } });
+
+  // Integer pixels and a dimension without a linear batch kernel
+  using ShortImageType = itk::Image<short, 2>;
+  auto shortLinear = itk::LinearInterpolateImageFunction<ShortImageType>::New();
+  shortLinear->SetInputImage(MakeImage<ShortImageType>(itk::Size<2>{ { 19, 13 } }));
+  status |= TestBatch("Linear short 2D", shortLinear.GetPointer());
+
+  using ImageType4D = itk::Image<float, 4>;
+  auto linear4D = itk::LinearInterpolateImageFunction<ImageType4D>::New();
+  linear4D->SetInputImage(MakeImage<ImageType4D>(itk::Size<4>{ { 5, 4, 3, 3 } }));
+  status |= TestBatch("Linear 4D", linear4D.GetPointer());
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkCachedDisplacementFieldResampleImageFilter_h
+#define itkCachedDisplacementFieldResampleImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include "itkTransformToDisplacementFieldFilter.h"
+#include "itkVector.h"
+
+namespace itk
+{
+/** \class CachedDisplacementFieldResampleImageFilter
+ * \brief Resample an image through a displacement field computed once from
+ * the transform on the output grid.
+ *
+ * Resampling through a deep transform, like a CompositeTransform of an
+ * affine, a BSplineTransform and a DisplacementFieldTransform, is dominated
+ * by the per pixel cost of TransformPoint. This filter collapses a non-linear
+ * transform into a dense displacement field on the output grid, computed in
+ * parallel by a TransformToDisplacementFieldFilter, and resamples the input
+ * by looking up the displacement of each output pixel.
+ *
+ * The field is kept between updates, and is only computed again when the
+ * transform, any of the transforms it is composed of, or the output grid
+ * are modified. Resampling several images, or the channels of an image, on
+ * the same grid through the same transform therefore computes the field
+ * once: set each image as the input of the filter in turn, and update it.
+ *
+ * Linear transforms are resampled as by ResampleImageFilter, without a
+ * field, as are images with special coordinates.
+ *
+ * The field holds a vector of TTransformPrecisionType per output pixel. The
+ * transformed points are computed from the displacements, so that the output
+ * may differ from the one of ResampleImageFilter by rounding.
+ *
+ * \sa ResampleImageFilter
+ * \sa TransformToDisplacementFieldFilter
+ *
+ * \ingroup GeometricTransform
+ * \ingroup ITKDisplacementField
+ */
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType = double,
+          typename TTransformPrecisionType = TInterpolatorPrecisionType>
+class ITK_TEMPLATE_EXPORT CachedDisplacementFieldResampleImageFilter
+  : public ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CachedDisplacementFieldResampleImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = CachedDisplacementFieldResampleImageFilter;
+  using Superclass =
+    ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(CachedDisplacementFieldResampleImageFilter, ResampleImageFilter);
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+  static_assert(TInputImage::ImageDimension == ImageDimension,
+                "The input and output images must have the same dimension.");
+
+  using typename Superclass::InputImageType;
+  using typename Superclass::OutputImageType;
+  using typename Superclass::OutputImageRegionType;
+  using typename Superclass::TransformType;
+  using typename Superclass::InterpolatorType;
+  using typename Superclass::InputPixelType;
+  using typename Superclass::ExtrapolatorType;
+  using typename Superclass::PixelType;
+  using typename Superclass::ContinuousInputIndexType;
+
+  /** Type of the cached displacement field. */
+  using DisplacementFieldType = Image<Vector<TTransformPrecisionType, ImageDimension>, ImageDimension>;
+  using DisplacementFieldFilterType = TransformToDisplacementFieldFilter<DisplacementFieldType, TTransformPrecisionType>;
+
+  /** Get the displacement field of the last update, or nullptr when the last
+   * update did not need one. */
+  const DisplacementFieldType *
+  GetDisplacementField() const;
+
+protected:
+  CachedDisplacementFieldResampleImageFilter();
+  ~CachedDisplacementFieldResampleImageFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Compute the Modified Time, including the one of the transforms the
+   * transform is composed of. */
+  ModifiedTimeType
+  GetMTime() const override;
+
+  /** Compute the displacement field, when the transform is not linear and it
+   * is out of date. */
+  void
+  BeforeThreadedGenerateData() override;
+
+  /** Resample through the displacement field. */
+  void
+  NonlinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** The modification time of a transform and of the transforms it is
+   * composed of. */
+  static ModifiedTimeType
+  GetTransformMTime(const TransformType * transform);
+
+  typename DisplacementFieldFilterType::Pointer m_DisplacementFieldFilter;
+  bool                                          m_UseDisplacementField{ false };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkCachedDisplacementFieldResampleImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkCachedDisplacementFieldResampleImageFilter_hxx
+#define itkCachedDisplacementFieldResampleImageFilter_hxx
+
+#include "itkCachedDisplacementFieldResampleImageFilter.h"
+
+#include "itkMultiTransform.h"
+#include "itkSpecialCoordinatesImage.h"
+#include "itkImageScanlineIterator.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+CachedDisplacementFieldResampleImageFilter<TInputImage,
+                                           TOutputImage,
+                                           TInterpolatorPrecisionType,
+                                           TTransformPrecisionType>::CachedDisplacementFieldResampleImageFilter()
+  : m_DisplacementFieldFilter(DisplacementFieldFilterType::New())
+{}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetDisplacementField() const -> const DisplacementFieldType *
+{
+  if (!m_UseDisplacementField)
+  {
+    return nullptr;
+  }
+  return m_DisplacementFieldFilter->GetOutput();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+ModifiedTimeType
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetTransformMTime(const TransformType * transform)
+{
+  using MultiTransformType = MultiTransform<TTransformPrecisionType, ImageDimension, ImageDimension>;
+
+  ModifiedTimeType mtime = transform->GetMTime();
+  if (const auto * multiTransform = dynamic_cast<const MultiTransformType *>(transform))
+  {
+    for (SizeValueType n = 0; n < multiTransform->GetNumberOfTransforms(); ++n)
+    {
+      mtime = std::max(mtime, Self::GetTransformMTime(multiTransform->GetNthTransformConstPointer(n)));
+    }
+  }
+  return mtime;
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+ModifiedTimeType
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetMTime() const
+{
+  ModifiedTimeType latestTime = Superclass::GetMTime();
+  if (const TransformType * transform = this->GetTransform())
+  {
+    latestTime = std::max(latestTime, Self::GetTransformMTime(transform));
+  }
+  return latestTime;
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  using InputSpecialCoordinatesImageType = SpecialCoordinatesImage<InputPixelType, ImageDimension>;
+  using OutputSpecialCoordinatesImageType = SpecialCoordinatesImage<PixelType, ImageDimension>;
+
+  const OutputImageType * outputPtr = this->GetOutput();
+  const TransformType *   transformPtr = this->GetTransform();
+
+  m_UseDisplacementField =
+    transformPtr->GetTransformCategory() != TransformType::TransformCategoryEnum::Linear &&
+    dynamic_cast<const InputSpecialCoordinatesImageType *>(this->GetInput()) == nullptr &&
+    dynamic_cast<const OutputSpecialCoordinatesImageType *>(outputPtr) == nullptr;
+  if (!m_UseDisplacementField)
+  {
+    return;
+  }
+
+  // The field covers the largest possible region of the output, so that it
+  // is shared by all the requested regions
+  const OutputImageRegionType & largestRegion = outputPtr->GetLargestPossibleRegion();
+  m_DisplacementFieldFilter->SetInput(this->GetTransformInput());
+  m_DisplacementFieldFilter->SetSize(largestRegion.GetSize());
+  m_DisplacementFieldFilter->SetOutputStartIndex(largestRegion.GetIndex());
+  m_DisplacementFieldFilter->SetOutputOrigin(outputPtr->GetOrigin());
+  m_DisplacementFieldFilter->SetOutputSpacing(outputPtr->GetSpacing());
+  m_DisplacementFieldFilter->SetOutputDirection(outputPtr->GetDirection());
+  m_DisplacementFieldFilter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // The modification of the transforms a composite transform is made of does
+  // not modify the composite transform
+  if (Self::GetTransformMTime(transformPtr) > m_DisplacementFieldFilter->GetOutput()->GetUpdateMTime())
+  {
+    m_DisplacementFieldFilter->Modified();
+  }
+
+  m_DisplacementFieldFilter->Update();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  NonlinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  if (!m_UseDisplacementField)
+  {
+    Superclass::NonlinearThreadedGenerateData(outputRegionForThread);
+    return;
+  }
+
+  OutputImageType *             outputPtr = this->GetOutput();
+  const InputImageType *        inputPtr = this->GetInput();
+  const DisplacementFieldType * fieldPtr = m_DisplacementFieldFilter->GetOutput();
+  const InterpolatorType *      interpolator = this->GetInterpolator();
+  const ExtrapolatorType *      extrapolator = this->GetExtrapolator();
+
+  TotalProgressReporter progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
+
+  // Without its displacement, the input continuous index of an output pixel
+  // changes by a constant step along a scan line
+  typename InputImageType::DirectionType physicalPointToIndex = inputPtr->GetInverseDirection();
+  ContinuousInputIndexType               lineStep;
+  for (unsigned int j = 0; j < ImageDimension; ++j)
+  {
+    double step = 0.0;
+    for (unsigned int k = 0; k < ImageDimension; ++k)
+    {
+      physicalPointToIndex(j, k) /= inputPtr->GetSpacing()[j];
+      step += physicalPointToIndex(j, k) * outputPtr->GetDirection()(k, 0) * outputPtr->GetSpacing()[0];
+    }
+    lineStep[j] = step;
+  }
+
+  using OutputType = typename InterpolatorType::OutputType;
+  using DisplacementType = typename DisplacementFieldType::PixelType;
+
+  // The input positions of a scan line which are inside the input buffer
+  // are interpolated as one batch
+  const SizeValueType                                 lineLength = outputRegionForThread.GetSize(0);
+  std::vector<ContinuousInputIndexType>               inputIndices(lineLength);
+  std::vector<bool>                                   isInside(lineLength);
+  std::vector<TInterpolatorPrecisionType>             batchCoordinates(ImageDimension * lineLength);
+  typename InterpolatorType::ContinuousIndexBatchType batchIndices;
+  for (unsigned int j = 0; j < ImageDimension; ++j)
+  {
+    batchIndices[j] = batchCoordinates.data() + j * lineLength;
+  }
+  std::vector<OutputType> batchValues(lineLength);
+
+  ImageScanlineIterator<TOutputImage> outIt(outputPtr, outputRegionForThread);
+  while (!outIt.IsAtEnd())
+  {
+    const typename OutputImageType::IndexType lineIndex = outIt.GetIndex();
+
+    ContinuousInputIndexType lineStart;
+    inputPtr->TransformPhysicalPointToContinuousIndex(outputPtr->template TransformIndexToPhysicalPoint<double>(lineIndex),
+                                                      lineStart);
+    const DisplacementType * displacement = fieldPtr->GetBufferPointer() + fieldPtr->ComputeOffset(lineIndex);
+
+    SizeValueType numberInside = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i)
+    {
+      ContinuousInputIndexType & inputIndex = inputIndices[i];
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        double value = lineStart[j] + static_cast<double>(i) * lineStep[j];
+        for (unsigned int k = 0; k < ImageDimension; ++k)
+        {
+          value += physicalPointToIndex(j, k) * displacement[i][k];
+        }
+        inputIndex[j] = value;
+      }
+
+      isInside[i] = interpolator->IsInsideBuffer(inputIndex);
+      if (isInside[i])
+      {
+        for (unsigned int j = 0; j < ImageDimension; ++j)
+        {
+          batchCoordinates[j * lineLength + numberInside] = inputIndex[j];
+        }
+        ++numberInside;
+      }
+    }
+
+    interpolator->EvaluateAtContinuousIndices(batchIndices, numberInside, batchValues.data());
+    SizeValueType batchIndex = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i, ++outIt)
+    {
+      if (isInside[i])
+      {
+        outIt.Set(Superclass::CastPixelWithBoundsChecking(batchValues[batchIndex++]));
+      }
+      else if (extrapolator == nullptr)
+      {
+        outIt.Set(this->GetDefaultPixelValue());
+      }
+      else
+      {
+        const OutputType value = extrapolator->EvaluateAtContinuousIndex(inputIndices[i]);
+        outIt.Set(Superclass::CastPixelWithBoundsChecking(value));
+      }
+    }
+    outIt.NextLine();
+    progress.Completed(lineLength);
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+CachedDisplacementFieldResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(DisplacementFieldFilter);
+  os << indent << "UseDisplacementField: " << (m_UseDisplacementField ? "On" : "Off") << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,243 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCachedDisplacementFieldResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using CachedResampleFilterType = itk::CachedDisplacementFieldResampleImageFilter<ImageType, ImageType>;
+using ResampleFilterType = itk::ResampleImageFilter<ImageType, ImageType>;
+
+ImageType::Pointer
+MakeImage(double frequency)
+{
+  auto                        image = ImageType::New();
+  const ImageType::IndexType  start = { { -3, 2, 5 } };
+  const ImageType::SizeType   size = { { 31, 27, 19 } };
+  const ImageType::RegionType region(start, size);
+  image->SetRegions(region);
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.1;
+  spacing[1] = 0.9;
+  spacing[2] = 1.6;
+  image->SetSpacing(spacing);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(100.0 * std::sin(frequency * index[0]) * std::cos(0.2 * index[1]) + 3.0 * index[2]));
+  }
+  return image;
+}
+
+// Compare to the output of ResampleImageFilter with the same settings
+int
+CompareToResample(const std::string & name, CachedResampleFilterType * cached, ResampleFilterType * resample)
+{
+  std::cout << name << std::endl;
+  ITK_TRY_EXPECT_NO_EXCEPTION(cached->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(resample->Update());
+
+  const ImageType * expected = resample->GetOutput();
+  unsigned int      numberInside = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(cached->GetOutput(),
+                                                           cached->GetOutput()->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const float expectedValue = expected->GetPixel(it.GetIndex());
+    if (std::abs(it.Get() - expectedValue) > 1e-3)
+    {
+      std::cerr << "Resampled value " << it.Get() << " at " << it.GetIndex() << " differs from " << expectedValue
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (expectedValue != resample->GetDefaultPixelValue())
+    {
+      ++numberInside;
+    }
+  }
+
+  // The output covers both the inside and the outside of the input
+  ITK_TEST_EXPECT_TRUE(numberInside > 0);
+  ITK_TEST_EXPECT_TRUE(numberInside < expected->GetLargestPossibleRegion().GetNumberOfPixels());
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkCachedDisplacementFieldResampleImageFilterTest(int, char *[])
+{
+  auto cached = CachedResampleFilterType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(cached, CachedDisplacementFieldResampleImageFilter, ResampleImageFilter);
+
+  const auto image = MakeImage(0.3);
+
+  // Affine, then B-spline, then dense displacements
+  auto                                       affine = itk::AffineTransform<double, Dimension>::New();
+  itk::AffineTransform<double, Dimension>::OutputVectorType translation;
+  translation[0] = -4.3;
+  translation[1] = 6.1;
+  translation[2] = 3.7;
+  affine->Translate(translation);
+  affine->Rotate(0, 1, 0.21);
+
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto                                      bspline = BSplineTransformType::New();
+  BSplineTransformType::OriginType          domainOrigin;
+  BSplineTransformType::PhysicalDimensionsType domainSize;
+  BSplineTransformType::MeshSizeType        meshSize;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    domainOrigin[d] = -10.0;
+    domainSize[d] = 60.0;
+    meshSize[d] = 4;
+  }
+  bspline->SetTransformDomainOrigin(domainOrigin);
+  bspline->SetTransformDomainPhysicalDimensions(domainSize);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  BSplineTransformType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.size(); ++i)
+  {
+    parameters[i] = 2.0 * std::sin(0.7 * i);
+  }
+  bspline->SetParametersByValue(parameters);
+
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform<double, Dimension>;
+  using FieldType = DisplacementFieldTransformType::DisplacementFieldType;
+  auto field = FieldType::New();
+  field->SetRegions(FieldType::SizeType{ { 20, 20, 20 } });
+  FieldType::SpacingType fieldSpacing;
+  fieldSpacing.Fill(3.0);
+  field->SetSpacing(fieldSpacing);
+  FieldType::PointType fieldOrigin;
+  fieldOrigin.Fill(-15.0);
+  field->SetOrigin(fieldOrigin);
+  field->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<FieldType> it(field, field->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const FieldType::IndexType index = it.GetIndex();
+    FieldType::PixelType       displacement;
+    displacement[0] = 1.5 * std::sin(0.4 * index[1]);
+    displacement[1] = 1.2 * std::cos(0.3 * index[2]);
+    displacement[2] = 0.8 * std::sin(0.5 * index[0]);
+    it.Set(displacement);
+  }
+  auto displacementTransform = DisplacementFieldTransformType::New();
+  displacementTransform->SetDisplacementField(field);
+
+  auto composite = itk::CompositeTransform<double, Dimension>::New();
+  composite->AddTransform(affine);
+  composite->AddTransform(bspline);
+  composite->AddTransform(displacementTransform);
+
+  // An output grid which crosses the borders of the input
+  ImageType::SpacingType outputSpacing;
+  outputSpacing[0] = 0.8;
+  outputSpacing[1] = 1.3;
+  outputSpacing[2] = 1.0;
+  ImageType::PointType outputOrigin;
+  outputOrigin[0] = -9.0;
+  outputOrigin[1] = 1.0;
+  outputOrigin[2] = 4.0;
+  ImageType::DirectionType outputDirection;
+  outputDirection.SetIdentity();
+  outputDirection(0, 0) = outputDirection(1, 1) = std::cos(0.1);
+  outputDirection(0, 1) = -std::sin(0.1);
+  outputDirection(1, 0) = std::sin(0.1);
+  const ImageType::SizeType  outputSize = { { 47, 29, 25 } };
+  const ImageType::IndexType outputStart = { { -4, 1, 2 } };
+
+  auto resample = ResampleFilterType::New();
+  for (ResampleFilterType * filter : { static_cast<ResampleFilterType *>(cached.GetPointer()), resample.GetPointer() })
+  {
+    filter->SetInput(image);
+    filter->SetTransform(composite);
+    filter->SetDefaultPixelValue(-1000.0f);
+    filter->SetOutputSpacing(outputSpacing);
+    filter->SetOutputOrigin(outputOrigin);
+    filter->SetOutputDirection(outputDirection);
+    filter->SetSize(outputSize);
+    filter->SetOutputStartIndex(outputStart);
+  }
+
+  int status = EXIT_SUCCESS;
+  status |= CompareToResample("Composite transform, linear", cached, resample);
+
+  const CachedResampleFilterType::DisplacementFieldType * displacementField = cached->GetDisplacementField();
+  ITK_TEST_EXPECT_TRUE(displacementField != nullptr);
+  ITK_TEST_EXPECT_EQUAL(displacementField->GetLargestPossibleRegion(), cached->GetOutput()->GetLargestPossibleRegion());
+  const itk::ModifiedTimeType fieldTime = displacementField->GetUpdateMTime();
+
+  // Another image through the same transform reuses the field
+  const auto otherImage = MakeImage(0.45);
+  cached->SetInput(otherImage);
+  resample->SetInput(otherImage);
+  status |= CompareToResample("Other image", cached, resample);
+  ITK_TEST_EXPECT_EQUAL(cached->GetDisplacementField()->GetUpdateMTime(), fieldTime);
+
+  // As does another interpolator
+  cached->SetInterpolator(itk::BSplineInterpolateImageFunction<ImageType, double>::New());
+  resample->SetInterpolator(itk::BSplineInterpolateImageFunction<ImageType, double>::New());
+  status |= CompareToResample("Cubic B-spline", cached, resample);
+  ITK_TEST_EXPECT_EQUAL(cached->GetDisplacementField()->GetUpdateMTime(), fieldTime);
+
+  cached->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+  resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+  std::cout << "Extrapolated" << std::endl;
+  ITK_TRY_EXPECT_NO_EXCEPTION(cached->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(resample->Update());
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(cached->GetOutput(),
+                                                           cached->GetOutput()->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    ITK_TEST_EXPECT_TRUE(std::abs(it.Get() - resample->GetOutput()->GetPixel(it.GetIndex())) <= 1e-3);
+  }
+  cached->SetExtrapolator(nullptr);
+  resample->SetExtrapolator(nullptr);
+
+  // Modifying a transform of the composite transform updates the field
+  translation.Fill(1.5);
+  affine->Translate(translation);
+  resample->Modified();
+  status |= CompareToResample("Modified affine transform", cached, resample);
+  ITK_TEST_EXPECT_TRUE(cached->GetDisplacementField()->GetUpdateMTime() > fieldTime);
+
+  // A linear transform is resampled without a field
+  cached->SetTransform(affine);
+  resample->SetTransform(affine);
+  status |= CompareToResample("Affine transform", cached, resample);
+  ITK_TEST_EXPECT_TRUE(cached->GetDisplacementField() == nullptr);
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -22,9 +22,36 @@
 #include "itkFixedArray.h"
 #include "itkNeighborhoodIterator.h"
 #include "itkNeighborhood.h"
+#include "ITKImageFeatureExport.h"
+
+#include <vector>
 
 namespace itk
 {
+/**\class BilateralImageFilterEnums
+ * \brief Contains all enum classes used by BilateralImageFilter class.
+ * \ingroup ITKImageFeature
+ */
+class BilateralImageFilterEnums
+{
+public:
+  /**\class Algorithm
+   * \ingroup ITKImageFeature
+   * How the domain and range Gaussians are applied to the image. */
+  enum class Algorithm : uint8_t
+  {
+    /** The product of the Gaussians is evaluated over the neighborhood of
+     * each pixel. */
+    Exact = 0,
+    /** The pixels are accumulated in a coarse grid of the domain and the
+     * range, which is blurred, then interpolated at each pixel. */
+    BilateralGrid = 1
+  };
+};
+// Define how to print enumeration
+extern ITKImageFeature_EXPORT std::ostream &
+                              operator<<(std::ostream & out, const BilateralImageFilterEnums::Algorithm value);
+
 /**
  * \class BilateralImageFilter
  * \brief Blurs an image while preserving edges
@@ -48,6 +75,25 @@ namespace itk
  * Bilateral filtering is capable of reducing the noise in an image
  * by an order of magnitude while maintaining edges.
  *
+ * The cost of the exact filter grows with the size of the domain kernel.
+ * With the BilateralGrid algorithm, the filter is approximated as
+ * described by Paris and Durand: each pixel is accumulated, with its value
+ * and a weight of one, in a grid whose axes are the image axes and the
+ * intensity, with cells GridSamplingRatio times the domain and range
+ * sigmas. The grid is blurred by a separable Gaussian, and the output is
+ * the ratio of the blurred values and weights, interpolated at the
+ * position and intensity of each pixel. The cost is nearly independent of
+ * the sigmas, but the grid has as many cells along the intensity axis as
+ * the dynamic range of the image divided by the range sigma times
+ * GridSamplingRatio. The Radius, AutomaticKernelSize and
+ * NumberOfRangeGaussianSamples are not used by the BilateralGrid
+ * algorithm, and the pixels near the image boundary are averaged over the
+ * pixels inside the image only.
+ *
+ * See S. Paris and F. Durand, "A Fast Approximation of the Bilateral Filter
+ * using a Signal Processing Approach", International Journal of Computer
+ * Vision, 81(1), pp. 24-52, 2009.
+ *
  * The bilateral operator used here was described by Tomasi and
  * Manduchi (Bilateral Filtering for Gray and ColorImages. IEEE
  * ICCV. 1998.)
@@ -126,6 +172,8 @@ public:
   /** Gaussian image type */
   using GaussianImageType = Image<double, Self::ImageDimension>;
 
+  using AlgorithmEnum = BilateralImageFilterEnums::Algorithm;
+
   /** Standard get/set macros for filter parameters.
    * DomainSigma is specified in the same units as the Image spacing.
    * RangeSigma is specified in the units of intensity. */
@@ -144,6 +192,7 @@ public:
   SetDomainSigma(const double v)
   {
     m_DomainSigma.Fill(v);
+    this->Modified();
   }
 
   /** Control automatic kernel size determination. When
@@ -169,6 +218,18 @@ public:
   itkSetMacro(NumberOfRangeGaussianSamples, unsigned long);
   itkGetConstMacro(NumberOfRangeGaussianSamples, unsigned long);
 
+  /** Set/Get the algorithm of the filter, Exact or BilateralGrid. Default
+   * is Exact. */
+  itkSetEnumMacro(Algorithm, AlgorithmEnum);
+  itkGetConstMacro(Algorithm, AlgorithmEnum);
+
+  /** Set/Get the size of the cells of the bilateral grid, relative to the
+   * domain and range sigmas. Smaller values give a more accurate output, at
+   * the cost of a larger grid. Only used by the BilateralGrid algorithm.
+   * Default is 1.0. */
+  itkSetMacro(GridSamplingRatio, double);
+  itkGetConstMacro(GridSamplingRatio, double);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro(OutputHasNumericTraitsCheck, (Concept::HasNumericTraits<OutputPixelType>));
@@ -195,6 +256,10 @@ protected:
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
+  /** Release the bilateral grid. */
+  void
+  AfterThreadedGenerateData() override;
+
   /** BilateralImageFilter needs a larger input requested region than
    * the output requested region (larger by the size of the domain
    * Gaussian kernel).  As such, BilateralImageFilter needs to provide
@@ -205,6 +270,16 @@ protected:
   GenerateInputRequestedRegion() override;
 
 private:
+  static constexpr unsigned int GridDimension = ImageDimension + 1;
+
+  /** Accumulate the input image in the bilateral grid, and blur it. */
+  void
+  BuildBilateralGrid(double rangeMinimum, double rangeMaximum);
+
+  /** Interpolate the blurred grid at the pixels of a region. */
+  void
+  SliceBilateralGrid(const OutputImageRegionType & outputRegionForThread);
+
   /** The standard deviation of the gaussian blurring kernel in the image
       range. Units are intensity. */
   double m_RangeSigma;
@@ -231,6 +306,22 @@ private:
   double              m_DynamicRange;
   double              m_DynamicRangeUsed;
   std::vector<double> m_RangeGaussianTable;
+
+  AlgorithmEnum m_Algorithm{ AlgorithmEnum::Exact };
+  double        m_GridSamplingRatio{ 1.0 };
+
+  /** The bilateral grid, as pairs of the sum of the weighted values and of
+   * the weights, with the intensity axis first in memory, then the image
+   * axes. The grid coordinates of the pixels of the input requested region
+   * along each image axis, and of the intensities, are kept for slicing. */
+  std::vector<float>                       m_Grid;
+  FixedArray<SizeValueType, GridDimension> m_GridSize;
+  FixedArray<SizeValueType, GridDimension> m_GridStrides;
+  typename TInputImage::RegionType         m_GridRegion;
+  std::vector<double>                      m_GridCoordinates[ImageDimension];
+  double                                   m_GridRangeMinimum{ 0.0 };
+  double                                   m_GridRangeMaximum{ 0.0 };
+  double                                   m_GridRangeCellSize{ 1.0 };
 };
 } // end namespace itk
 
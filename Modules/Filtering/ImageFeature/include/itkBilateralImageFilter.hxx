@@ -25,6 +25,7 @@
 #include "itkZeroFluxNeumannBoundaryCondition.h"
 #include "itkTotalProgressReporter.h"
 #include "itkStatisticsImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 namespace itk
 {
@@ -51,6 +52,7 @@ void
 BilateralImageFilter<TInputImage, TOutputImage>::SetRadius(const SizeValueType i)
 {
   m_Radius.Fill(i);
+  this->Modified();
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -124,6 +126,22 @@ template <typename TInputImage, typename TOutputImage>
 void
 BilateralImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
 {
+  auto localInput = TInputImage::New();
+  localInput->Graft(this->GetInput());
+
+  // First, determine the min and max intensity range
+  typename StatisticsImageFilter<TInputImage>::Pointer statistics = StatisticsImageFilter<TInputImage>::New();
+
+  statistics->SetInput(localInput);
+  statistics->Update();
+
+  if (m_Algorithm == AlgorithmEnum::BilateralGrid)
+  {
+    this->BuildBilateralGrid(static_cast<double>(statistics->GetMinimum()),
+                             static_cast<double>(statistics->GetMaximum()));
+    return;
+  }
+
   // Build a small image of the N-dimensional Gaussian used for domain filter
   //
   // Gaussian image size will be (2*std::ceil(2.5*sigma)+1) x
@@ -195,15 +213,6 @@ BilateralImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
 
   // Build a lookup table for the range gaussian
 
-  auto localInput = TInputImage::New();
-  localInput->Graft(this->GetInput());
-
-  // First, determine the min and max intensity range
-  typename StatisticsImageFilter<TInputImage>::Pointer statistics = StatisticsImageFilter<TInputImage>::New();
-
-  statistics->SetInput(localInput);
-  statistics->Update();
-
   // Now create the lookup table whose domain runs from 0.0 to
   // (max-min) and range is gaussian evaluated at
   // that point
@@ -236,6 +245,12 @@ void
 BilateralImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
+  if (m_Algorithm == AlgorithmEnum::BilateralGrid)
+  {
+    this->SliceBilateralGrid(outputRegionForThread);
+    return;
+  }
+
   typename TInputImage::ConstPointer   input = this->GetInput();
   typename TOutputImage::Pointer       output = this->GetOutput();
   typename TInputImage::IndexValueType i;
@@ -320,6 +335,253 @@ BilateralImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+BilateralImageFilter<TInputImage, TOutputImage>::AfterThreadedGenerateData()
+{
+  m_Grid = std::vector<float>();
+  for (auto & coordinates : m_GridCoordinates)
+  {
+    coordinates = std::vector<double>();
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+BilateralImageFilter<TInputImage, TOutputImage>::BuildBilateralGrid(double rangeMinimum, double rangeMaximum)
+{
+  if (m_GridSamplingRatio <= 0.0 || m_RangeSigma <= 0.0)
+  {
+    itkExceptionMacro(<< "GridSamplingRatio and RangeSigma must be positive, but are " << m_GridSamplingRatio
+                      << " and " << m_RangeSigma);
+  }
+
+  const InputImageType * input = this->GetInput();
+  m_GridRegion = input->GetRequestedRegion();
+  if (m_GridRegion.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  // The grid has a cell every GridSamplingRatio sigmas, and one more cell
+  // after the last pixel, so that each pixel falls between two cells along
+  // each axis.
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    if (m_DomainSigma[d] <= 0.0)
+    {
+      itkExceptionMacro(<< "DomainSigma must be positive, but is " << m_DomainSigma);
+    }
+    const double        cellSize = m_GridSamplingRatio * m_DomainSigma[d] / input->GetSpacing()[d];
+    const SizeValueType size = m_GridRegion.GetSize(d);
+    m_GridCoordinates[d].resize(size);
+    for (SizeValueType i = 0; i < size; ++i)
+    {
+      m_GridCoordinates[d][i] = static_cast<double>(i) / cellSize;
+    }
+    m_GridSize[d] = Math::Floor<SizeValueType>(m_GridCoordinates[d][size - 1]) + 2;
+  }
+  m_GridRangeMinimum = rangeMinimum;
+  m_GridRangeMaximum = rangeMaximum;
+  m_GridRangeCellSize = m_GridSamplingRatio * m_RangeSigma;
+  m_GridSize[ImageDimension] =
+    Math::Floor<SizeValueType>((rangeMaximum - m_GridRangeMinimum) / m_GridRangeCellSize) + 2;
+
+  m_GridStrides[ImageDimension] = 1;
+  m_GridStrides[0] = m_GridSize[ImageDimension];
+  for (unsigned int d = 1; d < ImageDimension; ++d)
+  {
+    m_GridStrides[d] = m_GridStrides[d - 1] * m_GridSize[d - 1];
+  }
+  const SizeValueType numberOfCells = m_GridStrides[ImageDimension - 1] * m_GridSize[ImageDimension - 1];
+  m_Grid.assign(2 * numberOfCells, 0.0f);
+
+  // Accumulate the pixels in the grid, with multilinear weights. Each work
+  // unit fills the cells of one grid slice along the last image axis, from
+  // the pixels between the slice and the next ones.
+  constexpr unsigned int SliceAxis = ImageDimension - 1;
+  const auto             accumulateSlice = [this, input](SizeValueType slice) {
+    typename TInputImage::RegionType pixelSlice = m_GridRegion;
+    pixelSlice.SetSize(SliceAxis, 1);
+    for (SizeValueType i = 0; i < m_GridRegion.GetSize(SliceAxis); ++i)
+    {
+      const double        sliceCoordinate = m_GridCoordinates[SliceAxis][i];
+      const SizeValueType sliceCell = Math::Floor<SizeValueType>(sliceCoordinate);
+      if (sliceCell + 1 < slice || sliceCell > slice)
+      {
+        continue;
+      }
+      const double sliceFraction = sliceCoordinate - static_cast<double>(sliceCell);
+      const double sliceWeight = sliceCell == slice ? 1.0 - sliceFraction : sliceFraction;
+      pixelSlice.SetIndex(SliceAxis, m_GridRegion.GetIndex(SliceAxis) + static_cast<IndexValueType>(i));
+
+      for (ImageRegionConstIteratorWithIndex<TInputImage> it(input, pixelSlice); !it.IsAtEnd(); ++it)
+      {
+        const double value = static_cast<double>(it.Get());
+        const auto & index = it.GetIndex();
+
+        // The cell before the pixel, and the fractions, along the other axes
+        SizeValueType offset = slice * m_GridStrides[SliceAxis];
+        double        fractions[GridDimension];
+        SizeValueType strides[GridDimension];
+        unsigned int  numberOfAxes = 0;
+        for (unsigned int d = 0; d < GridDimension; ++d)
+        {
+          if (d == SliceAxis)
+          {
+            continue;
+          }
+          const double coordinate =
+            d == ImageDimension ? (value - m_GridRangeMinimum) / m_GridRangeCellSize
+                                : m_GridCoordinates[d][index[d] - m_GridRegion.GetIndex(d)];
+          const SizeValueType cell = Math::Floor<SizeValueType>(coordinate);
+          offset += cell * m_GridStrides[d];
+          fractions[numberOfAxes] = coordinate - static_cast<double>(cell);
+          strides[numberOfAxes] = m_GridStrides[d];
+          ++numberOfAxes;
+        }
+
+        for (unsigned int corner = 0; corner < (1u << numberOfAxes); ++corner)
+        {
+          SizeValueType cornerOffset = offset;
+          double        weight = sliceWeight;
+          for (unsigned int a = 0; a < numberOfAxes; ++a)
+          {
+            if (corner & (1u << a))
+            {
+              cornerOffset += strides[a];
+              weight *= fractions[a];
+            }
+            else
+            {
+              weight *= 1.0 - fractions[a];
+            }
+          }
+          m_Grid[2 * cornerOffset] += static_cast<float>(weight * value);
+          m_Grid[2 * cornerOffset + 1] += static_cast<float>(weight);
+        }
+      }
+    }
+  };
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->ParallelizeArray(0, m_GridSize[SliceAxis], accumulateSlice, nullptr);
+
+  // Blur the grid along each axis. The accumulation and the interpolation
+  // each blur the grid by a variance of 1/6 of a cell, which is subtracted
+  // from the variance of the Gaussian, one over the squared ratio of cells.
+  const double variance = std::max(1.0 / (m_GridSamplingRatio * m_GridSamplingRatio) - 1.0 / 3.0, 0.0);
+  for (unsigned int d = 0; d < GridDimension; ++d)
+  {
+    const double mu = d == ImageDimension ? m_RangeMu : m_DomainMu;
+    const auto   radius = std::min(Math::Ceil<SizeValueType>(mu * std::sqrt(variance)), m_GridSize[d] - 1);
+    if (radius == 0)
+    {
+      continue;
+    }
+    std::vector<double> kernel(2 * radius + 1);
+    for (SizeValueType k = 0; k < kernel.size(); ++k)
+    {
+      const double x = static_cast<double>(k) - static_cast<double>(radius);
+      kernel[k] = std::exp(-0.5 * x * x / variance);
+    }
+
+    // The lines along the axis, in blocks of adjacent lines
+    constexpr SizeValueType LinesPerBlock = 64;
+    const SizeValueType     lineLength = m_GridSize[d];
+    const SizeValueType     stride = m_GridStrides[d];
+    const SizeValueType     numberOfLines = numberOfCells / lineLength;
+    const auto              blurLines = [&, this](SizeValueType block) {
+      std::vector<double> line(2 * lineLength);
+      const SizeValueType lastLine = std::min((block + 1) * LinesPerBlock, numberOfLines);
+      for (SizeValueType l = block * LinesPerBlock; l < lastLine; ++l)
+      {
+        float * start = m_Grid.data() + 2 * (l % stride + (l / stride) * stride * lineLength);
+        for (SizeValueType i = 0; i < lineLength; ++i)
+        {
+          line[2 * i] = start[2 * i * stride];
+          line[2 * i + 1] = start[2 * i * stride + 1];
+        }
+        for (SizeValueType i = 0; i < lineLength; ++i)
+        {
+          const SizeValueType first = i < radius ? radius - i : 0;
+          const SizeValueType last = std::min(2 * radius, lineLength - 1 + radius - i);
+          double              sum = 0.0;
+          double              weight = 0.0;
+          for (SizeValueType k = first; k <= last; ++k)
+          {
+            sum += kernel[k] * line[2 * (i + k - radius)];
+            weight += kernel[k] * line[2 * (i + k - radius) + 1];
+          }
+          start[2 * i * stride] = static_cast<float>(sum);
+          start[2 * i * stride + 1] = static_cast<float>(weight);
+        }
+      }
+    };
+    this->GetMultiThreader()->ParallelizeArray(
+      0, (numberOfLines + LinesPerBlock - 1) / LinesPerBlock, blurLines, nullptr);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+BilateralImageFilter<TInputImage, TOutputImage>::SliceBilateralGrid(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  ImageRegionConstIteratorWithIndex<TInputImage> it(input, outputRegionForThread);
+  ImageRegionIterator<OutputImageType>           oit(output, outputRegionForThread);
+  for (; !it.IsAtEnd(); ++it, ++oit)
+  {
+    const double value = static_cast<double>(it.Get());
+    const auto & index = it.GetIndex();
+
+    SizeValueType offset = 0;
+    double        fractions[GridDimension];
+    for (unsigned int d = 0; d < GridDimension; ++d)
+    {
+      const double coordinate = d == ImageDimension ? (value - m_GridRangeMinimum) / m_GridRangeCellSize
+                                                    : m_GridCoordinates[d][index[d] - m_GridRegion.GetIndex(d)];
+      const SizeValueType cell = Math::Floor<SizeValueType>(coordinate);
+      offset += cell * m_GridStrides[d];
+      fractions[d] = coordinate - static_cast<double>(cell);
+    }
+
+    double sum = 0.0;
+    double weightSum = 0.0;
+    for (unsigned int corner = 0; corner < (1u << GridDimension); ++corner)
+    {
+      SizeValueType cornerOffset = offset;
+      double        weight = 1.0;
+      for (unsigned int d = 0; d < GridDimension; ++d)
+      {
+        if (corner & (1u << d))
+        {
+          cornerOffset += m_GridStrides[d];
+          weight *= fractions[d];
+        }
+        else
+        {
+          weight *= 1.0 - fractions[d];
+        }
+      }
+      sum += weight * m_Grid[2 * cornerOffset];
+      weightSum += weight * m_Grid[2 * cornerOffset + 1];
+    }
+
+    // The filtered value is a weighted mean of the pixels, so clamping it to
+    // their range only removes the rounding errors of the float grid, which
+    // would otherwise change a constant image of integers when truncated.
+    const double              mean = weightSum > 0.0 ? sum / weightSum : value;
+    const OutputPixelRealType filtered = std::min(std::max(mean, m_GridRangeMinimum), m_GridRangeMaximum);
+    oit.Set(static_cast<OutputPixelType>(filtered));
+    progress.CompletedPixel();
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 BilateralImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
@@ -334,6 +596,8 @@ BilateralImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, In
   os << indent << "Amount of dynamic range used: " << m_DynamicRangeUsed << std::endl;
   os << indent << "AutomaticKernelSize: " << m_AutomaticKernelSize << std::endl;
   os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
+  os << indent << "GridSamplingRatio: " << m_GridSamplingRatio << std::endl;
 }
 } // end namespace itk
 
@@ -62,6 +62,19 @@ extern ITKImageFeature_EXPORT std::ostream &
  * The filter computes a second output image (accessed by the GetScalesOutput method)
  * containing the scales at which each pixel gave the best response.
  *
+ * By default, the Hessian image of each scale is computed for the whole image
+ * by a HessianRecursiveGaussianImageFilter, then passed to the measure filter.
+ * With FuseHessianComputation on, the Hessian and the measure are computed
+ * slab by slab along the last axis, each slab from the input extended by a
+ * halo of 16 sigma along that axis, so that neither the Hessian image nor the
+ * Gaussian derivatives of the whole image are ever allocated. Besides the
+ * outputs, the working memory is then a few slabs of the size of the input,
+ * about 1.5 times the input for 3D images, rather than the Hessian image of
+ * the whole image. The derivatives along the last axis are computed again on
+ * the halos, which makes it slower. The measure filter must compute each
+ * pixel from the Hessian of that pixel only, as
+ * HessianToObjectnessMeasureImageFilter does.
+ *
  *
  * This code was contributed in the Insight Journal paper:
  * "Generalizing vesselness with respect to dimensionality and shape"
@@ -201,6 +214,13 @@ public:
   itkGetConstMacro(GenerateHessianOutput, bool);
   itkBooleanMacro(GenerateHessianOutput);
 
+  /** Methods to turn on/off flag to compute the Hessian and the measure slab
+   *  by slab along the last axis, rather than for the whole image at each
+   *  scale. This uses less memory, but takes longer. Off by default. */
+  itkSetMacro(FuseHessianComputation, bool);
+  itkGetConstMacro(FuseHessianComputation, bool);
+  itkBooleanMacro(FuseHessianComputation);
+
   /** This is overloaded to create the Scales and Hessian output images */
   using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
 
@@ -222,8 +242,13 @@ protected:
   MakeOutput(DataObjectPointerArraySizeType idx) override;
 
 private:
+  /** Compute the measure of a scale slab by slab, and update the best
+   * response. */
+  void
+  GenerateDataInSlabs(double sigma, unsigned int scaleLevel);
+
   void
-  UpdateMaximumResponse(double sigma);
+  UpdateMaximumResponse(double sigma, const OutputRegionType & region, const HessianImageType * hessianImage);
 
   double
   ComputeSigmaValue(int scaleLevel);
@@ -247,6 +272,7 @@ private:
 
   bool m_GenerateScalesOutput;
   bool m_GenerateHessianOutput;
+  bool m_FuseHessianComputation{ false };
 };
 } // end namespace itk
 
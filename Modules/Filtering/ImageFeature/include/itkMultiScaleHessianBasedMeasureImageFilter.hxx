@@ -20,6 +20,7 @@
 
 #include "itkMultiScaleHessianBasedMeasureImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkRecursiveGaussianImageFilter.h"
 #include "itkMath.h"
 
 /*
@@ -163,35 +164,50 @@ MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImag
 
   typename InputImageType::ConstPointer input = this->GetInput();
 
-  this->m_HessianFilter->SetInput(input);
-
-  this->m_HessianFilter->SetNormalizeAcrossScale(true);
+  if (m_FuseHessianComputation)
+  {
+    for (unsigned int scaleLevel = 0; scaleLevel < m_NumberOfSigmaSteps; ++scaleLevel)
+    {
+      const double sigma = this->ComputeSigmaValue(scaleLevel);
 
-  // Create a process accumulator for tracking the progress of this
-  // minipipeline
-  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
-  progress->SetMiniPipelineFilter(this);
+      itkDebugMacro(<< "Computing measure in slabs for scale with sigma = " << sigma);
 
-  // prevent a divide by zero
-  if (m_NumberOfSigmaSteps > 0)
-  {
-    progress->RegisterInternalFilter(this->m_HessianFilter, .5 / m_NumberOfSigmaSteps);
-    progress->RegisterInternalFilter(this->m_HessianToMeasureFilter, .5 / m_NumberOfSigmaSteps);
+      this->GenerateDataInSlabs(sigma, scaleLevel);
+    }
   }
-
-  for (unsigned int scaleLevel = 0; scaleLevel < m_NumberOfSigmaSteps; ++scaleLevel)
+  else
   {
-    const double sigma = this->ComputeSigmaValue(scaleLevel);
+    this->m_HessianFilter->SetInput(input);
 
-    itkDebugMacro(<< "Computing measure for scale with sigma = " << sigma);
+    this->m_HessianFilter->SetNormalizeAcrossScale(true);
 
-    m_HessianFilter->SetSigma(sigma);
+    // Create a process accumulator for tracking the progress of this
+    // minipipeline
+    ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+    progress->SetMiniPipelineFilter(this);
 
-    m_HessianToMeasureFilter->SetInput(m_HessianFilter->GetOutput());
+    // prevent a divide by zero
+    if (m_NumberOfSigmaSteps > 0)
+    {
+      progress->RegisterInternalFilter(this->m_HessianFilter, .5 / m_NumberOfSigmaSteps);
+      progress->RegisterInternalFilter(this->m_HessianToMeasureFilter, .5 / m_NumberOfSigmaSteps);
+    }
+
+    for (unsigned int scaleLevel = 0; scaleLevel < m_NumberOfSigmaSteps; ++scaleLevel)
+    {
+      const double sigma = this->ComputeSigmaValue(scaleLevel);
+
+      itkDebugMacro(<< "Computing measure for scale with sigma = " << sigma);
 
-    m_HessianToMeasureFilter->Update();
+      m_HessianFilter->SetSigma(sigma);
 
-    this->UpdateMaximumResponse(sigma);
+      m_HessianToMeasureFilter->SetInput(m_HessianFilter->GetOutput());
+
+      m_HessianToMeasureFilter->Update();
+
+      this->UpdateMaximumResponse(
+        sigma, this->GetOutput()->GetBufferedRegion(), this->m_HessianFilter->GetOutput());
+    }
   }
 
   // Write out the best response to the output image
@@ -217,18 +233,207 @@ MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImag
 
 template <typename TInputImage, typename THessianImage, typename TOutputImage>
 void
-MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImage>::UpdateMaximumResponse(double sigma)
+MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImage>::GenerateDataInSlabs(
+  double       sigma,
+  unsigned int scaleLevel)
+{
+  using RealImageType = typename HessianFilterType::RealImageType;
+  using InputRegionType = typename InputImageType::RegionType;
+  using InputPixelType = typename InputImageType::PixelType;
+  using SlabAxisFilterType = RecursiveGaussianImageFilter<InputImageType, RealImageType>;
+  using SlabFilterType = RecursiveGaussianImageFilter<RealImageType, RealImageType>;
+  using HessianPixelType = typename HessianImageType::PixelType;
+  using HessianValueType = typename NumericTraits<HessianPixelType>::ValueType;
+
+  // The slabs are along the last axis. For each slab, the derivatives along
+  // the last axis, of order 0, 1 and 2, are computed one at a time from the
+  // slab of the input extended by a halo on each side, and each is shared by
+  // the elements of the Hessian which start from it; the derivatives along the
+  // other axes are then computed from the last axis to the first. The
+  // recursive Gaussian along the last axis only sees the halo around the slab,
+  // so the result differs from the one for the whole image by the tail of the
+  // filter beyond the halo, which is below the float precision of the
+  // derivatives for a halo of 16 sigmas.
+  constexpr unsigned int  SlabAxis = ImageDimension - 1;
+  constexpr SizeValueType NumberOfSlabs = 16;
+  constexpr double        HaloInSigmas = 16.0;
+
+  const InputImageType * input = this->GetInput();
+  const OutputRegionType region = this->GetOutput()->GetBufferedRegion();
+
+  // The orders of the derivatives of each element of the Hessian along each
+  // axis, and the axes of the element
+  std::vector<FixedArray<unsigned int, ImageDimension>> elementOrders;
+  std::vector<std::pair<unsigned int, unsigned int>>    elementAxes;
+  for (unsigned int dima = 0; dima < ImageDimension; ++dima)
+  {
+    for (unsigned int dimb = dima; dimb < ImageDimension; ++dimb)
+    {
+      FixedArray<unsigned int, ImageDimension> orders;
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        orders[d] = (d == dima ? 1 : 0) + (d == dimb ? 1 : 0);
+      }
+      elementOrders.push_back(orders);
+      elementAxes.emplace_back(dima, dimb);
+    }
+  }
+
+  // Only the derivatives are normalized across scale, as by HessianRecursiveGaussianImageFilter
+  const auto makeFilter = [this, sigma](auto filter, unsigned int direction, unsigned int order) {
+    filter->SetDirection(direction);
+    filter->SetOrder(static_cast<GaussianOrderEnum>(order));
+    filter->SetNormalizeAcrossScale(order > 0);
+    filter->SetSigma(sigma);
+    filter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    return filter;
+  };
+
+  typename SlabAxisFilterType::Pointer slabAxisFilters[3];
+  for (const auto & orders : elementOrders)
+  {
+    const unsigned int order = orders[SlabAxis];
+    if (slabAxisFilters[order].IsNull())
+    {
+      slabAxisFilters[order] = makeFilter(SlabAxisFilterType::New(), SlabAxis, order);
+    }
+  }
+
+  // For each element, the pipeline of the derivatives along the other axes.
+  // The filters are kept, since their outputs do not keep them.
+  std::vector<std::vector<typename SlabFilterType::Pointer>> elementFilters;
+  for (const auto & orders : elementOrders)
+  {
+    std::vector<typename SlabFilterType::Pointer> filters;
+    for (unsigned int d = SlabAxis; d > 0; --d)
+    {
+      auto filter = makeFilter(SlabFilterType::New(), d - 1, orders[d - 1]);
+      if (filters.empty())
+      {
+        filter->SetInput(slabAxisFilters[orders[SlabAxis]]->GetOutput());
+      }
+      else
+      {
+        filters.back()->ReleaseDataFlagOn();
+        filter->SetInput(filters.back()->GetOutput());
+      }
+      filters.push_back(filter);
+    }
+    elementFilters.push_back(filters);
+  }
+
+  const auto halo = static_cast<IndexValueType>(std::ceil(HaloInSigmas * sigma / input->GetSpacing()[SlabAxis]));
+  const InputRegionType inputRegion = input->GetBufferedRegion();
+  const IndexValueType  inputFirst = inputRegion.GetIndex(SlabAxis);
+  const IndexValueType  inputEnd = inputFirst + static_cast<IndexValueType>(inputRegion.GetSize(SlabAxis));
+
+  const SizeValueType slabAxisSize = region.GetSize(SlabAxis);
+  const SizeValueType slabThickness = (slabAxisSize + NumberOfSlabs - 1) / NumberOfSlabs;
+  const SizeValueType numberOfSlabs = (slabAxisSize + slabThickness - 1) / slabThickness;
+  for (SizeValueType slab = 0; slab < numberOfSlabs; ++slab)
+  {
+    OutputRegionType slabRegion = region;
+    slabRegion.SetIndex(SlabAxis, region.GetIndex(SlabAxis) + static_cast<IndexValueType>(slab * slabThickness));
+    slabRegion.SetSize(SlabAxis, std::min(slabThickness, slabAxisSize - slab * slabThickness));
+
+    // The slab of the input and its halo are contiguous in the buffer of the
+    // input, so the derivative filters along the last axis read them in place.
+    const IndexValueType slabFirst = slabRegion.GetIndex(SlabAxis);
+    const IndexValueType slabEnd = slabFirst + static_cast<IndexValueType>(slabRegion.GetSize(SlabAxis));
+    const IndexValueType haloFirst = std::max(slabFirst - halo, inputFirst);
+    const IndexValueType haloEnd = std::min(slabEnd + halo, inputEnd);
+    InputRegionType      haloRegion = inputRegion;
+    haloRegion.SetIndex(SlabAxis, haloFirst);
+    haloRegion.SetSize(SlabAxis, static_cast<SizeValueType>(haloEnd - haloFirst));
+
+    auto haloInput = InputImageType::New();
+    haloInput->CopyInformation(input);
+    haloInput->SetRegions(haloRegion);
+    haloInput->GetPixelContainer()->SetImportPointer(const_cast<InputPixelType *>(input->GetBufferPointer()) +
+                                                       input->ComputeOffset(haloRegion.GetIndex()),
+                                                     haloRegion.GetNumberOfPixels(),
+                                                     false);
+
+    auto hessianImage = HessianImageType::New();
+    hessianImage->CopyInformation(input);
+    hessianImage->SetRegions(slabRegion);
+    hessianImage->Allocate();
+
+    for (const auto & slabAxisFilter : slabAxisFilters)
+    {
+      if (slabAxisFilter.IsNull())
+      {
+        continue;
+      }
+      slabAxisFilter->SetInput(haloInput);
+      slabAxisFilter->UpdateLargestPossibleRegion();
+
+      for (unsigned int element = 0; element < elementOrders.size(); ++element)
+      {
+        if (slabAxisFilters[elementOrders[element][SlabAxis]] != slabAxisFilter)
+        {
+          continue;
+        }
+
+        const RealImageType * derivativeImage = slabAxisFilter->GetOutput();
+        if (!elementFilters[element].empty())
+        {
+          SlabFilterType * lastFilter = elementFilters[element].back();
+          lastFilter->GetOutput()->SetRequestedRegion(slabRegion);
+          lastFilter->Update();
+          derivativeImage = lastFilter->GetOutput();
+        }
+
+        // As by HessianRecursiveGaussianImageFilter
+        const unsigned int dima = elementAxes[element].first;
+        const unsigned int dimb = elementAxes[element].second;
+        const double       factor = input->GetSpacing()[dima] * input->GetSpacing()[dimb];
+
+        ImageRegionConstIterator<RealImageType> it(derivativeImage, slabRegion);
+        ImageRegionIterator<HessianImageType>   hit(hessianImage, slabRegion);
+        for (; !hit.IsAtEnd(); ++it, ++hit)
+        {
+          hit.Value()(dima, dimb) = static_cast<HessianValueType>(it.Get() / factor);
+        }
+        if (!elementFilters[element].empty())
+        {
+          elementFilters[element].back()->GetOutput()->ReleaseData();
+        }
+      }
+
+      // Only one derivative along the last axis is kept at a time
+      slabAxisFilter->GetOutput()->ReleaseData();
+    }
+
+    m_HessianToMeasureFilter->SetInput(hessianImage);
+    m_HessianToMeasureFilter->UpdateLargestPossibleRegion();
+
+    this->UpdateMaximumResponse(sigma, slabRegion, hessianImage);
+
+    this->UpdateProgress(static_cast<float>(scaleLevel * numberOfSlabs + slab + 1) /
+                         static_cast<float>(m_NumberOfSigmaSteps * numberOfSlabs));
+  }
+
+  // The measure filter does not keep the last slab
+  m_HessianToMeasureFilter->GetOutput()->ReleaseData();
+}
+
+template <typename TInputImage, typename THessianImage, typename TOutputImage>
+void
+MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImage>::UpdateMaximumResponse(
+  double                   sigma,
+  const OutputRegionType & outputRegion,
+  const HessianImageType * hessianImage)
 {
   // the meta-data should match between these images, therefore we
   // iterate over the desired output region
-  OutputRegionType outputRegion = this->GetOutput()->GetBufferedRegion();
 
   ImageRegionIterator<UpdateBufferType> oit(m_UpdateBuffer, outputRegion);
 
   typename ScalesImageType::Pointer    scalesImage = static_cast<ScalesImageType *>(this->ProcessObject::GetOutput(1));
   ImageRegionIterator<ScalesImageType> osit;
 
-  typename HessianImageType::Pointer hessianImage = static_cast<HessianImageType *>(this->ProcessObject::GetOutput(2));
+  typename HessianImageType::Pointer hessianOutput = static_cast<HessianImageType *>(this->ProcessObject::GetOutput(2));
   ImageRegionIterator<HessianImageType> ohit;
 
   oit.GoToBegin();
@@ -239,14 +444,14 @@ MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImag
   }
   if (m_GenerateHessianOutput)
   {
-    ohit = ImageRegionIterator<HessianImageType>(hessianImage, outputRegion);
+    ohit = ImageRegionIterator<HessianImageType>(hessianOutput, outputRegion);
     ohit.GoToBegin();
   }
 
   using HessianToMeasureOutputImageType = typename HessianToMeasureFilterType::OutputImageType;
 
   ImageRegionIterator<HessianToMeasureOutputImageType> it(m_HessianToMeasureFilter->GetOutput(), outputRegion);
-  ImageRegionIterator<HessianImageType>                hit(m_HessianFilter->GetOutput(), outputRegion);
+  ImageRegionConstIterator<HessianImageType>           hit(hessianImage, outputRegion);
 
   it.GoToBegin();
   hit.GoToBegin();
@@ -366,6 +571,7 @@ MultiScaleHessianBasedMeasureImageFilter<TInputImage, THessianImage, TOutputImag
   os << indent << "NonNegativeHessianBasedMeasure:  " << m_NonNegativeHessianBasedMeasure << std::endl;
   os << indent << "GenerateScalesOutput: " << m_GenerateScalesOutput << std::endl;
   os << indent << "GenerateHessianOutput: " << m_GenerateHessianOutput << std::endl;
+  os << indent << "FuseHessianComputation: " << m_FuseHessianComputation << std::endl;
 }
 } // end namespace itk
 
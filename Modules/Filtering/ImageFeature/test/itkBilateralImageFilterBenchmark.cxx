@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBilateralImageFilter.h"
+#include "itkStepsWithNoiseImage.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Report the time and the remaining noise of the Exact and BilateralGrid
+ * algorithms of BilateralImageFilter for a range of domain sigmas, on a 3D
+ * image of float pixels and a 2D image of 8 bit pixels with steps and noise.
+ * The Exact algorithm is only run for the smaller sigmas. This benchmark is
+ * not run by default; the accuracy of the BilateralGrid algorithm is checked
+ * by itkBilateralImageFilterGridTest.
+ */
+
+namespace
+{
+
+constexpr double StepHeight = 100.0;
+constexpr double NoiseSigma = 20.0;
+
+template <typename TImage>
+void
+SweepDomainSigma(unsigned int size, double maximumExactDomainSigma, double maximumDomainSigma)
+{
+  using FilterType = itk::BilateralImageFilter<TImage, TImage>;
+  using AlgorithmEnum = typename FilterType::AlgorithmEnum;
+
+  typename TImage::SizeType imageSize;
+  imageSize.Fill(size);
+  imageSize[0] += 3;
+  typename TImage::Pointer noiseFree;
+  const auto               image = MakeStepsWithNoiseImage<TImage>(imageSize, StepHeight, NoiseSigma, noiseFree);
+  std::cout << TImage::ImageDimension << "D, " << imageSize
+            << " pixels, noise: " << RootMeanSquareDifference(image.GetPointer(), noiseFree.GetPointer()) << std::endl;
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetRangeSigma(2.0 * NoiseSigma);
+
+  for (double domainSigma = 1.0; domainSigma <= maximumDomainSigma; domainSigma *= 2.0)
+  {
+    filter->SetDomainSigma(domainSigma);
+    std::cout << "domain sigma " << domainSigma << std::endl;
+
+    for (const auto algorithm : { AlgorithmEnum::Exact, AlgorithmEnum::BilateralGrid })
+    {
+      if (algorithm == AlgorithmEnum::Exact && domainSigma > maximumExactDomainSigma)
+      {
+        continue;
+      }
+      filter->SetAlgorithm(algorithm);
+      itk::TimeProbe probe;
+      probe.Start();
+      filter->Update();
+      probe.Stop();
+      std::cout << "  " << algorithm << ": " << probe.GetTotal()
+                << " s, error " << RootMeanSquareDifference(filter->GetOutput(), noiseFree.GetPointer()) << std::endl;
+    }
+  }
+}
+
+} // namespace
+
+int
+itkBilateralImageFilterBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " imageSize" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto imageSize = static_cast<unsigned int>(std::stoi(argv[1]));
+
+  SweepDomainSigma<itk::Image<float, 3>>(imageSize, 2.0, 8.0);
+  SweepDomainSigma<itk::Image<unsigned char, 2>>(imageSize * imageSize / 4, 4.0, 16.0);
+
+  std::cout << "Benchmark finished." << std::endl;
+  return EXIT_SUCCESS;
+}
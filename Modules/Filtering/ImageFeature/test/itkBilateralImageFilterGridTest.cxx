@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBilateralImageFilter.h"
+#include "itkStepsWithNoiseImage.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Check that the BilateralGrid algorithm of BilateralImageFilter removes the
+ * noise of small images with steps about as well as the Exact algorithm, and
+ * that it keeps constant images, where the range of the pixels is empty, and
+ * images which are one pixel wide along an axis.
+ */
+
+namespace
+{
+
+constexpr double StepHeight = 100.0;
+constexpr double NoiseSigma = 20.0;
+
+template <typename TImage>
+int
+CompareToExact(const typename TImage::SizeType & size, double domainSigma)
+{
+  using FilterType = itk::BilateralImageFilter<TImage, TImage>;
+  using AlgorithmEnum = typename FilterType::AlgorithmEnum;
+
+  typename TImage::Pointer noiseFree;
+  const auto               image = MakeStepsWithNoiseImage<TImage>(size, StepHeight, NoiseSigma, noiseFree);
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetRangeSigma(2.0 * NoiseSigma);
+  filter->SetDomainSigma(domainSigma);
+
+  double errors[2];
+  for (const auto algorithm : { AlgorithmEnum::Exact, AlgorithmEnum::BilateralGrid })
+  {
+    filter->SetAlgorithm(algorithm);
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+    errors[algorithm == AlgorithmEnum::Exact ? 0 : 1] =
+      RootMeanSquareDifference(filter->GetOutput(), noiseFree.GetPointer());
+  }
+  std::cout << TImage::ImageDimension << "D, " << size << " pixels, domain sigma " << domainSigma
+            << ": noise " << RootMeanSquareDifference(image.GetPointer(), noiseFree.GetPointer()) << ", Exact "
+            << errors[0] << ", BilateralGrid " << errors[1] << std::endl;
+
+  // The noise is reduced about as much as by the Exact algorithm
+  const double maximumError = 1.25 * errors[0] + 1.0;
+  if (errors[1] > maximumError)
+  {
+    std::cerr << "The error of the BilateralGrid algorithm " << errors[1] << " is above " << maximumError
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename TImage>
+int
+CheckConstantImage(const typename TImage::SizeType & size, typename TImage::PixelType value)
+{
+  using FilterType = itk::BilateralImageFilter<TImage, TImage>;
+
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  image->FillBuffer(value);
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetAlgorithm(FilterType::AlgorithmEnum::BilateralGrid);
+  filter->SetDomainSigma(2.0);
+  filter->SetRangeSigma(10.0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+  const double tolerance = 1e-4 * std::max(std::abs(static_cast<double>(value)), 1.0);
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(filter->GetOutput(), image->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    if (std::abs(static_cast<double>(it.Get()) - static_cast<double>(value)) > tolerance)
+    {
+      std::cerr << "The pixel " << it.GetIndex() << " of the constant image " << static_cast<double>(value)
+                << " of size " << size << " is " << static_cast<double>(it.Get()) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkBilateralImageFilterGridTest(int, char *[])
+{
+  using FloatImageType = itk::Image<float, 3>;
+  using UnsignedCharImageType = itk::Image<unsigned char, 2>;
+
+  int status = EXIT_SUCCESS;
+  for (const double domainSigma : { 1.0, 2.0 })
+  {
+    status |= CompareToExact<FloatImageType>({ { 19, 16, 16 } }, domainSigma);
+  }
+  for (const double domainSigma : { 1.0, 2.0, 4.0 })
+  {
+    status |= CompareToExact<UnsignedCharImageType>({ { 67, 64 } }, domainSigma);
+  }
+
+  // One pixel along an axis, including the axis along which the grid is
+  // accumulated in slices
+  status |= CompareToExact<UnsignedCharImageType>({ { 1, 64 } }, 2.0);
+  status |= CompareToExact<UnsignedCharImageType>({ { 64, 1 } }, 2.0);
+  status |= CompareToExact<FloatImageType>({ { 19, 1, 16 } }, 2.0);
+
+  // The minimum and maximum of the pixels are equal
+  status |= CheckConstantImage<FloatImageType>({ { 9, 8, 7 } }, -7.5f);
+  status |= CheckConstantImage<FloatImageType>({ { 1, 1, 1 } }, 3.0f);
+  status |= CheckConstantImage<UnsignedCharImageType>({ { 20, 10 } }, 0);
+  status |= CheckConstantImage<UnsignedCharImageType>({ { 20, 10 } }, 255);
+
+  FloatImageType::Pointer noiseFree;
+  const auto image = MakeStepsWithNoiseImage<FloatImageType>({ { 4, 4, 4 } }, StepHeight, NoiseSigma, noiseFree);
+  using FilterType = itk::BilateralImageFilter<FloatImageType, FloatImageType>;
+  auto filter = FilterType::New();
+  ITK_TEST_SET_GET_VALUE(FilterType::AlgorithmEnum::Exact, filter->GetAlgorithm());
+  filter->SetInput(image);
+  filter->SetAlgorithm(FilterType::AlgorithmEnum::BilateralGrid);
+  ITK_TEST_SET_GET_VALUE(FilterType::AlgorithmEnum::BilateralGrid, filter->GetAlgorithm());
+  ITK_TEST_SET_GET_VALUE(1.0, filter->GetGridSamplingRatio());
+  filter->SetGridSamplingRatio(0.0);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
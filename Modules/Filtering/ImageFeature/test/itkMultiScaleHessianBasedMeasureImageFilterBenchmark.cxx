@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiScaleHessianBasedMeasureImageFilter.h"
+#include "itkHessianToObjectnessMeasureImageFilter.h"
+#include "itkTubesImage.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Report the time of MultiScaleHessianBasedMeasureImageFilter with and
+ * without FuseHessianComputation, on 3D and 2D images of tubes. This
+ * benchmark is not run by default; the outputs of both modes are compared by
+ * itkMultiScaleHessianBasedMeasureImageFilterTest.
+ */
+
+namespace
+{
+
+template <unsigned int VDimension>
+void
+TimeFusedHessianComputation(unsigned int size)
+{
+  using ImageType = itk::Image<float, VDimension>;
+  using HessianImageType = itk::Image<itk::SymmetricSecondRankTensor<double, VDimension>, VDimension>;
+  using ObjectnessFilterType = itk::HessianToObjectnessMeasureImageFilter<HessianImageType, ImageType>;
+  using FilterType = itk::MultiScaleHessianBasedMeasureImageFilter<ImageType, HessianImageType, ImageType>;
+
+  const typename ImageType::Pointer image = MakeTubesImage<ImageType>(size);
+  std::cout << VDimension << "D, " << image->GetLargestPossibleRegion().GetSize() << " pixels" << std::endl;
+
+  for (bool fused : { false, true })
+  {
+    auto objectnessFilter = ObjectnessFilterType::New();
+    objectnessFilter->SetObjectDimension(1);
+    objectnessFilter->SetBrightObject(true);
+
+    auto filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetHessianToMeasureFilter(objectnessFilter);
+    filter->SetSigmaMinimum(1.0);
+    filter->SetSigmaMaximum(4.0);
+    filter->SetNumberOfSigmaSteps(4);
+    filter->SetFuseHessianComputation(fused);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    filter->Update();
+    probe.Stop();
+    std::cout << (fused ? "  fused: " : "  whole image: ") << probe.GetTotal() << " s" << std::endl;
+  }
+}
+
+} // namespace
+
+int
+itkMultiScaleHessianBasedMeasureImageFilterBenchmark(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " imageSize" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto imageSize = static_cast<unsigned int>(std::stoi(argv[1]));
+
+  TimeFusedHessianComputation<3>(imageSize);
+  TimeFusedHessianComputation<2>(4 * imageSize);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
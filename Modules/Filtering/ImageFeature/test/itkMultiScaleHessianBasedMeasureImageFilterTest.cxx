@@ -20,8 +20,99 @@
 #include "itkMultiScaleHessianBasedMeasureImageFilter.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkSimpleFilterWatcher.h"
+#include "itkTubesImage.h"
 #include "itkTestingMacros.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+template <typename TImage>
+double
+MaximumDifference(const TImage * image1, const TImage * image2)
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+
+  double maximumDifference = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image1, image1->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto value1 = it.Get();
+    const auto value2 = image2->GetPixel(it.GetIndex());
+    for (unsigned int c = 0; c < itk::NumericTraits<typename TImage::PixelType>::GetLength(value1); ++c)
+    {
+      maximumDifference = std::max(maximumDifference,
+                                   std::abs(static_cast<double>(PixelTraits::GetNthComponent(c, value1)) -
+                                            static_cast<double>(PixelTraits::GetNthComponent(c, value2))));
+    }
+  }
+  return maximumDifference;
+}
+
+// Compare the measure, scales and Hessian outputs with and without
+// FuseHessianComputation. The derivatives are computed in another order, with
+// float images in between, and the derivatives along the last axis only see a
+// halo around each slab.
+template <typename TImage>
+int
+CompareFusedHessianComputation(const TImage * image)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+  using HessianImageType = itk::Image<itk::SymmetricSecondRankTensor<double, Dimension>, Dimension>;
+  using ObjectnessFilterType = itk::HessianToObjectnessMeasureImageFilter<HessianImageType, TImage>;
+  using FilterType = itk::MultiScaleHessianBasedMeasureImageFilter<TImage, HessianImageType, TImage>;
+
+  typename TImage::Pointer                      measures[2];
+  typename FilterType::ScalesImageType::Pointer scales[2];
+  typename HessianImageType::Pointer            hessians[2];
+  for (unsigned int fused = 0; fused < 2; ++fused)
+  {
+    auto objectnessFilter = ObjectnessFilterType::New();
+    objectnessFilter->SetObjectDimension(1);
+    objectnessFilter->SetBrightObject(true);
+
+    auto filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetHessianToMeasureFilter(objectnessFilter);
+    filter->SetSigmaMinimum(1.0);
+    filter->SetSigmaMaximum(4.0);
+    filter->SetNumberOfSigmaSteps(4);
+    filter->GenerateScalesOutputOn();
+    filter->GenerateHessianOutputOn();
+    ITK_TEST_SET_GET_BOOLEAN(filter, FuseHessianComputation, fused == 1);
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+    measures[fused] = filter->GetOutput();
+    scales[fused] = const_cast<typename FilterType::ScalesImageType *>(filter->GetScalesOutput());
+    hessians[fused] = const_cast<HessianImageType *>(filter->GetHessianOutput());
+  }
+
+  const double measureDifference = MaximumDifference(measures[0].GetPointer(), measures[1].GetPointer());
+  const double hessianDifference = MaximumDifference(hessians[0].GetPointer(), hessians[1].GetPointer());
+  unsigned int numberOfDifferentScales = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<typename FilterType::ScalesImageType> it(
+         scales[0], scales[0]->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    numberOfDifferentScales += it.Get() != scales[1]->GetPixel(it.GetIndex()) ? 1 : 0;
+  }
+  const auto numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  std::cout << Dimension << "D, FuseHessianComputation: measure difference " << measureDifference
+            << ", Hessian difference " << hessianDifference << ", " << numberOfDifferentScales << " of "
+            << numberOfPixels << " pixels with different scales" << std::endl;
+
+  if (measureDifference > 1e-3 || hessianDifference > 1e-3 || numberOfDifferentScales > numberOfPixels / 1000)
+  {
+    std::cerr << "The outputs with FuseHessianComputation differ" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
 
 int
 itkMultiScaleHessianBasedMeasureImageFilterTest(int argc, char * argv[])
@@ -304,5 +395,9 @@ itkMultiScaleHessianBasedMeasureImageFilterTest(int argc, char * argv[])
               << std::endl;
   }
 
-  return EXIT_SUCCESS;
+  // The slab by slab computation gives the same outputs as the whole image one
+  int status = CompareFusedHessianComputation(imageReader->GetOutput());
+  status |= CompareFusedHessianComputation(MakeTubesImage<itk::Image<float, 3>>(40).GetPointer());
+
+  return status;
 }
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkStepsWithNoiseImage_h
+#define itkStepsWithNoiseImage_h
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+// Blocks of constant values, stepHeight apart, with Gaussian noise of the
+// given sigma, clamped to [0, 255], used to compare the algorithms of the
+// edge preserving filters. The noise is seeded, so the image is the same on
+// each call. The blocks without noise are returned in noiseFree.
+template <typename TImage>
+typename TImage::Pointer
+MakeStepsWithNoiseImage(const typename TImage::SizeType & size,
+                        double                            stepHeight,
+                        double                            noiseSigma,
+                        typename TImage::Pointer &        noiseFree)
+{
+  auto                              image = TImage::New();
+  const typename TImage::RegionType region(size);
+  image->SetRegions(region);
+  image->Allocate();
+  noiseFree = TImage::New();
+  noiseFree->SetRegions(region);
+  noiseFree->Allocate();
+
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(1234);
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    unsigned int block = 0;
+    for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+    {
+      block += static_cast<unsigned int>(2 * it.GetIndex()[d] / size[d]) << d;
+    }
+    const double value = 30.0 + stepHeight * (block % 3);
+    noiseFree->SetPixel(it.GetIndex(), static_cast<typename TImage::PixelType>(value));
+    it.Set(static_cast<typename TImage::PixelType>(
+      std::min(std::max(value + noiseSigma * generator->GetNormalVariate(), 0.0), 255.0)));
+  }
+  return image;
+}
+
+// The root mean square of the differences of the pixels of two images with
+// the same buffered region.
+template <typename TImage>
+double
+RootMeanSquareDifference(const TImage * image1, const TImage * image2)
+{
+  double sum = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image1, image1->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const double difference = static_cast<double>(it.Get()) - static_cast<double>(image2->GetPixel(it.GetIndex()));
+    sum += difference * difference;
+  }
+  return std::sqrt(sum / static_cast<double>(image1->GetBufferedRegion().GetNumberOfPixels()));
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkTubesImage_h
+#define itkTubesImage_h
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include <cmath>
+
+// Bright tubes of radii 1, 2, ..., one along each axis, in an image of the
+// given size along each axis, 5 pixels wider along the first one, with an
+// anisotropic spacing. Used to compare the modes of the Hessian based filters.
+template <typename TImage>
+typename TImage::Pointer
+MakeTubesImage(unsigned int size)
+{
+  auto image = TImage::New();
+
+  typename TImage::SizeType imageSize;
+  imageSize.Fill(size);
+  imageSize[0] += 5;
+  const typename TImage::RegionType region(imageSize);
+  image->SetRegions(region);
+  typename TImage::SpacingType spacing;
+  for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+  {
+    spacing[d] = 1.0 + 0.25 * d;
+  }
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    double value = 0.0;
+    for (unsigned int axis = 0; axis < TImage::ImageDimension; ++axis)
+    {
+      const double radius = 1.0 + axis;
+      double       squaredDistance = 0.0;
+      for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+      {
+        if (d != axis)
+        {
+          const double offset = (it.GetIndex()[d] - 0.25 * (axis + 1) * size) * spacing[d];
+          squaredDistance += offset * offset;
+        }
+      }
+      value += 100.0 * std::exp(-squaredDistance / (2.0 * radius * radius));
+    }
+    it.Set(static_cast<typename TImage::PixelType>(value));
+  }
+  return image;
+}
+
+#endif
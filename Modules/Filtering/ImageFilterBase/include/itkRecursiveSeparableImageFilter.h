@@ -22,6 +22,8 @@
 #include "itkNumericTraits.h"
 #include "itkVariableLengthVector.h"
 
+#include <type_traits>
+
 namespace itk
 {
 /** \class RecursiveSeparableImageFilter
@@ -45,6 +47,13 @@ namespace itk
  * Filters". J Math Imaging Vis 26, 293–299 (2006).
  * https://doi.org/10.1007/s10851-006-8464-z
  *
+ * For images of scalar pixels, blocks of lines which are adjacent along
+ * another axis are copied to a buffer where their values are interleaved,
+ * and filtered together, so that the recursions of the lines run in the
+ * lanes of vector instructions and the image is read and written a few
+ * pixels at a time along each line, rather than one line at a time with a
+ * stride along the axes other than the first.
+ *
  * \ingroup ImageFilters
  * \ingroup ITKImageFilterBase
  */
@@ -77,6 +86,13 @@ public:
   using ScalarRealType = typename NumericTraits<InputPixelType>::ScalarRealType;
 
   using OutputImageRegionType = typename TOutputImage::RegionType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  /** Whether the lines are filtered in blocks: images of scalar pixels. */
+  static constexpr bool LineBlocksSupportImageTypes =
+    std::is_arithmetic<InputPixelType>::value && std::is_arithmetic<OutputPixelType>::value &&
+    std::is_same<TInputImage, Image<InputPixelType, TInputImage::ImageDimension>>::value &&
+    std::is_same<TOutputImage, Image<OutputPixelType, TOutputImage::ImageDimension>>::value;
 
   /** Type of the input image */
   using InputImageType = TInputImage;
@@ -140,6 +156,21 @@ protected:
   void
   FilterDataArray(RealType * outs, const RealType * data, RealType * scratch, SizeValueType ln) const;
 
+  /** Apply the Recursive Filter to a block of lines of length ln, with the
+   * values of the lines interleaved: the value at position i of line b is at
+   * index i * blockWidth + b of the arrays. The lines are filtered as by
+   * FilterDataArray(). */
+  void
+  FilterDataBlock(RealType *       outs,
+                  const RealType * data,
+                  RealType *       scratch,
+                  SizeValueType    ln,
+                  SizeValueType    blockWidth) const;
+
+  /** Filter the lines of a region one at a time, with FilterDataArray(). */
+  void
+  GenerateDataLineByLine(const OutputImageRegionType & outputRegionForThread);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
@@ -252,6 +283,16 @@ protected:
   }
 
 private:
+  /** Filter the lines of a region in blocks, with FilterDataBlock(). */
+  void
+  GenerateDataInLineBlocks(const OutputImageRegionType & outputRegionForThread, std::true_type);
+
+  void
+  GenerateDataInLineBlocks(const OutputImageRegionType & outputRegionForThread, std::false_type)
+  {
+    this->GenerateDataLineByLine(outputRegionForThread);
+  }
+
   /** Direction in which the filter is to be applied
    * this should be in the range [0,ImageDimension-1]. */
   unsigned int m_Direction{ 0 };
@@ -21,7 +21,9 @@
 #include "itkRecursiveSeparableImageFilter.h"
 #include "itkObjectFactory.h"
 #include "itkImageLinearIteratorWithIndex.h"
+#include "itkIndexRange.h"
 #include <memory> // For unique_ptr
+#include <vector>
 
 namespace itk
 {
@@ -166,6 +168,123 @@ RecursiveSeparableImageFilter<TInputImage, TOutputImage>::FilterDataArray(RealTy
   }
 }
 
+/**
+ * Apply Recursive Filter to interleaved lines
+ */
+template <typename TInputImage, typename TOutputImage>
+void
+RecursiveSeparableImageFilter<TInputImage, TOutputImage>::FilterDataBlock(RealType * const       outs,
+                                                                          const RealType * const data,
+                                                                          RealType * const       scratch,
+                                                                          const SizeValueType    ln,
+                                                                          const SizeValueType    blockWidth) const
+{
+  // The coefficients are copied so that the compiler does not reload them
+  // after each store to the arrays, which keeps the loops over the lines
+  // vectorizable. The operations of each line are those of FilterDataArray().
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+
+  const SizeValueType w = blockWidth;
+
+  /**
+   * Causal direction pass, with the borders initialized as in FilterDataArray()
+   */
+  RealType * const scratch1 = outs;
+  for (SizeValueType b = 0; b < w; ++b)
+  {
+    const RealType   outV1 = data[b];
+    const RealType * x = data + b;
+    RealType *       s = scratch1 + b;
+
+    MathEMAMAMAM(s[0], outV1, n0, outV1, n1, outV1, n2, outV1, n3);
+    MathEMAMAMAM(s[w], x[w], n0, outV1, n1, outV1, n2, outV1, n3);
+    MathEMAMAMAM(s[2 * w], x[2 * w], n0, x[w], n1, outV1, n2, outV1, n3);
+    MathEMAMAMAM(s[3 * w], x[3 * w], n0, x[2 * w], n1, x[w], n2, outV1, n3);
+
+    MathSMAMAMAM(s[0], outV1, m_BN1, outV1, m_BN2, outV1, m_BN3, outV1, m_BN4);
+    MathSMAMAMAM(s[w], s[0], d1, outV1, m_BN2, outV1, m_BN3, outV1, m_BN4);
+    MathSMAMAMAM(s[2 * w], s[w], d1, s[0], d2, outV1, m_BN3, outV1, m_BN4);
+    MathSMAMAMAM(s[3 * w], s[2 * w], d1, s[w], d2, s[0], d3, outV1, m_BN4);
+  }
+
+  for (SizeValueType i = 4; i < ln; ++i)
+  {
+    const RealType * x0 = data + i * w;
+    const RealType * x1 = x0 - w;
+    const RealType * x2 = x1 - w;
+    const RealType * x3 = x2 - w;
+    RealType *       y0 = scratch1 + i * w;
+    const RealType * y1 = y0 - w;
+    const RealType * y2 = y1 - w;
+    const RealType * y3 = y2 - w;
+    const RealType * y4 = y3 - w;
+    for (SizeValueType b = 0; b < w; ++b)
+    {
+      MathEMAMAMAM(y0[b], x0[b], n0, x1[b], n1, x2[b], n2, x3[b], n3);
+      MathSMAMAMAM(y0[b], y1[b], d1, y2[b], d2, y3[b], d3, y4[b], d4);
+    }
+  }
+
+  /**
+   * AntiCausal direction pass
+   */
+  RealType * const scratch2 = scratch;
+  const SizeValueType last = (ln - 1) * w;
+  for (SizeValueType b = 0; b < w; ++b)
+  {
+    const RealType   outV2 = data[last + b];
+    const RealType * x = data + last + b;
+    RealType *       s = scratch2 + last + b;
+
+    MathEMAMAMAM(s[0], outV2, m1, outV2, m2, outV2, m3, outV2, m4);
+    MathEMAMAMAM(*(s - w), x[0], m1, outV2, m2, outV2, m3, outV2, m4);
+    MathEMAMAMAM(*(s - 2 * w), *(x - w), m1, x[0], m2, outV2, m3, outV2, m4);
+    MathEMAMAMAM(*(s - 3 * w), *(x - 2 * w), m1, *(x - w), m2, x[0], m3, outV2, m4);
+
+    MathSMAMAMAM(s[0], outV2, m_BM1, outV2, m_BM2, outV2, m_BM3, outV2, m_BM4);
+    MathSMAMAMAM(*(s - w), s[0], d1, outV2, m_BM2, outV2, m_BM3, outV2, m_BM4);
+    MathSMAMAMAM(*(s - 2 * w), *(s - w), d1, s[0], d2, outV2, m_BM3, outV2, m_BM4);
+    MathSMAMAMAM(*(s - 3 * w), *(s - 2 * w), d1, *(s - w), d2, s[0], d3, outV2, m_BM4);
+  }
+
+  for (SizeValueType i = ln - 4; i > 0; i--)
+  {
+    const RealType * x1 = data + i * w;
+    const RealType * x2 = x1 + w;
+    const RealType * x3 = x2 + w;
+    const RealType * x4 = x3 + w;
+    RealType *       y0 = scratch2 + (i - 1) * w;
+    const RealType * y1 = y0 + w;
+    const RealType * y2 = y1 + w;
+    const RealType * y3 = y2 + w;
+    const RealType * y4 = y3 + w;
+    for (SizeValueType b = 0; b < w; ++b)
+    {
+      MathEMAMAMAM(y0[b], x1[b], m1, x2[b], m2, x3[b], m3, x4[b], m4);
+      MathSMAMAMAM(y0[b], y1[b], d1, y2[b], d2, y3[b], d3, y4[b], d4);
+    }
+  }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for (SizeValueType i = 0; i < ln * w; ++i)
+  {
+    outs[i] += scratch2[i];
+  }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -262,8 +381,14 @@ void
 RecursiveSeparableImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
-  using OutputPixelType = typename TOutputImage::PixelType;
+  this->GenerateDataInLineBlocks(outputRegionForThread, std::integral_constant<bool, LineBlocksSupportImageTypes>{});
+}
 
+template <typename TInputImage, typename TOutputImage>
+void
+RecursiveSeparableImageFilter<TInputImage, TOutputImage>::GenerateDataLineByLine(
+  const OutputImageRegionType & outputRegionForThread)
+{
   using InputConstIteratorType = ImageLinearConstIteratorWithIndex<TInputImage>;
   using OutputIteratorType = ImageLinearIteratorWithIndex<TOutputImage>;
 
@@ -312,6 +437,82 @@ RecursiveSeparableImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerat
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+RecursiveSeparableImageFilter<TInputImage, TOutputImage>::GenerateDataInLineBlocks(
+  const OutputImageRegionType & outputRegionForThread,
+  std::true_type)
+{
+  constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  const TInputImage * inputImage = this->GetInputImage();
+  TOutputImage *      outputImage = this->GetOutput();
+
+  // The lines of a block are adjacent along the first axis, or along the
+  // second one when filtering along the first axis.
+  const unsigned int  direction = this->m_Direction;
+  const unsigned int  blockAxis = (direction == 0 && ImageDimension > 1) ? 1 : 0;
+  const SizeValueType numberOfAdjacentLines =
+    blockAxis == direction ? 1 : outputRegionForThread.GetSize(blockAxis);
+  const SizeValueType ln = outputRegionForThread.GetSize(direction);
+
+  // Blocks of at most 32 lines, whose buffers fit in 192 KB
+  constexpr SizeValueType MaximumBlockWidth = 32;
+  constexpr SizeValueType BlockSizeInBytes = 192 * 1024;
+  const SizeValueType     blockWidth = std::min(
+    numberOfAdjacentLines,
+    std::min(MaximumBlockWidth, std::max<SizeValueType>(1, BlockSizeInBytes / (3 * ln * sizeof(RealType)))));
+
+  std::vector<RealType> inps(ln * blockWidth);
+  std::vector<RealType> outs(ln * blockWidth);
+  std::vector<RealType> scratch(ln * blockWidth);
+
+  const OffsetValueType   inputLineStride = inputImage->GetOffsetTable()[direction];
+  const OffsetValueType   outputLineStride = outputImage->GetOffsetTable()[direction];
+  const OffsetValueType   inputBlockStride = inputImage->GetOffsetTable()[blockAxis];
+  const OffsetValueType   outputBlockStride = outputImage->GetOffsetTable()[blockAxis];
+  const InputPixelType *  inputBuffer = inputImage->GetBufferPointer();
+  OutputPixelType * const outputBuffer = outputImage->GetBufferPointer();
+
+  OutputImageRegionType firstLinesRegion = outputRegionForThread;
+  firstLinesRegion.SetSize(direction, 1);
+  firstLinesRegion.SetSize(blockAxis, 1);
+  for (const auto & firstLineIndex : ImageRegionIndexRange<ImageDimension>(firstLinesRegion))
+  {
+    for (SizeValueType blockStart = 0; blockStart < numberOfAdjacentLines; blockStart += blockWidth)
+    {
+      const SizeValueType w = std::min(blockWidth, numberOfAdjacentLines - blockStart);
+      auto                index = firstLineIndex;
+      index[blockAxis] += static_cast<IndexValueType>(blockStart);
+
+      const InputPixelType * input = inputBuffer + inputImage->ComputeOffset(index);
+      for (SizeValueType i = 0; i < ln; ++i)
+      {
+        const InputPixelType * inputPixels = input + static_cast<OffsetValueType>(i) * inputLineStride;
+        RealType *             inputValues = inps.data() + i * w;
+        for (SizeValueType b = 0; b < w; ++b)
+        {
+          inputValues[b] = inputPixels[static_cast<OffsetValueType>(b) * inputBlockStride];
+        }
+      }
+
+      this->FilterDataBlock(outs.data(), inps.data(), scratch.data(), ln, w);
+
+      OutputPixelType * output = outputBuffer + outputImage->ComputeOffset(index);
+      for (SizeValueType i = 0; i < ln; ++i)
+      {
+        OutputPixelType * outputPixels = output + static_cast<OffsetValueType>(i) * outputLineStride;
+        const RealType *  outputValues = outs.data() + i * w;
+        for (SizeValueType b = 0; b < w; ++b)
+        {
+          outputPixels[static_cast<OffsetValueType>(b) * outputBlockStride] =
+            static_cast<OutputPixelType>(outputValues[b]);
+        }
+      }
+    }
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 RecursiveSeparableImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMultiImageResampleImageFilter_h
+#define itkMultiImageResampleImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class MultiImageResampleImageFilter
+ * \brief Resample several images through the same coordinate transform in
+ * a single pass.
+ *
+ * Co-registered images, like the channels of an acquisition, label maps or
+ * probability maps, are often resampled on the same grid through the same
+ * transform. MultiImageResampleImageFilter transforms each output point once,
+ * and interpolates all the images at the transformed point, rather than
+ * running one ResampleImageFilter per image.
+ *
+ * The first image is the primary input of the filter, and image \c n is
+ * resampled into output \c n. The output grid, the transform and the
+ * extrapolator are set as for ResampleImageFilter, and apply to all images.
+ * Each image may have its own interpolator and default pixel value; an image
+ * without an interpolator of its own uses a new instance of the type of the
+ * interpolator of the filter, with its default settings, and an image
+ * without a default pixel value of its own uses the one of the filter. The
+ * images with the same origin, spacing, direction and buffered region as
+ * the first image share the continuous indices of the transformed points.
+ *
+ * All the images have the same type. An image of vectors, or a VectorImage,
+ * of several channels is resampled as by ResampleImageFilter.
+ *
+ * \sa ResampleImageFilter
+ *
+ * \ingroup GeometricTransform
+ * \ingroup ITKImageGrid
+ */
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType = double,
+          typename TTransformPrecisionType = TInterpolatorPrecisionType>
+class ITK_TEMPLATE_EXPORT MultiImageResampleImageFilter
+  : public ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MultiImageResampleImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = MultiImageResampleImageFilter;
+  using Superclass =
+    ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MultiImageResampleImageFilter, ResampleImageFilter);
+
+  using typename Superclass::InputImageType;
+  using typename Superclass::OutputImageType;
+  using typename Superclass::OutputImageRegionType;
+  using typename Superclass::TransformType;
+  using typename Superclass::InterpolatorType;
+  using typename Superclass::InterpolatorPointerType;
+  using typename Superclass::ExtrapolatorType;
+  using typename Superclass::ExtrapolatorPointerType;
+  using typename Superclass::InputPixelType;
+  using typename Superclass::PixelType;
+  using typename Superclass::InputPointType;
+  using typename Superclass::OutputPointType;
+  using typename Superclass::ContinuousInputIndexType;
+
+  static constexpr unsigned int InputImageDimension = Superclass::InputImageDimension;
+
+  /** Set/Get image \c n. Image 0 is the primary input of the filter.
+   * Setting the last image to nullptr removes it, and the unset images
+   * before it, with their outputs. */
+  void
+  SetImage(unsigned int n, const InputImageType * image);
+  const InputImageType *
+  GetImage(unsigned int n) const;
+
+  /** Get the number of images, which is the number of outputs. */
+  itkGetConstMacro(NumberOfImages, unsigned int);
+
+  /** Set/Get the interpolator of image \c n. The interpolator of image 0 is
+   * the one of the filter. */
+  void
+  SetInterpolator(unsigned int n, InterpolatorType * interpolator);
+  const InterpolatorType *
+  GetInterpolator(unsigned int n) const;
+  using Superclass::SetInterpolator;
+  using Superclass::GetInterpolator;
+
+  /** Set/Get the default pixel value of image \c n. */
+  void
+  SetDefaultPixelValue(unsigned int n, const PixelType & value);
+  const PixelType &
+  GetDefaultPixelValue(unsigned int n) const;
+  using Superclass::SetDefaultPixelValue;
+  using Superclass::GetDefaultPixelValue;
+
+protected:
+  MultiImageResampleImageFilter();
+  ~MultiImageResampleImageFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Check that all the images are set. */
+  void
+  VerifyPreconditions() ITKv5_CONST override;
+
+  /** All outputs have the grid of the first one. */
+  void
+  GenerateOutputInformation() override;
+
+  /** The images other than the first one are requested entirely. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** Connect the images to their interpolators and extrapolators. */
+  void
+  BeforeThreadedGenerateData() override;
+
+  /** Disconnect the images from their interpolators and extrapolators. */
+  void
+  AfterThreadedGenerateData() override;
+
+  /** Compute the Modified Time, including the one of the interpolators of
+   * the images. */
+  ModifiedTimeType
+  GetMTime() const override;
+
+  /** Transform the points of each scan line once, and interpolate each image
+   * at them. */
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** The name of the pipeline input of an image other than the first one. */
+  static std::string
+  MakeImageInputName(unsigned int n);
+
+  /** Compute the continuous indices in an image of the transformed points of
+   * a scan line, and gather the ones inside its buffer, along each dimension.
+   * Returns the number of points inside. */
+  SizeValueType
+  MapScanline(unsigned int                              n,
+              const std::vector<InputPointType> &       inputPoints,
+              std::vector<ContinuousInputIndexType> &   inputIndices,
+              std::vector<bool> &                       isInside,
+              std::vector<TInterpolatorPrecisionType> & batchCoordinates) const;
+
+  unsigned int                                    m_NumberOfImages{ 1 };
+  std::map<unsigned int, InterpolatorPointerType> m_Interpolators;
+  std::map<unsigned int, PixelType>               m_DefaultPixelValues;
+
+  /** The image functions and default pixel values of an update. */
+  std::vector<InterpolatorPointerType> m_ImageInterpolators;
+  std::vector<ExtrapolatorPointerType> m_ImageExtrapolators;
+  std::vector<PixelType>               m_ImageDefaultPixelValues;
+  std::vector<bool>                    m_SharesIndices;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMultiImageResampleImageFilter.hxx"
+#endif
+
+#endif
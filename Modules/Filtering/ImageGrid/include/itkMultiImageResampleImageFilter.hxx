@@ -0,0 +1,510 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMultiImageResampleImageFilter_hxx
+#define itkMultiImageResampleImageFilter_hxx
+
+#include "itkMultiImageResampleImageFilter.h"
+
+#include "itkSpecialCoordinatesImage.h"
+#include "itkImageScanlineIterator.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+#include <string>
+
+namespace itk
+{
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  MultiImageResampleImageFilter() = default;
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+std::string
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  MakeImageInputName(unsigned int n)
+{
+  return "Image" + std::to_string(n);
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::SetImage(
+  unsigned int           n,
+  const InputImageType * image)
+{
+  if (n == 0)
+  {
+    this->SetInput(image);
+    return;
+  }
+
+  if (image == nullptr)
+  {
+    this->ProcessObject::RemoveInput(Self::MakeImageInputName(n));
+    if (n + 1 == m_NumberOfImages)
+    {
+      // Clearing the last image drops it, and the unset images before it,
+      // with their outputs
+      while (m_NumberOfImages > 1 && this->GetImage(m_NumberOfImages - 1) == nullptr)
+      {
+        --m_NumberOfImages;
+      }
+      this->SetNumberOfIndexedOutputs(m_NumberOfImages);
+      this->Modified();
+    }
+    return;
+  }
+
+  // Process object is not const-correct so the const_cast is required here
+  this->ProcessObject::SetInput(Self::MakeImageInputName(n), const_cast<InputImageType *>(image));
+  if (n >= m_NumberOfImages)
+  {
+    // One output per image
+    for (unsigned int i = m_NumberOfImages; i <= n; ++i)
+    {
+      this->SetNthOutput(i, this->MakeOutput(i));
+    }
+    m_NumberOfImages = n + 1;
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::GetImage(
+  unsigned int n) const -> const InputImageType *
+{
+  if (n == 0)
+  {
+    return this->GetInput();
+  }
+  return itkDynamicCastInDebugMode<const InputImageType *>(
+    this->ProcessObject::GetInput(Self::MakeImageInputName(n)));
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  SetInterpolator(unsigned int n, InterpolatorType * interpolator)
+{
+  if (n == 0)
+  {
+    this->SetInterpolator(interpolator);
+    return;
+  }
+  if (interpolator == nullptr)
+  {
+    m_Interpolators.erase(n);
+  }
+  else
+  {
+    m_Interpolators[n] = interpolator;
+  }
+  this->Modified();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetInterpolator(unsigned int n) const -> const InterpolatorType *
+{
+  if (n == 0)
+  {
+    return this->GetInterpolator();
+  }
+  const auto found = m_Interpolators.find(n);
+  return found == m_Interpolators.end() ? nullptr : found->second.GetPointer();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  SetDefaultPixelValue(unsigned int n, const PixelType & value)
+{
+  if (n == 0)
+  {
+    this->SetDefaultPixelValue(value);
+    return;
+  }
+  m_DefaultPixelValues[n] = value;
+  this->Modified();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+auto
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetDefaultPixelValue(unsigned int n) const -> const PixelType &
+{
+  const auto found = m_DefaultPixelValues.find(n);
+  return (n == 0 || found == m_DefaultPixelValues.end()) ? this->GetDefaultPixelValue() : found->second;
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  VerifyPreconditions() ITKv5_CONST
+{
+  Superclass::VerifyPreconditions();
+
+  for (unsigned int n = 1; n < m_NumberOfImages; ++n)
+  {
+    if (this->GetImage(n) == nullptr)
+    {
+      itkExceptionMacro(<< "Image " << n << " of " << m_NumberOfImages << " is not set.");
+    }
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  const OutputImageType * firstOutput = this->GetOutput();
+  for (unsigned int n = 1; n < m_NumberOfImages; ++n)
+  {
+    OutputImageType * output = this->GetOutput(n);
+    output->SetLargestPossibleRegion(firstOutput->GetLargestPossibleRegion());
+    output->SetSpacing(firstOutput->GetSpacing());
+    output->SetOrigin(firstOutput->GetOrigin());
+    output->SetDirection(firstOutput->GetDirection());
+    output->SetNumberOfComponentsPerPixel(this->GetImage(n)->GetNumberOfComponentsPerPixel());
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  for (unsigned int n = 1; n < m_NumberOfImages; ++n)
+  {
+    const_cast<InputImageType *>(this->GetImage(n))->SetRequestedRegionToLargestPossibleRegion();
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  InterpolatorType *     firstInterpolator = this->GetModifiableInterpolator();
+  ExtrapolatorType *     firstExtrapolator = this->GetModifiableExtrapolator();
+  const InputImageType * firstImage = this->GetInput();
+
+  m_ImageInterpolators.assign(m_NumberOfImages, nullptr);
+  m_ImageExtrapolators.assign(m_NumberOfImages, nullptr);
+  m_ImageDefaultPixelValues.assign(m_NumberOfImages, this->GetDefaultPixelValue());
+  m_SharesIndices.assign(m_NumberOfImages, true);
+  m_ImageInterpolators[0] = firstInterpolator;
+  m_ImageExtrapolators[0] = firstExtrapolator;
+
+  for (unsigned int n = 1; n < m_NumberOfImages; ++n)
+  {
+    const InputImageType * image = this->GetImage(n);
+
+    // Image functions hold their image, so that each image needs its own
+    const auto found = m_Interpolators.find(n);
+    if (found != m_Interpolators.end())
+    {
+      m_ImageInterpolators[n] = found->second;
+    }
+    else
+    {
+      m_ImageInterpolators[n] = dynamic_cast<InterpolatorType *>(firstInterpolator->CreateAnother().GetPointer());
+    }
+    m_ImageInterpolators[n]->SetInputImage(image);
+    if (firstExtrapolator != nullptr)
+    {
+      m_ImageExtrapolators[n] = dynamic_cast<ExtrapolatorType *>(firstExtrapolator->CreateAnother().GetPointer());
+      m_ImageExtrapolators[n]->SetInputImage(image);
+    }
+
+    PixelType & defaultPixelValue = m_ImageDefaultPixelValues[n];
+    defaultPixelValue = this->GetDefaultPixelValue(n);
+    const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+    if (NumericTraits<PixelType>::GetLength(defaultPixelValue) != numberOfComponents)
+    {
+      // A variable length default value takes the length of the pixels of
+      // the image
+      NumericTraits<PixelType>::SetLength(defaultPixelValue, numberOfComponents);
+      defaultPixelValue = NumericTraits<PixelType>::ZeroValue(defaultPixelValue);
+    }
+
+    m_SharesIndices[n] = image->GetOrigin() == firstImage->GetOrigin() &&
+                         image->GetSpacing() == firstImage->GetSpacing() &&
+                         image->GetDirection() == firstImage->GetDirection() &&
+                         image->GetBufferedRegion() == firstImage->GetBufferedRegion();
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  AfterThreadedGenerateData()
+{
+  Superclass::AfterThreadedGenerateData();
+
+  for (unsigned int n = 1; n < m_NumberOfImages; ++n)
+  {
+    m_ImageInterpolators[n]->SetInputImage(nullptr);
+    if (m_ImageExtrapolators[n])
+    {
+      m_ImageExtrapolators[n]->SetInputImage(nullptr);
+    }
+  }
+  m_ImageInterpolators.clear();
+  m_ImageExtrapolators.clear();
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+ModifiedTimeType
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  GetMTime() const
+{
+  ModifiedTimeType latestTime = Superclass::GetMTime();
+  for (const auto & interpolator : m_Interpolators)
+  {
+    latestTime = std::max(latestTime, interpolator.second->GetMTime());
+  }
+  return latestTime;
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+SizeValueType
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  MapScanline(unsigned int                              n,
+              const std::vector<InputPointType> &       inputPoints,
+              std::vector<ContinuousInputIndexType> &   inputIndices,
+              std::vector<bool> &                       isInside,
+              std::vector<TInterpolatorPrecisionType> & batchCoordinates) const
+{
+  using InputSpecialCoordinatesImageType = SpecialCoordinatesImage<InputPixelType, InputImageDimension>;
+
+  const InputImageType *   image = this->GetImage(n);
+  const InterpolatorType * interpolator = m_ImageInterpolators[n];
+  const bool isSpecialCoordinatesImage = dynamic_cast<const InputSpecialCoordinatesImageType *>(image) != nullptr;
+
+  const SizeValueType lineLength = inputPoints.size();
+  SizeValueType       numberInside = 0;
+  for (SizeValueType i = 0; i < lineLength; ++i)
+  {
+    // Honor the SpecialCoordinatesImage isInside value returned
+    // by TransformPhysicalPointToContinuousIndex
+    const bool isInsideImage = image->TransformPhysicalPointToContinuousIndex(inputPoints[i], inputIndices[i]);
+    isInside[i] = interpolator->IsInsideBuffer(inputIndices[i]) && (!isSpecialCoordinatesImage || isInsideImage);
+    if (isInside[i])
+    {
+      for (unsigned int j = 0; j < InputImageDimension; ++j)
+      {
+        batchCoordinates[j * lineLength + numberInside] = inputIndices[i][j];
+      }
+      ++numberInside;
+    }
+  }
+  return numberInside;
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  using OutputType = typename InterpolatorType::OutputType;
+
+  if (outputRegionForThread.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  const OutputImageType * firstOutput = this->GetOutput();
+  const TransformType *   transformPtr = this->GetTransform();
+
+  TotalProgressReporter progress(this, firstOutput->GetRequestedRegion().GetNumberOfPixels());
+
+  std::vector<ImageScanlineIterator<TOutputImage>> outputIterators;
+  for (unsigned int n = 0; n < m_NumberOfImages; ++n)
+  {
+    outputIterators.emplace_back(this->GetOutput(n), outputRegionForThread);
+  }
+
+  // The transformed points of a scan line, their continuous indices in the
+  // first image, and in the image being interpolated when it does not share
+  // them
+  const SizeValueType                     lineLength = outputRegionForThread.GetSize(0);
+  std::vector<InputPointType>             inputPoints(lineLength);
+  std::vector<ContinuousInputIndexType>   sharedIndices(lineLength);
+  std::vector<bool>                       sharedIsInside(lineLength);
+  std::vector<TInterpolatorPrecisionType> sharedCoordinates(InputImageDimension * lineLength);
+  std::vector<ContinuousInputIndexType>   ownIndices(lineLength);
+  std::vector<bool>                       ownIsInside(lineLength);
+  std::vector<TInterpolatorPrecisionType> ownCoordinates(InputImageDimension * lineLength);
+  std::vector<OutputType>                 batchValues(lineLength);
+
+  typename InterpolatorType::ContinuousIndexBatchType sharedBatchIndices;
+  typename InterpolatorType::ContinuousIndexBatchType ownBatchIndices;
+  for (unsigned int j = 0; j < InputImageDimension; ++j)
+  {
+    sharedBatchIndices[j] = sharedCoordinates.data() + j * lineLength;
+    ownBatchIndices[j] = ownCoordinates.data() + j * lineLength;
+  }
+
+  OutputPointType outputPoint;
+  while (!outputIterators[0].IsAtEnd())
+  {
+    typename OutputImageType::IndexType index = outputIterators[0].GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
+    {
+      firstOutput->TransformIndexToPhysicalPoint(index, outputPoint);
+      inputPoints[i] = transformPtr->TransformPoint(outputPoint);
+    }
+    const SizeValueType sharedNumberInside =
+      this->MapScanline(0, inputPoints, sharedIndices, sharedIsInside, sharedCoordinates);
+
+    for (unsigned int n = 0; n < m_NumberOfImages; ++n)
+    {
+      const bool sharesIndices = m_SharesIndices[n];
+      const SizeValueType numberInside =
+        sharesIndices ? sharedNumberInside : this->MapScanline(n, inputPoints, ownIndices, ownIsInside, ownCoordinates);
+      const auto & inputIndices = sharesIndices ? sharedIndices : ownIndices;
+      const auto & isInside = sharesIndices ? sharedIsInside : ownIsInside;
+
+      m_ImageInterpolators[n]->EvaluateAtContinuousIndices(
+        sharesIndices ? sharedBatchIndices : ownBatchIndices, numberInside, batchValues.data());
+
+      const ExtrapolatorType * extrapolator = m_ImageExtrapolators[n];
+      const PixelType &        defaultPixelValue = m_ImageDefaultPixelValues[n];
+      auto &                   outIt = outputIterators[n];
+      SizeValueType            batchIndex = 0;
+      for (SizeValueType i = 0; i < lineLength; ++i, ++outIt)
+      {
+        if (isInside[i])
+        {
+          outIt.Set(Superclass::CastPixelWithBoundsChecking(batchValues[batchIndex++]));
+        }
+        else if (extrapolator == nullptr)
+        {
+          outIt.Set(defaultPixelValue);
+        }
+        else
+        {
+          const OutputType value = extrapolator->EvaluateAtContinuousIndex(inputIndices[i]);
+          outIt.Set(Superclass::CastPixelWithBoundsChecking(value));
+        }
+      }
+      outIt.NextLine();
+    }
+    progress.Completed(lineLength);
+  }
+}
+
+
+template <typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType>
+void
+MultiImageResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType>::
+  PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfImages: " << m_NumberOfImages << std::endl;
+  for (const auto & interpolator : m_Interpolators)
+  {
+    os << indent << "Interpolator of image " << interpolator.first << ": " << interpolator.second.GetPointer()
+       << std::endl;
+  }
+  for (const auto & defaultPixelValue : m_DefaultPixelValues)
+  {
+    os << indent << "DefaultPixelValue of image " << defaultPixelValue.first << ": "
+       << static_cast<typename NumericTraits<PixelType>::PrintType>(defaultPixelValue.second) << std::endl;
+  }
+}
+
+} // end namespace itk
+
+#endif
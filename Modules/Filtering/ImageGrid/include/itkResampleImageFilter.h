@@ -349,6 +349,15 @@ protected:
                                                                const ComponentType          minComponent,
                                                                const ComponentType          maxComponent) const);
 
+  /** Cast an interpolated value to PixelType, clamping each component to the
+   * range of the output pixel components. */
+  static PixelType
+  CastPixelWithBoundsChecking(const ComponentType value);
+
+  template <typename TPixel>
+  static PixelType
+  CastPixelWithBoundsChecking(const TPixel value);
+
 private:
   static PixelComponentType
   CastComponentWithBoundsChecking(const PixelComponentType value);
@@ -357,13 +366,6 @@ private:
   static PixelComponentType
   CastComponentWithBoundsChecking(const TComponent value);
 
-  static PixelType
-  CastPixelWithBoundsChecking(const ComponentType value);
-
-  template <typename TPixel>
-  static PixelType
-  CastPixelWithBoundsChecking(const TPixel value);
-
   void
   InitializeTransform();
 
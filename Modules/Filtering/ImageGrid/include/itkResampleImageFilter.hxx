@@ -28,6 +28,8 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkImageAlgorithm.h"
 
+#include <algorithm>
+#include <cmath>
 #include <type_traits> // For is_same.
 
 namespace itk
@@ -383,7 +385,7 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
 
   // Create an iterator that will walk the output region for this thread.
-  using OutputIterator = ImageRegionIteratorWithIndex<TOutputImage>;
+  using OutputIterator = ImageScanlineIterator<TOutputImage>;
   OutputIterator outIt(outputPtr, outputRegionForThread);
 
   // Define a few indices that will be used to translate from an input pixel
@@ -391,43 +393,70 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
   OutputPointType outputPoint; // Coordinates of current output pixel
   InputPointType  inputPoint;  // Coordinates of current input pixel
 
-  ContinuousInputIndexType inputIndex;
-
   using OutputType = typename InterpolatorType::OutputType;
 
-  // Walk the output region
-  outIt.GoToBegin();
+  // The input positions of a scan line which are inside the input buffer
+  // are interpolated as one batch
+  const SizeValueType                                 lineLength = outputRegionForThread.GetSize(0);
+  std::vector<ContinuousInputIndexType>               inputIndices(lineLength);
+  std::vector<bool>                                   isInside(lineLength);
+  std::vector<TInterpolatorPrecisionType>             batchCoordinates(InputImageDimension * lineLength);
+  typename InterpolatorType::ContinuousIndexBatchType batchIndices;
+  for (unsigned int j = 0; j < InputImageDimension; ++j)
+  {
+    batchIndices[j] = batchCoordinates.data() + j * lineLength;
+  }
+  std::vector<OutputType> batchValues(lineLength);
 
+  // Walk the output region
   while (!outIt.IsAtEnd())
   {
-    // Determine the index of the current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
+    IndexType     index = outIt.GetIndex();
+    SizeValueType numberInside = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
+    {
+      // Determine the index of the current output pixel
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
 
-    // Compute corresponding input pixel position
-    inputPoint = transformPtr->TransformPoint(outputPoint);
-    const bool isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+      // Compute corresponding input pixel position
+      inputPoint = transformPtr->TransformPoint(outputPoint);
+      const bool isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndices[i]);
 
-    OutputType value;
-    // Evaluate input at right position and copy to the output
-    if (m_Interpolator->IsInsideBuffer(inputIndex) && (!isSpecialCoordinatesImage || isInsideInput))
-    {
-      value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-      outIt.Set(Self::CastPixelWithBoundsChecking(value));
+      isInside[i] = m_Interpolator->IsInsideBuffer(inputIndices[i]) && (!isSpecialCoordinatesImage || isInsideInput);
+      if (isInside[i])
+      {
+        for (unsigned int j = 0; j < InputImageDimension; ++j)
+        {
+          batchCoordinates[j * lineLength + numberInside] = inputIndices[i][j];
+        }
+        ++numberInside;
+      }
     }
-    else
+
+    // Evaluate input at right positions and copy to the output
+    m_Interpolator->EvaluateAtContinuousIndices(batchIndices, numberInside, batchValues.data());
+    SizeValueType batchIndex = 0;
+    for (SizeValueType i = 0; i < lineLength; ++i, ++outIt)
     {
-      if (m_Extrapolator.IsNull())
+      if (isInside[i])
       {
-        outIt.Set(m_DefaultPixelValue); // default background value
+        outIt.Set(Self::CastPixelWithBoundsChecking(batchValues[batchIndex++]));
       }
       else
       {
-        value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndex);
-        outIt.Set(Self::CastPixelWithBoundsChecking(value));
+        if (m_Extrapolator.IsNull())
+        {
+          outIt.Set(m_DefaultPixelValue); // default background value
+        }
+        else
+        {
+          const OutputType value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndices[i]);
+          outIt.Set(Self::CastPixelWithBoundsChecking(value));
+        }
       }
     }
-    progress.CompletedPixel();
-    ++outIt;
+    outIt.NextLine();
+    progress.Completed(lineLength);
   }
 }
 
@@ -475,6 +504,29 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
       transformPtr->TransformPoint(outputPtr->template TransformIndexToPhysicalPoint<double>(index)));
   };
 
+  // The bounds of the input buffer, as checked by IsInsideBuffer
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  ContinuousInputIndexType                    bufferStart;
+  ContinuousInputIndexType                    bufferEnd;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    bufferStart[i] = bufferedRegion.GetIndex(i) - 0.5;
+    bufferEnd[i] = bufferedRegion.GetIndex(i) + static_cast<IndexValueType>(bufferedRegion.GetSize(i)) - 0.5;
+  }
+
+  using OutputType = typename InterpolatorType::OutputType;
+
+  // The input positions of a scan line which are inside the input buffer
+  // are interpolated as one batch
+  const SizeValueType                                 lineLength = outputRegionForThread.GetSize(0);
+  std::vector<TInterpolatorPrecisionType>             batchCoordinates(InputImageDimension * lineLength);
+  typename InterpolatorType::ContinuousIndexBatchType batchIndices;
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    batchIndices[i] = batchCoordinates.data() + i * lineLength;
+  }
+  std::vector<OutputType> batchValues(lineLength);
+
   while (!outIt.IsAtEnd())
   {
     // Determine the continuous index of the first and end pixel of output
@@ -487,13 +539,8 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
     index[0] += firstSizeValueOfLargestPossibleRegion;
     const auto vectorFromStartIndex = transformIndex(index) - startIndex;
 
-    IndexValueType scanlineIndex = outIt.GetIndex()[0];
-
-
-    while (!outIt.IsAtEndOfLine())
-    {
-
-      // Perform linear interpolation from startIndex, along vectorFromStartIndex
+    // Perform linear interpolation from startIndex, along vectorFromStartIndex
+    const auto inputIndexAt = [&](IndexValueType scanlineIndex) {
       const double alpha =
         (scanlineIndex - firstIndexValueOfLargestPossibleRegion) / firstSizeValueOfLargestPossibleRegion;
 
@@ -502,29 +549,104 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
       {
         inputIndex[i] += alpha * vectorFromStartIndex[i];
       }
+      return inputIndex;
+    };
+    const auto isInsideBuffer = [this, &inputIndexAt](IndexValueType scanlineIndex) {
+      return m_Interpolator->IsInsideBuffer(inputIndexAt(scanlineIndex));
+    };
+
+    // Clip the scan line against the input buffer once, solving for the
+    // range of alpha over which each input coordinate is inside it.
+    double alphaBegin = NumericTraits<double>::NonpositiveMin();
+    double alphaEnd = NumericTraits<double>::max();
+    for (unsigned int i = 0; i < InputImageDimension; ++i)
+    {
+      if (vectorFromStartIndex[i] != 0.0)
+      {
+        const double alphaStart = (bufferStart[i] - startIndex[i]) / vectorFromStartIndex[i];
+        const double alphaStop = (bufferEnd[i] - startIndex[i]) / vectorFromStartIndex[i];
+        alphaBegin = std::max(alphaBegin, std::min(alphaStart, alphaStop));
+        alphaEnd = std::min(alphaEnd, std::max(alphaStart, alphaStop));
+      }
+      else if (!(startIndex[i] >= bufferStart[i] && startIndex[i] < bufferEnd[i]))
+      {
+        alphaEnd = NumericTraits<double>::NonpositiveMin();
+      }
+    }
+    const IndexValueType lineBegin = outIt.GetIndex()[0];
+    const IndexValueType lineEnd = lineBegin + static_cast<IndexValueType>(lineLength);
+    const auto           clampToLine = [lineBegin, lineEnd](double scanlineIndex) {
+      return static_cast<IndexValueType>(
+        std::min(std::max(scanlineIndex, static_cast<double>(lineBegin)), static_cast<double>(lineEnd)));
+    };
+    IndexValueType insideBegin = clampToLine(
+      std::floor(firstIndexValueOfLargestPossibleRegion + alphaBegin * firstSizeValueOfLargestPossibleRegion) - 1.0);
+    IndexValueType insideEnd = std::max(
+      insideBegin,
+      clampToLine(std::ceil(firstIndexValueOfLargestPossibleRegion + alphaEnd * firstSizeValueOfLargestPossibleRegion) +
+                  1.0));
+
+    // The positions inside the buffer form a single range of the scan line,
+    // so the estimate, which is padded against rounding, only needs to be
+    // corrected at its ends. This also honors interpolators that override
+    // IsInsideBuffer.
+    while (insideBegin < insideEnd && !isInsideBuffer(insideBegin))
+    {
+      ++insideBegin;
+    }
+    while (insideEnd > insideBegin && !isInsideBuffer(insideEnd - 1))
+    {
+      --insideEnd;
+    }
+    while (insideBegin > lineBegin && isInsideBuffer(insideBegin - 1))
+    {
+      --insideBegin;
+    }
+    while (insideEnd < lineEnd && isInsideBuffer(insideEnd))
+    {
+      ++insideEnd;
+    }
 
-      // Evaluate input at right position and copy to the output
-      if (m_Interpolator->IsInsideBuffer(inputIndex))
+    const auto setOutside = [this, &outIt, &inputIndexAt, defaultValue](IndexValueType scanlineIndex) {
+      if (m_Extrapolator.IsNull())
       {
-        outIt.Set(Self::CastPixelWithBoundsChecking(m_Interpolator->EvaluateAtContinuousIndex(inputIndex)));
+        outIt.Set(defaultValue); // default background value
       }
       else
       {
-        if (m_Extrapolator.IsNull())
-        {
-          outIt.Set(defaultValue); // default background value
-        }
-        else
-        {
-          outIt.Set(Self::CastPixelWithBoundsChecking(m_Extrapolator->EvaluateAtContinuousIndex(inputIndex)));
-        }
+        const OutputType value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndexAt(scanlineIndex));
+        outIt.Set(Self::CastPixelWithBoundsChecking(value));
       }
+    };
 
-      ++outIt;
-      ++scanlineIndex;
+    IndexValueType scanlineIndex = lineBegin;
+    for (; scanlineIndex < insideBegin; ++scanlineIndex, ++outIt)
+    {
+      setOutside(scanlineIndex);
+    }
+
+    // Evaluate input at right positions and copy to the output
+    const auto numberInside = static_cast<SizeValueType>(insideEnd - insideBegin);
+    for (SizeValueType n = 0; n < numberInside; ++n)
+    {
+      const ContinuousInputIndexType inputIndex = inputIndexAt(insideBegin + static_cast<IndexValueType>(n));
+      for (unsigned int i = 0; i < InputImageDimension; ++i)
+      {
+        batchCoordinates[i * lineLength + n] = inputIndex[i];
+      }
+    }
+    m_Interpolator->EvaluateAtContinuousIndices(batchIndices, numberInside, batchValues.data());
+    for (SizeValueType n = 0; n < numberInside; ++n, ++scanlineIndex, ++outIt)
+    {
+      outIt.Set(Self::CastPixelWithBoundsChecking(batchValues[n]));
+    }
+
+    for (; scanlineIndex < lineEnd; ++scanlineIndex, ++outIt)
+    {
+      setOutside(scanlineIndex);
     }
     outIt.NextLine();
-    progress.Completed(outputRegionForThread.GetSize()[0]);
+    progress.Completed(lineLength);
   }
 }
 
@@ -0,0 +1,254 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiImageResampleImageFilter.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+/* Each output of MultiImageResampleImageFilter, compared to the output of a
+ * ResampleImageFilter with the settings of its image.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using MultiResampleFilterType = itk::MultiImageResampleImageFilter<ImageType, ImageType>;
+using ResampleFilterType = itk::ResampleImageFilter<ImageType, ImageType>;
+
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::IndexType & start, double frequency, double originShift)
+{
+  auto                                 image = TImage::New();
+  const typename TImage::SizeType      size = { { 29, 23, 17 } };
+  const typename TImage::RegionType    region(start, size);
+  typename TImage::PointType           origin;
+  origin.Fill(originShift);
+  image->SetRegions(region);
+  image->SetOrigin(origin);
+  image->SetNumberOfComponentsPerPixel(1);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const typename TImage::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(100.0 * std::sin(frequency * index[0]) * std::cos(0.2 * index[1]) + 3.0 * index[2]));
+  }
+  return image;
+}
+
+template <typename TFilter, typename TImage>
+void
+SetUpFilter(TFilter * filter, const typename TFilter::TransformType * transform)
+{
+  const typename TImage::SizeType  outputSize = { { 37, 21, 19 } };
+  const typename TImage::IndexType outputStart = { { -6, 1, 2 } };
+  typename TImage::SpacingType     outputSpacing;
+  outputSpacing[0] = 0.9;
+  outputSpacing[1] = 1.2;
+  outputSpacing[2] = 1.0;
+  filter->SetTransform(transform);
+  filter->SetSize(outputSize);
+  filter->SetOutputStartIndex(outputStart);
+  filter->SetOutputSpacing(outputSpacing);
+}
+
+int
+CompareImages(const std::string & name, const ImageType * output, const ImageType * expected)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(output, output->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const float expectedValue = expected->GetPixel(it.GetIndex());
+    if (std::abs(it.Get() - expectedValue) > 1e-3)
+    {
+      std::cerr << name << ": resampled value " << it.Get() << " at " << it.GetIndex() << " differs from "
+                << expectedValue << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+int
+CompareToResample(const std::string & name, MultiResampleFilterType * multiResample)
+{
+  std::cout << name << std::endl;
+  ITK_TRY_EXPECT_NO_EXCEPTION(multiResample->Update());
+
+  int status = EXIT_SUCCESS;
+  for (unsigned int n = 0; n < multiResample->GetNumberOfImages(); ++n)
+  {
+    auto resample = ResampleFilterType::New();
+    SetUpFilter<ResampleFilterType, ImageType>(resample, multiResample->GetTransform());
+    resample->SetInput(multiResample->GetImage(n));
+    resample->SetDefaultPixelValue(multiResample->GetDefaultPixelValue(n));
+    if (multiResample->GetInterpolator(n) != nullptr)
+    {
+      resample->SetInterpolator(const_cast<ResampleFilterType::InterpolatorType *>(multiResample->GetInterpolator(n)));
+    }
+    if (multiResample->GetExtrapolator() != nullptr)
+    {
+      resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(resample->Update());
+    status |= CompareImages(name + ", image " + std::to_string(n), multiResample->GetOutput(n), resample->GetOutput());
+  }
+  return status;
+}
+
+} // namespace
+
+int
+itkMultiImageResampleImageFilterTest(int, char *[])
+{
+  auto multiResample = MultiResampleFilterType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(multiResample, MultiImageResampleImageFilter, ResampleImageFilter);
+
+  // Two images on the same grid, and one on another grid
+  const ImageType::IndexType start = { { -3, 2, 5 } };
+  const ImageType::IndexType otherStart = { { 0, -1, 4 } };
+  multiResample->SetImage(0, MakeImage<ImageType>(start, 0.3, 0.0));
+  multiResample->SetImage(1, MakeImage<ImageType>(start, 0.45, 0.0));
+  multiResample->SetImage(2, MakeImage<ImageType>(otherStart, 0.3, 1.7));
+  ITK_TEST_EXPECT_EQUAL(multiResample->GetNumberOfImages(), 3u);
+  ITK_TEST_EXPECT_EQUAL(multiResample->GetNumberOfIndexedOutputs(), 3u);
+
+  multiResample->SetInterpolator(1, itk::NearestNeighborInterpolateImageFunction<ImageType, double>::New());
+  ITK_TEST_EXPECT_TRUE(multiResample->GetInterpolator(2) == nullptr);
+  multiResample->SetDefaultPixelValue(-1000.0f);
+  multiResample->SetDefaultPixelValue(2, -7.0f);
+  ITK_TEST_EXPECT_EQUAL(multiResample->GetDefaultPixelValue(1), -1000.0f);
+  ITK_TEST_EXPECT_EQUAL(multiResample->GetDefaultPixelValue(2), -7.0f);
+
+  // A non-linear transform
+  using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+  auto                                         bspline = BSplineTransformType::New();
+  BSplineTransformType::OriginType             domainOrigin;
+  BSplineTransformType::PhysicalDimensionsType domainSize;
+  BSplineTransformType::MeshSizeType           meshSize;
+  domainOrigin.Fill(-10.0);
+  domainSize.Fill(50.0);
+  meshSize.Fill(4);
+  bspline->SetTransformDomainOrigin(domainOrigin);
+  bspline->SetTransformDomainPhysicalDimensions(domainSize);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  BSplineTransformType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.size(); ++i)
+  {
+    parameters[i] = 2.0 * std::sin(0.7 * i);
+  }
+  bspline->SetParametersByValue(parameters);
+  SetUpFilter<MultiResampleFilterType, ImageType>(multiResample, bspline);
+
+  int status = EXIT_SUCCESS;
+  status |= CompareToResample("B-spline transform", multiResample);
+
+  // A linear transform
+  auto                                                       affine = itk::AffineTransform<double, Dimension>::New();
+  itk::AffineTransform<double, Dimension>::OutputVectorType translation;
+  translation[0] = -4.3;
+  translation[1] = 6.1;
+  translation[2] = 3.7;
+  affine->Translate(translation);
+  affine->Rotate(0, 1, 0.21);
+  multiResample->SetTransform(affine);
+  status |= CompareToResample("Affine transform", multiResample);
+
+  multiResample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+  status |= CompareToResample("Affine transform, extrapolated", multiResample);
+
+  // Images of a variable number of components
+  using VectorImageType = itk::VectorImage<float, Dimension>;
+  auto vectorResample = itk::MultiImageResampleImageFilter<VectorImageType, VectorImageType>::New();
+  SetUpFilter<itk::MultiImageResampleImageFilter<VectorImageType, VectorImageType>, VectorImageType>(vectorResample,
+                                                                                                      affine);
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    auto image = VectorImageType::New();
+    image->SetRegions(VectorImageType::RegionType(start, VectorImageType::SizeType{ { 29, 23, 17 } }));
+    image->SetNumberOfComponentsPerPixel(n + 2);
+    image->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<VectorImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      VectorImageType::PixelType pixel(n + 2);
+      for (unsigned int c = 0; c < n + 2; ++c)
+      {
+        pixel[c] = static_cast<float>(it.GetIndex()[c % Dimension] + 10 * c);
+      }
+      it.Set(pixel);
+    }
+    vectorResample->SetImage(n, image);
+  }
+  std::cout << "Vector images" << std::endl;
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorResample->Update());
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    const VectorImageType * output = vectorResample->GetOutput(n);
+    ITK_TEST_EXPECT_EQUAL(output->GetNumberOfComponentsPerPixel(), n + 2);
+
+    auto resample = itk::ResampleImageFilter<VectorImageType, VectorImageType>::New();
+    SetUpFilter<itk::ResampleImageFilter<VectorImageType, VectorImageType>, VectorImageType>(resample, affine);
+    resample->SetInput(vectorResample->GetImage(n));
+    ITK_TRY_EXPECT_NO_EXCEPTION(resample->Update());
+    for (itk::ImageRegionConstIteratorWithIndex<VectorImageType> it(output, output->GetLargestPossibleRegion());
+         !it.IsAtEnd();
+         ++it)
+    {
+      const VectorImageType::PixelType expected = resample->GetOutput()->GetPixel(it.GetIndex());
+      for (unsigned int c = 0; c < n + 2; ++c)
+      {
+        if (std::abs(it.Get()[c] - expected[c]) > 1e-3)
+        {
+          std::cerr << "Vector image " << n << ": resampled value " << it.Get() << " at " << it.GetIndex()
+                    << " differs from " << expected << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // All the images up to the last one are required
+  auto incomplete = MultiResampleFilterType::New();
+  incomplete->SetImage(0, multiResample->GetImage(0));
+  incomplete->SetImage(2, multiResample->GetImage(2));
+  SetUpFilter<MultiResampleFilterType, ImageType>(incomplete, affine);
+  ITK_TRY_EXPECT_EXCEPTION(incomplete->Update());
+
+  // Clearing an image before the last one keeps the number of images, and
+  // clearing the last one also drops the unset images before it
+  incomplete->SetImage(1, multiResample->GetImage(1));
+  incomplete->SetImage(1, nullptr);
+  ITK_TEST_EXPECT_EQUAL(incomplete->GetNumberOfImages(), 3u);
+  incomplete->SetImage(2, nullptr);
+  ITK_TEST_EXPECT_EQUAL(incomplete->GetNumberOfImages(), 1u);
+  ITK_TEST_EXPECT_EQUAL(incomplete->GetNumberOfIndexedOutputs(), 1u);
+  ITK_TEST_EXPECT_TRUE(incomplete->GetImage(2) == nullptr);
+  ITK_TRY_EXPECT_NO_EXCEPTION(incomplete->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkNearestNeighborExtrapolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* The scan line fast path of ResampleImageFilter for linear transforms,
+ * compared to the interpolation of each output point mapped by the transform.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using TransformType = itk::AffineTransform<double, Dimension>;
+using ResampleFilterType = itk::ResampleImageFilter<ImageType, ImageType>;
+
+int
+CompareToPointwise(const std::string & name, ResampleFilterType * resample, const ImageType * input)
+{
+  std::cout << name << std::endl;
+  ITK_TRY_EXPECT_NO_EXCEPTION(resample->UpdateLargestPossibleRegion());
+
+  const ImageType *                         output = resample->GetOutput();
+  const ResampleFilterType::TransformType * transform = resample->GetTransform();
+
+  // The filter disconnects its image functions from the input once done
+  auto * interpolator = resample->GetModifiableInterpolator();
+  auto * extrapolator = resample->GetModifiableExtrapolator();
+  interpolator->SetInputImage(input);
+  if (extrapolator)
+  {
+    extrapolator->SetInputImage(input);
+  }
+
+  unsigned int numberInside = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(output, output->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto inputIndex = input->TransformPhysicalPointToContinuousIndex<double>(
+      transform->TransformPoint(output->TransformIndexToPhysicalPoint<double>(it.GetIndex())));
+    double expected = resample->GetDefaultPixelValue();
+    if (interpolator->IsInsideBuffer(inputIndex))
+    {
+      expected = interpolator->EvaluateAtContinuousIndex(inputIndex);
+      ++numberInside;
+    }
+    else if (extrapolator)
+    {
+      expected = extrapolator->EvaluateAtContinuousIndex(inputIndex);
+    }
+    if (std::abs(it.Get() - expected) > 1e-3)
+    {
+      std::cerr << "Resampled value " << it.Get() << " at " << it.GetIndex() << " differs from " << expected
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The output covers both the inside and the outside of the input
+  ITK_TEST_EXPECT_TRUE(numberInside > 0);
+  ITK_TEST_EXPECT_TRUE(numberInside < output->GetLargestPossibleRegion().GetNumberOfPixels());
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkResampleImageTest9(int, char *[])
+{
+  // A smooth image with a non-zero start index
+  auto                        image = ImageType::New();
+  const ImageType::IndexType  start = { { -3, 2, 5 } };
+  const ImageType::SizeType   size = { { 41, 37, 29 } };
+  const ImageType::RegionType region(start, size);
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(100.0 * std::sin(0.3 * index[0]) * std::cos(0.2 * index[1]) + 3.0 * index[2]));
+  }
+
+  auto resample = ResampleFilterType::New();
+  resample->SetInput(image);
+  resample->SetDefaultPixelValue(-1000.0f);
+
+  auto bspline = itk::BSplineInterpolateImageFunction<ImageType, double>::New();
+  resample->SetInterpolator(bspline);
+
+  int status = EXIT_SUCCESS;
+
+  // Output scan lines that are not aligned with the input axes, and cross the
+  // borders of the input
+  auto                            affine = TransformType::New();
+  TransformType::OutputVectorType translation;
+  translation[0] = -4.3;
+  translation[1] = 6.1;
+  translation[2] = 3.7;
+  affine->Translate(translation);
+  affine->Rotate(0, 1, 0.31);
+  affine->Rotate(1, 2, -0.17);
+  resample->SetTransform(affine);
+  const ImageType::SizeType outputSize = { { 53, 31, 23 } };
+  resample->SetSize(outputSize);
+  const ImageType::IndexType outputStart = { { -9, 1, 2 } };
+  resample->SetOutputStartIndex(outputStart);
+  status |= CompareToPointwise("Rotated, cubic B-spline", resample, image);
+
+  // Scan lines along an input axis, upsampled, which are interpolated
+  // separably
+  auto                            scaling = TransformType::New();
+  TransformType::OutputVectorType scale;
+  scale[0] = 0.55;
+  scale[1] = 0.8;
+  scale[2] = 1.3;
+  scaling->Scale(scale);
+  scaling->Translate(translation);
+  resample->SetTransform(scaling);
+  status |= CompareToPointwise("Scaled, cubic B-spline", resample, image);
+
+  // Scan lines along an input axis, downsampled
+  scale[0] = 2.7;
+  scaling->SetIdentity();
+  scaling->Scale(scale);
+  scaling->Translate(translation);
+  status |= CompareToPointwise("Downsampled, cubic B-spline", resample, image);
+
+  // Other interpolators and extrapolation
+  auto linearBSpline = itk::BSplineInterpolateImageFunction<ImageType, double>::New();
+  linearBSpline->SetSplineOrder(1);
+  resample->SetInterpolator(linearBSpline);
+  status |= CompareToPointwise("Scaled, linear B-spline", resample, image);
+
+  resample->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  resample->SetTransform(affine);
+  status |= CompareToPointwise("Rotated, linear", resample, image);
+
+  resample->SetExtrapolator(itk::NearestNeighborExtrapolateImageFunction<ImageType, double>::New());
+  status |= CompareToPointwise("Rotated, linear, extrapolated", resample, image);
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
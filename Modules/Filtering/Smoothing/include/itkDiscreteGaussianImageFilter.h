@@ -21,9 +21,41 @@
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkGaussianOperator.h"
+#include "ITKSmoothingExport.h"
+
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
+/**\class DiscreteGaussianImageFilterEnums
+ * \brief Contains all enum classes used by DiscreteGaussianImageFilter class.
+ * \ingroup ITKSmoothing
+ */
+class DiscreteGaussianImageFilterEnums
+{
+public:
+  /**\class ConvolutionAlgorithm
+   * \ingroup ITKSmoothing
+   * How the 1D kernels are applied to the image. */
+  enum class ConvolutionAlgorithm : uint8_t
+  {
+    /** Direct or FFT, chosen for each axis from the kernel width, when the
+     * image types support it, NeighborhoodOperator otherwise. */
+    Automatic = 0,
+    /** A pipeline of NeighborhoodOperatorImageFilter, one for each axis. */
+    NeighborhoodOperator = 1,
+    /** Blocks of lines convolved in a buffer with the kernel. */
+    Direct = 2,
+    /** Blocks of lines convolved in a buffer by FFT. */
+    FFT = 3
+  };
+};
+// Define how to print enumeration
+extern ITKSmoothing_EXPORT std::ostream &
+                           operator<<(std::ostream & out, const DiscreteGaussianImageFilterEnums::ConvolutionAlgorithm value);
+
 /**
  * \class DiscreteGaussianImageFilter
  * \brief Blurs an image by separable convolution with discrete gaussian kernels.
@@ -44,6 +76,13 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * For images of scalar pixels with the default boundary conditions, the
+ * kernels are applied axis by axis to blocks of adjacent lines, copied in a
+ * small buffer, and written back to a single intermediate image, rather than
+ * through a pipeline of NeighborhoodOperatorImageFilter which allocates an
+ * image for each axis. Along an axis with a wide kernel, the lines are
+ * convolved by FFT instead. See SetConvolutionAlgorithm().
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -113,6 +152,31 @@ public:
   using SigmaArrayType = ArrayType;
   using ScalarRealType = double;
 
+  using ConvolutionAlgorithmEnum = DiscreteGaussianImageFilterEnums::ConvolutionAlgorithm;
+
+  /** Whether the Direct and FFT algorithms support the image types: images
+   * of scalar pixels. */
+  static constexpr bool SeparableConvolutionSupportsImageTypes =
+    std::is_arithmetic<InputPixelType>::value && std::is_arithmetic<OutputPixelType>::value &&
+    std::is_same<TInputImage, Image<InputPixelType, ImageDimension>>::value &&
+    std::is_same<TOutputImage, Image<OutputPixelType, ImageDimension>>::value;
+
+  /** Set/Get how the kernels are applied. Default is Automatic. Direct and FFT
+   * throw an exception at update when the image types do not support them, or
+   * when a boundary condition is set. */
+  itkSetEnumMacro(ConvolutionAlgorithm, ConvolutionAlgorithmEnum);
+  itkGetConstMacro(ConvolutionAlgorithm, ConvolutionAlgorithmEnum);
+
+  /** Whether the kernels are applied by the Direct or FFT algorithm, rather
+   * than by NeighborhoodOperatorImageFilter. */
+  bool
+  UsesSeparableConvolution() const;
+
+  /** Whether the Automatic algorithm convolves by FFT along an axis, given
+   * the width of the kernel and the length of the lines. */
+  static bool
+  FFTIsFaster(SizeValueType kernelWidth, SizeValueType lineLength);
+
   /** The variance for the discrete Gaussian kernel.  Sets the variance
    * independently for each dimension, but
    * see also SetVariance(const double v). The default is 0.0 in each
@@ -328,13 +392,40 @@ protected:
 
   /** Standard pipeline method. While this class does not implement a
    * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
-   * multithreaded by default. */
+   * calculations to an NeighborhoodOperatorImageFilter, or to its own
+   * line by line convolution, which are multithreaded. */
   void
   GenerateData() override;
 
 private:
+  using OperatorType = GaussianOperator<RealOutputPixelValueType, ImageDimension>;
+  using RegionType = typename TOutputImage::RegionType;
+
+  /** Apply the operators, from the last axis to the first, line by line. */
+  void
+  SeparableConvolutionGenerateData(const InputImageType *            input,
+                                   const std::vector<OperatorType> & operators,
+                                   std::true_type);
+
+  void
+  SeparableConvolutionGenerateData(const InputImageType *, const std::vector<OperatorType> &, std::false_type)
+  {}
+
+  /** Convolve the lines of lineRegion along an axis, read from the source
+   * buffer, and write them to the destination buffer, which may be the same. */
+  template <typename TSourcePixel, typename TDestinationPixel>
+  void
+  ConvolveLines(const TSourcePixel *                          source,
+                const RegionType &                            sourceRegion,
+                TDestinationPixel *                           destination,
+                const RegionType &                            destinationRegion,
+                const RegionType &                            lineRegion,
+                unsigned int                                  axis,
+                const std::vector<RealOutputPixelValueType> & kernel,
+                bool                                          useFFT);
+
+  ConvolutionAlgorithmEnum m_ConvolutionAlgorithm{ ConvolutionAlgorithmEnum::Automatic };
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
@@ -24,6 +24,12 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
 #include "itkImageAlgorithm.h"
+#include "itkIndexRange.h"
+#include "vnl/algo/vnl_fft_1d.h"
+
+#include <cmath>
+#include <complex>
+#include <memory>
 
 namespace itk
 {
@@ -109,10 +115,41 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRe
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+bool
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::UsesSeparableConvolution() const
+{
+  return SeparableConvolutionSupportsImageTypes &&
+         m_ConvolutionAlgorithm != ConvolutionAlgorithmEnum::NeighborhoodOperator &&
+         m_InputBoundaryCondition == &m_InputDefaultBoundaryCondition &&
+         m_RealBoundaryCondition == &m_RealDefaultBoundaryCondition;
+}
+
+template <typename TInputImage, typename TOutputImage>
+bool
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::FFTIsFaster(SizeValueType kernelWidth,
+                                                                    SizeValueType lineLength)
+{
+  // The direct convolution costs a multiply-add per pixel and per kernel
+  // coefficient, the FFT of a padded line about ten times its length times
+  // the logarithm of its length, as measured for the vnl FFT.
+  const auto paddedLineLength = static_cast<double>(lineLength + kernelWidth);
+  return static_cast<double>(lineLength) * static_cast<double>(kernelWidth) >
+         10.0 * paddedLineLength * std::log2(paddedLineLength);
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
+  if ((m_ConvolutionAlgorithm == ConvolutionAlgorithmEnum::Direct ||
+       m_ConvolutionAlgorithm == ConvolutionAlgorithmEnum::FFT) &&
+      !this->UsesSeparableConvolution())
+  {
+    itkExceptionMacro(<< "The " << m_ConvolutionAlgorithm
+                      << " algorithm requires images of scalar pixels and the default boundary conditions");
+  }
+
   TOutputImage * output = this->GetOutput();
 
   output->SetBufferedRegion(output->GetRequestedRegion());
@@ -161,8 +198,6 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   using SingleFilterPointer = typename SingleFilterType::Pointer;
 
   // Create a series of operators
-  using OperatorType = GaussianOperator<RealOutputPixelValueType, ImageDimension>;
-
   std::vector<OperatorType> oper;
   oper.resize(filterDimensionality);
 
@@ -204,6 +239,13 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
     oper[reverse_i].CreateDirectional();
   }
 
+  if (this->UsesSeparableConvolution())
+  {
+    this->SeparableConvolutionGenerateData(
+      localInput, oper, std::integral_constant<bool, SeparableConvolutionSupportsImageTypes>{});
+    return;
+  }
+
   // Create a chain of filters
   //
   //
@@ -300,6 +342,300 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::SeparableConvolutionGenerateData(
+  const InputImageType *            input,
+  const std::vector<OperatorType> & operators,
+  std::true_type)
+{
+  OutputImageType * output = this->GetOutput();
+
+  // The operators are ordered from the last axis to the first. The output
+  // region of each of them is the requested region, padded along the axes
+  // of the following operators.
+  const auto              numberOfStages = static_cast<unsigned int>(operators.size());
+  std::vector<RegionType> stageRegions(numberOfStages, output->GetRequestedRegion());
+  for (unsigned int stage = 0; stage < numberOfStages; ++stage)
+  {
+    const unsigned int axis = numberOfStages - 1 - stage;
+    typename RegionType::SizeType radius;
+    radius.Fill(0);
+    for (unsigned int previousAxis = 0; previousAxis < axis; ++previousAxis)
+    {
+      radius[previousAxis] = operators[numberOfStages - 1 - previousAxis].GetRadius(previousAxis);
+    }
+    stageRegions[stage].PadByRadius(radius);
+    stageRegions[stage].Crop(output->GetLargestPossibleRegion());
+  }
+
+  // All the operators but the last one convolve in place an intermediate
+  // image, which has the pixel type of the output as with the
+  // NeighborhoodOperatorImageFilter pipeline.
+  typename RealOutputImageType::Pointer intermediate;
+  if (numberOfStages > 1)
+  {
+    intermediate = RealOutputImageType::New();
+    intermediate->SetRegions(stageRegions[0]);
+    intermediate->Allocate();
+  }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  for (unsigned int stage = 0; stage < numberOfStages; ++stage)
+  {
+    const unsigned int                          axis = numberOfStages - 1 - stage;
+    const std::vector<RealOutputPixelValueType> kernel(operators[stage].Begin(), operators[stage].End());
+    const bool useFFT =
+      m_ConvolutionAlgorithm == ConvolutionAlgorithmEnum::FFT ||
+      (m_ConvolutionAlgorithm == ConvolutionAlgorithmEnum::Automatic &&
+       FFTIsFaster(kernel.size(), stageRegions[stage].GetSize(axis)));
+
+    const bool first = stage == 0;
+    const bool last = stage + 1 == numberOfStages;
+    if (first && last)
+    {
+      this->ConvolveLines(input->GetBufferPointer(),
+                          input->GetBufferedRegion(),
+                          output->GetBufferPointer(),
+                          output->GetBufferedRegion(),
+                          stageRegions[stage],
+                          axis,
+                          kernel,
+                          useFFT);
+    }
+    else if (first)
+    {
+      this->ConvolveLines(input->GetBufferPointer(),
+                          input->GetBufferedRegion(),
+                          intermediate->GetBufferPointer(),
+                          intermediate->GetBufferedRegion(),
+                          stageRegions[stage],
+                          axis,
+                          kernel,
+                          useFFT);
+    }
+    else if (last)
+    {
+      this->ConvolveLines(intermediate->GetBufferPointer(),
+                          intermediate->GetBufferedRegion(),
+                          output->GetBufferPointer(),
+                          output->GetBufferedRegion(),
+                          stageRegions[stage],
+                          axis,
+                          kernel,
+                          useFFT);
+    }
+    else
+    {
+      this->ConvolveLines(intermediate->GetBufferPointer(),
+                          intermediate->GetBufferedRegion(),
+                          intermediate->GetBufferPointer(),
+                          intermediate->GetBufferedRegion(),
+                          stageRegions[stage],
+                          axis,
+                          kernel,
+                          useFFT);
+    }
+    this->UpdateProgress(static_cast<float>(stage + 1) / numberOfStages);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TSourcePixel, typename TDestinationPixel>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::ConvolveLines(
+  const TSourcePixel *                          source,
+  const RegionType &                            sourceRegion,
+  TDestinationPixel *                           destination,
+  const RegionType &                            destinationRegion,
+  const RegionType &                            lineRegion,
+  unsigned int                                  axis,
+  const std::vector<RealOutputPixelValueType> & kernel,
+  bool                                          useFFT)
+{
+  using RealType = RealOutputPixelValueType;
+  using ComplexType = std::complex<RealType>;
+
+  const auto          kernelRadius = static_cast<IndexValueType>(kernel.size() / 2);
+  const SizeValueType lineLength = lineRegion.GetSize(axis);
+  const SizeValueType paddedLineLength = lineLength + kernel.size() - 1;
+
+  // The pixels outside of the source region have the value of the nearest
+  // pixel inside, as with the ZeroFluxNeumannBoundaryCondition.
+  const IndexValueType firstSourceIndex = sourceRegion.GetIndex(axis);
+  const IndexValueType lastSourceIndex = firstSourceIndex + static_cast<IndexValueType>(sourceRegion.GetSize(axis)) - 1;
+
+  OffsetValueType sourceStrides[ImageDimension];
+  OffsetValueType destinationStrides[ImageDimension];
+  sourceStrides[0] = 1;
+  destinationStrides[0] = 1;
+  for (unsigned int d = 1; d < ImageDimension; ++d)
+  {
+    sourceStrides[d] = sourceStrides[d - 1] * static_cast<OffsetValueType>(sourceRegion.GetSize(d - 1));
+    destinationStrides[d] =
+      destinationStrides[d - 1] * static_cast<OffsetValueType>(destinationRegion.GetSize(d - 1));
+  }
+
+  // The FFT length is the smallest product of 2, 3 and 5, supported by vnl,
+  // which holds a padded line. The convolution is circular, but the padding
+  // is as long as the kernel so that the lines do not wrap around.
+  SizeValueType fftLength = 0;
+  if (useFFT)
+  {
+    for (fftLength = paddedLineLength;; ++fftLength)
+    {
+      SizeValueType remainder = fftLength;
+      for (const SizeValueType factor : { 2, 3, 5 })
+      {
+        while (remainder % factor == 0)
+        {
+          remainder /= factor;
+        }
+      }
+      if (remainder == 1)
+      {
+        break;
+      }
+    }
+  }
+
+  // Along the first axis, the lines are convolved one at a time. Along the
+  // other axes, blocks of lines which are adjacent along the first axis are
+  // convolved together, so that the buffers are read and written with unit
+  // stride, and the kernel is applied to the whole block at once.
+  constexpr SizeValueType BlockSizeInBytes = 64 * 1024;
+  const SizeValueType     maximumBlockWidth =
+    axis == 0 ? 1 : std::max<SizeValueType>(1, BlockSizeInBytes / ((paddedLineLength + lineLength) * sizeof(RealType)));
+
+  const auto convolvePiece = [&](const RegionType & piece) {
+    const SizeValueType numberOfAdjacentLines = axis == 0 ? 1 : piece.GetSize(0);
+    const SizeValueType blockWidth = std::min(maximumBlockWidth, numberOfAdjacentLines);
+    std::vector<RealType> block(paddedLineLength * blockWidth);
+    std::vector<RealType> convolvedBlock(lineLength * blockWidth);
+
+    std::vector<ComplexType> fftKernel;
+    std::vector<ComplexType> fftLine;
+    std::unique_ptr<vnl_fft_1d<RealType>> fft;
+    if (useFFT)
+    {
+      // The kernel at negative shifts, so that the circular convolution of
+      // a padded line gives the inner products of the kernel with the pixels.
+      fft = std::make_unique<vnl_fft_1d<RealType>>(static_cast<int>(fftLength));
+      fftKernel.assign(fftLength, ComplexType());
+      for (SizeValueType k = 0; k < kernel.size(); ++k)
+      {
+        fftKernel[(fftLength - k) % fftLength] = kernel[k] / static_cast<RealType>(fftLength);
+      }
+      fft->fwd_transform(fftKernel.data());
+      fftLine.resize(fftLength);
+    }
+
+    RegionType outerRegion = piece;
+    outerRegion.SetSize(axis, 1);
+    outerRegion.SetSize(0, 1);
+    for (const auto & outerIndex : ImageRegionIndexRange<ImageDimension>(outerRegion))
+    {
+      for (SizeValueType blockStart = 0; blockStart < numberOfAdjacentLines; blockStart += blockWidth)
+      {
+        const SizeValueType width = std::min(blockWidth, numberOfAdjacentLines - blockStart);
+        auto                index = outerIndex;
+        index[0] += static_cast<IndexValueType>(blockStart);
+
+        OffsetValueType sourceOffset = 0;
+        OffsetValueType destinationOffset = 0;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          if (d != axis)
+          {
+            sourceOffset += (index[d] - sourceRegion.GetIndex(d)) * sourceStrides[d];
+            destinationOffset += (index[d] - destinationRegion.GetIndex(d)) * destinationStrides[d];
+          }
+        }
+
+        // Copy the block of padded lines, each line a column of the block
+        for (SizeValueType i = 0; i < paddedLineLength; ++i)
+        {
+          const IndexValueType lineIndex = std::min(
+            std::max(index[axis] - kernelRadius + static_cast<IndexValueType>(i), firstSourceIndex), lastSourceIndex);
+          const TSourcePixel * sourcePixels =
+            source + sourceOffset + (lineIndex - firstSourceIndex) * sourceStrides[axis];
+          RealType * blockRow = block.data() + i * width;
+          for (SizeValueType b = 0; b < width; ++b)
+          {
+            blockRow[b] = static_cast<RealType>(sourcePixels[b]);
+          }
+        }
+
+        const SizeValueType numberOfConvolvedValues = lineLength * width;
+        if (useFFT)
+        {
+          // Two lines at a time, as the real and imaginary parts of a
+          // complex line, since the kernel is real.
+          for (SizeValueType b = 0; b < width; b += 2)
+          {
+            const bool pair = b + 1 < width;
+            for (SizeValueType i = 0; i < paddedLineLength; ++i)
+            {
+              fftLine[i] = ComplexType(block[i * width + b], pair ? block[i * width + b + 1] : RealType{});
+            }
+            std::fill(fftLine.begin() + paddedLineLength, fftLine.end(), ComplexType());
+            fft->fwd_transform(fftLine.data());
+            for (SizeValueType i = 0; i < fftLength; ++i)
+            {
+              fftLine[i] *= fftKernel[i];
+            }
+            fft->bwd_transform(fftLine.data());
+            for (SizeValueType j = 0; j < lineLength; ++j)
+            {
+              convolvedBlock[j * width + b] = fftLine[j].real();
+              if (pair)
+              {
+                convolvedBlock[j * width + b + 1] = fftLine[j].imag();
+              }
+            }
+          }
+        }
+        else
+        {
+          // The coefficients are accumulated in the order of the inner
+          // product of NeighborhoodOperatorImageFilter.
+          RealType *       convolved = convolvedBlock.data();
+          const RealType * rows = block.data();
+          for (SizeValueType m = 0; m < numberOfConvolvedValues; ++m)
+          {
+            convolved[m] = kernel[0] * rows[m];
+          }
+          for (SizeValueType k = 1; k < kernel.size(); ++k)
+          {
+            const RealType   coefficient = kernel[k];
+            const RealType * shiftedRows = rows + k * width;
+            for (SizeValueType m = 0; m < numberOfConvolvedValues; ++m)
+            {
+              convolved[m] += coefficient * shiftedRows[m];
+            }
+          }
+        }
+
+        // Write the block of lines
+        for (SizeValueType j = 0; j < lineLength; ++j)
+        {
+          const IndexValueType lineIndex = index[axis] + static_cast<IndexValueType>(j);
+          TDestinationPixel *  destinationPixels =
+            destination + destinationOffset + (lineIndex - destinationRegion.GetIndex(axis)) * destinationStrides[axis];
+          const RealType * convolvedRow = convolvedBlock.data() + j * width;
+          for (SizeValueType b = 0; b < width; ++b)
+          {
+            destinationPixels[b] = static_cast<TDestinationPixel>(convolvedRow[b]);
+          }
+        }
+      }
+    }
+  };
+
+  this->GetMultiThreader()->template ParallelizeImageRegionRestrictDirection<ImageDimension>(
+    axis, lineRegion, convolvePiece, nullptr);
+}
+
 #if !defined(ITK_LEGACY_REMOVE)
 template <typename TInputImage, typename TOutputImage>
 unsigned int
@@ -330,6 +666,7 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream &
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
   os << indent << "RealBoundaryCondition: " << m_RealBoundaryCondition << std::endl;
+  os << indent << "ConvolutionAlgorithm: " << m_ConvolutionAlgorithm << std::endl;
 }
 } // end namespace itk
 
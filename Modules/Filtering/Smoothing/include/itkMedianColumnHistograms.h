@@ -0,0 +1,238 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMedianColumnHistograms_h
+#define itkMedianColumnHistograms_h
+
+#include "itkIntTypes.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace itk
+{
+/** \class MedianColumnHistograms
+ * \brief Column histograms and kernel histogram of the histogram algorithm of MedianImageFilter.
+ *
+ * The pixels of the neighborhood of a pixel are split in columns, one for
+ * each position along the first axis. Each column has a histogram, which is
+ * updated by adding and removing pixels as the neighborhood moves along the
+ * other axes, and the histogram of the neighborhood, the kernel histogram,
+ * is the sum of the histograms of its columns, updated by adding the column
+ * which enters the neighborhood and removing the one which leaves it as the
+ * neighborhood moves along the first axis.
+ *
+ * Each histogram has one bin per value of the pixel type, which must be an
+ * integral type of at most 16 bits, and coarse bins which count the pixels
+ * of groups of consecutive bins. The kernel histogram only keeps its coarse
+ * bins up to date, and updates the fine bins of a group when the median
+ * falls into it, from the columns which entered and left the neighborhood
+ * since the last update of the group.
+ *
+ * See S. Perreault and P. Hebert, "Median Filtering in Constant Time",
+ * IEEE Transactions on Image Processing, 16(9), pp. 2389-2394, 2007.
+ *
+ * \ingroup ITKSmoothing
+ */
+template <typename TPixel>
+class MedianColumnHistograms
+{
+public:
+  static_assert(std::is_integral<TPixel>::value && sizeof(TPixel) <= 2,
+                "MedianColumnHistograms requires an integral pixel type of at most 16 bits");
+
+  using PixelType = TPixel;
+  using CountType = uint32_t;
+
+  /** Number of fine bins in a coarse bin, and number of coarse bins. */
+  static constexpr unsigned int BitsPerCoarseBin = 4 * sizeof(TPixel);
+  static constexpr SizeValueType NumberOfFineBinsPerCoarseBin = SizeValueType{ 1 } << BitsPerCoarseBin;
+  static constexpr SizeValueType NumberOfCoarseBins = NumberOfFineBinsPerCoarseBin;
+  static constexpr SizeValueType NumberOfBins = NumberOfCoarseBins * NumberOfFineBinsPerCoarseBin;
+
+  /** Memory used by the histogram of a column, in bytes. */
+  static constexpr SizeValueType ColumnSizeInBytes = (NumberOfCoarseBins + NumberOfBins) * sizeof(CountType);
+
+  /** Create the histograms of a number of columns, initially empty. */
+  explicit MedianColumnHistograms(SizeValueType numberOfColumns)
+    : m_NumberOfColumns(numberOfColumns)
+    , m_Columns(numberOfColumns * (NumberOfCoarseBins + NumberOfBins), 0)
+    , m_KernelCoarse(NumberOfCoarseBins, 0)
+    , m_KernelFine(NumberOfBins, 0)
+    , m_FineFirstColumn(NumberOfCoarseBins, 0)
+    , m_FineEndColumn(NumberOfCoarseBins, 0)
+  {}
+
+  SizeValueType
+  GetNumberOfColumns() const
+  {
+    return m_NumberOfColumns;
+  }
+
+  /** Add a pixel value to, or remove it from, the histogram of a column. */
+  void
+  AddToColumn(SizeValueType column, PixelType value)
+  {
+    const SizeValueType bin = Bin(value);
+    CountType *         columnHistogram = this->Column(column);
+    ++columnHistogram[bin >> BitsPerCoarseBin];
+    ++columnHistogram[NumberOfCoarseBins + bin];
+  }
+
+  void
+  RemoveFromColumn(SizeValueType column, PixelType value)
+  {
+    const SizeValueType bin = Bin(value);
+    CountType *         columnHistogram = this->Column(column);
+    --columnHistogram[bin >> BitsPerCoarseBin];
+    --columnHistogram[NumberOfCoarseBins + bin];
+  }
+
+  /** Empty the kernel histogram. The next column added to it is firstColumn. */
+  void
+  StartKernel(SizeValueType firstColumn)
+  {
+    std::fill(m_KernelCoarse.begin(), m_KernelCoarse.end(), 0);
+    std::fill(m_FineFirstColumn.begin(), m_FineFirstColumn.end(), 0);
+    std::fill(m_FineEndColumn.begin(), m_FineEndColumn.end(), 0);
+    m_KernelFirstColumn = firstColumn;
+    m_KernelEndColumn = firstColumn;
+  }
+
+  /** Add the column which follows the last column of the kernel histogram. */
+  void
+  AddNextColumnToKernel()
+  {
+    const CountType * columnCoarse = this->Column(m_KernelEndColumn);
+    for (SizeValueType c = 0; c < NumberOfCoarseBins; ++c)
+    {
+      m_KernelCoarse[c] += columnCoarse[c];
+    }
+    ++m_KernelEndColumn;
+  }
+
+  /** Remove the first column of the kernel histogram. */
+  void
+  RemoveFirstColumnFromKernel()
+  {
+    const CountType * columnCoarse = this->Column(m_KernelFirstColumn);
+    for (SizeValueType c = 0; c < NumberOfCoarseBins; ++c)
+    {
+      m_KernelCoarse[c] -= columnCoarse[c];
+    }
+    ++m_KernelFirstColumn;
+  }
+
+  /** Get the value of a rank, from 0, of the pixels of the kernel histogram. */
+  PixelType
+  GetKernelValue(SizeValueType rank)
+  {
+    SizeValueType below = 0;
+    SizeValueType coarse = 0;
+    while (below + m_KernelCoarse[coarse] <= rank)
+    {
+      below += m_KernelCoarse[coarse];
+      ++coarse;
+    }
+
+    const CountType * fine = this->UpdateKernelFine(coarse);
+    SizeValueType     bin = 0;
+    while (below + fine[bin] <= rank)
+    {
+      below += fine[bin];
+      ++bin;
+    }
+    return Value((coarse << BitsPerCoarseBin) + bin);
+  }
+
+private:
+  static constexpr PixelType MinimumValue = std::numeric_limits<PixelType>::min();
+
+  static SizeValueType
+  Bin(PixelType value)
+  {
+    return static_cast<SizeValueType>(static_cast<int>(value) - static_cast<int>(MinimumValue));
+  }
+
+  static PixelType
+  Value(SizeValueType bin)
+  {
+    return static_cast<PixelType>(static_cast<int>(bin) + static_cast<int>(MinimumValue));
+  }
+
+  CountType *
+  Column(SizeValueType column)
+  {
+    return m_Columns.data() + column * (NumberOfCoarseBins + NumberOfBins);
+  }
+
+  /** Bring the fine bins of a coarse bin of the kernel histogram up to date
+   * with its columns. The kernel only moves forward between calls of
+   * StartKernel(), so the columns from the first column of the last update
+   * are removed, and the columns up to the end column are added. */
+  const CountType *
+  UpdateKernelFine(SizeValueType coarse)
+  {
+    CountType *         fine = m_KernelFine.data() + coarse * NumberOfFineBinsPerCoarseBin;
+    const SizeValueType columnOffset = NumberOfCoarseBins + coarse * NumberOfFineBinsPerCoarseBin;
+
+    SizeValueType & firstColumn = m_FineFirstColumn[coarse];
+    SizeValueType & endColumn = m_FineEndColumn[coarse];
+    if (endColumn <= m_KernelFirstColumn)
+    {
+      // No column in common: start from an empty group of bins
+      std::fill(fine, fine + NumberOfFineBinsPerCoarseBin, 0);
+      firstColumn = m_KernelFirstColumn;
+      endColumn = m_KernelFirstColumn;
+    }
+    for (; firstColumn < m_KernelFirstColumn; ++firstColumn)
+    {
+      const CountType * columnFine = this->Column(firstColumn) + columnOffset;
+      for (SizeValueType b = 0; b < NumberOfFineBinsPerCoarseBin; ++b)
+      {
+        fine[b] -= columnFine[b];
+      }
+    }
+    for (; endColumn < m_KernelEndColumn; ++endColumn)
+    {
+      const CountType * columnFine = this->Column(endColumn) + columnOffset;
+      for (SizeValueType b = 0; b < NumberOfFineBinsPerCoarseBin; ++b)
+      {
+        fine[b] += columnFine[b];
+      }
+    }
+    return fine;
+  }
+
+  SizeValueType          m_NumberOfColumns;
+  std::vector<CountType> m_Columns;
+
+  std::vector<CountType> m_KernelCoarse;
+  std::vector<CountType> m_KernelFine;
+  SizeValueType          m_KernelFirstColumn{ 0 };
+  SizeValueType          m_KernelEndColumn{ 0 };
+
+  /** Columns of the kernel histogram when the fine bins of each coarse bin
+   * were last updated. */
+  std::vector<SizeValueType> m_FineFirstColumn;
+  std::vector<SizeValueType> m_FineEndColumn;
+};
+} // end namespace itk
+
+#endif
@@ -20,9 +20,41 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkMedianColumnHistograms.h"
+#include "ITKSmoothingExport.h"
+
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
+/**\class MedianImageFilterEnums
+ * \brief Contains all enum classes used by MedianImageFilter class.
+ * \ingroup ITKSmoothing
+ */
+class MedianImageFilterEnums
+{
+public:
+  /**\class Algorithm
+   * \ingroup ITKSmoothing
+   * Algorithm used to compute the median of each neighborhood. */
+  enum class Algorithm : uint8_t
+  {
+    /** Histogram when the pixel type supports it and the neighborhood is
+     * large enough for it to be faster, Sort otherwise. */
+    Automatic = 0,
+    /** Partial sort of the pixels of each neighborhood. */
+    Sort = 1,
+    /** Sliding column histograms, for integral pixel types of at most 16 bits. */
+    Histogram = 2
+  };
+};
+// Define how to print enumeration
+extern ITKSmoothing_EXPORT std::ostream &
+                           operator<<(std::ostream & out, const MedianImageFilterEnums::Algorithm value);
+
 /**
  *\class MedianImageFilter
  * \brief Applies a median filter to an image
@@ -36,6 +68,15 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * Two algorithms compute the median. The Sort algorithm partially sorts the
+ * pixels of each neighborhood, at a cost proportional to the size of the
+ * neighborhood. The Histogram algorithm, for integral pixel types of at
+ * most 16 bits, keeps a histogram of each column of pixels along the first
+ * axis, and slides the histogram of the neighborhood from column to column
+ * (see MedianColumnHistograms), at a cost which does not depend on the
+ * radius along the first two axes. By default, the algorithm is chosen from
+ * the pixel type and the size of the neighborhood. Both give the same output.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -84,6 +125,23 @@ public:
 
   using InputSizeType = typename InputImageType::SizeType;
 
+  using AlgorithmEnum = MedianImageFilterEnums::Algorithm;
+
+  /** Whether the Histogram algorithm supports the input pixel type. */
+  static constexpr bool HistogramAlgorithmSupportsPixelType = std::is_integral<InputPixelType>::value &&
+                                                              !std::is_same<InputPixelType, bool>::value &&
+                                                              sizeof(InputPixelType) <= 2;
+
+  /** Set/Get the algorithm. Default is Automatic. Histogram throws an
+   * exception at update when the pixel type does not support it. */
+  itkSetEnumMacro(Algorithm, AlgorithmEnum);
+  itkGetConstMacro(Algorithm, AlgorithmEnum);
+
+  /** Whether the Histogram algorithm is used, given the algorithm, the
+   * input pixel type and the radius. */
+  bool
+  UsesHistogramAlgorithm() const;
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
@@ -96,6 +154,15 @@ protected:
   MedianImageFilter();
   ~MedianImageFilter() override = default;
 
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  BeforeThreadedGenerateData() override;
+
+  void
+  AfterThreadedGenerateData() override;
+
   /** MedianImageFilter can be implemented as a multithreaded filter.
    * Therefore, this implementation provides a ThreadedGenerateData()
    * routine which is called for each processing thread. The output
@@ -108,6 +175,36 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** The column histograms of the Histogram algorithm. The pixel type is a
+   * placeholder when the algorithm does not support the input pixel type. */
+  using HistogramsType =
+    MedianColumnHistograms<std::conditional_t<HistogramAlgorithmSupportsPixelType, InputPixelType, uint8_t>>;
+
+  /** Take column histograms of at least a number of columns from the ones
+   * released by the chunks already processed, or allocate them, and give
+   * them back once they are empty again. */
+  std::unique_ptr<HistogramsType>
+  AcquireHistograms(SizeValueType numberOfColumns);
+
+  void
+  ReleaseHistograms(std::unique_ptr<HistogramsType> histograms);
+
+  void
+  SortThreadedGenerateData(const OutputImageRegionType & outputRegionForThread);
+
+  void
+  HistogramThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type);
+
+  void
+  HistogramThreadedGenerateData(const OutputImageRegionType &, std::false_type)
+  {}
+
+  AlgorithmEnum m_Algorithm{ AlgorithmEnum::Automatic };
+
+  std::vector<std::unique_ptr<HistogramsType>> m_ReleasedHistograms;
+  std::mutex                                   m_HistogramsMutex;
 };
 } // end namespace itk
 
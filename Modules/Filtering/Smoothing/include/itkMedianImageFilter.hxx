@@ -20,6 +20,7 @@
 #include "itkMedianImageFilter.h"
 
 #include "itkBufferedImageNeighborhoodPixelAccessPolicy.h"
+#include "itkImageBufferRange.h"
 #include "itkImageNeighborhoodOffsets.h"
 #include "itkImageRegionRange.h"
 #include "itkIndexRange.h"
@@ -40,10 +41,97 @@ MedianImageFilter<TInputImage, TOutputImage>::MedianImageFilter()
   this->ThreaderUpdateProgressOff();
 }
 
+template <typename TInputImage, typename TOutputImage>
+bool
+MedianImageFilter<TInputImage, TOutputImage>::UsesHistogramAlgorithm() const
+{
+  if (!HistogramAlgorithmSupportsPixelType || m_Algorithm == AlgorithmEnum::Sort)
+  {
+    return false;
+  }
+  if (m_Algorithm == AlgorithmEnum::Histogram)
+  {
+    return true;
+  }
+
+  // Neighborhood sizes from which the histogram algorithm is faster than
+  // the partial sort, for 8 and 16 bits.
+  SizeValueType neighborhoodSize = 1;
+  for (unsigned int d = 0; d < InputImageDimension; ++d)
+  {
+    neighborhoodSize *= 2 * this->GetRadius()[d] + 1;
+  }
+  return neighborhoodSize >= (sizeof(InputPixelType) == 1 ? 9 : 49);
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  if (m_Algorithm == AlgorithmEnum::Histogram && !HistogramAlgorithmSupportsPixelType)
+  {
+    itkExceptionMacro("The Histogram algorithm requires an integral input pixel type of at most 16 bits.");
+  }
+  m_ReleasedHistograms.clear();
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::AfterThreadedGenerateData()
+{
+  // The column histograms of 16 bit pixel types take megabytes.
+  m_ReleasedHistograms.clear();
+
+  Superclass::AfterThreadedGenerateData();
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+MedianImageFilter<TInputImage, TOutputImage>::AcquireHistograms(SizeValueType numberOfColumns)
+  -> std::unique_ptr<HistogramsType>
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_HistogramsMutex);
+    if (!m_ReleasedHistograms.empty() && m_ReleasedHistograms.back()->GetNumberOfColumns() >= numberOfColumns)
+    {
+      std::unique_ptr<HistogramsType> histograms = std::move(m_ReleasedHistograms.back());
+      m_ReleasedHistograms.pop_back();
+      return histograms;
+    }
+  }
+  return std::make_unique<HistogramsType>(numberOfColumns);
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::ReleaseHistograms(std::unique_ptr<HistogramsType> histograms)
+{
+  const std::lock_guard<std::mutex> lock(m_HistogramsMutex);
+  m_ReleasedHistograms.push_back(std::move(histograms));
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
+{
+  if (this->UsesHistogramAlgorithm())
+  {
+    this->HistogramThreadedGenerateData(outputRegionForThread,
+                                        std::integral_constant<bool, HistogramAlgorithmSupportsPixelType>{});
+  }
+  else
+  {
+    this->SortThreadedGenerateData(outputRegionForThread);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::SortThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
 {
   // Allocate output
   OutputImageType *      output = this->GetOutput();
@@ -105,6 +193,183 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::HistogramThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  std::true_type)
+{
+  OutputImageType *      output = this->GetOutput();
+  const InputImageType * input = this->GetInput();
+
+  const auto radius = this->GetRadius();
+
+  SizeValueType neighborhoodSize = 1;
+  for (unsigned int d = 0; d < InputImageDimension; ++d)
+  {
+    neighborhoodSize *= 2 * radius[d] + 1;
+  }
+  const SizeValueType medianRank = neighborhoodSize / 2;
+
+  // The pixels outside of the buffered region have the value of the nearest
+  // pixel inside, as with the ZeroFluxNeumannBoundaryCondition of the Sort
+  // algorithm.
+  const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+  const OffsetValueType *    inputOffsetTable = input->GetOffsetTable();
+  const auto                 clampedOffset = [&bufferedRegion, inputOffsetTable](unsigned int d, IndexValueType i) {
+    const IndexValueType first = bufferedRegion.GetIndex(d);
+    const IndexValueType last = first + static_cast<IndexValueType>(bufferedRegion.GetSize(d)) - 1;
+    return (std::min(std::max(i, first), last) - first) * inputOffsetTable[d];
+  };
+  const auto inputBuffer = MakeImageBufferRange(input);
+  auto       outputBuffer = MakeImageBufferRange(output);
+
+  // The second axis, along which the columns move, if any.
+  constexpr unsigned int RowAxis = InputImageDimension > 1 ? 1 : 0;
+  constexpr bool         HasRows = RowAxis > 0;
+  const IndexValueType   radiusX = radius[0];
+  const IndexValueType   radiusY = HasRows ? radius[RowAxis] : 0;
+  const IndexValueType   firstX = outputRegionForThread.GetIndex(0);
+  const IndexValueType   endX = firstX + static_cast<IndexValueType>(outputRegionForThread.GetSize(0));
+  const IndexValueType   firstY = HasRows ? outputRegionForThread.GetIndex(RowAxis) : 0;
+  const IndexValueType   endY =
+    HasRows ? firstY + static_cast<IndexValueType>(outputRegionForThread.GetSize(RowAxis)) : 1;
+  const auto rowOffset = [&clampedOffset](IndexValueType y) { return HasRows ? clampedOffset(RowAxis, y) : 0; };
+
+  // The output is processed in strips along the first axis, so that the
+  // column histograms of 16 bit pixel types fit in a bounded memory.
+  constexpr SizeValueType MaximumMemoryOfColumns = 16 * 1024 * 1024;
+  const SizeValueType     maximumNumberOfColumns = MaximumMemoryOfColumns / HistogramsType::ColumnSizeInBytes;
+  const SizeValueType     stripWidth = std::min<SizeValueType>(
+    outputRegionForThread.GetSize(0),
+    maximumNumberOfColumns > 2 * radius[0] + 1 ? maximumNumberOfColumns - 2 * radius[0] : 1);
+  // The histograms are allocated once per concurrent chunk rather than for
+  // each chunk, and are reused by the next chunks.
+  std::unique_ptr<HistogramsType> histogramsOfChunk = this->AcquireHistograms(stripWidth + 2 * radius[0]);
+  HistogramsType &                histograms = *histogramsOfChunk;
+
+  std::vector<OffsetValueType> columnOffsets(histograms.GetNumberOfColumns());
+  std::vector<OffsetValueType> sliceOffsets;
+
+  // The indices along the axes after the second, and the pixels of the
+  // neighborhood along these axes.
+  OutputImageRegionType outerRegion = outputRegionForThread;
+  InputImageRegionType  sliceRegion;
+  for (unsigned int d = 0; d < InputImageDimension; ++d)
+  {
+    if (d < 2)
+    {
+      outerRegion.SetSize(d, 1);
+      sliceRegion.SetSize(d, 1);
+    }
+    else
+    {
+      sliceRegion.SetIndex(d, -static_cast<IndexValueType>(radius[d]));
+      sliceRegion.SetSize(d, 2 * radius[d] + 1);
+    }
+  }
+
+  TotalProgressReporter progress(this, output->GetRequestedRegion().GetNumberOfPixels());
+
+  for (const auto & outerIndex : ImageRegionIndexRange<InputImageDimension>(outerRegion))
+  {
+    sliceOffsets.clear();
+    for (const auto & sliceIndex : ImageRegionIndexRange<InputImageDimension>(sliceRegion))
+    {
+      OffsetValueType sliceOffset = 0;
+      for (unsigned int d = 2; d < InputImageDimension; ++d)
+      {
+        sliceOffset += clampedOffset(d, outerIndex[d] + sliceIndex[d]);
+      }
+      sliceOffsets.push_back(sliceOffset);
+    }
+
+    for (IndexValueType stripFirstX = firstX; stripFirstX < endX;
+         stripFirstX += static_cast<IndexValueType>(stripWidth))
+    {
+      const IndexValueType stripEndX = std::min(stripFirstX + static_cast<IndexValueType>(stripWidth), endX);
+      const auto numberOfColumns = static_cast<SizeValueType>(stripEndX - stripFirstX + 2 * radiusX);
+      for (SizeValueType column = 0; column < numberOfColumns; ++column)
+      {
+        columnOffsets[column] = clampedOffset(0, stripFirstX - radiusX + static_cast<IndexValueType>(column));
+      }
+
+      const auto addRow = [&](IndexValueType y) {
+        const OffsetValueType offset = rowOffset(y);
+        for (SizeValueType column = 0; column < numberOfColumns; ++column)
+        {
+          for (const OffsetValueType sliceOffset : sliceOffsets)
+          {
+            histograms.AddToColumn(column, inputBuffer[columnOffsets[column] + offset + sliceOffset]);
+          }
+        }
+      };
+      const auto removeRow = [&](IndexValueType y) {
+        const OffsetValueType offset = rowOffset(y);
+        for (SizeValueType column = 0; column < numberOfColumns; ++column)
+        {
+          for (const OffsetValueType sliceOffset : sliceOffsets)
+          {
+            histograms.RemoveFromColumn(column, inputBuffer[columnOffsets[column] + offset + sliceOffset]);
+          }
+        }
+      };
+
+      for (IndexValueType y = firstY - radiusY; y <= firstY + radiusY; ++y)
+      {
+        addRow(y);
+      }
+
+      for (IndexValueType y = firstY; y < endY; ++y)
+      {
+        if (y > firstY && rowOffset(y - 1 - radiusY) != rowOffset(y + radiusY))
+        {
+          removeRow(y - 1 - radiusY);
+          addRow(y + radiusY);
+        }
+
+        histograms.StartKernel(0);
+        for (IndexValueType column = 0; column < 2 * radiusX; ++column)
+        {
+          histograms.AddNextColumnToKernel();
+        }
+
+        typename OutputImageType::IndexType outputIndex = outerIndex;
+        outputIndex[0] = stripFirstX;
+        if (HasRows)
+        {
+          outputIndex[RowAxis] = y;
+        }
+        const OffsetValueType outputOffset = output->ComputeOffset(outputIndex);
+        for (IndexValueType x = stripFirstX; x < stripEndX; ++x)
+        {
+          histograms.AddNextColumnToKernel();
+          outputBuffer[outputOffset + (x - stripFirstX)] = histograms.GetKernelValue(medianRank);
+          histograms.RemoveFirstColumnFromKernel();
+          progress.CompletedPixel();
+        }
+      }
+
+      // Leave the column histograms empty for the next strip.
+      for (IndexValueType y = endY - 1 - radiusY; y <= endY - 1 + radiusY; ++y)
+      {
+        removeRow(y);
+      }
+    }
+  }
+
+  this->ReleaseHistograms(std::move(histogramsOfChunk));
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+MedianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
+}
 } // end namespace itk
 
 #endif
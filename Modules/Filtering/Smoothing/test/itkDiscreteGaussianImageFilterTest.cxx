@@ -22,6 +22,82 @@
 #include "itkSimpleFilterWatcher.h"
 #include "itkTestingMacros.h"
 #include "itkConstantBoundaryCondition.h"
+#include "itkRampWithNoiseImage.h"
+
+namespace
+{
+
+// Check that the Direct and FFT algorithms give the output of the
+// NeighborhoodOperator algorithm for a range of variances, on the whole
+// image, and on a requested region at a corner of it with one axis less
+// filtered.
+template <typename TImage>
+int
+CompareConvolutionAlgorithms(const TImage * image, bool useImageSpacing, double maximumVariance, double tolerance)
+{
+  using FilterType = itk::DiscreteGaussianImageFilter<TImage, TImage>;
+  using AlgorithmEnum = typename FilterType::ConvolutionAlgorithmEnum;
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetUseImageSpacing(useImageSpacing);
+  filter->SetMaximumError(0.001);
+  filter->SetMaximumKernelWidth(1024);
+
+  int status = EXIT_SUCCESS;
+  for (double variance = 1.0; variance <= maximumVariance; variance *= 4.0)
+  {
+    filter->SetVariance(variance);
+
+    for (bool wholeImage : { true, false })
+    {
+      auto requestedRegion = image->GetLargestPossibleRegion();
+      filter->SetFilterDimensionality(TImage::ImageDimension);
+      if (!wholeImage)
+      {
+        filter->SetFilterDimensionality(TImage::ImageDimension - 1);
+        requestedRegion.SetSize(0, requestedRegion.GetSize(0) / 2);
+        requestedRegion.SetIndex(TImage::ImageDimension - 1, 2);
+        requestedRegion.SetSize(TImage::ImageDimension - 1, requestedRegion.GetSize(TImage::ImageDimension - 1) / 3);
+      }
+
+      typename TImage::Pointer expected;
+      for (const auto algorithm : { AlgorithmEnum::NeighborhoodOperator, AlgorithmEnum::Direct, AlgorithmEnum::FFT })
+      {
+        filter->SetConvolutionAlgorithm(algorithm);
+        filter->GetOutput()->SetRequestedRegion(requestedRegion);
+        ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+        if (algorithm == AlgorithmEnum::NeighborhoodOperator)
+        {
+          expected = filter->GetOutput();
+          expected->DisconnectPipeline();
+          continue;
+        }
+
+        const TImage * output = filter->GetOutput();
+        ITK_TEST_EXPECT_EQUAL(output->GetBufferedRegion(), expected->GetBufferedRegion());
+        double maximumDifference = 0.0;
+        for (itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, expected->GetBufferedRegion()); !it.IsAtEnd();
+             ++it)
+        {
+          maximumDifference =
+            std::max(maximumDifference,
+                     std::abs(static_cast<double>(it.Get()) - static_cast<double>(output->GetPixel(it.GetIndex()))));
+        }
+        if (maximumDifference > tolerance)
+        {
+          std::cerr << "For variance " << variance << (wholeImage ? " on the whole image" : " on a region")
+                    << ", the output of the " << algorithm << " algorithm differs by " << maximumDifference
+                    << " from the output of the NeighborhoodOperator algorithm" << std::endl;
+          status = EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return status;
+}
+
+} // namespace
 
 int
 itkDiscreteGaussianImageFilterTest(int argc, char * argv[])
@@ -124,7 +200,27 @@ itkDiscreteGaussianImageFilterTest(int argc, char * argv[])
 
   ITK_TRY_EXPECT_NO_EXCEPTION(test1.Execute());
 
+  // The boundary conditions of the NeighborhoodOperator algorithm are not
+  // supported by the other algorithms.
+  ITK_TEST_SET_GET_VALUE(FilterType::ConvolutionAlgorithmEnum::Automatic, filter->GetConvolutionAlgorithm());
+  ITK_TEST_EXPECT_TRUE(!filter->UsesSeparableConvolution());
+  filter->SetConvolutionAlgorithm(FilterType::ConvolutionAlgorithmEnum::Direct);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+  filter->SetConvolutionAlgorithm(FilterType::ConvolutionAlgorithmEnum::Automatic);
+  auto defaultFilter = FilterType::New();
+  ITK_TEST_EXPECT_TRUE(defaultFilter->UsesSeparableConvolution());
+
+  // Compare the algorithms on a noisy ramp of floating point pixels. The
+  // intermediate images of 8 bit pixels are rounded down as by the
+  // NeighborhoodOperator algorithm, or by one less when the sums differ in
+  // the last bits.
+  const auto floatImage = MakeRampWithNoiseImage<ImageType>(itk::Size<3>{ { 27, 24, 24 } }, -1024.0, 3071.0);
+  int        status = CompareConvolutionAlgorithms(floatImage.GetPointer(), useImageSpacing, 16.0, 1e-2);
+  using UnsignedCharImageType = itk::Image<unsigned char, 2>;
+  const auto unsignedCharImage = MakeRampWithNoiseImage<UnsignedCharImageType>(itk::Size<2>{ { 83, 80 } }, 0.0, 255.0);
+  status |= CompareConvolutionAlgorithms(unsignedCharImage.GetPointer(), useImageSpacing, 64.0, 2.0);
+
 
   std::cout << "Test finished" << std::endl;
-  return EXIT_SUCCESS;
+  return status;
 }
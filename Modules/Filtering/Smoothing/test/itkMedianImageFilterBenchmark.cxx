@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkRampWithNoiseImage.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Report the time of the Sort and Histogram algorithms of MedianImageFilter
+ * for a range of radii, on a 3D image of 16 bit pixels and a 2D image of
+ * 8 bit pixels, and which algorithm Automatic selects. This benchmark is not
+ * run by default; the outputs of both algorithms are compared by
+ * itkMedianImageFilterGTest.
+ */
+
+namespace
+{
+
+template <typename TImage>
+int
+SweepRadius(const TImage * image, unsigned int maximumRadius)
+{
+  using FilterType = itk::MedianImageFilter<TImage, TImage>;
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  for (unsigned int radius = 1; radius <= maximumRadius; ++radius)
+  {
+    filter->SetRadius(radius);
+
+    filter->SetAlgorithm(FilterType::AlgorithmEnum::Sort);
+    itk::TimeProbe sortProbe;
+    sortProbe.Start();
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+    sortProbe.Stop();
+
+    filter->SetAlgorithm(FilterType::AlgorithmEnum::Histogram);
+    itk::TimeProbe histogramProbe;
+    histogramProbe.Start();
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+    histogramProbe.Stop();
+
+    filter->SetAlgorithm(FilterType::AlgorithmEnum::Automatic);
+    std::cout << "radius " << radius << ": Sort " << sortProbe.GetTotal() << " s, Histogram "
+              << histogramProbe.GetTotal() << " s, Automatic uses "
+              << (filter->UsesHistogramAlgorithm() ? "Histogram" : "Sort") << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkMedianImageFilterBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " imageSize maximumRadius" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto imageSize = static_cast<unsigned int>(std::stoi(argv[1]));
+  const auto maximumRadius = static_cast<unsigned int>(std::stoi(argv[2]));
+
+  using ShortImageType = itk::Image<short, 3>;
+  std::cout << "short, " << imageSize << "^3 pixels" << std::endl;
+  ShortImageType::SizeType shortImageSize;
+  shortImageSize.Fill(imageSize);
+  const auto shortImage = MakeRampWithNoiseImage<ShortImageType>(shortImageSize, -1024.0, 3071.0);
+  int        status = SweepRadius(shortImage.GetPointer(), maximumRadius);
+
+  using UnsignedCharImageType = itk::Image<unsigned char, 2>;
+  const unsigned int planeSize = imageSize * imageSize / 8;
+  std::cout << "unsigned char, " << planeSize << "^2 pixels" << std::endl;
+  UnsignedCharImageType::SizeType unsignedCharImageSize;
+  unsignedCharImageSize.Fill(planeSize);
+  const auto unsignedCharImage = MakeRampWithNoiseImage<UnsignedCharImageType>(unsignedCharImageSize, 0.0, 255.0);
+  status |= SweepRadius(unsignedCharImage.GetPointer(), 2 * maximumRadius);
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
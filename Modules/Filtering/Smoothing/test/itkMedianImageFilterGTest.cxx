@@ -21,8 +21,10 @@
 
 #include "itkImage.h"
 #include "itkImageBufferRange.h"
+#include "itkRampWithNoiseImage.h"
 
 #include <numeric> // For iota.
+#include <random>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -92,6 +94,91 @@ Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numb
   EXPECT_EQ(outputPixelValues, expectedPixelValues);
 }
 
+
+// Expects that the Histogram and Sort algorithms give the same output for an image of random pixel values, both for
+// the largest possible region and for a region inside it.
+template <typename TImage>
+void
+Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm(const typename TImage::SizeType & imageSize,
+                                                             const typename TImage::SizeType & radius)
+{
+  using PixelType = typename TImage::PixelType;
+  using FilterType = itk::MedianImageFilter<TImage, TImage>;
+
+  const auto image = TImage::New();
+  image->SetRegions(imageSize);
+  image->Allocate();
+  std::mt19937                       randomNumberEngine;
+  std::uniform_int_distribution<int> distribution(std::numeric_limits<PixelType>::min(),
+                                                  std::numeric_limits<PixelType>::max());
+  for (PixelType & pixel : itk::MakeImageBufferRange(image.GetPointer()))
+  {
+    pixel = static_cast<PixelType>(distribution(randomNumberEngine));
+  }
+
+  typename TImage::RegionType innerRegion = image->GetLargestPossibleRegion();
+  for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+  {
+    if (imageSize[d] > 2)
+    {
+      innerRegion.SetIndex(d, 1);
+      innerRegion.SetSize(d, imageSize[d] - 2);
+    }
+  }
+
+  for (const auto & region : { image->GetLargestPossibleRegion(), innerRegion })
+  {
+    std::vector<std::vector<PixelType>> outputPixelValues;
+    for (const auto algorithm : { FilterType::AlgorithmEnum::Sort, FilterType::AlgorithmEnum::Histogram })
+    {
+      const auto filter = FilterType::New();
+      filter->SetInput(image);
+      filter->SetRadius(radius);
+      filter->SetAlgorithm(algorithm);
+      filter->GetOutput()->SetRequestedRegion(region);
+      filter->Update();
+
+      const auto outputImageBufferRange = itk::MakeImageBufferRange(filter->GetOutput());
+      outputPixelValues.emplace_back(outputImageBufferRange.cbegin(), outputImageBufferRange.cend());
+    }
+    EXPECT_EQ(outputPixelValues.front().size(), region.GetNumberOfPixels());
+    EXPECT_EQ(outputPixelValues.front(), outputPixelValues.back());
+  }
+}
+
+
+// Expects that the Histogram and Sort algorithms give the same output for a noisy ramp, for each radius up to the
+// specified maximum, so that the columns of the histogram slide over many pixel values.
+template <typename TImage>
+void
+Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm_for_noisy_ramp(
+  const typename TImage::SizeType & imageSize,
+  double                            minimum,
+  double                            maximum,
+  unsigned int                      maximumRadius)
+{
+  using PixelType = typename TImage::PixelType;
+  using FilterType = itk::MedianImageFilter<TImage, TImage>;
+
+  const auto image = MakeRampWithNoiseImage<TImage>(imageSize, minimum, maximum);
+  for (unsigned int radius = 1; radius <= maximumRadius; ++radius)
+  {
+    std::vector<std::vector<PixelType>> outputPixelValues;
+    for (const auto algorithm : { FilterType::AlgorithmEnum::Sort, FilterType::AlgorithmEnum::Histogram })
+    {
+      const auto filter = FilterType::New();
+      filter->SetInput(image);
+      filter->SetRadius(radius);
+      filter->SetAlgorithm(algorithm);
+      filter->Update();
+
+      const auto outputImageBufferRange = itk::MakeImageBufferRange(filter->GetOutput());
+      outputPixelValues.emplace_back(outputImageBufferRange.cbegin(), outputImageBufferRange.cend());
+    }
+    EXPECT_EQ(outputPixelValues.front(), outputPixelValues.back()) << "radius " << radius;
+  }
+}
+
 } // namespace
 
 
@@ -122,3 +209,59 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+// Tests that the Histogram algorithm gives the same output as the Sort algorithm, including for radii larger than the
+// image.
+TEST(MedianImageFilter, HistogramAlgorithmHasSameOutputAsSortAlgorithm)
+{
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm<itk::Image<unsigned char>>(itk::Size<>{ { 7, 5 } },
+                                                                                          itk::Size<>{ { 2, 1 } });
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm<itk::Image<unsigned short>>(itk::Size<>{ { 40, 3 } },
+                                                                                           itk::Size<>{ { 20, 1 } });
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm<itk::Image<char, 1>>(itk::Size<1>{ { 11 } },
+                                                                                    itk::Size<1>{ { 4 } });
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm<itk::Image<short, 3>>(itk::Size<3>{ { 6, 7, 5 } },
+                                                                                     itk::Size<3>{ { 1, 2, 3 } });
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm<itk::Image<unsigned char, 4>>(
+    itk::Size<4>{ { 4, 3, 5, 3 } }, itk::Size<4>{ { 1, 1, 2, 1 } });
+}
+
+
+// Tests that the Histogram algorithm gives the same output as the Sort algorithm for the noisy ramp of 16 bit pixels of
+// a CT scan, and of 8 bit pixels.
+TEST(MedianImageFilter, HistogramAlgorithmHasSameOutputAsSortAlgorithmForNoisyRamp)
+{
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm_for_noisy_ramp<itk::Image<short, 3>>(
+    itk::Size<3>{ { 19, 17, 15 } }, -1024.0, 3071.0, 4);
+  Expect_Histogram_algorithm_has_same_output_as_Sort_algorithm_for_noisy_ramp<itk::Image<unsigned char>>(
+    itk::Size<>{ { 70, 61 } }, 0.0, 255.0, 8);
+}
+
+
+// Tests which algorithm is used, given the algorithm, the pixel type and the radius.
+TEST(MedianImageFilter, UsesHistogramAlgorithm)
+{
+  const auto unsignedCharFilter = itk::MedianImageFilter<itk::Image<unsigned char>, itk::Image<unsigned char>>::New();
+  EXPECT_EQ(unsignedCharFilter->GetAlgorithm(), itk::MedianImageFilterEnums::Algorithm::Automatic);
+  EXPECT_TRUE(unsignedCharFilter->UsesHistogramAlgorithm());
+  unsignedCharFilter->SetAlgorithm(itk::MedianImageFilterEnums::Algorithm::Sort);
+  EXPECT_FALSE(unsignedCharFilter->UsesHistogramAlgorithm());
+
+  const auto shortFilter = itk::MedianImageFilter<itk::Image<short>, itk::Image<short>>::New();
+  EXPECT_FALSE(shortFilter->UsesHistogramAlgorithm());
+  shortFilter->SetRadius(3);
+  EXPECT_TRUE(shortFilter->UsesHistogramAlgorithm());
+
+  using FloatImageType = itk::Image<float>;
+  const auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(itk::Size<>{ { 5, 6 } });
+  floatImage->Allocate(true);
+  const auto floatFilter = itk::MedianImageFilter<FloatImageType, FloatImageType>::New();
+  floatFilter->SetInput(floatImage);
+  floatFilter->SetRadius(5);
+  EXPECT_FALSE(floatFilter->UsesHistogramAlgorithm());
+  floatFilter->SetAlgorithm(itk::MedianImageFilterEnums::Algorithm::Histogram);
+  EXPECT_FALSE(floatFilter->UsesHistogramAlgorithm());
+  EXPECT_THROW(floatFilter->Update(), itk::ExceptionObject);
+}
@@ -0,0 +1,53 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkRampWithNoiseImage_h
+#define itkRampWithNoiseImage_h
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include <algorithm>
+#include <cmath>
+
+// An image of a smooth ramp with noise, clamped to [minimum, maximum], used
+// to compare the algorithms of the smoothing filters. The noise is seeded,
+// so the image is the same on each call.
+template <typename TImage>
+typename TImage::Pointer
+MakeRampWithNoiseImage(const typename TImage::SizeType & size, double minimum, double maximum)
+{
+  auto                              image = TImage::New();
+  const typename TImage::RegionType region(size);
+  image->SetRegions(region);
+  image->Allocate();
+
+  auto generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  generator->Initialize(1234);
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    double value = 0.5 * (minimum + maximum) + 0.1 * (maximum - minimum) * generator->GetNormalVariate();
+    for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+    {
+      value += 0.2 * (maximum - minimum) * std::sin(0.1 * (d + 1) * it.GetIndex()[d]);
+    }
+    it.Set(static_cast<typename TImage::PixelType>(std::min(std::max(value, minimum), maximum)));
+  }
+  return image;
+}
+
+#endif
@@ -22,10 +22,106 @@
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
 #include "itkTestingMacros.h"
+#include "itkRampWithNoiseImage.h"
 
 #include <algorithm>
 #include <numeric>
 
+namespace
+{
+
+// Filter the lines one at a time, as before the blocks of lines
+template <typename TInputImage, typename TOutputImage>
+class LineByLineRecursiveGaussianImageFilter : public itk::RecursiveGaussianImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(LineByLineRecursiveGaussianImageFilter);
+
+  using Self = LineByLineRecursiveGaussianImageFilter;
+  using Superclass = itk::RecursiveGaussianImageFilter<TInputImage, TOutputImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using OutputImageRegionType = typename Superclass::OutputImageRegionType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(LineByLineRecursiveGaussianImageFilter, RecursiveGaussianImageFilter);
+
+protected:
+  LineByLineRecursiveGaussianImageFilter() = default;
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override
+  {
+    this->GenerateDataLineByLine(outputRegionForThread);
+  }
+};
+
+// Check that filtering the lines in blocks gives the same output as filtering
+// them one at a time, along each axis, for the whole image and for a
+// requested region inside it.
+template <typename TInputImage, typename TOutputImage>
+int
+CompareBlocksToLineByLine(const TInputImage * image)
+{
+  using FilterType = itk::RecursiveGaussianImageFilter<TInputImage, TOutputImage>;
+  using ReferenceFilterType = LineByLineRecursiveGaussianImageFilter<TInputImage, TOutputImage>;
+  static_assert(FilterType::LineBlocksSupportImageTypes, "The lines should be filtered in blocks");
+
+  auto filter = FilterType::New();
+  auto referenceFilter = ReferenceFilterType::New();
+  filter->SetInput(image);
+  referenceFilter->SetInput(image);
+
+  for (unsigned int direction = 0; direction < TInputImage::ImageDimension; ++direction)
+  {
+    for (const auto order : { itk::GaussianOrderEnum::ZeroOrder, itk::GaussianOrderEnum::SecondOrder })
+    {
+      for (bool wholeImage : { true, false })
+      {
+        auto requestedRegion = image->GetLargestPossibleRegion();
+        if (!wholeImage)
+        {
+          for (unsigned int d = 0; d < TInputImage::ImageDimension; ++d)
+          {
+            requestedRegion.SetIndex(d, 1);
+            requestedRegion.SetSize(d, requestedRegion.GetSize(d) / 2);
+          }
+        }
+
+        FilterType * const filters[] = { filter.GetPointer(), referenceFilter.GetPointer() };
+        for (FilterType * currentFilter : filters)
+        {
+          currentFilter->SetDirection(direction);
+          currentFilter->SetOrder(order);
+          currentFilter->SetSigma(2.5);
+          currentFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+          currentFilter->Modified();
+          currentFilter->Update();
+        }
+
+        const TOutputImage * output = filter->GetOutput();
+        const TOutputImage * expected = referenceFilter->GetOutput();
+        ITK_TEST_EXPECT_EQUAL(output->GetBufferedRegion(), expected->GetBufferedRegion());
+        for (itk::ImageRegionConstIteratorWithIndex<TOutputImage> it(expected, expected->GetBufferedRegion());
+             !it.IsAtEnd();
+             ++it)
+        {
+          if (output->GetPixel(it.GetIndex()) != it.Get())
+          {
+            std::cerr << "Along direction " << direction << ", " << order
+                      << (wholeImage ? " on the whole image" : " on a region") << ", the output "
+                      << output->GetPixel(it.GetIndex()) << " at " << it.GetIndex() << " differs from the output "
+                      << it.Get() << " of the lines filtered one at a time" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
 
 int
 itkRecursiveGaussianImageFiltersTest(int, char *[])
@@ -522,6 +618,23 @@ itkRecursiveGaussianImageFiltersTest(int, char *[])
     std::cout << "STREAMED ENUM VALUE RecursiveGaussianImageFilterEnums::GaussianOrder: " << ee << std::endl;
   }
 
+  // Compare the blocks of lines to the lines filtered one at a time, on a
+  // noisy ramp of floating point pixels, and of 8 bit pixels filtered to
+  // double pixels
+  using FloatImageType = itk::Image<float, 3>;
+  const auto floatImage = MakeRampWithNoiseImage<FloatImageType>(itk::Size<3>{ { 23, 20, 20 } }, -1024.0, 3071.0);
+  if (CompareBlocksToLineByLine<FloatImageType, FloatImageType>(floatImage.GetPointer()) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  using UnsignedCharImageType = itk::Image<unsigned char, 2>;
+  const auto unsignedCharImage = MakeRampWithNoiseImage<UnsignedCharImageType>(itk::Size<2>{ { 83, 80 } }, 0.0, 255.0);
+  if (CompareBlocksToLineByLine<UnsignedCharImageType, itk::Image<double, 2>>(unsignedCharImage.GetPointer()) !=
+      EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
   // All objects should be automatically destroyed at this point
   return EXIT_SUCCESS;
 }
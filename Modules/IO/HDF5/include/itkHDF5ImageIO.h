@@ -79,6 +79,17 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The voxel data set is stored in chunks, the unit of compression and of
+ * random access in HDF5 files, whose size is set by SetChunkSize(). Any
+ * region may be read or written, including by ImageFileReader and
+ * ImageFileWriter streaming: a streamed write splits the image along
+ * chunk boundaries, and a region covering whole chunks is compressed or
+ * decompressed concurrently, one chunk per work unit. Other regions go
+ * through the HDF5 chunk cache, whose size is set by SetChunkCacheSize().
+ *
+ * The data is always deflated, at the level set by SetCompressionLevel(),
+ * after the bytes of its components are optionally shuffled by
+ * SetUseShuffleFilter().
  *
  */
 
@@ -137,6 +148,48 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Set/Get the size of the chunks of the voxel data set, in pixels along
+   * each image dimension, fastest first. Missing or zero sizes span the
+   * whole image along their dimension. By default, a chunk spans a single
+   * index along the slowest dimension. Chunks are reduced along the slowest
+   * dimensions to the 4 GiB limit of HDF5. */
+  virtual void
+  SetChunkSize(const std::vector<SizeValueType> & chunkSize)
+  {
+    if (this->m_ChunkSize != chunkSize)
+    {
+      this->m_ChunkSize = chunkSize;
+      this->Modified();
+    }
+  }
+  itkGetConstReferenceMacro(ChunkSize, std::vector<SizeValueType>);
+
+  /** Set/Get whether the bytes of the pixel components are grouped by
+   * significance before the data is compressed, which usually improves the
+   * compression of images with more than one byte per component. */
+  itkSetMacro(UseShuffleFilter, bool);
+  itkGetConstMacro(UseShuffleFilter, bool);
+  itkBooleanMacro(UseShuffleFilter);
+
+  /** Set/Get the size, in bytes, of the cache of decompressed chunks of the
+   * voxel data set. Partial reads or writes of chunks which fit in the cache
+   * decompress them once. Zero, the default, uses the HDF5 default size. */
+  itkSetMacro(ChunkCacheSize, SizeValueType);
+  itkGetConstMacro(ChunkCacheSize, SizeValueType);
+
+  /** Streamed writes are split along chunk boundaries, so that each chunk
+   * is written by a single piece. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+  ImageIORegion
+  GetSplitRegionForWriting(unsigned int          ithPiece,
+                           unsigned int          numberOfActualSplits,
+                           const ImageIORegion & pasteRegion,
+                           const ImageIORegion & largestPossibleRegion) override;
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -203,6 +256,18 @@ private:
   void
   SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace);
 
+  /** Size of the chunks for writing the image, in pixels along each image
+   * dimension, fastest first. */
+  std::vector<SizeValueType>
+  ComputeChunkSize() const;
+
+  /** Index range [first, last) of the rows of chunks of the paste region
+   * along the dimension that streamed writes split. */
+  unsigned int
+  GetChunkRowsForWriting(const ImageIORegion & pasteRegion,
+                         SizeValueType &       firstRow,
+                         SizeValueType &       lastRow) const;
+
   void
   CloseH5File();
   void
@@ -211,6 +276,10 @@ private:
   H5::H5File *  m_H5File{ nullptr };
   H5::DataSet * m_VoxelDataSet{ nullptr };
   bool          m_ImageInformationWritten{ false };
+
+  std::vector<SizeValueType> m_ChunkSize;
+  bool                       m_UseShuffleFilter{ false };
+  SizeValueType              m_ChunkCacheSize{ 0 };
 };
 } // end namespace itk
 
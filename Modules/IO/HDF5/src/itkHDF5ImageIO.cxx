@@ -20,7 +20,9 @@
 #include "itkMetaDataObject.h"
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
+#include "itkMultiThreaderBase.h"
 #include "itk_H5Cpp.h"
+#include "itk_zlib.h"
 
 #include <algorithm>
 
@@ -55,6 +57,14 @@ HDF5ImageIO ::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: [";
+  for (size_t i = 0; i < this->m_ChunkSize.size(); ++i)
+  {
+    os << (i == 0 ? "" : ", ") << this->m_ChunkSize[i];
+  }
+  os << ']' << std::endl;
+  os << indent << "UseShuffleFilter: " << (this->m_UseShuffleFilter ? "On" : "Off") << std::endl;
+  os << indent << "ChunkCacheSize: " << this->m_ChunkCacheSize << std::endl;
 }
 
 //
@@ -259,6 +269,513 @@ doesAttrExist(const H5::H5Object & object, const char * const name)
   return (H5Aexists(object.getId(), name) > 0 ? true : false);
 }
 
+// HDF5 limits the size of a chunk to 4 GiB
+constexpr hsize_t MaximumChunkBytes = (hsize_t{ 1 } << 32) - 1;
+
+// Uncompressed bytes of the chunks filtered at once by the concurrent chunk IO
+constexpr hsize_t ChunkBatchBytes = hsize_t{ 1 } << 28;
+
+// Chunk cache of cacheSize bytes, with about 100 hash slots per cached chunk as
+// the HDF5 documentation advises, their number being prime
+void
+SetChunkCache(H5::DSetAccPropList & accessList, SizeValueType cacheSize, hsize_t chunkBytes)
+{
+  if (cacheSize == 0)
+  {
+    return;
+  }
+  const hsize_t numberOfChunks = std::max<hsize_t>(1, cacheSize / std::max<hsize_t>(chunkBytes, 1));
+  hsize_t       numberOfSlots = std::min<hsize_t>(100 * numberOfChunks, hsize_t{ 1 } << 24) | 1;
+  for (bool prime = false; !prime; numberOfSlots += 2)
+  {
+    prime = true;
+    for (hsize_t divisor = 3; divisor * divisor <= numberOfSlots && prime; divisor += 2)
+    {
+      prime = numberOfSlots % divisor != 0;
+    }
+  }
+  accessList.setChunkCache(static_cast<size_t>(numberOfSlots - 2), cacheSize, H5D_CHUNK_CACHE_W0_DEFAULT);
+}
+
+// Number of bytes of the chunks of a data set, and its chunk size in HDF5 order
+hsize_t
+GetChunkDimensions(const H5::DataSet & dataSet, std::vector<hsize_t> & chunkDimensions)
+{
+  const H5::DSetCreatPropList creationList = dataSet.getCreatePlist();
+  chunkDimensions.assign(dataSet.getSpace().getSimpleExtentNdims(), 0);
+  if (creationList.getLayout() != H5D_CHUNKED ||
+      creationList.getChunk(static_cast<int>(chunkDimensions.size()), chunkDimensions.data()) !=
+        static_cast<int>(chunkDimensions.size()))
+  {
+    return 0;
+  }
+  hsize_t chunkBytes = dataSet.getDataType().getSize();
+  for (const hsize_t dimension : chunkDimensions)
+  {
+    chunkBytes *= dimension;
+  }
+  return chunkBytes;
+}
+
+// Whether a region, in HDF5 order, covers whole chunks, the chunks at the end of
+// the data set being cut by its extent
+bool
+CoversWholeChunks(const std::vector<hsize_t> & offset,
+                  const std::vector<hsize_t> & size,
+                  const std::vector<hsize_t> & chunkDimensions,
+                  const std::vector<hsize_t> & dimensions)
+{
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    const hsize_t end = offset[d] + size[d];
+    if (offset[d] % chunkDimensions[d] != 0 || (end % chunkDimensions[d] != 0 && end != dimensions[d]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copy the intersection of a chunk and a region between their buffers, both in HDF5 order
+void
+CopyChunkRegion(const std::vector<hsize_t> & chunkOrigin,
+                const std::vector<hsize_t> & chunkDimensions,
+                const std::vector<hsize_t> & regionOffset,
+                const std::vector<hsize_t> & regionSize,
+                size_t                       elementSize,
+                char *                       chunk,
+                char *                       region,
+                bool                         toChunk)
+{
+  const size_t         numberOfDimensions = chunkDimensions.size();
+  std::vector<hsize_t> first(numberOfDimensions);
+  std::vector<hsize_t> last(numberOfDimensions);
+  for (size_t d = 0; d < numberOfDimensions; ++d)
+  {
+    first[d] = std::max(chunkOrigin[d], regionOffset[d]);
+    last[d] = std::min(chunkOrigin[d] + chunkDimensions[d], regionOffset[d] + regionSize[d]);
+    if (first[d] >= last[d])
+    {
+      return;
+    }
+  }
+
+  // Contiguous runs along the fastest dimension
+  const size_t         runBytes = (last[numberOfDimensions - 1] - first[numberOfDimensions - 1]) * elementSize;
+  std::vector<hsize_t> index(first);
+  while (true)
+  {
+    hsize_t chunkOffset = 0;
+    hsize_t regionOffsetInBuffer = 0;
+    for (size_t d = 0; d < numberOfDimensions; ++d)
+    {
+      chunkOffset = chunkOffset * chunkDimensions[d] + (index[d] - chunkOrigin[d]);
+      regionOffsetInBuffer = regionOffsetInBuffer * regionSize[d] + (index[d] - regionOffset[d]);
+    }
+    char * chunkRun = chunk + chunkOffset * elementSize;
+    char * regionRun = region + regionOffsetInBuffer * elementSize;
+    if (toChunk)
+    {
+      std::copy(regionRun, regionRun + runBytes, chunkRun);
+    }
+    else
+    {
+      std::copy(chunkRun, chunkRun + runBytes, regionRun);
+    }
+
+    // Next run, along the slower dimensions
+    size_t d = numberOfDimensions - 1;
+    while (true)
+    {
+      if (d == 0)
+      {
+        return;
+      }
+      --d;
+      if (++index[d] < last[d])
+      {
+        break;
+      }
+      index[d] = first[d];
+    }
+  }
+}
+
+// Filters of the chunks of a data set which the concurrent chunk IO applies itself
+struct ChunkFilters
+{
+  std::vector<H5Z_filter_t> filters;
+  int                       deflateLevel{ 0 };
+};
+
+bool
+GetChunkFilters(const H5::DataSet & dataSet, ChunkFilters & chunkFilters)
+{
+  const H5::DSetCreatPropList creationList = dataSet.getCreatePlist();
+  const int                   numberOfFilters = creationList.getNfilters();
+  for (int i = 0; i < numberOfFilters; ++i)
+  {
+    unsigned int flags = 0;
+    size_t       numberOfValues = 1;
+    unsigned int values[1] = { 0 };
+    char         name[64];
+    unsigned int configuration = 0;
+    const H5Z_filter_t filter =
+      creationList.getFilter(i, flags, numberOfValues, values, sizeof(name), name, configuration);
+    if (filter == H5Z_FILTER_DEFLATE)
+    {
+      chunkFilters.deflateLevel = static_cast<int>(values[0]);
+    }
+    else if (filter != H5Z_FILTER_SHUFFLE)
+    {
+      return false;
+    }
+    chunkFilters.filters.push_back(filter);
+  }
+  return true;
+}
+
+// Apply the filters to a chunk, or undo the filters which the filter mask of a
+// chunk read from the file does not exclude
+bool
+FilterChunk(const ChunkFilters &         chunkFilters,
+            size_t                       elementSize,
+            size_t                       chunkBytes,
+            std::vector<unsigned char> & data,
+            bool                         decode,
+            unsigned int                 filterMask = 0)
+{
+  std::vector<unsigned char> filtered;
+  const size_t               numberOfFilters = chunkFilters.filters.size();
+  for (size_t k = 0; k < numberOfFilters; ++k)
+  {
+    const size_t i = decode ? numberOfFilters - 1 - k : k;
+    if (filterMask & (1u << i))
+    {
+      continue;
+    }
+    if (chunkFilters.filters[i] == H5Z_FILTER_SHUFFLE)
+    {
+      // Byte j of element e is stored at j * numberOfElements + e
+      const size_t numberOfElements = data.size() / elementSize;
+      if (elementSize == 1 || numberOfElements <= 1)
+      {
+        continue;
+      }
+      filtered = data;
+      for (size_t e = 0; e < numberOfElements; ++e)
+      {
+        for (size_t j = 0; j < elementSize; ++j)
+        {
+          if (decode)
+          {
+            filtered[e * elementSize + j] = data[j * numberOfElements + e];
+          }
+          else
+          {
+            filtered[j * numberOfElements + e] = data[e * elementSize + j];
+          }
+        }
+      }
+    }
+    else if (decode)
+    {
+      filtered.resize(chunkBytes);
+      auto destinationSize = static_cast<uLongf>(chunkBytes);
+      if (uncompress(filtered.data(), &destinationSize, data.data(), static_cast<uLong>(data.size())) != Z_OK ||
+          destinationSize != chunkBytes)
+      {
+        return false;
+      }
+    }
+    else
+    {
+      auto destinationSize = static_cast<uLongf>(compressBound(static_cast<uLong>(data.size())));
+      filtered.resize(destinationSize);
+      if (compress2(filtered.data(),
+                    &destinationSize,
+                    data.data(),
+                    static_cast<uLong>(data.size()),
+                    chunkFilters.deflateLevel) != Z_OK)
+      {
+        return false;
+      }
+      filtered.resize(destinationSize);
+    }
+    data.swap(filtered);
+  }
+  return true;
+}
+
+// Origins of the chunks intersecting a region, in HDF5 order
+std::vector<std::vector<hsize_t>>
+GetChunkOrigins(const std::vector<hsize_t> & offset,
+                const std::vector<hsize_t> & size,
+                const std::vector<hsize_t> & chunkDimensions)
+{
+  const size_t         numberOfDimensions = chunkDimensions.size();
+  std::vector<hsize_t> first(numberOfDimensions);
+  std::vector<hsize_t> last(numberOfDimensions);
+  for (size_t d = 0; d < numberOfDimensions; ++d)
+  {
+    if (size[d] == 0)
+    {
+      return {};
+    }
+    first[d] = offset[d] / chunkDimensions[d] * chunkDimensions[d];
+    last[d] = offset[d] + size[d];
+  }
+  std::vector<std::vector<hsize_t>> origins;
+  std::vector<hsize_t>              origin(first);
+  while (true)
+  {
+    origins.push_back(origin);
+    size_t d = numberOfDimensions;
+    while (true)
+    {
+      if (d == 0)
+      {
+        return origins;
+      }
+      --d;
+      origin[d] += chunkDimensions[d];
+      if (origin[d] < last[d])
+      {
+        break;
+      }
+      origin[d] = first[d];
+    }
+  }
+}
+
+// Hyperslab of an IO region in the voxel data set, in HDF5 order: slowest
+// dimension first, and the components, if more than one, last
+void
+GetHyperslab(const ImageIORegion &  region,
+             unsigned int           numberOfDimensions,
+             unsigned int           numberOfComponents,
+             std::vector<hsize_t> & offset,
+             std::vector<hsize_t> & size)
+{
+  const unsigned int HDFDim = numberOfDimensions + (numberOfComponents > 1 ? 1 : 0);
+  offset.assign(HDFDim, 0);
+  size.assign(HDFDim, 1);
+  unsigned int i = 0;
+  if (numberOfComponents > 1)
+  {
+    size[HDFDim - 1] = numberOfComponents;
+    ++i;
+  }
+  for (unsigned int j = 0; j < region.GetImageDimension() && i < HDFDim; ++i, ++j)
+  {
+    offset[HDFDim - i - 1] = region.GetIndex(j);
+    size[HDFDim - i - 1] = region.GetSize(j);
+  }
+}
+
+H5::DataSet
+OpenVoxelDataSet(const H5::H5File & file, const std::string & name, SizeValueType chunkCacheSize)
+{
+  H5::DataSet dataSet = file.openDataSet(name);
+  if (chunkCacheSize > 0)
+  {
+    // The number of hash slots of the cache depends on the size of the chunks
+    std::vector<hsize_t> chunkDimensions;
+    H5::DSetAccPropList  accessList;
+    SetChunkCache(accessList, chunkCacheSize, GetChunkDimensions(dataSet, chunkDimensions));
+    dataSet.close();
+    dataSet = file.openDataSet(name, accessList);
+  }
+  return dataSet;
+}
+
+// Read the chunks covered by a region directly, inflating them concurrently.
+// Returns false if the data set or the region do not allow it.
+bool
+ReadWholeChunks(const H5::DataSet &          dataSet,
+                const H5::DataType &         memoryType,
+                const std::vector<hsize_t> & offset,
+                const std::vector<hsize_t> & size,
+                void *                       buffer)
+{
+#if H5_VERSION_GE(1, 10, 5)
+  std::vector<hsize_t> chunkDimensions;
+  const hsize_t        chunkBytes = GetChunkDimensions(dataSet, chunkDimensions);
+  const H5::DataSpace  space = dataSet.getSpace();
+  std::vector<hsize_t> dimensions(space.getSimpleExtentNdims());
+  space.getSimpleExtentDims(dimensions.data());
+  ChunkFilters chunkFilters;
+  if (chunkBytes == 0 || dimensions.size() != offset.size() || !(dataSet.getDataType() == memoryType) ||
+      !GetChunkFilters(dataSet, chunkFilters) || !CoversWholeChunks(offset, size, chunkDimensions, dimensions))
+  {
+    return false;
+  }
+  const std::vector<std::vector<hsize_t>> origins = GetChunkOrigins(offset, size, chunkDimensions);
+  if (origins.size() < 2)
+  {
+    return false;
+  }
+
+  const size_t elementSize = memoryType.getSize();
+
+  // The chunks which were never written hold the fill value of the data set
+  std::vector<unsigned char>  fillValue(elementSize, 0);
+  const H5::DSetCreatPropList creationList = dataSet.getCreatePlist();
+  if (creationList.isFillValueDefined() == H5D_FILL_VALUE_USER_DEFINED)
+  {
+    creationList.getFillValue(memoryType, fillValue.data());
+  }
+
+  const size_t chunksPerBatch = static_cast<size_t>(std::max<hsize_t>(1, ChunkBatchBytes / chunkBytes));
+  for (size_t batchStart = 0; batchStart < origins.size(); batchStart += chunksPerBatch)
+  {
+    const size_t                            batchSize = std::min(chunksPerBatch, origins.size() - batchStart);
+    std::vector<std::vector<unsigned char>> chunks(batchSize);
+    std::vector<unsigned int>               filterMasks(batchSize, 0);
+    for (size_t k = 0; k < batchSize; ++k)
+    {
+      // A chunk which was never written has no storage
+      haddr_t address = HADDR_UNDEF;
+      hsize_t storageSize = 0;
+      if (H5Dget_chunk_info_by_coord(
+            dataSet.getId(), origins[batchStart + k].data(), &filterMasks[k], &address, &storageSize) < 0)
+      {
+        return false;
+      }
+      chunks[k].resize(address == HADDR_UNDEF ? 0 : static_cast<size_t>(storageSize));
+      if (storageSize > 0 &&
+          H5Dread_chunk(
+            dataSet.getId(), H5P_DEFAULT, origins[batchStart + k].data(), &filterMasks[k], chunks[k].data()) < 0)
+      {
+        return false;
+      }
+    }
+
+    std::vector<char> failed(batchSize, 0);
+    MultiThreaderBase::New()->ParallelizeArray(
+      0,
+      batchSize,
+      [&](SizeValueType k) {
+        std::vector<unsigned char> & data = chunks[k];
+        if (data.empty())
+        {
+          data.resize(static_cast<size_t>(chunkBytes));
+          for (auto it = data.begin(); it != data.end(); it += elementSize)
+          {
+            std::copy(fillValue.cbegin(), fillValue.cend(), it);
+          }
+        }
+        else if (!FilterChunk(chunkFilters, elementSize, static_cast<size_t>(chunkBytes), data, true, filterMasks[k]) ||
+                 data.size() != chunkBytes)
+        {
+          failed[k] = 1;
+          return;
+        }
+        CopyChunkRegion(origins[batchStart + k],
+                        chunkDimensions,
+                        offset,
+                        size,
+                        elementSize,
+                        reinterpret_cast<char *>(data.data()),
+                        static_cast<char *>(buffer),
+                        false);
+        std::vector<unsigned char>().swap(data);
+      },
+      nullptr);
+    if (std::find(failed.cbegin(), failed.cend(), 1) != failed.cend())
+    {
+      return false;
+    }
+  }
+  return true;
+#else
+  (void)dataSet;
+  (void)memoryType;
+  (void)offset;
+  (void)size;
+  (void)buffer;
+  return false;
+#endif
+}
+
+// Write the chunks covered by a region directly, filtering them concurrently.
+// Returns false if the data set or the region do not allow it.
+bool
+WriteWholeChunks(const H5::DataSet &          dataSet,
+                 const H5::DataType &         memoryType,
+                 const std::vector<hsize_t> & offset,
+                 const std::vector<hsize_t> & size,
+                 const void *                 buffer)
+{
+#if H5_VERSION_GE(1, 10, 3)
+  std::vector<hsize_t> chunkDimensions;
+  const hsize_t        chunkBytes = GetChunkDimensions(dataSet, chunkDimensions);
+  const H5::DataSpace  space = dataSet.getSpace();
+  std::vector<hsize_t> dimensions(space.getSimpleExtentNdims());
+  space.getSimpleExtentDims(dimensions.data());
+  ChunkFilters chunkFilters;
+  if (chunkBytes == 0 || dimensions.size() != offset.size() || !(dataSet.getDataType() == memoryType) ||
+      !GetChunkFilters(dataSet, chunkFilters) || chunkFilters.filters.empty() ||
+      !CoversWholeChunks(offset, size, chunkDimensions, dimensions))
+  {
+    return false;
+  }
+  const std::vector<std::vector<hsize_t>> origins = GetChunkOrigins(offset, size, chunkDimensions);
+  if (origins.size() < 2)
+  {
+    return false;
+  }
+
+  const size_t elementSize = memoryType.getSize();
+  const size_t chunksPerBatch = static_cast<size_t>(std::max<hsize_t>(1, ChunkBatchBytes / chunkBytes));
+  for (size_t batchStart = 0; batchStart < origins.size(); batchStart += chunksPerBatch)
+  {
+    const size_t                            batchSize = std::min(chunksPerBatch, origins.size() - batchStart);
+    std::vector<std::vector<unsigned char>> chunks(batchSize);
+    std::vector<char>                       failed(batchSize, 0);
+    MultiThreaderBase::New()->ParallelizeArray(
+      0,
+      batchSize,
+      [&](SizeValueType k) {
+        // The chunks at the end of the data set are padded
+        std::vector<unsigned char> & data = chunks[k];
+        data.assign(static_cast<size_t>(chunkBytes), 0);
+        CopyChunkRegion(origins[batchStart + k],
+                        chunkDimensions,
+                        offset,
+                        size,
+                        elementSize,
+                        reinterpret_cast<char *>(data.data()),
+                        const_cast<char *>(static_cast<const char *>(buffer)),
+                        true);
+        failed[k] = !FilterChunk(chunkFilters, elementSize, static_cast<size_t>(chunkBytes), data, false);
+      },
+      nullptr);
+    if (std::find(failed.cbegin(), failed.cend(), 1) != failed.cend())
+    {
+      return false;
+    }
+
+    for (size_t k = 0; k < batchSize; ++k)
+    {
+      if (H5Dwrite_chunk(
+            dataSet.getId(), H5P_DEFAULT, 0, origins[batchStart + k].data(), chunks[k].size(), chunks[k].data()) < 0)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+#else
+  (void)dataSet;
+  (void)memoryType;
+  (void)offset;
+  (void)size;
+  (void)buffer;
+  return false;
+#endif
+}
+
 } // namespace
 
 void
@@ -712,7 +1229,7 @@ HDF5ImageIO ::ReadImageInformation()
 
     std::string VoxelDataName(groupName);
     VoxelDataName += VoxelData;
-    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    *(this->m_VoxelDataSet) = OpenVoxelDataSet(*this->m_H5File, VoxelDataName, this->m_ChunkCacheSize);
     H5::DataSet   imageSet = *(this->m_VoxelDataSet);
     H5::DataSpace imageSpace = imageSet.getSpace();
     //
@@ -908,58 +1425,178 @@ HDF5ImageIO ::ReadImageInformation()
 void
 HDF5ImageIO ::SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace)
 {
-  ImageIORegion            regionToRead = this->GetIORegion();
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
-  //
-  int numComponents = this->GetNumberOfComponents();
+  std::vector<hsize_t> offset;
+  std::vector<hsize_t> HDFSize;
+  GetHyperslab(this->GetIORegion(), this->GetNumberOfDimensions(), this->GetNumberOfComponents(), offset, HDFSize);
 
-  const int HDFDim(this->GetNumberOfDimensions() + (numComponents > 1 ? 1 : 0));
+  slabSpace->setExtentSimple(static_cast<int>(HDFSize.size()), HDFSize.data());
+  imageSpace->selectHyperslab(H5S_SELECT_SET, HDFSize.data(), offset.data());
+}
 
-  const std::unique_ptr<hsize_t[]> offset(new hsize_t[HDFDim]);
-  const std::unique_ptr<hsize_t[]> HDFSize(new hsize_t[HDFDim]);
-  const int                        limit = regionToRead.GetImageDimension();
-  //
-  // fastest moving dimension is intra-voxel
-  // index
-  int i = 0;
-  if (numComponents > 1)
+void
+HDF5ImageIO ::Read(void * buffer)
+{
+  try
   {
-    offset[HDFDim - 1] = 0;
-    HDFSize[HDFDim - 1] = numComponents;
-    ++i;
+    // Regions made of several whole chunks are inflated concurrently
+    std::vector<hsize_t> offset;
+    std::vector<hsize_t> size;
+    GetHyperslab(this->GetIORegion(), this->GetNumberOfDimensions(), this->GetNumberOfComponents(), offset, size);
+    if (ReadWholeChunks(*this->m_VoxelDataSet, ComponentToPredType(this->GetComponentType()), offset, size, buffer))
+    {
+      return;
+    }
+
+    H5::DataType  voxelType = this->m_VoxelDataSet->getDataType();
+    H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
+
+    H5::DataSpace dspace;
+    this->SetupStreaming(&imageSpace, &dspace);
+    this->m_VoxelDataSet->read(buffer, voxelType, dspace, imageSpace);
+  }
+  // catch failure caused by the DataSet operations
+  catch (H5::DataSetIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
   }
+  // catch failure caused by the DataSpace operations
+  catch (H5::DataSpaceIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  // catch failure caused by the DataSpace operations
+  catch (H5::DataTypeIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+  // catch failure caused by the property list operations
+  catch (H5::PropListIException & error)
+  {
+    itkExceptionMacro(<< error.getCDetailMsg());
+  }
+}
 
-  for (int j = 0; j < limit && i < HDFDim; ++i, ++j)
+std::vector<ImageIOBase::SizeValueType>
+HDF5ImageIO ::ComputeChunkSize() const
+{
+  const unsigned int         numDims = this->GetNumberOfDimensions();
+  std::vector<SizeValueType> chunkSize(numDims);
+  for (unsigned int i = 0; i < numDims; ++i)
+  {
+    chunkSize[i] = this->GetDimensions(i);
+    if (i < this->m_ChunkSize.size() && this->m_ChunkSize[i] > 0)
+    {
+      chunkSize[i] = std::min(this->m_ChunkSize[i], chunkSize[i]);
+    }
+  }
+  // By default, a chunk is a slice along the slowest moving dimension
+  if (this->m_ChunkSize.empty() && numDims > 0)
   {
-    offset[HDFDim - i - 1] = start[j];
-    HDFSize[HDFDim - i - 1] = size[j];
+    chunkSize[numDims - 1] = 1;
   }
 
-  while (i < HDFDim)
+  // HDF5 limits the size of a chunk to 4 GB
+  const auto chunkBytes = [&]() -> hsize_t {
+    hsize_t bytes = this->GetComponentSize() * this->GetNumberOfComponents();
+    for (const auto extent : chunkSize)
+    {
+      bytes *= extent;
+    }
+    return bytes;
+  };
+  for (unsigned int i = numDims; i > 0 && chunkBytes() > MaximumChunkBytes;)
   {
-    offset[HDFDim - i - 1] = 0;
-    HDFSize[HDFDim - i - 1] = 1;
-    ++i;
+    if (chunkSize[i - 1] > 1)
+    {
+      chunkSize[i - 1] = (chunkSize[i - 1] + 1) / 2;
+    }
+    else
+    {
+      --i;
+    }
   }
+  return chunkSize;
+}
 
-  slabSpace->setExtentSimple(HDFDim, HDFSize.get());
-  imageSpace->selectHyperslab(H5S_SELECT_SET, HDFSize.get(), offset.get());
+unsigned int
+HDF5ImageIO ::GetChunkRowsForWriting(const ImageIORegion & pasteRegion,
+                                     SizeValueType &       firstRow,
+                                     SizeValueType &       lastRow) const
+{
+  // The pieces are split along the slowest moving dimension of the region
+  unsigned int axis = std::min(pasteRegion.GetImageDimension(), this->GetNumberOfDimensions());
+  while (axis > 0 && pasteRegion.GetSize(axis - 1) <= 1)
+  {
+    --axis;
+  }
+  if (axis == 0)
+  {
+    firstRow = 0;
+    lastRow = 1;
+    return 0;
+  }
+  --axis;
+
+  const SizeValueType chunkExtent = this->ComputeChunkSize()[axis];
+  const auto          start = static_cast<SizeValueType>(pasteRegion.GetIndex(axis));
+  firstRow = start / chunkExtent;
+  lastRow = (start + pasteRegion.GetSize(axis) + chunkExtent - 1) / chunkExtent;
+  return axis;
 }
 
-void
-HDF5ImageIO ::Read(void * buffer)
+unsigned int
+HDF5ImageIO ::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
 {
-  ImageIORegion            regionToRead = this->GetIORegion();
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
+  // A new write starts: the image information is written again, or the
+  // existing file opened for pasting
+  this->CloseDataSet();
+  this->CloseH5File();
+  this->m_ImageInformationWritten = false;
 
-  H5::DataType  voxelType = this->m_VoxelDataSet->getDataType();
-  H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
+  const unsigned int numberOfSplits =
+    Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
 
-  H5::DataSpace dspace;
-  this->SetupStreaming(&imageSpace, &dspace);
-  this->m_VoxelDataSet->read(buffer, voxelType, dspace, imageSpace);
+  // Each piece is made of whole rows of chunks, so that no chunk is written twice
+  SizeValueType firstRow = 0;
+  SizeValueType lastRow = 0;
+  this->GetChunkRowsForWriting(pasteRegion, firstRow, lastRow);
+  return static_cast<unsigned int>(
+    std::max<SizeValueType>(1, std::min<SizeValueType>(numberOfSplits, lastRow - firstRow)));
+}
+
+ImageIORegion
+HDF5ImageIO ::GetSplitRegionForWriting(unsigned int          ithPiece,
+                                       unsigned int          numberOfActualSplits,
+                                       const ImageIORegion & pasteRegion,
+                                       const ImageIORegion & itkNotUsed(largestPossibleRegion))
+{
+  ImageIORegion splitRegion = pasteRegion;
+  if (numberOfActualSplits <= 1)
+  {
+    return splitRegion;
+  }
+
+  SizeValueType      firstRow = 0;
+  SizeValueType      lastRow = 0;
+  const unsigned int axis = this->GetChunkRowsForWriting(pasteRegion, firstRow, lastRow);
+  const auto         chunkExtent = static_cast<IndexValueType>(this->ComputeChunkSize()[axis]);
+  const SizeValueType numberOfRows = lastRow - firstRow;
+  const auto          boundary = [&](unsigned int piece) -> IndexValueType {
+    if (piece == 0)
+    {
+      return pasteRegion.GetIndex(axis);
+    }
+    if (piece == numberOfActualSplits)
+    {
+      return pasteRegion.GetIndex(axis) + static_cast<IndexValueType>(pasteRegion.GetSize(axis));
+    }
+    return static_cast<IndexValueType>(firstRow + numberOfRows * piece / numberOfActualSplits) * chunkExtent;
+  };
+  splitRegion.SetIndex(axis, boundary(ithPiece));
+  splitRegion.SetSize(axis, static_cast<SizeValueType>(boundary(ithPiece + 1) - boundary(ithPiece)));
+  return splitRegion;
 }
 
 template <typename TType>
@@ -1014,6 +1651,21 @@ HDF5ImageIO ::WriteImageInformation()
     this->CloseH5File();
     this->CloseDataSet();
 
+    std::string VoxelDataName(ImageGroup);
+    VoxelDataName += "/0";
+    VoxelDataName += VoxelData;
+
+    // Pasting into an existing file, whose image information was checked by
+    // GetActualNumberOfSplitsForWriting
+    if (this->RequestedToStream() && itksys::SystemTools::FileExists(this->GetFileName()))
+    {
+      this->m_H5File = new H5::H5File(this->GetFileName(), H5F_ACC_RDWR);
+      this->m_VoxelDataSet = new H5::DataSet();
+      *(this->m_VoxelDataSet) = OpenVoxelDataSet(*this->m_H5File, VoxelDataName, this->m_ChunkCacheSize);
+      this->m_ImageInformationWritten = true;
+      return;
+    }
+
     H5::FileAccPropList fapl;
 #if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) ||                                             \
   (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
@@ -1072,21 +1724,27 @@ HDF5ImageIO ::WriteImageInformation()
     H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
-    H5::DSetCreatPropList plist;
-
-    // we have implicit compression enabled here?
-    plist.setDeflate(this->GetCompressionLevel());
-
-    dims[0] = 1;
+    // by default, the chunk size is the N-1 dimension region
+    H5::DSetCreatPropList            plist;
+    const std::vector<SizeValueType> chunkSize = this->ComputeChunkSize();
+    hsize_t                          chunkBytes = this->GetComponentSize() * numComponents;
+    for (int i(0), j(this->GetNumberOfDimensions() - 1); j >= 0; i++, j--)
+    {
+      dims[i] = chunkSize[j];
+      chunkBytes *= chunkSize[j];
+    }
     plist.setChunk(numDims, dims.get());
     dims.reset();
 
-    std::string VoxelDataName(ImageGroup);
-    VoxelDataName += "/0";
-    VoxelDataName += VoxelData;
-    *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist);
+    if (this->m_UseShuffleFilter)
+    {
+      plist.setShuffle();
+    }
+    plist.setDeflate(this->GetCompressionLevel());
+
+    H5::DSetAccPropList accessList;
+    SetChunkCache(accessList, this->m_ChunkCacheSize, chunkBytes);
+    *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist, accessList);
     std::string MetaDataGroupName(groupName);
     MetaDataGroupName += MetaDataName;
     this->m_H5File->createGroup(MetaDataGroupName);
@@ -1277,6 +1935,16 @@ HDF5ImageIO ::Write(const void * buffer)
     }
     H5::DataSpace imageSpace(numDims, dims.get());
     H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
+
+    // Regions made of several whole chunks are compressed concurrently
+    std::vector<hsize_t> offset;
+    std::vector<hsize_t> size;
+    GetHyperslab(this->GetIORegion(), this->GetNumberOfDimensions(), numComponents, offset, size);
+    if (WriteWholeChunks(*this->m_VoxelDataSet, dataType, offset, size, buffer))
+    {
+      return;
+    }
+
     H5::DataSpace dspace;
     this->SetupStreaming(&imageSpace, &dspace);
     this->m_VoxelDataSet->write(buffer, dataType, dspace, imageSpace);
@@ -0,0 +1,321 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGenerateImageSource.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+#include "itk_H5Cpp.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+using VectorImageType = itk::Image<itk::Vector<float, 3>, 2>;
+
+short
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<short>(index[0] + 61 * index[1] - 100 * index[2]);
+}
+
+itk::Vector<float, 3>
+ExpectedValue(const VectorImageType::IndexType & index)
+{
+  itk::Vector<float, 3> pixel;
+  pixel[0] = index[0];
+  pixel[1] = index[1];
+  pixel[2] = 0.25f * index[0] * index[1];
+  return pixel;
+}
+
+// Streamable source of the expected pixel values, which generates the
+// requested regions only
+template <typename TOutputImage>
+class ExpectedImageSource : public itk::GenerateImageSource<TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ExpectedImageSource);
+
+  using Self = ExpectedImageSource;
+  using Superclass = itk::GenerateImageSource<TOutputImage>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ExpectedImageSource, GenerateImageSource);
+
+protected:
+  ExpectedImageSource() = default;
+  ~ExpectedImageSource() override = default;
+
+  void
+  GenerateData() override
+  {
+    TOutputImage * output = this->GetOutput();
+    output->SetBufferedRegion(output->GetRequestedRegion());
+    output->Allocate();
+    for (itk::ImageRegionIteratorWithIndex<TOutputImage> it(output, output->GetRequestedRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      it.Set(ExpectedValue(it.GetIndex()));
+    }
+  }
+};
+
+template <typename TImage>
+bool
+HasExpectedValues(const TImage * image, const typename TImage::RegionType & region)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Read a region of a file, which HDF5ImageIO reads alone
+template <typename TImage>
+typename TImage::Pointer
+ReadRegion(const std::string & fileName, const typename TImage::RegionType & region, itk::SizeValueType cacheSize)
+{
+  auto io = itk::HDF5ImageIO::New();
+  io->SetChunkCacheSize(cacheSize);
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+template <typename TImage>
+int
+WriteAndReadImage(const std::string &                     fileName,
+                  const typename TImage::SizeType &       size,
+                  const std::vector<itk::SizeValueType> & chunkSize,
+                  bool                                    useCompression,
+                  bool                                    useShuffleFilter,
+                  unsigned int                            numberOfStreamDivisions,
+                  const typename TImage::RegionType &     subRegion)
+{
+  std::cout << fileName << std::endl;
+  auto source = ExpectedImageSource<TImage>::New();
+  source->SetSize(size);
+  auto monitor = itk::PipelineMonitorImageFilter<TImage>::New();
+  monitor->SetInput(source->GetOutput());
+
+  auto io = itk::HDF5ImageIO::New();
+  io->SetChunkSize(chunkSize);
+  io->SetUseShuffleFilter(useShuffleFilter);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetImageIO(io);
+  writer->SetUseCompression(useCompression);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // The streamed pieces start on chunk boundaries
+  constexpr unsigned int splitAxis = TImage::ImageDimension - 1;
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyInputFilterExecutedStreaming(static_cast<int>(numberOfStreamDivisions)));
+  for (const auto & region : monitor->GetUpdatedBufferedRegions())
+  {
+    ITK_TEST_EXPECT_EQUAL(region.GetIndex(splitAxis) % static_cast<itk::IndexValueType>(chunkSize[splitAxis]), 0);
+  }
+
+  const typename TImage::RegionType largestRegion(size);
+  typename TImage::Pointer          whole;
+  ITK_TRY_EXPECT_NO_EXCEPTION(whole = ReadRegion<TImage>(fileName, largestRegion, 0));
+  ITK_TEST_EXPECT_EQUAL(whole->GetBufferedRegion(), largestRegion);
+  ITK_TEST_EXPECT_TRUE(HasExpectedValues(whole.GetPointer(), whole->GetBufferedRegion()));
+
+  // Partial chunks, through the chunk cache or not
+  for (const itk::SizeValueType cacheSize : { itk::SizeValueType{ 0 }, itk::SizeValueType{ 1 } << 20 })
+  {
+    typename TImage::Pointer part;
+    ITK_TRY_EXPECT_NO_EXCEPTION(part = ReadRegion<TImage>(fileName, subRegion, cacheSize));
+    ITK_TEST_EXPECT_EQUAL(part->GetBufferedRegion(), subRegion);
+    ITK_TEST_EXPECT_TRUE(HasExpectedValues(part.GetPointer(), subRegion));
+  }
+  return EXIT_SUCCESS;
+}
+// Recreate the voxel data set of a file with a fill value, writing back only
+// the given region of its data, in HDF5 order
+void
+RewriteVoxelDataWithFillValue(const std::string & fileName,
+                              short               fillValue,
+                              const hsize_t *     offset,
+                              const hsize_t *     size)
+{
+  const std::string     name = "/ITKImage/0/VoxelData";
+  H5::H5File            file(fileName, H5F_ACC_RDWR);
+  H5::DataSet           dataSet = file.openDataSet(name);
+  H5::DSetCreatPropList creationList = dataSet.getCreatePlist();
+  const H5::DataType    dataType = dataSet.getDataType();
+  H5::DataSpace         space = dataSet.getSpace();
+  std::vector<short>    values(static_cast<size_t>(space.getSimpleExtentNpoints()));
+  dataSet.read(values.data(), H5::PredType::NATIVE_SHORT);
+  dataSet.close();
+  file.unlink(name);
+
+  creationList.setFillValue(H5::PredType::NATIVE_SHORT, &fillValue);
+  dataSet = file.createDataSet(name, dataType, space, creationList);
+  space.selectHyperslab(H5S_SELECT_SET, size, offset);
+  dataSet.write(values.data(), H5::PredType::NATIVE_SHORT, space, space);
+}
+} // namespace
+
+int
+itkHDF5ImageIOChunkingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  auto io = itk::HDF5ImageIO::New();
+  ITK_TEST_EXPECT_TRUE(io->GetChunkSize().empty());
+  const std::vector<itk::SizeValueType> chunkSize{ 16, 16, 8 };
+  io->SetChunkSize(chunkSize);
+  ITK_TEST_EXPECT_TRUE(io->GetChunkSize() == chunkSize);
+  ITK_TEST_SET_GET_BOOLEAN(io, UseShuffleFilter, true);
+  io->SetChunkCacheSize(4096);
+  ITK_TEST_SET_GET_VALUE(4096, io->GetChunkCacheSize());
+
+  const ImageType::SizeType   size = { { 61, 47, 29 } };
+  const ImageType::RegionType subRegion({ { 5, 13, 3 } }, { { 40, 20, 17 } });
+  const ImageType::RegionType chunkRegion({ { 16, 0, 8 } }, { { 32, 47, 16 } });
+
+  int status = EXIT_SUCCESS;
+  status |= WriteAndReadImage<ImageType>(
+    directory + "/itkHDF5ImageIOChunkingTest.hdf5", size, chunkSize, true, true, 1, subRegion);
+  status |= WriteAndReadImage<ImageType>(
+    directory + "/itkHDF5ImageIOChunkingTestUnshuffled.hdf5", size, chunkSize, false, false, 1, chunkRegion);
+  status |= WriteAndReadImage<ImageType>(
+    directory + "/itkHDF5ImageIOChunkingTestDefault.hdf5", size, { 0, 0, 1 }, true, false, 1, subRegion);
+  status |= WriteAndReadImage<ImageType>(
+    directory + "/itkHDF5ImageIOChunkingTestStreamed.hdf5", size, chunkSize, true, true, 3, chunkRegion);
+
+  const VectorImageType::SizeType   sizeVector = { { 45, 38 } };
+  const VectorImageType::RegionType subRegionVector({ { 7, 9 } }, { { 30, 20 } });
+  status |= WriteAndReadImage<VectorImageType>(
+    directory + "/itkHDF5ImageIOChunkingTestVector.hdf5", sizeVector, { 10, 10 }, true, true, 2, subRegionVector);
+
+  // Streamed writes are split along rows of chunks
+  io->SetFileName(directory + "/itkHDF5ImageIOChunkingTestSplit.hdf5");
+  io->SetNumberOfDimensions(3);
+  io->SetComponentType(itk::IOComponentEnum::SHORT);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    io->SetDimensions(i, size[i]);
+  }
+  itk::ImageIORegion largestRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    largestRegion.SetSize(i, size[i]);
+  }
+  const unsigned int numberOfSplits = io->GetActualNumberOfSplitsForWriting(10, largestRegion, largestRegion);
+  ITK_TEST_EXPECT_EQUAL(numberOfSplits, 4u);
+  itk::IndexValueType nextIndex = 0;
+  for (unsigned int piece = 0; piece < numberOfSplits; ++piece)
+  {
+    const itk::ImageIORegion region =
+      io->GetSplitRegionForWriting(piece, numberOfSplits, largestRegion, largestRegion);
+    ITK_TEST_EXPECT_EQUAL(region.GetIndex(2), nextIndex);
+    ITK_TEST_EXPECT_EQUAL(region.GetIndex(2) % 8, 0);
+    nextIndex = region.GetIndex(2) + static_cast<itk::IndexValueType>(region.GetSize(2));
+  }
+  ITK_TEST_EXPECT_EQUAL(nextIndex, 29);
+
+  // Pasting into an existing file keeps the rest of the image
+  const std::string pasteFileName = directory + "/itkHDF5ImageIOChunkingTestPaste.hdf5";
+  auto              zeros = ImageType::New();
+  zeros->SetRegions(size);
+  zeros->Allocate(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(zeros, pasteFileName, true));
+
+  auto pasteIO = itk::HDF5ImageIO::New();
+  pasteIO->SetChunkSize(chunkSize);
+  auto source = ExpectedImageSource<ImageType>::New();
+  source->SetSize(size);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(source->GetOutput());
+  writer->SetFileName(pasteFileName);
+  writer->SetImageIO(pasteIO);
+  writer->SetUseCompression(true);
+  itk::ImageIORegion pasteRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    pasteRegion.SetIndex(i, subRegion.GetIndex()[i]);
+    pasteRegion.SetSize(i, subRegion.GetSize()[i]);
+  }
+  writer->SetIORegion(pasteRegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  ImageType::Pointer pasted;
+  ITK_TRY_EXPECT_NO_EXCEPTION(pasted = ReadRegion<ImageType>(pasteFileName, zeros->GetLargestPossibleRegion(), 0));
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(pasted, pasted->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const short expected = subRegion.IsInside(it.GetIndex()) ? ExpectedValue(it.GetIndex()) : 0;
+    if (it.Get() != expected)
+    {
+      std::cerr << "Wrong pasted value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The chunks which were never written hold the fill value of the data set
+  const std::string fillFileName = directory + "/itkHDF5ImageIOChunkingTestFillValue.hdf5";
+  auto              fillIO = itk::HDF5ImageIO::New();
+  fillIO->SetChunkSize(chunkSize);
+  auto fillWriter = itk::ImageFileWriter<ImageType>::New();
+  fillWriter->SetInput(source->GetOutput());
+  fillWriter->SetFileName(fillFileName);
+  fillWriter->SetImageIO(fillIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(fillWriter->Update());
+  const hsize_t               writtenOffset[] = { 8, 16, 16 };
+  const hsize_t               writtenSize[] = { 8, 16, 16 };
+  const ImageType::RegionType writtenRegion({ { 16, 16, 8 } }, { { 16, 16, 8 } });
+  constexpr short             fillValue = 7;
+  RewriteVoxelDataWithFillValue(fillFileName, fillValue, writtenOffset, writtenSize);
+
+  ImageType::Pointer filled;
+  ITK_TRY_EXPECT_NO_EXCEPTION(filled = ReadRegion<ImageType>(fillFileName, zeros->GetLargestPossibleRegion(), 0));
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(filled, filled->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const short expected = writtenRegion.IsInside(it.GetIndex()) ? ExpectedValue(it.GetIndex()) : fillValue;
+    if (it.Get() != expected)
+    {
+      std::cerr << "Wrong filled value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -55,6 +55,11 @@ namespace itk
  * raw binary format) have no accepted suffix, so you will have to
  * manually create the ImageIO instance of the write type.
  *
+ * When UseMemoryMapping is enabled on the ImageIO, and the pixels in the
+ * file have the type of the output pixels and need no conversion, the
+ * file is mapped in memory instead of read: the output pixel container is
+ * then a MemoryMappedImageContainer, and no buffer is allocated.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
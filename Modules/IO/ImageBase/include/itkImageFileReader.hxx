@@ -22,6 +22,7 @@
 #include "itkObjectFactory.h"
 #include "itkImageIOFactory.h"
 #include "itkConvertPixelBuffer.h"
+#include "itkMemoryMappedImageContainer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
@@ -356,13 +357,6 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   typename TOutputImage::Pointer output = this->GetOutput();
 
-  itkDebugMacro(<< "ImageFileReader::GenerateData() \n"
-                << "Allocating the buffer with the EnlargedRequestedRegion \n"
-                << output->GetRequestedRegion() << "\n");
-
-  // allocated the output image to the size of the enlarge requested region
-  this->AllocateOutputs();
-
   // Test if the file exists and if it can be opened.
   // An exception will be thrown otherwise, since we can't
   // successfully read the file. We catch the exception because some
@@ -392,8 +386,38 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     m_ActualIORegion.GetNumberOfPixels() * (m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
 
   IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
-  if (m_ImageIO->GetComponentType() != ioType ||
-      (m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()))
+  const bool      conversionRequired = m_ImageIO->GetComponentType() != ioType ||
+                                  m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents();
+
+  if (!conversionRequired && m_ImageIO->GetUseMemoryMapping() &&
+      m_ActualIORegion.GetNumberOfPixels() == output->GetRequestedRegion().GetNumberOfPixels())
+  {
+    MemoryMappedFile::Pointer mappedFile = m_ImageIO->MapImageData();
+    if (mappedFile)
+    {
+      itkDebugMacro(<< "Using the memory mapped image data.");
+
+      using PixelContainerType = typename TOutputImage::PixelContainer;
+      using MappedContainerType =
+        MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier, typename PixelContainerType::Element>;
+      auto container = MappedContainerType::New();
+      container->SetMappedFile(mappedFile);
+      output->SetBufferedRegion(output->GetRequestedRegion());
+      output->SetPixelContainer(container);
+
+      this->UpdateProgress(1.0f);
+      return;
+    }
+  }
+
+  itkDebugMacro(<< "ImageFileReader::GenerateData() \n"
+                << "Allocating the buffer with the EnlargedRequestedRegion \n"
+                << output->GetRequestedRegion() << "\n");
+
+  // allocated the output image to the size of the enlarge requested region
+  this->AllocateOutputs();
+
+  if (conversionRequired)
   {
     // the pixel types don't match so a type conversion needs to be
     // performed
@@ -33,6 +33,7 @@
 #include "itkVariableSizeMatrix.h"
 #include "itkImageRegionSplitterBase.h"
 #include "itkCommonEnums.h"
+#include "itkMemoryMappedFile.h"
 
 #include "vnl/vnl_vector.h"
 #include "vcl_compiler.h"
@@ -293,6 +294,12 @@ public:
   itkGetConstMacro(UseStreamedWriting, bool);
   itkBooleanMacro(UseStreamedWriting);
 
+  /** Set/Get a boolean to map the pixels of the file in memory instead of
+   * reading them, when the file format allows it. See MapImageData(). */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
   /** Set/Get a boolean to perform RGB palette expansion.
    * If true, palette image is read as RGB,
    * if false, palette image is read as Scalar+Palette.
@@ -440,6 +447,16 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Maps the pixels of the IORegion in memory, as Read() would have
+   * stored them in a buffer. Returns nullptr if UseMemoryMapping is off, or
+   * if the pixels are not stored in the file exactly as in memory: e.g. when
+   * they are compressed, in ASCII, in another byte order, or when the
+   * IORegion is not contiguous in the file. Read() must be used then.
+   *
+   * The ImageIOs supporting this implement GetRawImageDataLocation(). */
+  virtual MemoryMappedFile::Pointer
+  MapImageData();
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -695,6 +712,14 @@ protected:
   virtual bool
   HasSupportedWriteExtension(const char * fileName, bool ignoreCase = true);
 
+  /** Get the name of the file which contains the pixels, and the offset of
+   * the first one, when all the pixels of the image are stored there
+   * contiguously, uncompressed and in binary form, with the layout of an
+   * image buffer. Returns false otherwise, which is the default. Used by
+   * MapImageData(), which checks the byte order and the IORegion. */
+  virtual bool
+  GetRawImageDataLocation(std::string & fileName, SizeValueType & offset);
+
   /** Used internally to keep track of the type of the pixel. */
   IOPixelEnum m_PixelType{ IOPixelEnum::SCALAR };
 
@@ -745,6 +770,9 @@ protected:
   /** Should we use streaming for writing */
   bool m_UseStreamedWriting;
 
+  /** Should we map the pixels instead of reading them */
+  bool m_UseMemoryMapping{ false };
+
   /** Should we expand RGB palette or stay scalar */
   bool m_ExpandRGBPalette;
 
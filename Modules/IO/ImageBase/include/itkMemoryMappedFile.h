@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief A range of bytes of a file, mapped in memory
+ *
+ * The mapping is private and copy-on-write: the memory may be modified, the
+ * modified pages are then copied, and the file is never changed. The pages
+ * are read from the file when they are first accessed.
+ *
+ * The range does not need to start on a page boundary; GetBuffer() points
+ * to its first byte. The mapping is released by Unmap() or when the object
+ * is destroyed.
+ *
+ * \sa ImageIOBase::MapImageData()
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFile : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFile);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFile;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFile, Object);
+
+  /** Map numberOfBytes bytes of the file fileName, starting at offset. An
+   * exception is thrown if the file cannot be opened, is too short, or
+   * cannot be mapped. A previous mapping is released. */
+  void
+  Map(const std::string & fileName, SizeValueType offset, SizeValueType numberOfBytes);
+
+  /** Release the mapping. */
+  void
+  Unmap();
+
+  /** Pointer to the first mapped byte, nullptr if nothing is mapped. */
+  void *
+  GetBuffer() const
+  {
+    return m_Buffer;
+  }
+
+  itkGetConstMacro(NumberOfBytes, SizeValueType);
+  itkGetConstReferenceMacro(FileName, std::string);
+  itkGetConstMacro(Offset, SizeValueType);
+
+protected:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::string   m_FileName;
+  SizeValueType m_Offset{ 0 };
+  SizeValueType m_NumberOfBytes{ 0 };
+  void *        m_Buffer{ nullptr };
+
+  /** Start and length of the mapped pages, which contain the range. */
+  void *        m_Mapping{ nullptr };
+  SizeValueType m_MappingLength{ 0 };
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedFile_h
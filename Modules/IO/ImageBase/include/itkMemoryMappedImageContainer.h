@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_h
+#define itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ * \brief Pixel container whose elements are the mapped bytes of a file
+ *
+ * The container imports the buffer of a MemoryMappedFile without managing
+ * it, and keeps a reference to the mapping so that the memory stays valid
+ * as long as the container uses it. It is used by ImageFileReader when the
+ * ImageIO maps the pixels of the file instead of reading them.
+ *
+ * Since the mapping is copy-on-write, the pixels may be modified without
+ * changing the file.
+ *
+ * \sa ImageIOBase::MapImageData()
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using ElementIdentifier = TElementIdentifier;
+  using Element = TElement;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Use the mapped bytes of file as the elements of the container. */
+  void
+  SetMappedFile(MemoryMappedFile * file)
+  {
+    if (file == nullptr)
+    {
+      this->Initialize();
+    }
+    else
+    {
+      this->SetImportPointer(static_cast<TElement *>(file->GetBuffer()),
+                             static_cast<TElementIdentifier>(file->GetNumberOfBytes() / sizeof(TElement)),
+                             false);
+    }
+    m_MappedFile = file;
+  }
+  itkGetModifiableObjectMacro(MappedFile, MemoryMappedFile);
+
+protected:
+  MemoryMappedImageContainer() = default;
+  ~MemoryMappedImageContainer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    itkPrintSelfObjectMacro(MappedFile);
+  }
+
+private:
+  MemoryMappedFile::Pointer m_MappedFile;
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedImageContainer_h
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelDeflate_h
+#define itkParallelDeflate_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelDeflate
+ * \brief Multi-threaded deflate compression into standard zlib or gzip streams
+ *
+ * The data is split in chunks which are deflated concurrently by the global
+ * MultiThreaderBase, each chunk but the last one ending on a byte boundary,
+ * and the chunks are concatenated into a single zlib (RFC 1950) or gzip
+ * (RFC 1952) stream, which any inflater can decompress.
+ *
+ * A gzip stream also records the compressed size of its chunks in an
+ * extra field of its header, which other readers ignore. Decompress() uses
+ * these sizes to inflate the chunks concurrently; other streams are
+ * inflated by a single thread.
+ *
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ParallelDeflate
+{
+public:
+  /** Container format of the compressed stream. */
+  enum class Format : uint8_t
+  {
+    Zlib,
+    Gzip
+  };
+
+  /** Default number of uncompressed bytes per chunk. */
+  static constexpr SizeValueType DefaultChunkSize = SizeValueType{ 1 } << 20;
+
+  /** Compress numberOfBytes bytes of data with the given zlib compression
+   * level (1 to 9). The chunks may be enlarged so that the number of chunks
+   * fits in the gzip header. An exception is thrown if zlib fails. */
+  static std::vector<unsigned char>
+  Compress(const void *  data,
+           SizeValueType numberOfBytes,
+           int           level,
+           Format        format,
+           SizeValueType chunkSize = DefaultChunkSize);
+
+  /** Whether the compressed bytes start with a gzip header which records the
+   * size of its chunks. */
+  static bool
+  HasChunkIndex(const void * compressed, SizeValueType compressedSize);
+
+  /** Decompress a zlib or gzip stream, which must decompress to exactly
+   * numberOfBytes bytes. Returns false if the stream is invalid. */
+  static bool
+  Decompress(const void * compressed, SizeValueType compressedSize, void * output, SizeValueType numberOfBytes);
+};
+} // end namespace itk
+
+#endif // itkParallelDeflate_h
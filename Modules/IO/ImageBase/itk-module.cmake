@@ -11,11 +11,14 @@ itk_module(ITKIOImageBase
   ENABLE_SHARED
   DEPENDS
     ITKCommon
+  PRIVATE_DEPENDS
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKIOGDCM
     ITKIOMeta
     ITKImageIntensity
+    ITKZLIB
   DESCRIPTION
     "${DOCUMENTATION}"
 )
@@ -18,6 +18,8 @@
 
 #include "itkImageIOBase.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include "itkByteSwapper.h"
+#include <algorithm>
 #include <mutex>
 #include "itksys/SystemTools.hxx"
 #include "itkPrintHelper.h"
@@ -1132,6 +1134,75 @@ ImageIOBase::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion
   return streamableRegion;
 }
 
+MemoryMappedFile::Pointer
+ImageIOBase::MapImageData()
+{
+  if (!m_UseMemoryMapping || m_FileType == IOFileEnum::ASCII)
+  {
+    return nullptr;
+  }
+
+  const SizeValueType componentSize = this->GetComponentSize();
+  if (componentSize > 1 &&
+      ((m_ByteOrder == IOByteOrderEnum::BigEndian && !ByteSwapper<int>::SystemIsBigEndian()) ||
+       (m_ByteOrder == IOByteOrderEnum::LittleEndian && !ByteSwapper<int>::SystemIsLittleEndian())))
+  {
+    return nullptr;
+  }
+
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!this->GetRawImageDataLocation(fileName, offset))
+  {
+    return nullptr;
+  }
+
+  // The IORegion is contiguous in the file if it covers whole lines, slices,
+  // ... up to one dimension, and is one pixel thick in the others
+  const unsigned int ioDimension = m_IORegion.GetImageDimension();
+  SizeValueType      stride = componentSize * m_NumberOfComponents;
+  bool               partial = false;
+  for (unsigned int i = 0; i < std::max(ioDimension, m_NumberOfDimensions); ++i)
+  {
+    const SizeValueType  dimension = i < m_NumberOfDimensions ? m_Dimensions[i] : 1;
+    const SizeValueType  size = i < ioDimension ? m_IORegion.GetSize(i) : 1;
+    const IndexValueType index = i < ioDimension ? m_IORegion.GetIndex(i) : 0;
+    if ((partial && size != 1) || index < 0 || static_cast<SizeValueType>(index) + size > dimension)
+    {
+      return nullptr;
+    }
+    offset += static_cast<SizeValueType>(index) * stride;
+    partial = partial || size != dimension;
+    stride *= dimension;
+  }
+
+  // Misaligned components would not be usable as an array
+  const SizeValueType numberOfBytes = m_IORegion.GetNumberOfPixels() * componentSize * m_NumberOfComponents;
+  if (numberOfBytes == 0 || offset % componentSize != 0)
+  {
+    return nullptr;
+  }
+
+  auto mappedFile = MemoryMappedFile::New();
+  try
+  {
+    mappedFile->Map(fileName, offset, numberOfBytes);
+  }
+  catch (const ExceptionObject & exception)
+  {
+    // Read() reports the errors of the file
+    itkDebugMacro(<< "Cannot map the image data: " << exception.GetDescription());
+    return nullptr;
+  }
+  return mappedFile;
+}
+
+bool
+ImageIOBase::GetRawImageDataLocation(std::string &, SizeValueType &)
+{
+  return false;
+}
+
 /** Return the directions that this particular ImageIO would use by default
  *  in the case the recipient image dimension is smaller than the dimension
  *  of the image in file. */
@@ -1202,6 +1273,7 @@ ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
   {
     os << indent << "UseStreamedWriting: Off" << std::endl;
   }
+  os << indent << "UseMemoryMapping: " << (m_UseMemoryMapping ? "On" : "Off") << std::endl;
   if (m_ExpandRGBPalette)
   {
     os << indent << "ExpandRGBPalette: On" << std::endl;
@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+#include "itkInternationalizationIOHelpers.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined(_WIN32)
+#  include <io.h>
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+void
+MemoryMappedFile::Map(const std::string & fileName, SizeValueType offset, SizeValueType numberOfBytes)
+{
+  this->Unmap();
+
+  if (numberOfBytes == 0)
+  {
+    itkExceptionMacro(<< "Cannot map 0 bytes of " << fileName);
+  }
+
+  int flags = O_RDONLY;
+#if defined(_WIN32)
+  flags |= O_BINARY;
+#endif
+  const int fd = i18n::I18nOpen(fileName, flags);
+  if (fd < 0)
+  {
+    itkExceptionMacro(<< "Cannot open " << fileName << " for mapping");
+  }
+
+  const auto fileLength = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+  if (fileLength < offset || fileLength - offset < numberOfBytes)
+  {
+    close(fd);
+    itkExceptionMacro(<< fileName << " is too short to map " << numberOfBytes << " bytes at offset " << offset);
+  }
+
+#if defined(_WIN32)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType pageOffset = offset % systemInfo.dwAllocationGranularity;
+  const SizeValueType mappingOffset = offset - pageOffset;
+  const SizeValueType mappingLength = numberOfBytes + pageOffset;
+
+  // The mapping object keeps its own reference to the file
+  HANDLE mappingHandle = CreateFileMappingW(
+    reinterpret_cast<HANDLE>(_get_osfhandle(fd)), nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  close(fd);
+  if (mappingHandle == nullptr)
+  {
+    itkExceptionMacro(<< "Cannot map " << fileName);
+  }
+  void * mapping = MapViewOfFile(mappingHandle,
+                                 FILE_MAP_COPY,
+                                 static_cast<DWORD>(static_cast<uint64_t>(mappingOffset) >> 32),
+                                 static_cast<DWORD>(mappingOffset & 0xFFFFFFFF),
+                                 static_cast<SIZE_T>(mappingLength));
+  CloseHandle(mappingHandle);
+  if (mapping == nullptr)
+  {
+    itkExceptionMacro(<< "Cannot map " << numberOfBytes << " bytes of " << fileName);
+  }
+#else
+  const auto          pageSize = static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+  const SizeValueType pageOffset = offset % pageSize;
+  const SizeValueType mappingOffset = offset - pageOffset;
+  const SizeValueType mappingLength = numberOfBytes + pageOffset;
+
+  // The mapping keeps its own reference to the file
+  void * mapping = mmap(
+    nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(mappingOffset));
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    itkExceptionMacro(<< "Cannot map " << numberOfBytes << " bytes of " << fileName);
+  }
+#endif
+
+  m_FileName = fileName;
+  m_Offset = offset;
+  m_NumberOfBytes = numberOfBytes;
+  m_Mapping = mapping;
+  m_MappingLength = mappingLength;
+  m_Buffer = static_cast<char *>(mapping) + pageOffset;
+  this->Modified();
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if (m_Mapping == nullptr)
+  {
+    return;
+  }
+#if defined(_WIN32)
+  UnmapViewOfFile(m_Mapping);
+#else
+  munmap(m_Mapping, m_MappingLength);
+#endif
+  m_Mapping = nullptr;
+  m_MappingLength = 0;
+  m_Buffer = nullptr;
+  m_NumberOfBytes = 0;
+  m_Offset = 0;
+  m_FileName.clear();
+  this->Modified();
+}
+
+void
+MemoryMappedFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Offset: " << m_Offset << std::endl;
+  os << indent << "NumberOfBytes: " << m_NumberOfBytes << std::endl;
+  os << indent << "Buffer: " << m_Buffer << std::endl;
+}
+
+} // end namespace itk
@@ -0,0 +1,369 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkParallelDeflate.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+// Identifier of the subfield of the gzip extra field which holds the chunk sizes
+constexpr unsigned char ChunkIndexId1 = 'I';
+constexpr unsigned char ChunkIndexId2 = 'T';
+
+// The extra field holds at most 65535 bytes: 4 for the subfield header, 4 for the chunk size, and 4 per chunk
+constexpr SizeValueType MaximumNumberOfIndexedChunks = (65535 - 8) / 4;
+
+// zlib counts its input and output with 32 bits
+constexpr SizeValueType MaximumChunkSize = SizeValueType{ 1 } << 30;
+
+void
+AppendLittleEndian(std::vector<unsigned char> & bytes, uint32_t value, unsigned int numberOfBytes)
+{
+  for (unsigned int i = 0; i < numberOfBytes; ++i)
+  {
+    bytes.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  }
+}
+
+uint32_t
+GetLittleEndian(const unsigned char * bytes, unsigned int numberOfBytes)
+{
+  uint32_t value = 0;
+  for (unsigned int i = 0; i < numberOfBytes; ++i)
+  {
+    value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+// Find the chunk index of a gzip stream, and where its deflate data starts
+bool
+FindChunkIndex(const unsigned char * bytes,
+               SizeValueType         size,
+               const unsigned char *& index,
+               SizeValueType &        indexSize,
+               SizeValueType &        dataOffset)
+{
+  constexpr unsigned char FlagHeaderCRC = 2;
+  constexpr unsigned char FlagExtra = 4;
+  constexpr unsigned char FlagName = 8;
+  constexpr unsigned char FlagComment = 16;
+
+  if (size < 12 || bytes[0] != 0x1f || bytes[1] != 0x8b || bytes[2] != Z_DEFLATED || !(bytes[3] & FlagExtra))
+  {
+    return false;
+  }
+  const SizeValueType extraSize = GetLittleEndian(bytes + 10, 2);
+  const SizeValueType extraEnd = 12 + extraSize;
+  if (extraEnd > size)
+  {
+    return false;
+  }
+  index = nullptr;
+  for (SizeValueType subfield = 12; subfield + 4 <= extraEnd;)
+  {
+    const SizeValueType subfieldSize = GetLittleEndian(bytes + subfield + 2, 2);
+    if (subfield + 4 + subfieldSize > extraEnd)
+    {
+      return false;
+    }
+    if (bytes[subfield] == ChunkIndexId1 && bytes[subfield + 1] == ChunkIndexId2 && subfieldSize >= 8 &&
+        subfieldSize % 4 == 0)
+    {
+      index = bytes + subfield + 4;
+      indexSize = subfieldSize;
+    }
+    subfield += 4 + subfieldSize;
+  }
+
+  dataOffset = extraEnd;
+  for (const unsigned char flag : { FlagName, FlagComment })
+  {
+    if (bytes[3] & flag)
+    {
+      while (dataOffset < size && bytes[dataOffset] != 0)
+      {
+        ++dataOffset;
+      }
+      ++dataOffset;
+    }
+  }
+  if (bytes[3] & FlagHeaderCRC)
+  {
+    dataOffset += 2;
+  }
+  return index != nullptr && dataOffset <= size;
+}
+
+bool
+InflateSerially(const unsigned char * compressed, SizeValueType compressedSize, void * output, SizeValueType numberOfBytes)
+{
+  z_stream stream{};
+  // Automatic detection of the zlib or gzip header
+  if (inflateInit2(&stream, 47) != Z_OK)
+  {
+    return false;
+  }
+  auto *        out = static_cast<unsigned char *>(output);
+  SizeValueType inputLeft = compressedSize;
+  SizeValueType outputLeft = numberOfBytes;
+  int           result = Z_OK;
+  while (result == Z_OK)
+  {
+    if (stream.avail_in == 0)
+    {
+      stream.avail_in = static_cast<uInt>(std::min(inputLeft, MaximumChunkSize));
+      stream.next_in = const_cast<Bytef *>(compressed + (compressedSize - inputLeft));
+      inputLeft -= stream.avail_in;
+    }
+    if (stream.avail_out == 0)
+    {
+      stream.avail_out = static_cast<uInt>(std::min(outputLeft, MaximumChunkSize));
+      stream.next_out = out + (numberOfBytes - outputLeft);
+      outputLeft -= stream.avail_out;
+    }
+    result = inflate(&stream, Z_NO_FLUSH);
+  }
+  const bool succeeded = result == Z_STREAM_END && outputLeft == 0 && stream.avail_out == 0;
+  inflateEnd(&stream);
+  return succeeded;
+}
+} // namespace
+
+std::vector<unsigned char>
+ParallelDeflate::Compress(const void *  data,
+                          SizeValueType numberOfBytes,
+                          int           level,
+                          Format        format,
+                          SizeValueType chunkSize)
+{
+  level = std::max(1, std::min(level, 9));
+  chunkSize = std::max(chunkSize, SizeValueType{ 1 });
+  chunkSize = std::max(chunkSize, (numberOfBytes + MaximumNumberOfIndexedChunks - 1) / MaximumNumberOfIndexedChunks);
+  chunkSize = std::min(chunkSize, MaximumChunkSize);
+  const SizeValueType numberOfChunks = std::max(SizeValueType{ 1 }, (numberOfBytes + chunkSize - 1) / chunkSize);
+
+  const auto *                            bytes = static_cast<const unsigned char *>(data);
+  std::vector<std::vector<unsigned char>> chunks(numberOfChunks);
+  std::vector<uLong>                      checks(numberOfChunks);
+  std::vector<char>                       failed(numberOfChunks, 0);
+
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&](SizeValueType chunk) {
+      const unsigned char * first = bytes + chunk * chunkSize;
+      const auto            length = static_cast<uInt>(std::min(chunkSize, numberOfBytes - chunk * chunkSize));
+      const bool            isLast = chunk + 1 == numberOfChunks;
+
+      // Raw deflate data; all chunks but the last one end with an empty stored block, on a byte boundary
+      z_stream stream{};
+      if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+        failed[chunk] = 1;
+        return;
+      }
+      std::vector<unsigned char> & compressed = chunks[chunk];
+      compressed.resize(deflateBound(&stream, length) + 16);
+      stream.next_in = const_cast<Bytef *>(first);
+      stream.avail_in = length;
+      stream.next_out = compressed.data();
+      stream.avail_out = static_cast<uInt>(compressed.size());
+      const int result = deflate(&stream, isLast ? Z_FINISH : Z_SYNC_FLUSH);
+      failed[chunk] = isLast ? result != Z_STREAM_END : (result != Z_OK || stream.avail_in != 0 || stream.avail_out == 0);
+      compressed.resize(stream.total_out);
+      deflateEnd(&stream);
+
+      checks[chunk] = format == Format::Gzip ? crc32(crc32(0L, Z_NULL, 0), first, length)
+                                             : adler32(adler32(0L, Z_NULL, 0), first, length);
+    },
+    nullptr);
+
+  if (std::find(failed.cbegin(), failed.cend(), 1) != failed.cend())
+  {
+    itkGenericExceptionMacro(<< "Deflate compression failed.");
+  }
+
+  uLong check = checks[0];
+  for (SizeValueType chunk = 1; chunk < numberOfChunks; ++chunk)
+  {
+    const auto length = static_cast<z_off_t>(std::min(chunkSize, numberOfBytes - chunk * chunkSize));
+    check = format == Format::Gzip ? crc32_combine(check, checks[chunk], length)
+                                   : adler32_combine(check, checks[chunk], length);
+  }
+
+  SizeValueType compressedSize = 0;
+  for (const auto & chunk : chunks)
+  {
+    compressedSize += chunk.size();
+  }
+  std::vector<unsigned char> stream;
+  stream.reserve(compressedSize + 12 + 8 + 4 * numberOfChunks + 8);
+
+  if (format == Format::Gzip)
+  {
+    constexpr unsigned char FlagExtra = 4;
+    constexpr unsigned char UnknownOS = 255;
+    const unsigned char     extraFlags = level == 9 ? 2 : (level == 1 ? 4 : 0);
+    const bool              indexed = numberOfChunks <= MaximumNumberOfIndexedChunks;
+    stream.insert(stream.end(),
+                  { 0x1f, 0x8b, Z_DEFLATED, static_cast<unsigned char>(indexed ? FlagExtra : 0), 0, 0, 0, 0 });
+    stream.push_back(extraFlags);
+    stream.push_back(UnknownOS);
+    if (indexed)
+    {
+      const auto indexSize = static_cast<uint32_t>(4 + 4 * numberOfChunks);
+      AppendLittleEndian(stream, 4 + indexSize, 2);
+      stream.push_back(ChunkIndexId1);
+      stream.push_back(ChunkIndexId2);
+      AppendLittleEndian(stream, indexSize, 2);
+      AppendLittleEndian(stream, static_cast<uint32_t>(chunkSize), 4);
+      for (const auto & chunk : chunks)
+      {
+        AppendLittleEndian(stream, static_cast<uint32_t>(chunk.size()), 4);
+      }
+    }
+  }
+  else
+  {
+    // Window of 32K, and the compression level as zlib reports it
+    const unsigned int header = 0x78 * 256 + (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3))) * 64;
+    const unsigned int checkedHeader = header + (31 - header % 31) % 31;
+    stream.push_back(static_cast<unsigned char>(checkedHeader >> 8));
+    stream.push_back(static_cast<unsigned char>(checkedHeader & 0xff));
+  }
+
+  for (auto & chunk : chunks)
+  {
+    stream.insert(stream.end(), chunk.cbegin(), chunk.cend());
+    std::vector<unsigned char>().swap(chunk);
+  }
+
+  if (format == Format::Gzip)
+  {
+    AppendLittleEndian(stream, static_cast<uint32_t>(check), 4);
+    AppendLittleEndian(stream, static_cast<uint32_t>(numberOfBytes), 4);
+  }
+  else
+  {
+    for (int shift = 24; shift >= 0; shift -= 8)
+    {
+      stream.push_back(static_cast<unsigned char>(check >> shift));
+    }
+  }
+  return stream;
+}
+
+bool
+ParallelDeflate::HasChunkIndex(const void * compressed, SizeValueType compressedSize)
+{
+  const unsigned char * index = nullptr;
+  SizeValueType         indexSize = 0;
+  SizeValueType         dataOffset = 0;
+  return FindChunkIndex(static_cast<const unsigned char *>(compressed), compressedSize, index, indexSize, dataOffset);
+}
+
+bool
+ParallelDeflate::Decompress(const void *  compressed,
+                            SizeValueType compressedSize,
+                            void *        output,
+                            SizeValueType numberOfBytes)
+{
+  const auto *          bytes = static_cast<const unsigned char *>(compressed);
+  const unsigned char * index = nullptr;
+  SizeValueType         indexSize = 0;
+  SizeValueType         dataOffset = 0;
+  if (!FindChunkIndex(bytes, compressedSize, index, indexSize, dataOffset))
+  {
+    return InflateSerially(bytes, compressedSize, output, numberOfBytes);
+  }
+
+  const SizeValueType chunkSize = GetLittleEndian(index, 4);
+  const SizeValueType numberOfChunks = (indexSize - 4) / 4;
+  if (chunkSize == 0 || numberOfChunks != std::max(SizeValueType{ 1 }, (numberOfBytes + chunkSize - 1) / chunkSize))
+  {
+    return InflateSerially(bytes, compressedSize, output, numberOfBytes);
+  }
+  std::vector<SizeValueType> offsets(numberOfChunks + 1, dataOffset);
+  for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    offsets[chunk + 1] = offsets[chunk] + GetLittleEndian(index + 4 + 4 * chunk, 4);
+  }
+  if (offsets[numberOfChunks] + 8 > compressedSize ||
+      GetLittleEndian(bytes + offsets[numberOfChunks] + 4, 4) != static_cast<uint32_t>(numberOfBytes))
+  {
+    return false;
+  }
+
+  auto *             out = static_cast<unsigned char *>(output);
+  std::vector<uLong> checks(numberOfChunks);
+  std::vector<char>  failed(numberOfChunks, 0);
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&](SizeValueType chunk) {
+      unsigned char * first = out + chunk * chunkSize;
+      const auto      length = static_cast<uInt>(std::min(chunkSize, numberOfBytes - chunk * chunkSize));
+      const bool      isLast = chunk + 1 == numberOfChunks;
+
+      z_stream stream{};
+      if (inflateInit2(&stream, -15) != Z_OK)
+      {
+        failed[chunk] = 1;
+        return;
+      }
+      stream.next_in = const_cast<Bytef *>(bytes + offsets[chunk]);
+      stream.avail_in = static_cast<uInt>(offsets[chunk + 1] - offsets[chunk]);
+      stream.next_out = first;
+      stream.avail_out = length;
+      int result = inflate(&stream, Z_NO_FLUSH);
+      if (stream.avail_in != 0 && stream.avail_out == 0 && result == Z_OK)
+      {
+        // The end of the chunk must not produce more bytes
+        unsigned char extra;
+        stream.next_out = &extra;
+        stream.avail_out = 1;
+        result = inflate(&stream, Z_NO_FLUSH);
+        failed[chunk] = stream.avail_out == 0;
+      }
+      failed[chunk] = failed[chunk] || stream.avail_in != 0 || stream.total_out != length ||
+                      (isLast ? result != Z_STREAM_END : (result != Z_OK && result != Z_BUF_ERROR));
+      inflateEnd(&stream);
+
+      checks[chunk] = crc32(crc32(0L, Z_NULL, 0), first, length);
+    },
+    nullptr);
+
+  if (std::find(failed.cbegin(), failed.cend(), 1) != failed.cend())
+  {
+    return false;
+  }
+  uLong check = checks[0];
+  for (SizeValueType chunk = 1; chunk < numberOfChunks; ++chunk)
+  {
+    const auto length = static_cast<z_off_t>(std::min(chunkSize, numberOfBytes - chunk * chunkSize));
+    check = crc32_combine(check, checks[chunk], length);
+  }
+  return static_cast<uint32_t>(check) == GetLittleEndian(bytes + offsets[numberOfChunks], 4);
+}
+
+} // end namespace itk
@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using PixelType = unsigned char;
+using ImageType = itk::Image<PixelType, Dimension>;
+
+PixelType
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<PixelType>(index[0] + 3 * index[1] + 7 * index[2]);
+}
+
+template <typename TImage>
+bool
+HasExpectedValues(const TImage * image, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (static_cast<PixelType>(it.Get()) != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << static_cast<double>(it.Get()) << " at " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+std::string
+GetPixelContainerClass(const TImage * image)
+{
+  return image->GetPixelContainer()->GetNameOfClass();
+}
+} // namespace
+
+int
+itkImageFileReaderMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputFileName [compressedOutputFileName]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string fileName = argv[1];
+  const std::string compressedFileName =
+    argc > 2 ? std::string(argv[2])
+             : itksys::SystemTools::GetFilenamePath(fileName) + '/' +
+                 itksys::SystemTools::GetFilenameWithoutLastExtension(fileName) + "Compressed" +
+                 itksys::SystemTools::GetFilenameLastExtension(fileName);
+
+  const ImageType::SizeType size = { { 31, 17, 9 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  auto writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  writer->SetFileName(compressedFileName);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  // Off by default: the pixels are read in an allocated buffer
+  auto reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(!reader->GetImageIO()->GetUseMemoryMapping());
+  ITK_TEST_EXPECT_EQUAL(GetPixelContainerClass(reader->GetOutput()), "ImportImageContainer");
+
+  // Mapped
+  itk::ImageIOBase::Pointer imageIO =
+    itk::ImageIOFactory::CreateImageIO(fileName.c_str(), itk::ImageIOFactory::IOFileModeEnum::ReadMode);
+  ITK_TEST_SET_GET_BOOLEAN(imageIO, UseMemoryMapping, true);
+  auto mappedReader = ReaderType::New();
+  mappedReader->SetFileName(fileName);
+  mappedReader->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(mappedReader->Update());
+  ImageType::Pointer mapped = mappedReader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL(GetPixelContainerClass(mapped.GetPointer()), "MemoryMappedImageContainer");
+  ITK_TEST_EXPECT_TRUE(HasExpectedValues(mapped.GetPointer(), mapped->GetLargestPossibleRegion()));
+
+  // The mapping outlives the reader, and is copy-on-write
+  mapped->DisconnectPipeline();
+  mappedReader = nullptr;
+  const ImageType::IndexType modifiedIndex = { { 3, 4, 5 } };
+  mapped->SetPixel(modifiedIndex, 0);
+  reader->Modified();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(static_cast<int>(reader->GetOutput()->GetPixel(modifiedIndex)),
+                        static_cast<int>(ExpectedValue(modifiedIndex)));
+  mapped = nullptr;
+
+  // Streamed slabs are mapped too
+  if (imageIO->CanStreamRead())
+  {
+    imageIO->UseStreamedReadingOn();
+    auto slabReader = ReaderType::New();
+    slabReader->SetFileName(fileName);
+    slabReader->SetImageIO(imageIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(slabReader->UpdateOutputInformation());
+    ImageType::RegionType slab = slabReader->GetOutput()->GetLargestPossibleRegion();
+    slab.SetIndex(2, 3);
+    slab.SetSize(2, 4);
+    slabReader->GetOutput()->SetRequestedRegion(slab);
+    ITK_TRY_EXPECT_NO_EXCEPTION(slabReader->Update());
+    ITK_TEST_EXPECT_EQUAL(slabReader->GetOutput()->GetBufferedRegion(), slab);
+    ITK_TEST_EXPECT_EQUAL(GetPixelContainerClass(slabReader->GetOutput()), "MemoryMappedImageContainer");
+    ITK_TEST_EXPECT_TRUE(HasExpectedValues(slabReader->GetOutput(), slab));
+    imageIO->UseStreamedReadingOff();
+  }
+
+  // Conversions and compressed files fall back to reading
+  using FloatImageType = itk::Image<float, Dimension>;
+  auto floatReader = itk::ImageFileReader<FloatImageType>::New();
+  floatReader->SetFileName(fileName);
+  floatReader->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(floatReader->Update());
+  ITK_TEST_EXPECT_EQUAL(GetPixelContainerClass(floatReader->GetOutput()), "ImportImageContainer");
+  ITK_TEST_EXPECT_TRUE(HasExpectedValues(floatReader->GetOutput(), floatReader->GetOutput()->GetBufferedRegion()));
+
+  itk::ImageIOBase::Pointer compressedImageIO =
+    itk::ImageIOFactory::CreateImageIO(compressedFileName.c_str(), itk::ImageIOFactory::IOFileModeEnum::ReadMode);
+  compressedImageIO->UseMemoryMappingOn();
+  auto compressedReader = ReaderType::New();
+  compressedReader->SetFileName(compressedFileName);
+  compressedReader->SetImageIO(compressedImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(compressedReader->Update());
+  ITK_TEST_EXPECT_EQUAL(GetPixelContainerClass(compressedReader->GetOutput()), "ImportImageContainer");
+  ITK_TEST_EXPECT_TRUE(
+    HasExpectedValues(compressedReader->GetOutput(), compressedReader->GetOutput()->GetBufferedRegion()));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelDeflate.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+namespace
+{
+std::vector<unsigned char>
+MakeData(size_t numberOfBytes)
+{
+  // Compressible, but not trivially
+  std::vector<unsigned char> data(numberOfBytes);
+  unsigned int               state = 12345;
+  for (size_t i = 0; i < numberOfBytes; ++i)
+  {
+    state = state * 1103515245 + 12345;
+    data[i] = static_cast<unsigned char>((i / 7) % 50 + ((state >> 16) % 4));
+  }
+  return data;
+}
+
+// Decompress with zlib only, as any other reader would
+bool
+InflatesWithZlib(const std::vector<unsigned char> & compressed, const std::vector<unsigned char> & expected)
+{
+  std::vector<unsigned char> output(expected.size() + 1);
+  z_stream                   stream{};
+  if (inflateInit2(&stream, 47) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = const_cast<Bytef *>(compressed.data());
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = output.data();
+  stream.avail_out = static_cast<uInt>(output.size());
+  const int result = inflate(&stream, Z_FINISH);
+  const bool succeeded = result == Z_STREAM_END && stream.total_out == expected.size() && stream.avail_in == 0 &&
+                         std::equal(expected.cbegin(), expected.cend(), output.cbegin());
+  inflateEnd(&stream);
+  return succeeded;
+}
+
+int
+TestRoundTrip(size_t numberOfBytes, itk::ParallelDeflate::Format format, itk::SizeValueType chunkSize)
+{
+  std::cout << "Bytes " << numberOfBytes << ", chunks of " << chunkSize << std::endl;
+  const std::vector<unsigned char> data = MakeData(numberOfBytes);
+  std::vector<unsigned char>       compressed;
+  ITK_TRY_EXPECT_NO_EXCEPTION(compressed =
+                                itk::ParallelDeflate::Compress(data.data(), data.size(), 6, format, chunkSize));
+  ITK_TEST_EXPECT_TRUE(InflatesWithZlib(compressed, data));
+  ITK_TEST_EXPECT_EQUAL(itk::ParallelDeflate::HasChunkIndex(compressed.data(), compressed.size()),
+                        format == itk::ParallelDeflate::Format::Gzip);
+
+  std::vector<unsigned char> output(numberOfBytes + 1);
+  ITK_TEST_EXPECT_TRUE(
+    itk::ParallelDeflate::Decompress(compressed.data(), compressed.size(), output.data(), numberOfBytes));
+  ITK_TEST_EXPECT_TRUE(std::equal(data.cbegin(), data.cend(), output.cbegin()));
+
+  // A wrong size or corrupted data is detected
+  ITK_TEST_EXPECT_TRUE(
+    !itk::ParallelDeflate::Decompress(compressed.data(), compressed.size(), output.data(), numberOfBytes + 1));
+  compressed[compressed.size() - 9] ^= 0x55;
+  ITK_TEST_EXPECT_TRUE(
+    !itk::ParallelDeflate::Decompress(compressed.data(), compressed.size(), output.data(), numberOfBytes));
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkParallelDeflateTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputFileName" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int status = EXIT_SUCCESS;
+  for (const auto format : { itk::ParallelDeflate::Format::Zlib, itk::ParallelDeflate::Format::Gzip })
+  {
+    status |= TestRoundTrip(1, format, itk::ParallelDeflate::DefaultChunkSize);
+    status |= TestRoundTrip(100000, format, 4096);
+    status |= TestRoundTrip(100000, format, 100000);
+    status |= TestRoundTrip(3 * itk::ParallelDeflate::DefaultChunkSize + 17, format, itk::ParallelDeflate::DefaultChunkSize);
+  }
+
+  // A gzip stream compressed by zlib alone is inflated serially
+  const std::vector<unsigned char> data = MakeData(50000);
+  std::vector<unsigned char>       compressed(compressBound(data.size()) + 18);
+  z_stream                         stream{};
+  ITK_TEST_EXPECT_EQUAL(deflateInit2(&stream, 6, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY), Z_OK);
+  stream.next_in = const_cast<Bytef *>(data.data());
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = compressed.data();
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  ITK_TEST_EXPECT_EQUAL(deflate(&stream, Z_FINISH), Z_STREAM_END);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  ITK_TEST_EXPECT_TRUE(!itk::ParallelDeflate::HasChunkIndex(compressed.data(), compressed.size()));
+  std::vector<unsigned char> output(data.size());
+  ITK_TEST_EXPECT_TRUE(
+    itk::ParallelDeflate::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+  ITK_TEST_EXPECT_TRUE(output == data);
+
+  // MetaImage compressed in parallel
+  using ImageType = itk::Image<short, 3>;
+  const ImageType::SizeType size = { { 97, 83, 61 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>(index[0] * index[1] - 5 * index[2]));
+  }
+
+  auto metaIO = itk::MetaImageIO::New();
+  metaIO->SetCompressor("ParallelZlib");
+  ITK_TEST_SET_GET_VALUE("ParallelZlib", metaIO->GetCompressor());
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(argv[1]);
+  writer->SetImageIO(metaIO);
+  writer->SetUseCompression(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(argv[1]);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  itk::ImageRegionConstIterator<ImageType> expected(image, image->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> it(reader->GetOutput(), reader->GetOutput()->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it, ++expected)
+  {
+    if (it.Get() != expected.Get())
+    {
+      std::cerr << "Wrong value " << it.Get() << " instead of " << expected.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -37,6 +37,12 @@ namespace itk
  *  For a detailed description of using this format, please see
  *  https://www.itk.org/Wiki/ITK/MetaIO/Documentation
  *
+ *  Compressed data is deflated by a single thread with the default "ZLIB"
+ *  compressor. The "PARALLELZLIB" compressor deflates chunks of the data
+ *  concurrently, into a zlib stream any MetaImage reader decompresses. It
+ *  applies to the data written at once, in a single file; streamed writing
+ *  and slice files fall back to "ZLIB".
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIOMeta
  */
@@ -187,6 +193,14 @@ protected:
   ~MetaImageIO() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
+  /** Uncompressed binary data, in the header file (LOCAL) or in a single
+   * data file, may be memory mapped. */
+  bool
+  GetRawImageDataLocation(std::string & fileName, SizeValueType & offset) override;
   template <unsigned int VNRows, unsigned int VNColumns = VNRows>
   bool
   WriteMatrixInMetaData(std::ostringstream & strs, const MetaDataDictionary & metaDict, const std::string & metaString);
@@ -199,6 +213,8 @@ private:
 
   unsigned int m_SubSamplingFactor;
 
+  bool m_UseParallelCompression{ false };
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
@@ -22,9 +22,80 @@
 #include "itksys/SystemTools.hxx"
 #include "itkMath.h"
 #include "itkSingleton.h"
+#include "itkParallelDeflate.h"
 
 namespace itk
 {
+namespace
+{
+// MetaImage deflates the element data with a single thread when it writes
+// it. This writer takes data deflated beforehand, and writes it with the
+// header the way MetaImage::Write() does, through the protected members of
+// MetaImage.
+class PrecompressedMetaImageWriter : public MetaImage
+{
+public:
+  static bool
+  WriteCompressed(MetaImage & image, const std::string & fileName, const std::vector<unsigned char> & compressedData)
+  {
+    const bool  userDataFileName = image.ElementDataFileName()[0] != '\0';
+    std::string headerFileName = fileName;
+    std::string dataFileName = image.ElementDataFileName();
+    if (!userDataFileName)
+    {
+      int suffix = 0;
+      if (MET_GetFileSuffixPtr(headerFileName, &suffix) &&
+          headerFileName.compare(suffix, std::string::npos, "mha") == 0)
+      {
+        dataFileName = "LOCAL";
+      }
+      else
+      {
+        MET_SetFileSuffix(headerFileName, "mhd");
+        dataFileName = headerFileName;
+        MET_SetFileSuffix(dataFileName, "zraw");
+      }
+    }
+    MET_SetFileSuffix(headerFileName, dataFileName == "LOCAL" ? "mha" : "mhd");
+
+    std::string pathName;
+    if (MET_GetFilePath(headerFileName, pathName))
+    {
+      std::string dataPathName;
+      MET_GetFilePath(dataFileName, dataPathName);
+      if (dataPathName == pathName)
+      {
+        dataFileName = dataFileName.substr(pathName.length());
+      }
+    }
+    image.FileName(headerFileName.c_str());
+    image.ElementDataFileName(dataFileName.c_str());
+
+    bool          written = false;
+    std::ofstream stream(headerFileName, std::ios::binary | std::ios::out);
+    if (stream.is_open())
+    {
+      const auto compressedDataSize = static_cast<std::streamoff>(compressedData.size());
+      image.*(&PrecompressedMetaImageWriter::m_WriteStream) = &stream;
+      image.*(&PrecompressedMetaImageWriter::m_CompressedDataSize) = compressedDataSize;
+      (image.*(&PrecompressedMetaImageWriter::M_SetupWriteFields))();
+      written = (image.*(&PrecompressedMetaImageWriter::M_Write))() &&
+                (image.*(&PrecompressedMetaImageWriter::M_WriteElements))(
+                  &stream, compressedData.data(), compressedDataSize) &&
+                stream.good();
+      image.*(&PrecompressedMetaImageWriter::m_WriteStream) = nullptr;
+      image.*(&PrecompressedMetaImageWriter::m_CompressedDataSize) = 0;
+    }
+
+    if (!userDataFileName)
+    {
+      image.ElementDataFileName("");
+    }
+    return written;
+  }
+};
+} // namespace
+
 // Explicitly set std::numeric_limits<double>::max_digits10 this will provide
 // better accuracy when writing out floating point number in MetaImage header.
 itkGetGlobalValueMacro(MetaImageIO, unsigned int, DefaultDoublePrecision, 17);
@@ -60,6 +131,17 @@ MetaImageIO::MetaImageIO()
 
 MetaImageIO::~MetaImageIO() = default;
 
+void
+MetaImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  // "ZLIB" data is deflated by MetaImage, "PARALLELZLIB" data by ParallelDeflate
+  m_UseParallelCompression = _compressor == "PARALLELZLIB";
+  if (!_compressor.empty() && _compressor != "ZLIB" && !m_UseParallelCompression)
+  {
+    this->Superclass::InternalSetCompressor(_compressor);
+  }
+}
+
 void
 MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -493,6 +575,79 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::GetRawImageDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 ||
+      (this->GetComponentSize() > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB()))
+  {
+    return false;
+  }
+
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool        local = itksys::SystemTools::UpperCase(elementDataFileName) == "LOCAL";
+  if (local)
+  {
+    fileName = m_FileName;
+  }
+  else if (elementDataFileName.compare(0, 4, "LIST") == 0 || elementDataFileName.find('%') != std::string::npos)
+  {
+    // The data is split over several files
+    return false;
+  }
+  else
+  {
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    fileName = (itksys::SystemTools::FileIsFullPath(elementDataFileName) || path.empty())
+                 ? elementDataFileName
+                 : path + '/' + elementDataFileName;
+    if (!itksys::SystemTools::FileExists(fileName, true))
+    {
+      // Compressed data file, with a .gz or .Z extension
+      return false;
+    }
+  }
+
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    offset = static_cast<SizeValueType>(m_MetaImage.HeaderSize());
+  }
+  else if (m_MetaImage.HeaderSize() == -1)
+  {
+    // The data is at the end of the file
+    const auto fileLength = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+    const auto numberOfBytes = static_cast<SizeValueType>(this->GetImageSizeInBytes());
+    if (fileLength < numberOfBytes)
+    {
+      return false;
+    }
+    offset = fileLength - numberOfBytes;
+  }
+  else if (local)
+  {
+    // The data follows the ElementDataFile line, which ends the header
+    std::ifstream file;
+    this->OpenFileForReading(file, fileName);
+    std::string line;
+    while (std::getline(file, line))
+    {
+      const std::string::size_type keyBegin = line.find_first_not_of(" \t");
+      const std::string::size_type keyEnd = line.find_first_of(" \t=", keyBegin);
+      if (keyBegin != std::string::npos && line.compare(keyBegin, keyEnd - keyBegin, "ElementDataFile") == 0)
+      {
+        offset = static_cast<SizeValueType>(file.tellg());
+        return true;
+      }
+    }
+    return false;
+  }
+  else
+  {
+    offset = 0;
+  }
+  return true;
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -1118,6 +1273,23 @@ MetaImageIO ::Write(const void * buffer)
     delete[] indexMin;
     delete[] indexMax;
   }
+  else if (m_UseCompression && m_UseParallelCompression && binaryData &&
+           std::string(m_MetaImage.ElementDataFileName()).find('%') == std::string::npos)
+  {
+    const std::vector<unsigned char> compressedData =
+      ParallelDeflate::Compress(static_cast<const unsigned char *>(buffer),
+                                static_cast<SizeValueType>(this->GetImageSizeInBytes()),
+                                this->GetCompressionLevel(),
+                                ParallelDeflate::Format::Zlib);
+    if (!PrecompressedMetaImageWriter::WriteCompressed(m_MetaImage, m_FileName, compressedData))
+    {
+      delete[] dSize;
+      delete[] eSpacing;
+      delete[] eOrigin;
+      itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                   << "Reason: " << itksys::SystemTools::GetLastSystemError());
+    }
+  }
   else
   {
     if (!m_MetaImage.Write(m_FileName.c_str()))
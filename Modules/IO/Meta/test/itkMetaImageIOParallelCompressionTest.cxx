@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMetaImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaDataObject.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+
+using ImageType = itk::Image<short, 3>;
+
+ImageType::PixelType
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<ImageType::PixelType>((index[0] + 3 * index[1] + 7 * index[2]) % 1000);
+}
+
+// Write an image with the given compressor, then read it back
+int
+WriteAndReadImage(const std::string & fileName, const std::string & compressor)
+{
+  std::cout << fileName << ", " << compressor << std::endl;
+
+  // Several chunks of compressed data
+  const ImageType::SizeType size = { { 160, 128, 70 } };
+  auto                      image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+  itk::EncapsulateMetaData<std::string>(image->GetMetaDataDictionary(), "Compressor", compressor);
+
+  auto writerIO = itk::MetaImageIO::New();
+  writerIO->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(writerIO);
+  writer->SetUseCompression(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::MetaImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), image->GetLargestPossibleRegion());
+
+  std::string metaData;
+  ITK_TEST_EXPECT_TRUE(
+    itk::ExposeMetaData<std::string>(reader->GetOutput()->GetMetaDataDictionary(), "Compressor", metaData));
+  ITK_TEST_EXPECT_EQUAL(metaData, compressor);
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(reader->GetOutput(), reader->GetOutput()->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkMetaImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  int status = EXIT_SUCCESS;
+  for (const char * compressor : { "ParallelZlib", "zlib" })
+  {
+    const std::string suffix = compressor == std::string("zlib") ? "Serial" : "";
+    status |= WriteAndReadImage(directory + "/itkMetaImageIOParallelCompressionTest" + suffix + ".mha", compressor);
+    status |= WriteAndReadImage(directory + "/itkMetaImageIOParallelCompressionTest" + suffix + ".mhd", compressor);
+  }
+
+  // The data of a .mhd header is deflated in a .zraw file next to it
+  ITK_TEST_EXPECT_TRUE(
+    itksys::SystemTools::FileExists(directory + "/itkMetaImageIOParallelCompressionTest.zraw", true));
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -91,6 +91,17 @@ extern ITKIONIFTI_EXPORT std::ostream &
  * The specification for this file format is taken from the
  * web site http://analyzedirect.com/support/10.0Documents/Analyze_Resource_01.pdf
  *
+ * Any region of an image can be read without loading the whole
+ * file. Uncompressed data is read by seeking to each contiguous run of
+ * voxels, so e.g. a single time point of a 4D series is a single read.
+ * Compressed files are indexed while they are decompressed, such that
+ * later regions restart from the nearest indexed position instead of
+ * the beginning of the file.
+ *
+ * Uncompressed binary files (.nii, .hdr/.img) can also be written in
+ * streamed pieces: the piece at the origin of the image creates the files
+ * and every piece is then written at its offset in the data file.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
@@ -177,6 +188,23 @@ public:
   ImageIORegion
   GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
 
+  /** Any region can be read. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Only uncompressed binary files can be written in pieces. */
+  bool
+  CanStreamWrite() override;
+
+  /** Pasting into an existing file is not supported. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
   /** Set the slope and intercept for voxel value rescaling. */
   itkSetMacro(RescaleSlope, double);
   itkSetMacro(RescaleIntercept, double);
@@ -200,6 +228,11 @@ protected:
     return false;
   }
 
+  /** Uncompressed voxels which need neither rescaling nor reordering of
+   * their components may be memory mapped. */
+  bool
+  GetRawImageDataLocation(std::string & fileName, SizeValueType & offset) override;
+
 private:
   // Try to use the Q and S form codes from MetaDataDictionary if they are specified
   // there, otherwise default to the backwards compatible values from earlier
@@ -225,6 +258,16 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  /** Read the voxels of a hyperslab of the NIfTI dimensions into a
+   * buffer allocated with malloc. */
+  void *
+  ReadHyperslab(const int origin[7], const int size[7]);
+
+  /** Write the voxels of a hyperslab, already in NIfTI layout, at their
+   * offsets in the data file. */
+  void
+  WriteHyperslab(const void * buffer, const int origin[7], const int size[7]);
+
   // This proxy class provides a nifti_image pointer interface to the internal implementation
   // of itk::NiftiImageIO, while hiding the niftilib interface from the external ITK interface.
   class NiftiImageProxy;
@@ -235,6 +278,11 @@ private:
 
   NiftiImageProxy & m_NiftiImage;
 
+  // Access points into compressed data files, kept between the reads of a
+  // streamed image.
+  class GzipIndex;
+  const std::unique_ptr<GzipIndex> m_GzipIndex;
+
   double m_RescaleSlope{ 1.0 };
   double m_RescaleIntercept{ 0.0 };
 
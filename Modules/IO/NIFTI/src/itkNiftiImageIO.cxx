@@ -20,6 +20,8 @@
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
 #include <nifti1_io.h>
+#include "itk_zlib.h"
+#include <algorithm>
 
 #include "itkNiftiImageIOConfigurePrivate.h"
 
@@ -445,9 +447,216 @@ public:
 };
 
 
+// Random access into a gzip compressed file, after the zran example of zlib. While decompressing, the
+// state of the decompressor is saved at block boundaries every SpanSize bytes of output, such that a later
+// read can restart from the closest access point. Reads which continue where the previous read stopped reuse
+// the current state of the decompressor.
+class NiftiImageIO::GzipIndex
+{
+public:
+  ~GzipIndex() { this->Close(); }
+
+  /** Forget the access points, e.g. because the file may have changed. */
+  void
+  Reset()
+  {
+    this->Close();
+    m_FileName.clear();
+    m_AccessPoints.clear();
+  }
+
+  /** Read length bytes at the given offset in the decompressed data. */
+  bool
+  Read(const std::string & fileName, uint64_t offset, char * buffer, size_t length)
+  {
+    if (fileName != m_FileName)
+    {
+      this->Reset();
+      m_FileName = fileName;
+    }
+
+    // Restart unless the decompressor is already at or before the offset, and no access point is closer.
+    const auto next = std::upper_bound(
+      m_AccessPoints.cbegin(), m_AccessPoints.cend(), offset, [](uint64_t value, const AccessPoint & point) {
+        return value < point.m_Output;
+      });
+    const AccessPoint * point = next == m_AccessPoints.cbegin() ? nullptr : &*(next - 1);
+    if (!m_Started || offset < m_Output || (point != nullptr && point->m_Output > m_Output))
+    {
+      if (!this->Start(point))
+      {
+        return false;
+      }
+    }
+
+    while (length > 0)
+    {
+      if (m_Stream.avail_out == 0)
+      {
+        m_Stream.next_out = m_Window;
+        m_Stream.avail_out = WindowSize;
+      }
+      if (m_Stream.avail_in == 0)
+      {
+        m_File.read(reinterpret_cast<char *>(m_Input), InputSize);
+        const auto count = static_cast<uInt>(m_File.gcount());
+        if (count == 0)
+        {
+          return false;
+        }
+        m_InputOffset += count;
+        m_Stream.next_in = m_Input;
+        m_Stream.avail_in = count;
+      }
+
+      // Stop at the end of the requested bytes, such that a following read can continue from there
+      const Bytef * const produced = m_Stream.next_out;
+      const uInt          available = m_Stream.avail_out;
+      m_Stream.avail_out = static_cast<uInt>(std::min<uint64_t>(available, offset + length - m_Output));
+      const uInt limit = m_Stream.avail_out;
+      const int  result = inflate(&m_Stream, Z_BLOCK);
+      if (result != Z_OK && result != Z_STREAM_END)
+      {
+        return false;
+      }
+      const auto count = static_cast<size_t>(m_Stream.next_out - produced);
+      m_Stream.avail_out = available - (limit - m_Stream.avail_out);
+      if (m_Output + count > offset)
+      {
+        const auto skip = static_cast<size_t>(offset - m_Output);
+        const auto copied = std::min(count - skip, length);
+        std::copy_n(produced + skip, copied, buffer);
+        buffer += copied;
+        offset += copied;
+        length -= copied;
+      }
+      m_Output += count;
+
+      if (result == Z_STREAM_END)
+      {
+        this->Close();
+        return length == 0;
+      }
+
+      // At the end of a block which is not the last one, add an access point past the indexed data
+      if ((m_Stream.data_type & 128) && !(m_Stream.data_type & 64) &&
+          (m_AccessPoints.empty() || m_Output >= m_AccessPoints.back().m_Output + SpanSize))
+      {
+        this->AddAccessPoint();
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr uInt     WindowSize = 32768;
+  static constexpr uInt     InputSize = 16384;
+  static constexpr uint64_t SpanSize = uint64_t{ 16 } << 20;
+
+  struct AccessPoint
+  {
+    uint64_t                   m_Output;
+    uint64_t                   m_Input;
+    int                        m_Bits;
+    std::vector<unsigned char> m_Window;
+  };
+
+  bool
+  Start(const AccessPoint * point)
+  {
+    this->Close();
+    m_File.open(m_FileName.c_str(), std::ios::in | std::ios::binary);
+    if (!m_File.is_open())
+    {
+      return false;
+    }
+    m_Stream = z_stream();
+    if (point == nullptr)
+    {
+      // Automatic detection of the gzip or zlib header
+      if (inflateInit2(&m_Stream, 47) != Z_OK)
+      {
+        return false;
+      }
+      m_Started = true;
+      m_InputOffset = 0;
+      m_Output = 0;
+    }
+    else
+    {
+      // Raw deflate data, preceded by the bits of the byte shared with the previous block
+      if (inflateInit2(&m_Stream, -15) != Z_OK)
+      {
+        return false;
+      }
+      m_Started = true;
+      m_InputOffset = point->m_Input - (point->m_Bits ? 1 : 0);
+      m_File.seekg(static_cast<std::streamoff>(m_InputOffset));
+      if (point->m_Bits)
+      {
+        const int byte = m_File.get();
+        if (byte == std::char_traits<char>::eof() ||
+            inflatePrime(&m_Stream, point->m_Bits, byte >> (8 - point->m_Bits)) != Z_OK)
+        {
+          return false;
+        }
+        ++m_InputOffset;
+      }
+      if (inflateSetDictionary(&m_Stream, point->m_Window.data(), WindowSize) != Z_OK)
+      {
+        return false;
+      }
+      std::copy(point->m_Window.cbegin(), point->m_Window.cend(), m_Window);
+      m_Output = point->m_Output;
+    }
+    m_Stream.next_out = m_Window;
+    m_Stream.avail_out = WindowSize;
+    return true;
+  }
+
+  void
+  AddAccessPoint()
+  {
+    // The window is circular, its oldest byte is at the current output position
+    const uInt position = WindowSize - m_Stream.avail_out;
+    AccessPoint point{ m_Output, m_InputOffset - m_Stream.avail_in, m_Stream.data_type & 7, {} };
+    point.m_Window.reserve(WindowSize);
+    point.m_Window.insert(point.m_Window.end(), m_Window + position, m_Window + WindowSize);
+    point.m_Window.insert(point.m_Window.end(), m_Window, m_Window + position);
+    m_AccessPoints.push_back(std::move(point));
+  }
+
+  void
+  Close()
+  {
+    if (m_Started)
+    {
+      inflateEnd(&m_Stream);
+      m_Started = false;
+    }
+    if (m_File.is_open())
+    {
+      m_File.close();
+    }
+    m_File.clear();
+  }
+
+  std::string              m_FileName;
+  std::vector<AccessPoint> m_AccessPoints;
+  std::ifstream            m_File;
+  z_stream                 m_Stream{};
+  bool                     m_Started{ false };
+  uint64_t                 m_InputOffset{ 0 };
+  uint64_t                 m_Output{ 0 };
+  Bytef                    m_Input[InputSize];
+  Bytef                    m_Window[WindowSize];
+};
+
+
 NiftiImageIO::NiftiImageIO()
   : m_NiftiImageHolder(new NiftiImageProxy(nullptr))
   , m_NiftiImage(*m_NiftiImageHolder.get())
+  , m_GzipIndex(new GzipIndex)
   , m_LegacyAnalyze75Mode{ ITK_NIFTI_IO_ANALYZE_FLAVOR_DEFAULT }
 {
   this->SetNumberOfDimensions(3);
@@ -521,6 +730,246 @@ CastCopy(float * to, const void * from, size_t pixelcount)
   }
 }
 
+namespace
+{
+// Call runFunction(fileOffset, bufferOffset, numberOfBytes) for each contiguous run of the voxels of a
+// hyperslab of an image with the given NIfTI dimensions, in the order of the voxels in the file.
+template <typename TRunFunction>
+void
+ForEachHyperslabRun(const int    dims[7],
+                    const int    origin[7],
+                    const int    size[7],
+                    size_t       bytesPerVoxel,
+                    TRunFunction runFunction)
+{
+  size_t strides[7];
+  strides[0] = bytesPerVoxel;
+  for (unsigned int d = 1; d < 7; ++d)
+  {
+    strides[d] = strides[d - 1] * static_cast<size_t>(dims[d - 1]);
+  }
+
+  // Dimensions completely covered by the hyperslab extend the runs to the next dimension
+  size_t       runLength = bytesPerVoxel * static_cast<size_t>(size[0]);
+  unsigned int firstOuterDim = 1;
+  while (firstOuterDim < 7 && size[firstOuterDim - 1] == dims[firstOuterDim - 1])
+  {
+    runLength *= static_cast<size_t>(size[firstOuterDim]);
+    ++firstOuterDim;
+  }
+
+  int    position[7] = { 0, 0, 0, 0, 0, 0, 0 };
+  size_t bufferOffset = 0;
+  while (true)
+  {
+    size_t fileOffset = 0;
+    for (unsigned int d = 0; d < 7; ++d)
+    {
+      fileOffset += static_cast<size_t>(origin[d] + position[d]) * strides[d];
+    }
+    runFunction(fileOffset, bufferOffset, runLength);
+    bufferOffset += runLength;
+
+    unsigned int d = firstOuterDim;
+    for (; d < 7; ++d)
+    {
+      if (++position[d] < size[d])
+      {
+        break;
+      }
+      position[d] = 0;
+    }
+    if (d >= 7)
+    {
+      break;
+    }
+  }
+}
+
+// NIfTI stores the components of vector pixels as its fifth, slowest, dimension, whereas ITK interleaves them.
+void
+ReorderComponents(const char * from,
+                  char *       to,
+                  size_t       numberOfPixels,
+                  unsigned int numComponents,
+                  const int *  vecOrder,
+                  size_t       componentSize,
+                  bool         toNIfTI)
+{
+  for (size_t p = 0; p < numberOfPixels; ++p)
+  {
+    for (unsigned int c = 0; c < numComponents; ++c)
+    {
+      const size_t nifti_index = (c * numberOfPixels + p) * componentSize;
+      const size_t itk_index = (p * numComponents + vecOrder[c]) * componentSize;
+      if (toNIfTI)
+      {
+        memcpy(to + nifti_index, from + itk_index, componentSize);
+      }
+      else
+      {
+        memcpy(to + itk_index, from + nifti_index, componentSize);
+      }
+    }
+  }
+}
+
+// Like nifti_image_load, replace the NaN and infinite values by zero
+template <typename T>
+void
+ZeroNonFiniteValues(void * data, size_t numberOfBytes)
+{
+  auto * values = static_cast<T *>(data);
+  for (size_t i = 0; i < numberOfBytes / sizeof(T); ++i)
+  {
+    if (!std::isfinite(values[i]))
+    {
+      values[i] = 0;
+    }
+  }
+}
+} // namespace
+
+void *
+NiftiImageIO::ReadHyperslab(const int origin[7], const int size[7])
+{
+  nifti_image * const nim = this->m_NiftiImage;
+  int                 dims[7];
+  size_t              numberOfBytes = nim->nbyper;
+  for (unsigned int d = 0; d < 7; ++d)
+  {
+    dims[d] = std::max(nim->dim[d + 1], 1);
+    numberOfBytes *= static_cast<size_t>(size[d]);
+  }
+  // Malloc instead of new to be consistent with allocation used in niftilib
+  auto * data = static_cast<char *>(malloc(numberOfBytes));
+  if (data == nullptr)
+  {
+    itkExceptionMacro(<< "Failed to allocate " << numberOfBytes << " bytes to read: " << this->GetFileName());
+  }
+
+  bool succeeded = true;
+  if (nim->nifti_type == NIFTI_FTYPE_ASCII)
+  {
+    // The voxels are text, load them all and copy the hyperslab
+    succeeded = nifti_image_load(nim) != -1;
+    if (succeeded)
+    {
+      const auto * const voxels = static_cast<const char *>(nim->data);
+      ForEachHyperslabRun(
+        dims, origin, size, nim->nbyper, [data, voxels](size_t fileOffset, size_t bufferOffset, size_t length) {
+          memcpy(data + bufferOffset, voxels + fileOffset, length);
+        });
+      nifti_image_unload(nim);
+    }
+  }
+  else if (nifti_is_gzfile(nim->iname))
+  {
+    const std::string fileName(nim->iname);
+    const auto        dataOffset = static_cast<uint64_t>(nim->iname_offset);
+    GzipIndex &       index = *this->m_GzipIndex;
+    ForEachHyperslabRun(dims, origin, size, nim->nbyper, [&](size_t fileOffset, size_t bufferOffset, size_t length) {
+      succeeded = succeeded && index.Read(fileName, dataOffset + fileOffset, data + bufferOffset, length);
+    });
+  }
+  else
+  {
+    std::ifstream file(nim->iname, std::ios::in | std::ios::binary);
+    const auto    dataOffset = static_cast<std::streamoff>(nim->iname_offset);
+    ForEachHyperslabRun(dims, origin, size, nim->nbyper, [&](size_t fileOffset, size_t bufferOffset, size_t length) {
+      file.seekg(dataOffset + static_cast<std::streamoff>(fileOffset));
+      file.read(data + bufferOffset, static_cast<std::streamsize>(length));
+    });
+    succeeded = file.is_open() && !file.fail();
+  }
+  if (!succeeded)
+  {
+    free(data);
+    itkExceptionMacro(<< "Failed to read a region of the voxels of file: " << this->GetFileName());
+  }
+
+  if (nim->nifti_type != NIFTI_FTYPE_ASCII)
+  {
+    if (nim->swapsize > 1 && nim->byteorder != nifti_short_order())
+    {
+      nifti_swap_Nbytes(numberOfBytes / nim->swapsize, nim->swapsize, data);
+    }
+    switch (nim->datatype)
+    {
+      case NIFTI_TYPE_FLOAT32:
+      case NIFTI_TYPE_COMPLEX64:
+        ZeroNonFiniteValues<float>(data, numberOfBytes);
+        break;
+      case NIFTI_TYPE_FLOAT64:
+      case NIFTI_TYPE_COMPLEX128:
+        ZeroNonFiniteValues<double>(data, numberOfBytes);
+        break;
+      default:
+        break;
+    }
+  }
+  return data;
+}
+
+void
+NiftiImageIO::WriteHyperslab(const void * buffer, const int origin[7], const int size[7])
+{
+  nifti_image * const nim = this->m_NiftiImage;
+  int                 dims[7];
+  for (unsigned int d = 0; d < 7; ++d)
+  {
+    dims[d] = std::max(nim->dim[d + 1], 1);
+  }
+
+  std::fstream file(nim->iname, std::ios::in | std::ios::out | std::ios::binary);
+  if (!file.is_open())
+  {
+    itkExceptionMacro(<< "Failed to open the data file of: " << this->GetFileName());
+  }
+  const auto * const voxels = static_cast<const char *>(buffer);
+  const auto         dataOffset = static_cast<std::streamoff>(nim->iname_offset);
+  ForEachHyperslabRun(dims, origin, size, nim->nbyper, [&](size_t fileOffset, size_t bufferOffset, size_t length) {
+    file.seekp(dataOffset + static_cast<std::streamoff>(fileOffset));
+    file.write(voxels + bufferOffset, static_cast<std::streamsize>(length));
+  });
+  if (file.fail())
+  {
+    itkExceptionMacro(<< "Failed to write a region of the voxels of file: " << this->GetFileName());
+  }
+}
+
+bool
+NiftiImageIO::GetRawImageDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  // Same conditions as the memcpy of the voxels in Read()
+  if (this->MustRescale() || this->m_ComponentType != this->m_OnDiskComponentType ||
+      (this->GetNumberOfComponents() > 1 && this->GetPixelType() != IOPixelEnum::COMPLEX &&
+       this->GetPixelType() != IOPixelEnum::RGB && this->GetPixelType() != IOPixelEnum::RGBA))
+  {
+    return false;
+  }
+
+  nifti_image * header = nifti_image_read(this->GetFileName(), false);
+  if (header == nullptr)
+  {
+    return false;
+  }
+  // Read() sets the non-finite floating point voxels to zero, as
+  // nifti_read_buffer() does, so they are not mapped
+  const bool floatingPoint = header->datatype == NIFTI_TYPE_FLOAT32 || header->datatype == NIFTI_TYPE_FLOAT64 ||
+                             header->datatype == NIFTI_TYPE_FLOAT128 || header->datatype == NIFTI_TYPE_COMPLEX64 ||
+                             header->datatype == NIFTI_TYPE_COMPLEX128 || header->datatype == NIFTI_TYPE_COMPLEX256;
+  const bool mappable = header->iname != nullptr && !nifti_is_gzfile(header->iname) && header->iname_offset >= 0 &&
+                        (header->swapsize <= 1 || header->byteorder == nifti_short_order()) && !floatingPoint;
+  if (mappable)
+  {
+    fileName = header->iname;
+    offset = static_cast<SizeValueType>(header->iname_offset);
+  }
+  nifti_image_free(header);
+  return mappable;
+}
+
 void
 NiftiImageIO::Read(void * buffer)
 {
@@ -593,10 +1042,7 @@ NiftiImageIO::Read(void * buffer)
   else
   {
     // read in a subregion
-    if (nifti_read_subregion_image(this->m_NiftiImage, _origin, _size, &data) == -1)
-    {
-      itkExceptionMacro(<< "nifti_read_subregion_image failed for file: " << this->GetFileName());
-    }
+    data = this->ReadHyperslab(_origin, _size);
   }
   unsigned int pixelSize = this->m_NiftiImage->nbyper;
   //
@@ -681,12 +1127,7 @@ NiftiImageIO::Read(void * buffer)
   {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
-    const auto * niftibuf = (const char *)data;
-    auto *       itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const size_t numPixels = static_cast<size_t>(_size[0]) * _size[1] * _size[2] * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -705,29 +1146,13 @@ NiftiImageIO::Read(void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
-    {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
-      {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
-        {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
-          {
-            for (unsigned int c = 0; c < numComponents; ++c)
-            {
-              const size_t nifti_index =
-                (c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x) * pixelSize;
-              const size_t itk_index =
-                ((volumedist * t + slicedist * z + rowdist * y + x) * numComponents + vecOrder[c]) * pixelSize;
-              for (unsigned int b = 0; b < pixelSize; ++b)
-              {
-                itkbuf[itk_index + b] = niftibuf[nifti_index + b];
-              }
-            }
-          }
-        }
-      }
-    }
+    ReorderComponents(static_cast<const char *>(data),
+                      static_cast<char *>(buffer),
+                      numPixels,
+                      numComponents,
+                      vecOrder,
+                      pixelSize,
+                      false);
     delete[] vecOrder;
     dumpdata(data);
     dumpdata(buffer);
@@ -1017,6 +1442,9 @@ NiftiImageIO ::ReadImageInformation()
     }
   }
 
+  // the file may have changed since the previous regions were read
+  this->m_GzipIndex->Reset();
+
   this->m_NiftiImage = nifti_image_read(this->GetFileName(), false);
   static std::string prev;
   if (prev != this->GetFileName())
@@ -1447,6 +1875,9 @@ NiftiImageIO ::WriteImageInformation()
   {
     itkExceptionMacro(<< "Bad Nifti file name: " << FName);
   }
+  // release the names of a previous write
+  free(this->m_NiftiImage->fname);
+  free(this->m_NiftiImage->iname);
   this->m_NiftiImage->fname = nifti_makehdrname(BaseName.c_str(), this->m_NiftiImage->nifti_type, false, IsCompressed);
   this->m_NiftiImage->iname = nifti_makeimgname(BaseName.c_str(), this->m_NiftiImage->nifti_type, false, IsCompressed);
   //     FIELD         NOTES
@@ -2176,15 +2607,119 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short int origdims, unsign
   this->m_NiftiImage->sform_code = NIFTI_XFORM_SCANNER_ANAT;
 }
 
+bool
+NiftiImageIO::CanStreamWrite()
+{
+  const char * const extension = nifti_find_file_extension(this->GetFileName());
+  return extension != nullptr && !nifti_is_gzfile(this->GetFileName()) && std::string(extension) != ".nia";
+}
+
+unsigned int
+NiftiImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
+{
+  if (pasteRegion != largestPossibleRegion)
+  {
+    itkExceptionMacro("Pasting is not supported! Can't write:" << this->GetFileName());
+  }
+  return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+}
+
 void
 NiftiImageIO ::Write(const void * buffer)
 {
   // Write the image Information before writing data
   this->WriteImageInformation();
   const unsigned int numComponents = this->GetNumberOfComponents();
-  if (numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
+  const bool         isVectorImage =
+    !(numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
       (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
-      (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA))
+      (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA));
+
+  //
+  // as per ITK bug 0007485
+  // NIfTI is lower triangular, ITK is upper triangular.
+  // i.e. if a symmetric matrix is
+  // a b c
+  // b d e
+  // c e f
+  // ITK stores it a b c d e f, but NIfTI is a b d c e f
+  // so on read, step sequentially through the source vector, but
+  // reverse the order of vec[2] and vec[3]
+  std::unique_ptr<int[]> vecOrder;
+  if (isVectorImage)
+  {
+    if (this->GetPixelType() == IOPixelEnum::DIFFUSIONTENSOR3D ||
+        this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR)
+    {
+      vecOrder.reset(UpperToLowerOrder(SymMatDim(numComponents)));
+    }
+    else
+    {
+      vecOrder.reset(new int[numComponents]);
+      for (unsigned i = 0; i < numComponents; ++i)
+      {
+        vecOrder[i] = i;
+      }
+    }
+  }
+
+  //
+  // streamed pieces are written at their offsets in the data file, which
+  // the piece at the origin creates along with the header
+  const ImageIORegion & ioRegion = this->GetIORegion();
+  bool                  isWholeImage = true;
+  bool                  isFirstPiece = true;
+  int                   _origin[7] = { 0, 0, 0, 0, 0, 0, 0 };
+  int                   _size[7] = { 1, 1, 1, 1, 1, 1, 1 };
+  for (unsigned int i = 0; i < ioRegion.GetImageDimension() && i < 7; ++i)
+  {
+    _origin[i] = static_cast<int>(ioRegion.GetIndex(i));
+    _size[i] = static_cast<int>(ioRegion.GetSize(i));
+    isWholeImage = isWholeImage && ioRegion.GetIndex(i) == 0 && ioRegion.GetSize(i) == this->GetDimensions(i);
+    isFirstPiece = isFirstPiece && ioRegion.GetIndex(i) == 0;
+  }
+  if (!isWholeImage)
+  {
+    if (!this->CanStreamWrite())
+    {
+      itkExceptionMacro(<< "Only uncompressed binary files can be written in pieces: " << this->GetFileName());
+    }
+    if (isFirstPiece)
+    {
+      znzFile file = nifti_image_write_hdr_img(this->m_NiftiImage, 2, "wb");
+      if (znz_isnull(file))
+      {
+        itkExceptionMacro(<< "Failed to write the header of: " << this->GetFileName());
+      }
+      znzclose(file);
+    }
+
+    const size_t numPixels = static_cast<size_t>(_size[0]) * _size[1] * _size[2] * _size[3];
+    if (isVectorImage)
+    {
+      _size[6] = _size[5];
+      _size[5] = _size[4];
+      _size[4] = numComponents;
+      const std::unique_ptr<char[]> nifti_buf(new char[numPixels * numComponents * this->m_NiftiImage->nbyper]);
+      ReorderComponents(static_cast<const char *>(buffer),
+                        nifti_buf.get(),
+                        numPixels,
+                        numComponents,
+                        vecOrder.get(),
+                        this->m_NiftiImage->nbyper,
+                        true);
+      this->WriteHyperslab(nifti_buf.get(), _origin, _size);
+    }
+    else
+    {
+      this->WriteHyperslab(buffer, _origin, _size);
+    }
+    return;
+  }
+
+  if (!isVectorImage)
   {
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
@@ -2207,64 +2742,16 @@ NiftiImageIO ::Write(const void * buffer)
     const size_t buffer_size = numVoxels * numComponents // Number of components
                                * this->m_NiftiImage->nbyper;
 
-    auto *             nifti_buf = new char[buffer_size];
-    const auto * const itkbuf = (const char *)buffer;
+    auto * nifti_buf = new char[buffer_size];
     // Data must be rearranged to meet nifti organzation.
     // nifti_layout[vec][t][z][y][x] = itk_layout[t][z][y][z][vec]
-    const size_t rowdist = m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * m_NiftiImage->dim[4];
-    //
-    // as per ITK bug 0007485
-    // NIfTI is lower triangular, ITK is upper triangular.
-    // i.e. if a symmetric matrix is
-    // a b c
-    // b d e
-    // c e f
-    // ITK stores it a b c d e f, but NIfTI is a b d c e f
-    // so on read, step sequentially through the source vector, but
-    // reverse the order of vec[2] and vec[3]
-    int * vecOrder;
-    if (this->GetPixelType() == IOPixelEnum::DIFFUSIONTENSOR3D ||
-        this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR)
-    {
-      vecOrder = UpperToLowerOrder(SymMatDim(numComponents));
-    }
-    else
-    {
-      vecOrder = new int[numComponents];
-      for (unsigned i = 0; i < numComponents; ++i)
-      {
-        vecOrder[i] = i;
-      }
-    }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
-    {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
-      {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
-        {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
-          {
-            for (unsigned int c = 0; c < numComponents; ++c)
-            {
-              const size_t nifti_index =
-                (c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x) * this->m_NiftiImage->nbyper;
-              const size_t itk_index =
-                ((volumedist * t + slicedist * z + rowdist * y + x) * numComponents + vecOrder[c]) *
-                this->m_NiftiImage->nbyper;
-
-              for (int b = 0; b < this->m_NiftiImage->nbyper; ++b)
-              {
-                nifti_buf[nifti_index + b] = itkbuf[itk_index + b];
-              }
-            }
-          }
-        }
-      }
-    }
-    delete[] vecOrder;
+    ReorderComponents(static_cast<const char *>(buffer),
+                      nifti_buf,
+                      numVoxels,
+                      numComponents,
+                      vecOrder.get(),
+                      this->m_NiftiImage->nbyper,
+                      true);
     dumpdata(buffer);
     // Need a const cast here so that we don't have to copy the memory for
     // writing.
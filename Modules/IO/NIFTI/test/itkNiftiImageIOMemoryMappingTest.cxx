@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cstring>
+#include <limits>
+
+/*
+ * Read NIfTI files with and without memory mapping, and check that both
+ * give the same pixels: the non-finite voxels of floating point files are
+ * set to zero in both cases, and integer files are still mapped.
+ */
+
+namespace
+{
+
+template <typename TPixel>
+int
+CompareReadAndMapped(const std::string & fileName, const typename itk::Image<TPixel, 3>::IndexType & specialIndex)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+
+  const typename ImageType::SizeType size = { { 7, 5, 3 } };
+  auto                               image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<TPixel>(it.GetIndex()[0] + 3 * it.GetIndex()[1] + 7 * it.GetIndex()[2]));
+  }
+  if (std::numeric_limits<TPixel>::has_quiet_NaN)
+  {
+    image->SetPixel(specialIndex, std::numeric_limits<TPixel>::quiet_NaN());
+    typename ImageType::IndexType infinityIndex = specialIndex;
+    infinityIndex[0] += 1;
+    image->SetPixel(infinityIndex, std::numeric_limits<TPixel>::infinity());
+  }
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  auto mappingImageIO = itk::NiftiImageIO::New();
+  mappingImageIO->UseMemoryMappingOn();
+  auto mappedReader = itk::ImageFileReader<ImageType>::New();
+  mappedReader->SetFileName(fileName);
+  mappedReader->SetImageIO(mappingImageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(mappedReader->Update());
+
+  const std::string containerClass = mappedReader->GetOutput()->GetPixelContainer()->GetNameOfClass();
+  std::cout << fileName << ": " << containerClass << std::endl;
+  ITK_TEST_EXPECT_EQUAL(containerClass, std::numeric_limits<TPixel>::is_integer ? "MemoryMappedImageContainer"
+                                                                                : "ImportImageContainer");
+
+  const ImageType * read = reader->GetOutput();
+  const ImageType * mapped = mappedReader->GetOutput();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(read, read->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    // Compare the bytes, so that NaN voxels would be reported
+    const TPixel mappedValue = mapped->GetPixel(it.GetIndex());
+    const TPixel readValue = it.Get();
+    if (std::memcmp(&mappedValue, &readValue, sizeof(TPixel)) != 0)
+    {
+      std::cerr << "At " << it.GetIndex() << ", the mapped value " << static_cast<double>(mappedValue)
+                << " differs from the read value " << static_cast<double>(readValue) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (std::numeric_limits<TPixel>::has_quiet_NaN)
+  {
+    ITK_TEST_EXPECT_EQUAL(static_cast<double>(mapped->GetPixel(specialIndex)), 0.0);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkNiftiImageIOMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  const itk::Image<float, 3>::IndexType specialIndex = { { 2, 3, 1 } };
+  int status = CompareReadAndMapped<float>(directory + "/itkNiftiImageIOMemoryMappingTestFloat.nii", specialIndex);
+  status |= CompareReadAndMapped<double>(directory + "/itkNiftiImageIOMemoryMappingTestDouble.nii", specialIndex);
+  status |= CompareReadAndMapped<short>(directory + "/itkNiftiImageIOMemoryMappingTestShort.nii", specialIndex);
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+template <typename TPixel>
+struct PixelTraits
+{
+  static TPixel
+  FromValue(int value)
+  {
+    return static_cast<TPixel>(value);
+  }
+};
+
+template <typename TComponent, unsigned int VLength>
+struct PixelTraits<itk::Vector<TComponent, VLength>>
+{
+  static itk::Vector<TComponent, VLength>
+  FromValue(int value)
+  {
+    itk::Vector<TComponent, VLength> pixel;
+    for (unsigned int c = 0; c < VLength; ++c)
+    {
+      pixel[c] = static_cast<TComponent>(value + 1000 * c);
+    }
+    return pixel;
+  }
+};
+
+template <typename TImage>
+typename TImage::PixelType
+ExpectedValue(const typename TImage::IndexType & index)
+{
+  constexpr int factors[] = { 1, 3, 7, 13 };
+  int           value = 0;
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+  {
+    value += factors[i] * static_cast<int>(index[i]);
+  }
+  return PixelTraits<typename TImage::PixelType>::FromValue(value % 30000);
+}
+
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<TImage>(it.GetIndex()));
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+ReadsRegion(itk::ImageFileReader<TImage> * reader, const typename TImage::RegionType & region)
+{
+  reader->GetOutput()->SetRequestedRegion(region);
+  try
+  {
+    reader->Update();
+  }
+  catch (const itk::ExceptionObject & exception)
+  {
+    std::cerr << exception << std::endl;
+    return false;
+  }
+  if (reader->GetOutput()->GetBufferedRegion() != region)
+  {
+    std::cerr << "Read " << reader->GetOutput()->GetBufferedRegion() << " instead of " << region << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(reader->GetOutput(), region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue<TImage>(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Write an image, in streamed pieces when possible, then read it by regions
+template <typename TImage>
+int
+StreamImage(const std::string &                              fileName,
+            const typename TImage::SizeType &                size,
+            const std::vector<typename TImage::RegionType> & regions)
+{
+  const auto image = MakeImage<TImage>(size);
+
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(itk::NiftiImageIO::New());
+  writer->SetNumberOfStreamDivisions(5);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->UpdateOutputInformation());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+
+  // Successive regions of the same reader, in any order
+  for (const auto & region : regions)
+  {
+    ITK_TEST_EXPECT_TRUE(ReadsRegion(reader.GetPointer(), region));
+  }
+  ITK_TEST_EXPECT_TRUE(ReadsRegion(reader.GetPointer(), image->GetLargestPossibleRegion()));
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkNiftiImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  auto imageIO = itk::NiftiImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamRead());
+  imageIO->SetFileName(directory + "/itkNiftiImageIOStreamingTest.nii");
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+  imageIO->SetFileName(directory + "/itkNiftiImageIOStreamingTest.hdr");
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+  imageIO->SetFileName(directory + "/itkNiftiImageIOStreamingTest.nii.gz");
+  ITK_TEST_EXPECT_TRUE(!imageIO->CanStreamWrite());
+  imageIO->SetFileName(directory + "/itkNiftiImageIOStreamingTest.nia");
+  ITK_TEST_EXPECT_TRUE(!imageIO->CanStreamWrite());
+
+  using Image4DType = itk::Image<short, 4>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+
+  // A sub-volume, a single time point and a single voxel
+  const Image4DType::SizeType                size4D = { { 23, 17, 9, 11 } };
+  const std::vector<Image4DType::RegionType> regions4D = {
+    Image4DType::RegionType({ { 3, 2, 1, 4 } }, { { 15, 9, 5, 3 } }),
+    Image4DType::RegionType({ { 0, 0, 0, 7 } }, { { 23, 17, 9, 1 } }),
+    Image4DType::RegionType({ { 22, 16, 8, 0 } }, { { 1, 1, 1, 1 } })
+  };
+  const VectorImageType::SizeType                sizeVector = { { 19, 14, 10 } };
+  const std::vector<VectorImageType::RegionType> regionsVector = {
+    VectorImageType::RegionType({ { 4, 5, 2 } }, { { 11, 6, 7 } }),
+    VectorImageType::RegionType({ { 0, 0, 9 } }, { { 19, 14, 1 } })
+  };
+
+  int status = EXIT_SUCCESS;
+  for (const char * extension : { ".nii", ".hdr", ".nii.gz", ".nia" })
+  {
+    std::cout << "Extension " << extension << std::endl;
+    status |= StreamImage<Image4DType>(directory + "/itkNiftiImageIOStreamingTest4D" + extension, size4D, regions4D);
+    status |= StreamImage<VectorImageType>(
+      directory + "/itkNiftiImageIOStreamingTestVector" + extension, sizeVector, regionsVector);
+  }
+
+  // Time points of a compressed series large enough to be read from several access points
+  const Image4DType::SizeType                sizeSeries = { { 128, 128, 64, 12 } };
+  const std::vector<Image4DType::RegionType> regionsSeries = {
+    Image4DType::RegionType({ { 0, 0, 0, 10 } }, { { 128, 128, 64, 1 } }),
+    Image4DType::RegionType({ { 0, 0, 0, 1 } }, { { 128, 128, 64, 1 } }),
+    Image4DType::RegionType({ { 10, 20, 30, 11 } }, { { 50, 40, 30, 1 } }),
+    Image4DType::RegionType({ { 10, 20, 30, 9 } }, { { 50, 40, 30, 2 } })
+  };
+  status |=
+    StreamImage<Image4DType>(directory + "/itkNiftiImageIOStreamingTestSeries.nii.gz", sizeSeries, regionsSeries);
+
+  // Pasting is not supported
+  auto image = MakeImage<Image4DType>(size4D);
+  auto writer = itk::ImageFileWriter<Image4DType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(directory + "/itkNiftiImageIOStreamingTestPaste.nii");
+  writer->SetImageIO(itk::NiftiImageIO::New());
+  itk::ImageIORegion pasteRegion(4);
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    pasteRegion.SetSize(i, 2);
+  }
+  writer->SetIORegion(pasteRegion);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -38,6 +38,11 @@ namespace itk
  * "bzip2".  Only the "gzip" compressor support the compression level
  * in the range 0-9.
  *
+ * The "parallelgzip" compressor deflates chunks of the data concurrently
+ * into a gzip stream which any NRRD reader decompresses, and records the
+ * compressed size of the chunks in the gzip header so that this reader
+ * also inflates them concurrently.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
@@ -101,6 +106,21 @@ protected:
   void
   InternalSetCompressor(const std::string & _compressor) override;
 
+  /** Raw encoded data, attached or in a single detached data file, may be
+   * memory mapped when its range axis, if any, is the fastest one. */
+  bool
+  GetRawImageDataLocation(std::string & fileName, SizeValueType & offset) override;
+
+  /** Locate data of the given encoding, attached or in a single detached
+   * data file, when its range axis, if any, is the fastest one. */
+  bool
+  GetImageDataLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeValueType & offset);
+
+  /** Read gzip data written by the "parallelgzip" compressor, inflating its
+   * chunks concurrently. Returns false if the data is not such a stream. */
+  bool
+  ReadChunkedGzipData(void * buffer);
+
   /** Utility functions for converting between enumerated data type
       representations */
   int
@@ -110,6 +130,11 @@ protected:
   NrrdToITKComponentType(const int) const;
 
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+  bool m_ParallelCompression{ false };
+
+  /** Encoding of the data of the file read by ReadImageInformation(). */
+  const NrrdEncoding_t * m_ReadEncoding{ nullptr };
 };
 } // end namespace itk
 
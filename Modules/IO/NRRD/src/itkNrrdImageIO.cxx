@@ -22,6 +22,9 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkParallelDeflate.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
 
 namespace itk
 {
@@ -71,6 +74,7 @@ void
 NrrdImageIO::InternalSetCompressor(const std::string & _compressor)
 {
   this->m_NrrdCompressionEncoding = nullptr;
+  this->m_ParallelCompression = false;
 
   // set default to gzip
   if (_compressor.empty())
@@ -82,6 +86,13 @@ NrrdImageIO::InternalSetCompressor(const std::string & _compressor)
     return;
   }
 
+  if (_compressor == "PARALLELGZIP" && nrrdEncodingGzip->available())
+  {
+    this->m_NrrdCompressionEncoding = nrrdEncodingGzip;
+    this->m_ParallelCompression = true;
+    return;
+  }
+
   const NrrdEncoding * nrrdCompressionEncodings[] = { nrrdEncodingGzip, nrrdEncodingBzip2 };
 
   for (auto & nrrdEncoding : nrrdCompressionEncodings)
@@ -319,6 +330,7 @@ NrrdImageIO::ReadImageInformation()
       this->SetByteOrder(IOByteOrderEnum::OrderNotApplicable);
     }
 
+    m_ReadEncoding = nio->encoding;
     if (nio->encoding == nrrdEncodingAscii)
     {
       this->SetFileTypeToASCII();
@@ -727,6 +739,11 @@ NrrdImageIO::Read(void * buffer)
     // actual size of the data.  The data will be allocated by nrrdLoad.
     nrrdAllocated = true;
   }
+  else if (this->ReadChunkedGzipData(buffer))
+  {
+    nrrdNix(nrrd);
+    return;
+  }
   else
   {
     // The data buffer has already been allocated for the correct size.
@@ -849,6 +866,156 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::GetRawImageDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  return this->GetImageDataLocation(nrrdEncodingRaw, fileName, offset);
+}
+
+bool
+NrrdImageIO::GetImageDataLocation(const NrrdEncoding_t * encoding, std::string & fileName, SizeValueType & offset)
+{
+  if (IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType())
+  {
+    // May be stored with a mask component, see Read()
+    return false;
+  }
+
+  Nrrd *        nrrd = nrrdNew();
+  NrrdIoState * nio = nrrdIoStateNew();
+
+  // nrrd causes exceptions on purpose, so mask them
+  bool saveFPEState(false);
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    saveFPEState = FloatingPointExceptions::GetEnabled();
+    FloatingPointExceptions::Disable();
+  }
+
+  // Read the header again, to find where the data is
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  bool located = false;
+  if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
+  {
+    free(biffGetDone(NRRD));
+  }
+  else
+  {
+    unsigned int       rangeAxisIdx[NRRD_DIM_MAX];
+    const unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    const bool         attached = nio->dataFNArr->len == 0;
+    // A byte skip of compressed data counts decompressed bytes
+    located = nio->encoding == encoding && nio->lineSkip == 0 && !nio->dataFNFormat && nio->dataFNArr->len <= 1 &&
+              (encoding == nrrdEncodingRaw || nio->byteSkip == 0) &&
+              (rangeAxisNum == 0 || (rangeAxisNum == 1 && rangeAxisIdx[0] == 0));
+    if (located)
+    {
+      const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+      if (attached)
+      {
+        fileName = m_FileName;
+      }
+      else if (itksys::SystemTools::FileIsFullPath(nio->dataFN[0]) || path.empty())
+      {
+        fileName = nio->dataFN[0];
+      }
+      else
+      {
+        fileName = path + '/' + nio->dataFN[0];
+      }
+      const auto          numberOfBytes = static_cast<SizeValueType>(this->GetImageSizeInBytes());
+      const auto          fileLength = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+      if (nio->byteSkip == -1)
+      {
+        // The data is at the end of the file
+        located = fileLength >= numberOfBytes;
+        offset = fileLength - numberOfBytes;
+      }
+      else
+      {
+        offset = static_cast<SizeValueType>(nio->byteSkip);
+        if (attached)
+        {
+          // The data follows the empty line which ends the header
+          std::ifstream file;
+          this->OpenFileForReading(file, fileName);
+          std::string line;
+          located = false;
+          while (std::getline(file, line))
+          {
+            if (line.empty() || line == "\r")
+            {
+              offset += static_cast<SizeValueType>(file.tellg());
+              located = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (FloatingPointExceptions::HasFloatingPointExceptionsSupport())
+  {
+    FloatingPointExceptions::SetEnabled(saveFPEState);
+  }
+  nrrdNix(nrrd);
+  nrrdIoStateNix(nio);
+  return located;
+}
+
+bool
+NrrdImageIO::ReadChunkedGzipData(void * buffer)
+{
+  // Parse the header again only for gzip data
+  if (m_ReadEncoding != nrrdEncodingGzip ||
+      (this->GetComponentSize() > 1 &&
+       ((m_ByteOrder == IOByteOrderEnum::BigEndian && !ByteSwapper<int>::SystemIsBigEndian()) ||
+        (m_ByteOrder == IOByteOrderEnum::LittleEndian && !ByteSwapper<int>::SystemIsLittleEndian()))))
+  {
+    return false;
+  }
+
+  std::string   fileName;
+  SizeValueType offset = 0;
+  if (!this->GetImageDataLocation(nrrdEncodingGzip, fileName, offset))
+  {
+    return false;
+  }
+  const auto fileLength = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+  if (fileLength <= offset)
+  {
+    return false;
+  }
+
+  // The chunk index is in the extra field of the gzip header, at most 64 KiB.
+  // The whole compressed data is only read once the index is found.
+  std::ifstream file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(static_cast<std::streamoff>(offset));
+  const SizeValueType compressedSize = fileLength - offset;
+  const SizeValueType headerSize = std::min(compressedSize, SizeValueType{ 12 + 65535 });
+  std::vector<char>   compressed(headerSize);
+  file.read(compressed.data(), static_cast<std::streamsize>(headerSize));
+  if (!file || !ParallelDeflate::HasChunkIndex(compressed.data(), headerSize))
+  {
+    return false;
+  }
+  compressed.resize(compressedSize);
+  file.read(compressed.data() + headerSize, static_cast<std::streamsize>(compressedSize - headerSize));
+  if (!file)
+  {
+    itkExceptionMacro("Read: Error reading " << fileName);
+  }
+
+  if (!ParallelDeflate::Decompress(
+        compressed.data(), compressed.size(), buffer, static_cast<SizeValueType>(this->GetImageSizeInBytes())))
+  {
+    itkExceptionMacro("Read: Error decompressing gzip data of " << fileName);
+  }
+  return true;
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -1111,6 +1278,10 @@ NrrdImageIO::Write(const void * buffer)
       break;
   }
 
+  // The data compressed in parallel is written after the header
+  const bool parallelCompression = nio->encoding == nrrdEncodingGzip && this->m_ParallelCompression;
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, parallelCompression);
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1118,6 +1289,32 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (parallelCompression)
+  {
+    const std::vector<unsigned char> compressed =
+      ParallelDeflate::Compress(buffer,
+                                static_cast<SizeValueType>(this->GetImageSizeInBytes()),
+                                this->GetCompressionLevel(),
+                                ParallelDeflate::Format::Gzip);
+
+    // Attached data follows the header; the header names a detached data file
+    std::string dataFileName = m_FileName;
+    if (nio->dataFNArr->len > 0)
+    {
+      const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+      dataFileName = itksys::SystemTools::FileIsFullPath(nio->dataFN[0]) || path.empty()
+                       ? std::string(nio->dataFN[0])
+                       : path + '/' + nio->dataFN[0];
+    }
+    std::ofstream file(dataFileName.c_str(),
+                       std::ios::binary | (nio->dataFNArr->len > 0 ? std::ios::trunc : std::ios::app));
+    file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    if (!file)
+    {
+      itkExceptionMacro("Write: Error writing " << dataFileName);
+    }
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
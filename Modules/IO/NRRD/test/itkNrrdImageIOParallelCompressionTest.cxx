@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNrrdImageIO.h"
+#include "itkParallelDeflate.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+
+template <typename TPixel>
+TPixel
+ExpectedValue(int value)
+{
+  return static_cast<TPixel>(value);
+}
+
+template <>
+itk::Vector<float, 3>
+ExpectedValue<itk::Vector<float, 3>>(int value)
+{
+  itk::Vector<float, 3> pixel;
+  pixel[0] = value;
+  pixel[1] = -value;
+  pixel[2] = 0.5f * value;
+  return pixel;
+}
+
+template <typename TImage>
+typename TImage::PixelType
+ExpectedValue(const typename TImage::IndexType & index)
+{
+  return ExpectedValue<typename TImage::PixelType>(static_cast<int>(index[0] + 3 * index[1] + 7 * index[2]) % 1000);
+}
+
+// Write an image with the given compressor, then read it back
+template <typename TImage>
+int
+WriteAndReadImage(const std::string & fileName, const typename TImage::SizeType & size, const std::string & compressor)
+{
+  std::cout << fileName << ", " << compressor << std::endl;
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<TImage>(it.GetIndex()));
+  }
+
+  auto writerIO = itk::NrrdImageIO::New();
+  writerIO->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(writerIO);
+  writer->SetUseCompression(true);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(reader->GetOutput(), reader->GetOutput()->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue<TImage>(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// Whether the gzip stream of a detached data file records its chunks
+bool
+DataFileHasChunkIndex(const std::string & dataFileName)
+{
+  std::ifstream              file(dataFileName.c_str(), std::ios::binary);
+  std::vector<unsigned char> compressed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return itk::ParallelDeflate::HasChunkIndex(compressed.data(), compressed.size());
+}
+
+} // namespace
+
+int
+itkNrrdImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using ImageType = itk::Image<short, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+
+  // Several chunks of compressed data
+  const ImageType::SizeType       size = { { 160, 128, 70 } };
+  const VectorImageType::SizeType sizeVector = { { 31, 23, 17 } };
+
+  int status = EXIT_SUCCESS;
+  for (const char * compressor : { "ParallelGzip", "gzip" })
+  {
+    const std::string suffix = compressor == std::string("gzip") ? "Serial" : "";
+    status |= WriteAndReadImage<ImageType>(
+      directory + "/itkNrrdImageIOParallelCompressionTest" + suffix + ".nrrd", size, compressor);
+    status |= WriteAndReadImage<ImageType>(
+      directory + "/itkNrrdImageIOParallelCompressionTest" + suffix + ".nhdr", size, compressor);
+    status |= WriteAndReadImage<VectorImageType>(
+      directory + "/itkNrrdImageIOParallelCompressionTestVector" + suffix + ".nrrd", sizeVector, compressor);
+  }
+
+  // Only the parallel compressor records the chunks
+  ITK_TEST_EXPECT_TRUE(DataFileHasChunkIndex(directory + "/itkNrrdImageIOParallelCompressionTest.raw.gz"));
+  ITK_TEST_EXPECT_TRUE(!DataFileHasChunkIndex(directory + "/itkNrrdImageIOParallelCompressionTestSerial.raw.gz"));
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -166,6 +166,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Binary data is stored after the header, see GetHeaderSize(). */
+  bool
+  GetRawImageDataLocation(std::string & fileName, SizeValueType & offset) override;
+
   // void ComputeInternalFileName(unsigned long slice);
 
 private:
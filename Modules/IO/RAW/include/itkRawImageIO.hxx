@@ -162,6 +162,20 @@ RawImageIO<TPixel, VImageDimension>::Read(void * buffer)
   ReadRawBytesAfterSwapping(componentType, buffer, m_ByteOrder, numberOfComponents);
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+bool
+RawImageIO<TPixel, VImageDimension>::GetRawImageDataLocation(std::string & fileName, SizeValueType & offset)
+{
+  if (m_FileType != IOFileEnum::Binary || m_FileName.empty())
+  {
+    return false;
+  }
+  this->ComputeStrides();
+  fileName = m_FileName;
+  offset = this->GetHeaderSize();
+  return true;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 bool
 RawImageIO<TPixel, VImageDimension>::CanWriteFile(const char * fname)
@@ -21,6 +21,7 @@
 
 #include "itkImageIOBase.h"
 #include <fstream>
+#include <memory>
 
 namespace itk
 {
@@ -38,6 +39,12 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Streamed reading decodes only the pages, strips and tiles which
+ * intersect the requested region; the tiles are decoded in parallel.
+ * Streamed writing appends the pieces of the image to the file in order,
+ * along the slowest dimension, in strips or in tiles (see SetTileWidth()).
+ * Pasting into an existing file is not supported.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -83,6 +90,18 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** TIFF files can be streamed when reading. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Returns the requested region when streaming is enabled, the whole
+   * image otherwise. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const override;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -100,6 +119,28 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** TIFF files can be streamed when writing, by slabs written in order. */
+  bool
+  CanStreamWrite() override
+  {
+    return true;
+  }
+
+  /** Throws an exception when pasteRegion is not the largest possible
+   * region, since pasting is not supported. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+  /** Set/Get the size of the tiles of the written images. They must be
+   * multiples of 16. When either is 0, the default, the images are written
+   * in strips. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
   enum
   {
     NOFORMAT,
@@ -255,13 +296,40 @@ private:
   void
   ReadCurrentPage(void * buffer, size_t pixelOffset);
 
+  /** Get the part of the IORegion in the pages. */
+  void
+  GetPageRegion(uint32_t & startX, uint32_t & startY, uint32_t & sizeX, uint32_t & sizeY) const;
+
   template <typename TComponent>
   void
   ReadGenericImage(void * _out, unsigned int width, unsigned int height);
 
+  /** Reads the tiles of the current page which intersect the IORegion, on
+   * the multi-threader. */
   template <typename TComponent>
   void
-  RGBAImageToBuffer(void * out, const uint32_t * tempImage);
+  ReadGenericTiles(TComponent * out, unsigned int height, size_t inc);
+
+  /** Converts count pixels of a decoded row of the file, starting at
+   * firstPixel, to the output pixels. */
+  template <typename TComponent>
+  void
+  PutRow(TComponent * out, const void * row, unsigned int firstPixel, unsigned int count);
+
+  template <typename TComponent>
+  void
+  RGBAImageToBuffer(void * out, const uint32_t * tempImage, size_t sizeX, size_t sizeY, size_t tempWidth);
+
+  /** Sets the tags of a page being written. */
+  void
+  SetupPageForWriting(uint16_t page, uint16_t pages);
+
+  /** Writes the tiles of the rows buffered for the current page. */
+  void
+  WriteBufferedTiles();
+
+  void
+  CloseFileForWriting();
 
   template <typename TType>
   void
@@ -309,6 +377,19 @@ private:
   uint16_t *   m_ColorBlue;
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+
+  unsigned int m_TileWidth{ 0 };
+  unsigned int m_TileHeight{ 0 };
+
+  /** State of the file being written, kept between the streamed pieces. */
+  struct WriteState;
+  std::unique_ptr<WriteState> m_WriteState;
+
+  /** Handles of the file which decode the bands of tiles of the work units
+   * other than the first one. ReadVolume() keeps them from one page to the
+   * next. */
+  struct TileReaders;
+  std::unique_ptr<TileReaders> m_TileReaders;
 };
 } // end namespace itk
 
@@ -20,12 +20,59 @@
 #include "itkTIFFReaderInternal.h"
 #include "itksys/SystemTools.hxx"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
 
 #include "itk_tiff.h"
 
+#include <mutex>
+
 namespace itk
 {
 
+struct TIFFImageIO::WriteState
+{
+  TIFF * tif{ nullptr };
+
+  // Next row to write, counted over all the pages
+  SizeValueType nextRow{ 0 };
+
+  SizeValueType rowLength{ 0 }; // in bytes
+  SizeValueType pixelLength{ 0 };
+  bool          paletteAllocated{ false };
+
+  // Rows of the row of tiles being written
+  std::vector<char> tileRows;
+  uint32_t          tileRowsStart{ 0 };
+  uint32_t          numberOfTileRows{ 0 };
+};
+
+struct TIFFImageIO::TileReaders
+{
+  TileReaders() = default;
+  TileReaders(const TileReaders &) = delete;
+  TileReaders &
+  operator=(const TileReaders &) = delete;
+  ~TileReaders()
+  {
+    for (TIFF * tif : handles)
+    {
+      if (tif != nullptr)
+      {
+        TIFFClose(tif);
+      }
+    }
+  }
+
+  // One handle per work unit after the first one, nullptr until opened
+  std::vector<TIFF *> handles;
+};
+
+namespace
+{
+// Frees a buffer of libtiff when it goes out of scope
+using TIFFBufferPointer = std::unique_ptr<void, void (*)(tdata_t)>;
+} // namespace
+
 bool
 TIFFImageIO::CanReadFile(const char * file)
 {
@@ -148,10 +195,24 @@ TIFFImageIO::GetFormat()
 void
 TIFFImageIO::ReadVolume(void * buffer)
 {
-  const size_t width{ m_InternalImage->m_Width };
-  const size_t height{ m_InternalImage->m_Height };
+  uint32_t startX, startY, sizeX, sizeY;
+  this->GetPageRegion(startX, startY, sizeX, sizeY);
+
+  // Only the pages in the IORegion are read
+  const ImageIORegion & region = this->GetIORegion();
+  const auto            startPage = static_cast<size_t>(region.GetIndex(2));
+  const size_t          endPage = startPage + region.GetSize(2);
+
+  // The handles which decode the tiles follow the pages of the reader
+  struct TileReadersGuard
+  {
+    std::unique_ptr<TileReaders> & readers;
+    ~TileReadersGuard() { readers.reset(); }
+  } tileReadersGuard{ m_TileReaders };
+  m_TileReaders = std::make_unique<TileReaders>();
 
-  for (uint16_t page = 0; page < m_InternalImage->m_NumberOfPages; ++page)
+  size_t page = 0;
+  for (uint16_t directory = 0; directory < m_InternalImage->m_NumberOfPages && page < endPage; ++directory)
   {
     if (m_InternalImage->m_IgnoredSubFiles > 0)
     {
@@ -167,10 +228,13 @@ TIFFImageIO::ReadVolume(void * buffer)
       }
     }
 
+    if (page >= startPage)
+    {
+      const size_t pixelOffset = size_t{ sizeX } * sizeY * this->GetNumberOfComponents() * (page - startPage);
 
-    const size_t pixelOffset = width * height * this->GetNumberOfComponents() * page;
-
-    ReadCurrentPage(buffer, pixelOffset);
+      ReadCurrentPage(buffer, pixelOffset);
+    }
+    ++page;
 
     TIFFReadDirectory(m_InternalImage->m_Image);
   }
@@ -203,6 +267,41 @@ TIFFImageIO::Read(void * buffer)
   m_InternalImage->Clean();
 }
 
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  if (!m_UseStreamedReading)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+  }
+  // Only the pages, strips and tiles intersecting the requested region are
+  // decoded by Read()
+  return requested;
+}
+
+void
+TIFFImageIO::GetPageRegion(uint32_t & startX, uint32_t & startY, uint32_t & sizeX, uint32_t & sizeY) const
+{
+  const ImageIORegion & region = this->GetIORegion();
+  if (region.GetImageDimension() < 2)
+  {
+    startX = 0;
+    startY = 0;
+    sizeX = m_InternalImage->m_Width;
+    sizeY = m_InternalImage->m_Height;
+    return;
+  }
+  startX = static_cast<uint32_t>(region.GetIndex(0));
+  startY = static_cast<uint32_t>(region.GetIndex(1));
+  sizeX = static_cast<uint32_t>(region.GetSize(0));
+  sizeY = static_cast<uint32_t>(region.GetSize(1));
+  if (size_t{ startX } + sizeX > m_InternalImage->m_Width || size_t{ startY } + sizeY > m_InternalImage->m_Height)
+  {
+    itkExceptionMacro(<< "The IORegion " << region << " is outside of the " << m_InternalImage->m_Width << "x"
+                      << m_InternalImage->m_Height << " pages of " << m_FileName);
+  }
+}
+
 TIFFImageIO::TIFFImageIO()
   : m_ColorPalette(0)
 
@@ -237,6 +336,7 @@ TIFFImageIO::TIFFImageIO()
 
 TIFFImageIO::~TIFFImageIO()
 {
+  this->CloseFileForWriting();
   m_InternalImage->Clean();
   delete m_InternalImage;
 }
@@ -248,6 +348,8 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Compression: " << m_Compression << std::endl;
   os << indent << "JPEGQuality: " << this->GetJPEGQuality() << std::endl;
+  os << indent << "TileWidth: " << m_TileWidth << std::endl;
+  os << indent << "TileHeight: " << m_TileHeight << std::endl;
   if (!m_ColorPalette.empty())
   {
     os << indent << "Image RGB palette:"
@@ -560,12 +662,44 @@ TIFFImageIO::Write(const void * buffer)
   }
 }
 
+unsigned int
+TIFFImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  if (pasteRegion != largestPossibleRegion)
+  {
+    itkExceptionMacro("Pasting is not supported! Can't write:" << this->GetFileName());
+  }
+  // The pieces are split along the slowest dimension, and appended in order
+  return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+}
+
+void
+TIFFImageIO::CloseFileForWriting()
+{
+  if (m_WriteState)
+  {
+    if (m_WriteState->paletteAllocated)
+    {
+      _TIFFfree(m_ColorRed);
+      _TIFFfree(m_ColorGreen);
+      _TIFFfree(m_ColorBlue);
+    }
+    if (m_WriteState->tif)
+    {
+      TIFFClose(m_WriteState->tif);
+    }
+    m_WriteState.reset();
+  }
+}
+
 void
 TIFFImageIO::InternalWrite(const void * buffer)
 {
   const auto * outPtr = static_cast<const char *>(buffer);
 
-  uint16_t page, pages = 1;
+  uint16_t pages = 1;
 
   const SizeValueType width = m_Dimensions[0];
   const SizeValueType height = m_Dimensions[1];
@@ -574,88 +708,87 @@ TIFFImageIO::InternalWrite(const void * buffer)
     pages = static_cast<uint16_t>(m_Dimensions[2]);
   }
 
-  auto   scomponents = static_cast<uint16_t>(this->GetNumberOfComponents());
-  double resolution_x{ m_Spacing[0] != 0.0 ? 25.4 / m_Spacing[0] : 0.0 };
-  double resolution_y{ m_Spacing[1] != 0.0 ? 25.4 / m_Spacing[1] : 0.0 };
-  // rowsperstrip is set to a default value but modified based on the tif scanlinesize before
-  // passing it into the TIFFSetField (see below).
-  auto     rowsperstrip = uint32_t{ 0 };
-  uint16_t bps;
+  SizeValueType rowLength; // in bytes
 
   switch (this->GetComponentType())
   {
     case IOComponentEnum::UCHAR:
-      bps = 8;
-      break;
-    case IOComponentEnum::CHAR:
-      bps = 8;
+      rowLength = sizeof(unsigned char);
       break;
     case IOComponentEnum::USHORT:
-      bps = 16;
+      rowLength = sizeof(unsigned short);
+      break;
+    case IOComponentEnum::CHAR:
+      rowLength = sizeof(char);
       break;
     case IOComponentEnum::SHORT:
-      bps = 16;
+      rowLength = sizeof(short);
       break;
     case IOComponentEnum::FLOAT:
-      bps = 32;
+      rowLength = sizeof(float);
       break;
     default:
       itkExceptionMacro(<< "TIFF supports unsigned/signed char, unsigned/signed short, and float");
   }
 
-  uint16_t predictor;
-
-  const char * mode = "w";
-
-  // If the size of the image is greater than 2 GiB then use big tiff
-  constexpr SizeType oneKibiByte = 1024;
-  const SizeType     oneMebiByte = 1024 * oneKibiByte;
-  const SizeType     oneGibiByte = 1024 * oneMebiByte;
-  const SizeType     twoGibiBytes = 2 * oneGibiByte;
+  rowLength *= this->GetNumberOfComponents();
+  const SizeValueType pixelLength = rowLength;
+  rowLength *= width;
 
-  if (this->GetImageSizeInBytes() > twoGibiBytes)
+  const bool tiled = m_TileWidth > 0 && m_TileHeight > 0;
+  if (tiled && (m_TileWidth % 16 != 0 || m_TileHeight % 16 != 0))
   {
-#ifdef TIFF_INT64_T // detect if libtiff4
-    // Adding the "8" option enables the use of big tiff
-    mode = "w8";
-#else
-    itkExceptionMacro(<< "Size of image exceeds the limit of libtiff.");
-#endif
+    itkExceptionMacro(<< "The tile width and height must be multiples of 16, not " << m_TileWidth << " and "
+                      << m_TileHeight);
   }
 
-  TIFF * tif = TIFFOpen(m_FileName.c_str(), mode);
-  if (!tif)
+  // The IORegion is a slab of whole rows, or of whole pages
+  SizeValueType         firstRow = 0;
+  SizeValueType         numberOfRows = height * pages;
+  const ImageIORegion & region = this->GetIORegion();
+  if (region.GetImageDimension() >= 2)
   {
-    itkExceptionMacro("Error while trying to open file for writing: " << this->GetFileName() << std::endl
-                                                                      << "Reason: "
-                                                                      << itksys::SystemTools::GetLastSystemError());
+    const SizeValueType firstPage = region.GetImageDimension() > 2 ? region.GetIndex(2) : 0;
+    const SizeValueType numberOfPages = region.GetImageDimension() > 2 ? region.GetSize(2) : 1;
+    if (region.GetIndex(0) != 0 || region.GetSize(0) != width ||
+        (numberOfPages > 1 && (region.GetIndex(1) != 0 || region.GetSize(1) != height)))
+    {
+      itkExceptionMacro(<< "TIFFImageIO can only write slabs of whole rows or pages, not " << region);
+    }
+    firstRow = firstPage * height + region.GetIndex(1);
+    numberOfRows = numberOfPages * region.GetSize(1);
   }
 
-  if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
+  if (firstRow == 0)
   {
-    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
-  }
-  else if (this->GetComponentType() == IOComponentEnum::FLOAT)
-  {
-    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
-  }
+    this->CloseFileForWriting();
 
-  auto w = static_cast<uint32_t>(width);
-  auto h = static_cast<uint32_t>(height);
+    const char * mode = "w";
+
+    // If the size of the image is greater than 2 GiB then use big tiff
+    constexpr SizeType oneKibiByte = 1024;
+    const SizeType     oneMebiByte = 1024 * oneKibiByte;
+    const SizeType     oneGibiByte = 1024 * oneMebiByte;
+    const SizeType     twoGibiBytes = 2 * oneGibiByte;
+
+    if (this->GetImageSizeInBytes() > twoGibiBytes)
+    {
+#ifdef TIFF_INT64_T // detect if libtiff4
+      // Adding the "8" option enables the use of big tiff
+      mode = "w8";
+#else
+      itkExceptionMacro(<< "Size of image exceeds the limit of libtiff.");
+#endif
+    }
+
+    TIFF * tif = TIFFOpen(m_FileName.c_str(), mode);
+    if (!tif)
+    {
+      itkExceptionMacro("Error while trying to open file for writing: "
+                        << this->GetFileName() << std::endl
+                        << "Reason: " << itksys::SystemTools::GetLastSystemError());
+    }
 
-  if (m_NumberOfDimensions == 3)
-  {
-    TIFFCreateDirectory(tif);
-  }
-  for (page = 0; page < pages; ++page)
-  {
-    TIFFSetDirectory(tif, page);
-    TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
-    TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
-    TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-    TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
-    TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
-    TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
     if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
     {
       TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
@@ -664,88 +797,244 @@ TIFFImageIO::InternalWrite(const void * buffer)
     {
       TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
     }
-    TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
 
-    if (scomponents > 3)
+    if (m_NumberOfDimensions == 3)
     {
-      // if number of scalar components is greater than 3, that means we assume
-      // there is alpha.
-      uint16_t extra_samples = scomponents - 3;
-      auto *   sample_info = new uint16_t[scomponents - 3];
-      sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
-      for (uint16_t cc = 1; cc < scomponents - 3; ++cc)
-      {
-        sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
-      }
-      TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples, sample_info);
-      delete[] sample_info;
+      TIFFCreateDirectory(tif);
+    }
+
+    m_WriteState = std::make_unique<WriteState>();
+    m_WriteState->tif = tif;
+    m_WriteState->rowLength = rowLength;
+    m_WriteState->pixelLength = pixelLength;
+    if (tiled)
+    {
+      m_WriteState->tileRows.resize(rowLength * m_TileHeight);
     }
+  }
+  else if (!m_WriteState || firstRow != m_WriteState->nextRow)
+  {
+    itkExceptionMacro(<< "TIFFImageIO must write the pieces of " << m_FileName
+                      << " in order, along the slowest dimension");
+  }
 
-    uint16_t compression;
+  TIFF * tif = m_WriteState->tif;
+  for (SizeValueType row = firstRow; row < firstRow + numberOfRows; ++row)
+  {
+    const auto page = static_cast<uint16_t>(row / height);
+    const auto y = static_cast<uint32_t>(row % height);
+    if (y == 0)
+    {
+      this->SetupPageForWriting(page, pages);
+    }
 
-    if (m_UseCompression)
+    if (tiled)
     {
-      switch (m_Compression)
+      if (m_WriteState->numberOfTileRows == 0)
       {
-        case TIFFImageIO::LZW:
-          itkWarningMacro(
-            << "LZW compression is patented outside US so it is disabled. packbits compression will be used instead");
-          ITK_FALLTHROUGH;
-        case TIFFImageIO::PackBits:
-          compression = COMPRESSION_PACKBITS;
-          break;
-        case TIFFImageIO::JPEG:
-          compression = COMPRESSION_JPEG;
-          break;
-        case TIFFImageIO::Deflate:
-          compression = COMPRESSION_DEFLATE;
-          break;
-        default:
-          compression = COMPRESSION_NONE;
+        m_WriteState->tileRowsStart = y;
+      }
+      std::copy_n(outPtr, rowLength, &m_WriteState->tileRows[m_WriteState->numberOfTileRows * rowLength]);
+      ++m_WriteState->numberOfTileRows;
+      if (m_WriteState->numberOfTileRows == m_TileHeight || y + 1 == height)
+      {
+        this->WriteBufferedTiles();
       }
     }
-    else
+    else if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), y, 0) < 0)
     {
-      compression = COMPRESSION_NONE;
+      itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
     }
+    outPtr += rowLength;
 
-    TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
-
-    bool paletteAllocated = false;
-    if (scomponents == 1)
+    if (y + 1 == height)
     {
-      if (this->GetWritePalette())
+      if (m_NumberOfDimensions == 3)
       {
-        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_PALETTE);
-        this->AllocateTiffPalette(bps);
-        TIFFSetField(tif, TIFFTAG_COLORMAP, m_ColorRed, m_ColorGreen, m_ColorBlue);
-        paletteAllocated = true;
+        TIFFWriteDirectory(tif);
       }
-      else
+      if (m_WriteState->paletteAllocated)
       {
-        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+        _TIFFfree(m_ColorRed);
+        _TIFFfree(m_ColorGreen);
+        _TIFFfree(m_ColorBlue);
+        m_WriteState->paletteAllocated = false;
       }
     }
-    else
+  }
+
+  m_WriteState->nextRow = firstRow + numberOfRows;
+  if (m_WriteState->nextRow == height * pages)
+  {
+    this->CloseFileForWriting();
+  }
+}
+
+void
+TIFFImageIO::WriteBufferedTiles()
+{
+  const auto width = static_cast<uint32_t>(m_Dimensions[0]);
+
+  // Tiles past the end of the rows, or of the pages, are padded with 0
+  std::vector<char>   tile(m_WriteState->pixelLength * m_TileWidth * m_TileHeight);
+  const SizeValueType tileRowLength = m_WriteState->pixelLength * m_TileWidth;
+  for (uint32_t x = 0; x < width; x += m_TileWidth)
+  {
+    std::fill(tile.begin(), tile.end(), 0);
+    const SizeValueType length = m_WriteState->pixelLength * (std::min(x + m_TileWidth, width) - x);
+    for (uint32_t row = 0; row < m_WriteState->numberOfTileRows; ++row)
     {
-      if (this->GetWritePalette())
-      {
-        itkWarningMacro(<< "Could not write this image as palette because pixel is not scalar");
-      }
-      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+      std::copy_n(&m_WriteState->tileRows[row * m_WriteState->rowLength + x * m_WriteState->pixelLength],
+                  length,
+                  &tile[row * tileRowLength]);
+    }
+    if (TIFFWriteTile(m_WriteState->tif, tile.data(), x, m_WriteState->tileRowsStart, 0, 0) < 0)
+    {
+      itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+    }
+  }
+  m_WriteState->numberOfTileRows = 0;
+}
+
+void
+TIFFImageIO::SetupPageForWriting(uint16_t page, uint16_t pages)
+{
+  TIFF * tif = m_WriteState->tif;
+
+  const auto w = static_cast<uint32_t>(m_Dimensions[0]);
+  const auto h = static_cast<uint32_t>(m_Dimensions[1]);
+
+  auto   scomponents = static_cast<uint16_t>(this->GetNumberOfComponents());
+  double resolution_x{ m_Spacing[0] != 0.0 ? 25.4 / m_Spacing[0] : 0.0 };
+  double resolution_y{ m_Spacing[1] != 0.0 ? 25.4 / m_Spacing[1] : 0.0 };
+  uint16_t bps;
+
+  switch (this->GetComponentType())
+  {
+    case IOComponentEnum::UCHAR:
+      bps = 8;
+      break;
+    case IOComponentEnum::CHAR:
+      bps = 8;
+      break;
+    case IOComponentEnum::USHORT:
+      bps = 16;
+      break;
+    case IOComponentEnum::SHORT:
+      bps = 16;
+      break;
+    case IOComponentEnum::FLOAT:
+      bps = 32;
+      break;
+    default:
+      itkExceptionMacro(<< "TIFF supports unsigned/signed char, unsigned/signed short, and float");
+  }
+
+  uint16_t predictor;
+
+  TIFFSetDirectory(tif, page);
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, w);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, h);
+  TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, scomponents);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps); // Fix for stype
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  if (this->GetComponentType() == IOComponentEnum::SHORT || this->GetComponentType() == IOComponentEnum::CHAR)
+  {
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_INT);
+  }
+  else if (this->GetComponentType() == IOComponentEnum::FLOAT)
+  {
+    TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_IEEEFP);
+  }
+  TIFFSetField(tif, TIFFTAG_SOFTWARE, "InsightToolkit");
+
+  if (scomponents > 3)
+  {
+    // if number of scalar components is greater than 3, that means we assume
+    // there is alpha.
+    uint16_t extra_samples = scomponents - 3;
+    auto *   sample_info = new uint16_t[scomponents - 3];
+    sample_info[0] = EXTRASAMPLE_ASSOCALPHA;
+    for (uint16_t cc = 1; cc < scomponents - 3; ++cc)
+    {
+      sample_info[cc] = EXTRASAMPLE_UNSPECIFIED;
+    }
+    TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, extra_samples, sample_info);
+    delete[] sample_info;
+  }
+
+  uint16_t compression;
+
+  if (m_UseCompression)
+  {
+    switch (m_Compression)
+    {
+      case TIFFImageIO::LZW:
+        itkWarningMacro(
+          << "LZW compression is patented outside US so it is disabled. packbits compression will be used instead");
+        ITK_FALLTHROUGH;
+      case TIFFImageIO::PackBits:
+        compression = COMPRESSION_PACKBITS;
+        break;
+      case TIFFImageIO::JPEG:
+        compression = COMPRESSION_JPEG;
+        break;
+      case TIFFImageIO::Deflate:
+        compression = COMPRESSION_DEFLATE;
+        break;
+      default:
+        compression = COMPRESSION_NONE;
+    }
+  }
+  else
+  {
+    compression = COMPRESSION_NONE;
+  }
+
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, compression); // Fix for compression
+
+  if (scomponents == 1)
+  {
+    if (this->GetWritePalette())
+    {
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_PALETTE);
+      this->AllocateTiffPalette(bps);
+      TIFFSetField(tif, TIFFTAG_COLORMAP, m_ColorRed, m_ColorGreen, m_ColorBlue);
+      m_WriteState->paletteAllocated = true;
     }
-    if (compression == COMPRESSION_JPEG)
+    else
     {
-      TIFFSetField(tif, TIFFTAG_JPEGQUALITY, this->GetJPEGQuality());
-      TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+      TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
     }
-    else if (compression == COMPRESSION_DEFLATE)
+  }
+  else
+  {
+    if (this->GetWritePalette())
     {
-      predictor = PREDICTOR_NONE;
-      TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+      itkWarningMacro(<< "Could not write this image as palette because pixel is not scalar");
     }
+    TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+  }
+  if (compression == COMPRESSION_JPEG)
+  {
+    TIFFSetField(tif, TIFFTAG_JPEGQUALITY, this->GetJPEGQuality());
+    TIFFSetField(tif, TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+  }
+  else if (compression == COMPRESSION_DEFLATE)
+  {
+    predictor = PREDICTOR_NONE;
+    TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+  }
 
 
+  if (m_TileWidth > 0 && m_TileHeight > 0)
+  {
+    TIFFSetField(tif, TIFFTAG_TILEWIDTH, static_cast<uint32_t>(m_TileWidth));
+    TIFFSetField(tif, TIFFTAG_TILELENGTH, static_cast<uint32_t>(m_TileHeight));
+  }
+  else
+  {
     // Previously, rowsperstrip was set to a default value so that it would be calculated using
     // the STRIP_SIZE_DEFAULT defined to be 8 kB in tiffiop.h.
     // However, this a very conservative small number, and it leads to very small strips resulting
@@ -771,77 +1060,29 @@ TIFFImageIO::InternalWrite(const void * buffer)
     {
       itkExceptionMacro("TIFFScanlineSize returned 0");
     }
-    rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
+    auto rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
     if (rowsperstrip < 1)
     {
       rowsperstrip = 1;
     }
 
     TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+  }
 
-    if (resolution_x > 0 && resolution_y > 0)
-    {
-      TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
-      TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
-      TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
-    }
-
-    if (m_NumberOfDimensions == 3)
-    {
-      // We are writing single page of the multipage file
-      TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
-      // Set the page number
-      TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
-    }
-    SizeValueType rowLength; // in bytes
-
-    switch (this->GetComponentType())
-    {
-      case IOComponentEnum::UCHAR:
-        rowLength = sizeof(unsigned char);
-        break;
-      case IOComponentEnum::USHORT:
-        rowLength = sizeof(unsigned short);
-        break;
-      case IOComponentEnum::CHAR:
-        rowLength = sizeof(char);
-        break;
-      case IOComponentEnum::SHORT:
-        rowLength = sizeof(short);
-        break;
-      case IOComponentEnum::FLOAT:
-        rowLength = sizeof(float);
-        break;
-      default:
-        itkExceptionMacro(<< "TIFF supports unsigned/signed char, unsigned/signed short, and float");
-    }
-
-    rowLength *= this->GetNumberOfComponents();
-    rowLength *= width;
-
-    uint32_t row = 0;
-    for (unsigned int idx2 = 0; idx2 < height; ++idx2)
-    {
-      if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
-      {
-        itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
-      }
-      outPtr += rowLength;
-      ++row;
-    }
+  if (resolution_x > 0 && resolution_y > 0)
+  {
+    TIFFSetField(tif, TIFFTAG_XRESOLUTION, resolution_x);
+    TIFFSetField(tif, TIFFTAG_YRESOLUTION, resolution_y);
+    TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+  }
 
-    if (m_NumberOfDimensions == 3)
-    {
-      TIFFWriteDirectory(tif);
-    }
-    if (paletteAllocated)
-    {
-      _TIFFfree(m_ColorRed);
-      _TIFFfree(m_ColorGreen);
-      _TIFFfree(m_ColorBlue);
-    }
+  if (m_NumberOfDimensions == 3)
+  {
+    // We are writing single page of the multipage file
+    TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
+    // Set the page number
+    TIFFSetField(tif, TIFFTAG_PAGENUMBER, page, pages);
   }
-  TIFFClose(tif);
 }
 
 
@@ -1288,15 +1529,26 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
 
   if (!m_InternalImage->CanRead())
   {
-    uint32_t * tempImage = nullptr;
+    if (this->GetNumberOfComponents() != 4 || m_ComponentType != IOComponentEnum::UCHAR)
+    {
+      itkExceptionMacro("Logic Error: Unexpected buffer type!");
+    }
+
+    uint32_t startX, startY, sizeX, sizeY;
+    this->GetPageRegion(startX, startY, sizeX, sizeY);
 
-    if (this->GetNumberOfComponents() == 4 && m_ComponentType == IOComponentEnum::UCHAR)
+    // The RGBA interface decodes whole pages: a part of a page is cropped
+    // from a temporary page, a whole page is converted in place
+    std::vector<uint32_t> page;
+    uint32_t *            tempImage = nullptr;
+    if (sizeX == width && sizeY == height)
     {
       tempImage = static_cast<uint32_t *>(buffer) + (pixelOffset / 4);
     }
     else
     {
-      itkExceptionMacro("Logic Error: Unexpected buffer type!");
+      page.resize(size_t{ width } * height);
+      tempImage = page.data();
     }
 
     if (!TIFFReadRGBAImageOriented(m_InternalImage->m_Image, width, height, tempImage, ORIENTATION_TOPLEFT, 1))
@@ -1305,7 +1557,7 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
     }
 
     unsigned char * out = static_cast<unsigned char *>(buffer) + pixelOffset;
-    RGBAImageToBuffer<unsigned char>(out, tempImage);
+    RGBAImageToBuffer<unsigned char>(out, tempImage + size_t{ startY } * width + startX, sizeX, sizeY, width);
   }
   else
   {
@@ -1348,22 +1600,11 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
 
 template <typename TComponent>
 void
-TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int height)
+TIFFImageIO::ReadGenericImage(void * _out, unsigned int itkNotUsed(width), unsigned int height)
 {
   using ComponentType = TComponent;
 
-#ifdef TIFF_INT64_T // detect if libtiff4
-  uint64_t isize = TIFFScanlineSize64(m_InternalImage->m_Image);
-#else
-  tsize_t isize = TIFFScanlineSize(m_InternalImage->m_Image);
-#endif
-
-  size_t  inc;
-  tdata_t buf = _TIFFmalloc(static_cast<tmsize_t>(isize));
-  isize /= sizeof(ComponentType);
-
-  auto *          out = static_cast<ComponentType *>(_out);
-  ComponentType * image;
+  auto * out = static_cast<ComponentType *>(_out);
 
   if (m_InternalImage->m_PlanarConfig != PLANARCONFIG_CONTIG && m_InternalImage->m_SamplesPerPixel != 1)
   {
@@ -1375,7 +1616,7 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
     itkExceptionMacro(<< "This reader can only do ORIENTATION_TOPLEFT and  ORIENTATION_BOTLEFT.");
   }
 
-
+  size_t inc;
   switch (this->GetFormat())
   {
     case TIFFImageIO::GRAYSCALE:
@@ -1402,87 +1643,259 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       break;
   }
 
-  for (uint32_t row = 0; row < height; ++row)
+  if (TIFFIsTiled(m_InternalImage->m_Image))
   {
-    if (TIFFReadScanline(m_InternalImage->m_Image, buf, row, 0) <= 0)
+    this->ReadGenericTiles<ComponentType>(out, height, inc);
+    return;
+  }
+
+  uint32_t startX, startY, sizeX, sizeY;
+  this->GetPageRegion(startX, startY, sizeX, sizeY);
+
+  // Only the rows of the IORegion are decoded, in the order of the file
+  const uint32_t firstRow =
+    m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT ? startY : height - (startY + sizeY);
+
+#ifdef TIFF_INT64_T // detect if libtiff4
+  uint64_t isize = TIFFScanlineSize64(m_InternalImage->m_Image);
+#else
+  tsize_t isize = TIFFScanlineSize(m_InternalImage->m_Image);
+#endif
+
+  const TIFFBufferPointer buf(_TIFFmalloc(static_cast<tmsize_t>(isize)), _TIFFfree);
+
+  for (uint32_t row = firstRow; row < firstRow + sizeY; ++row)
+  {
+    if (TIFFReadScanline(m_InternalImage->m_Image, buf.get(), row, 0) <= 0)
     {
       itkExceptionMacro(<< "Problem reading the row: " << row);
     }
 
+    ComponentType * image;
     if (m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT)
     {
-      image = out + inc * row * width;
+      image = out + inc * (row - startY) * sizeX;
     }
     else // bottom left
     {
-      image = out + inc * width * (height - (row + 1));
+      image = out + inc * sizeX * (height - (row + 1) - startY);
     }
 
-    switch (this->GetFormat())
-    {
-      case TIFFImageIO::GRAYSCALE:
-        // check inverted
-        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
-        break;
-      case TIFFImageIO::RGB_:
-        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
-        break;
+    this->PutRow<ComponentType>(image, buf.get(), startX, sizeX);
+  }
+}
 
-      case TIFFImageIO::PALETTE_GRAYSCALE:
+template <typename TComponent>
+void
+TIFFImageIO::ReadGenericTiles(TComponent * out, unsigned int height, size_t inc)
+{
+  uint32_t startX, startY, sizeX, sizeY;
+  this->GetPageRegion(startX, startY, sizeX, sizeY);
+  if (sizeX == 0 || sizeY == 0)
+  {
+    return;
+  }
+
+  // The tiles of the pages may differ
+  uint32_t tileWidth = 0;
+  uint32_t tileHeight = 0;
+  if (!TIFFGetField(m_InternalImage->m_Image, TIFFTAG_TILEWIDTH, &tileWidth) ||
+      !TIFFGetField(m_InternalImage->m_Image, TIFFTAG_TILELENGTH, &tileHeight) || tileWidth == 0 || tileHeight == 0)
+  {
+    itkExceptionMacro(<< "Cannot read tile width and tile length from file");
+  }
+  const bool     topLeft = m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT;
+
+  // Rows of the file, and tiles, intersecting the IORegion
+  const uint32_t firstRow = topLeft ? startY : height - (startY + sizeY);
+  const uint32_t endRow = firstRow + sizeY;
+  const uint32_t firstTileRow = firstRow / tileHeight;
+  const uint32_t endTileRow = (endRow + tileHeight - 1) / tileHeight;
+  const uint32_t firstTileColumn = startX / tileWidth;
+  const uint32_t endTileColumn = (startX + sizeX + tileWidth - 1) / tileWidth;
+
+#ifdef TIFF_INT64_T // detect if libtiff4
+  const auto tileSize = static_cast<tmsize_t>(TIFFTileSize64(m_InternalImage->m_Image));
+  const auto tileRowSize = static_cast<size_t>(TIFFTileRowSize64(m_InternalImage->m_Image));
+#else
+  const auto tileSize = static_cast<tmsize_t>(TIFFTileSize(m_InternalImage->m_Image));
+  const auto tileRowSize = static_cast<size_t>(TIFFTileRowSize(m_InternalImage->m_Image));
+#endif
+  const auto     directory = TIFFCurrentDirectory(m_InternalImage->m_Image);
+
+  // A TIFF handle decodes one tile at a time: each work unit decodes a band of
+  // tile rows with its own handle, the first one uses the handle of the reader
+  auto               threader = MultiThreaderBase::New();
+  const uint32_t     numberOfTileRows = endTileRow - firstTileRow;
+  const uint32_t     numberOfBands = std::min(threader->GetNumberOfWorkUnits(), numberOfTileRows);
+  std::mutex         errorMutex;
+  std::ostringstream errors;
+
+  // Outside of ReadVolume(), the handles are only kept for this page
+  std::unique_ptr<TileReaders> pageReaders;
+  TileReaders *                readers = m_TileReaders.get();
+  if (readers == nullptr)
+  {
+    pageReaders = std::make_unique<TileReaders>();
+    readers = pageReaders.get();
+  }
+  if (readers->handles.size() + 1 < numberOfBands)
+  {
+    readers->handles.resize(numberOfBands - 1, nullptr);
+  }
+
+  threader->ParallelizeArray(
+    0,
+    numberOfBands,
+    [&](SizeValueType band) {
+      TIFF * tiff = m_InternalImage->m_Image;
+      if (band > 0)
+      {
+        // A handle kept from the previous page steps to the next one, rather
+        // than walking the directories from the first page
+        TIFF *& handle = readers->handles[band - 1];
+        if (handle == nullptr)
+        {
+          handle = TIFFOpen(m_FileName.c_str(), "r");
+        }
+        bool positioned = handle != nullptr;
+        while (positioned && TIFFCurrentDirectory(handle) < directory)
+        {
+          positioned = TIFFReadDirectory(handle) != 0;
+        }
+        if (handle != nullptr && (!positioned || TIFFCurrentDirectory(handle) != directory))
+        {
+          positioned = TIFFSetDirectory(handle, directory) != 0;
+        }
+        if (!positioned)
+        {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          errors << "Cannot open the page " << directory << " of " << m_FileName << ". ";
+          return;
+        }
+        tiff = handle;
+      }
+
+      const TIFFBufferPointer buf(_TIFFmalloc(tileSize), _TIFFfree);
+      const uint32_t bandStart = firstTileRow + static_cast<uint32_t>(band * numberOfTileRows / numberOfBands);
+      const uint32_t bandEnd = firstTileRow + static_cast<uint32_t>((band + 1) * numberOfTileRows / numberOfBands);
+      for (uint32_t tileRow = bandStart; tileRow < bandEnd; ++tileRow)
+      {
+        for (uint32_t tileColumn = firstTileColumn; tileColumn < endTileColumn; ++tileColumn)
+        {
+          const uint32_t tileX = tileColumn * tileWidth;
+          const uint32_t tileY = tileRow * tileHeight;
+          if (TIFFReadTile(tiff, buf.get(), tileX, tileY, 0, 0) < 0)
+          {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            errors << "Problem reading the tile at (" << tileX << ", " << tileY << "). ";
+            continue;
+          }
+
+          const uint32_t columnStart = std::max(startX, tileX);
+          const uint32_t columnEnd = std::min(startX + sizeX, tileX + tileWidth);
+          const uint32_t rowStart = std::max(firstRow, tileY);
+          const uint32_t rowEnd = std::min(endRow, tileY + tileHeight);
+          for (uint32_t row = rowStart; row < rowEnd; ++row)
+          {
+            const uint32_t outRow = topLeft ? row - startY : height - (row + 1) - startY;
+            this->PutRow<TComponent>(out + inc * (size_t{ outRow } * sizeX + columnStart - startX),
+                                     static_cast<const char *>(buf.get()) + (row - tileY) * tileRowSize,
+                                     columnStart - tileX,
+                                     columnEnd - columnStart);
+          }
+        }
+      }
+    },
+    nullptr);
+
+  if (!errors.str().empty())
+  {
+    itkExceptionMacro(<< errors.str());
+  }
+}
+
+template <typename TComponent>
+void
+TIFFImageIO::PutRow(TComponent * out, const void * row, unsigned int firstPixel, unsigned int count)
+{
+  using ComponentType = TComponent;
+
+  // The const_casts below are for the Put* methods, which do not modify
+  // their sources
+  switch (this->GetFormat())
+  {
+    case TIFFImageIO::GRAYSCALE:
+      // check inverted
+      PutGrayscale<ComponentType>(
+        out, const_cast<ComponentType *>(static_cast<const ComponentType *>(row)) + firstPixel, count, 1, 0, 0);
+      break;
+    case TIFFImageIO::RGB_:
+      PutRGB_<ComponentType>(out,
+                             const_cast<ComponentType *>(static_cast<const ComponentType *>(row)) +
+                               size_t{ firstPixel } * m_InternalImage->m_SamplesPerPixel,
+                             count,
+                             1,
+                             0,
+                             0);
+      break;
+
+    case TIFFImageIO::PALETTE_GRAYSCALE:
+      switch (m_InternalImage->m_BitsPerSample)
+      {
+        case 8:
+          PutPaletteGrayscale<ComponentType, unsigned char>(
+            out, const_cast<unsigned char *>(static_cast<const unsigned char *>(row)) + firstPixel, count, 1, 0, 0);
+          break;
+        case 16:
+          PutPaletteGrayscale<ComponentType, unsigned short>(
+            out, const_cast<unsigned short *>(static_cast<const unsigned short *>(row)) + firstPixel, count, 1, 0, 0);
+          break;
+        default:
+          itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
+                            << "-bit samples with palette.");
+      }
+      break;
+    case TIFFImageIO::PALETTE_RGB:
+      if (!this->GetIsReadAsScalarPlusPalette())
+      {
         switch (m_InternalImage->m_BitsPerSample)
         {
           case 8:
-            PutPaletteGrayscale<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+            PutPaletteRGB<ComponentType, unsigned char>(
+              out, const_cast<unsigned char *>(static_cast<const unsigned char *>(row)) + firstPixel, count, 1, 0, 0);
             break;
           case 16:
-            PutPaletteGrayscale<ComponentType, unsigned short>(
-              image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+            PutPaletteRGB<ComponentType, unsigned short>(
+              out, const_cast<unsigned short *>(static_cast<const unsigned short *>(row)) + firstPixel, count, 1, 0, 0);
             break;
           default:
             itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
                               << "-bit samples with palette.");
         }
-        break;
-      case TIFFImageIO::PALETTE_RGB:
-        if (!this->GetIsReadAsScalarPlusPalette())
-        {
-          switch (m_InternalImage->m_BitsPerSample)
-          {
-            case 8:
-              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
-              break;
-            case 16:
-              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
-              break;
-            default:
-              itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
-                                << "-bit samples with palette.");
-          }
-        }
-        else
+      }
+      else
+      {
+        switch (m_InternalImage->m_BitsPerSample)
         {
-          switch (m_InternalImage->m_BitsPerSample)
-          {
-            case 8:
-              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
-              break;
-            case 16:
-              PutPaletteScalar<ComponentType, unsigned short>(
-                image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
-              break;
-            default:
-              itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
-                                << "-bit samples with palette.");
-          }
+          case 8:
+            PutPaletteScalar<ComponentType, unsigned char>(
+              out, const_cast<unsigned char *>(static_cast<const unsigned char *>(row)) + firstPixel, count, 1, 0, 0);
+            break;
+          case 16:
+            PutPaletteScalar<ComponentType, unsigned short>(
+              out, const_cast<unsigned short *>(static_cast<const unsigned short *>(row)) + firstPixel, count, 1, 0, 0);
+            break;
+          default:
+            itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
+                              << "-bit samples with palette.");
         }
-        break;
+      }
+      break;
 
-      default:
-        itkExceptionMacro("Logic Error: Unexpected format!");
-    }
+    default:
+      itkExceptionMacro("Logic Error: Unexpected format!");
   }
-
-  _TIFFfree(buf);
 }
 
 // iso component scalar
@@ -1612,30 +2025,28 @@ TIFFImageIO::PutPaletteScalar(TType *      to,
 
 template <typename TComponent>
 void
-TIFFImageIO::RGBAImageToBuffer(void * out, const uint32_t * tempImage)
+TIFFImageIO::RGBAImageToBuffer(void * out, const uint32_t * tempImage, size_t sizeX, size_t sizeY, size_t tempWidth)
 {
   using ComponentType = TComponent;
 
-  const size_t width = m_InternalImage->m_Width;
-  const size_t height = m_InternalImage->m_Height;
-
   auto * fimage = static_cast<ComponentType *>(out);
 
-  for (size_t yy = 0; yy < height; ++yy)
+  for (size_t yy = 0; yy < sizeY; ++yy)
   {
-    for (size_t xx = 0; xx < width; ++xx)
+    const uint32_t * tempRow = tempImage + yy * tempWidth;
+    for (size_t xx = 0; xx < sizeX; ++xx)
     {
-      const auto red = static_cast<ComponentType>(TIFFGetR(*tempImage));
-      const auto green = static_cast<ComponentType>(TIFFGetG(*tempImage));
-      const auto blue = static_cast<ComponentType>(TIFFGetB(*tempImage));
-      const auto alpha = static_cast<ComponentType>(TIFFGetA(*tempImage));
+      const auto red = static_cast<ComponentType>(TIFFGetR(*tempRow));
+      const auto green = static_cast<ComponentType>(TIFFGetG(*tempRow));
+      const auto blue = static_cast<ComponentType>(TIFFGetB(*tempRow));
+      const auto alpha = static_cast<ComponentType>(TIFFGetA(*tempRow));
 
       *(fimage) = red;
       *(fimage + 1) = green;
       *(fimage + 2) = blue;
       *(fimage + 3) = alpha;
       fimage += 4;
-      ++tempImage;
+      ++tempRow;
     }
   }
 }
@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTIFFImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+template <typename TImage>
+typename TImage::PixelType
+ExpectedValue(const typename TImage::IndexType & index)
+{
+  constexpr int factors[] = { 1, 5, 11 };
+  int           value = 0;
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+  {
+    value += factors[i] * static_cast<int>(index[i]);
+  }
+  return static_cast<typename TImage::PixelType>(value);
+}
+
+template <typename TImage>
+bool
+HasExpectedValues(const TImage * image, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue<TImage>(it.GetIndex()))
+    {
+      std::cerr << "Wrong value " << static_cast<double>(it.Get()) << " at " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Write an image in streamed pieces, then read it, whole and by regions
+template <typename TImage>
+int
+StreamImage(const std::string &                 fileName,
+            const typename TImage::SizeType &   size,
+            unsigned int                        tileSize,
+            bool                                compress,
+            const typename TImage::RegionType & region)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<TImage>(it.GetIndex()));
+  }
+
+  auto writerIO = itk::TIFFImageIO::New();
+  writerIO->SetTileWidth(tileSize);
+  writerIO->SetTileHeight(tileSize);
+  if (compress)
+  {
+    writerIO->SetCompressionToDeflate();
+  }
+
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(writerIO);
+  writer->SetUseCompression(compress);
+  writer->SetNumberOfStreamDivisions(4);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Whole image
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::TIFFImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), image->GetLargestPossibleRegion());
+  ITK_TEST_EXPECT_TRUE(HasExpectedValues(reader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  // Only the requested region is read
+  auto regionReader = itk::ImageFileReader<TImage>::New();
+  regionReader->SetFileName(fileName);
+  regionReader->SetImageIO(itk::TIFFImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->UpdateOutputInformation());
+  regionReader->GetOutput()->SetRequestedRegion(region);
+  ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->Update());
+  ITK_TEST_EXPECT_EQUAL(regionReader->GetOutput()->GetBufferedRegion(), region);
+  ITK_TEST_EXPECT_TRUE(HasExpectedValues(regionReader->GetOutput(), region));
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkTIFFImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  auto imageIO = itk::TIFFImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamRead());
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+  ITK_TEST_SET_GET_VALUE(0u, imageIO->GetTileWidth());
+  ITK_TEST_SET_GET_VALUE(0u, imageIO->GetTileHeight());
+
+  using Image2DType = itk::Image<unsigned char, 2>;
+  using Image3DType = itk::Image<unsigned short, 3>;
+
+  const Image2DType::SizeType   size2D = { { 100, 70 } };
+  const Image2DType::RegionType region2D({ { 21, 17 } }, { { 45, 38 } });
+  const Image3DType::SizeType   size3D = { { 57, 41, 6 } };
+  const Image3DType::RegionType region3D({ { 5, 19, 2 } }, { { 40, 20, 3 } });
+
+  int status = EXIT_SUCCESS;
+
+  // Strips
+  status |= StreamImage<Image2DType>(directory + "/itkTIFFImageIOStreamingTest2D.tif", size2D, 0, false, region2D);
+  status |= StreamImage<Image3DType>(directory + "/itkTIFFImageIOStreamingTest3D.tif", size3D, 0, false, region3D);
+
+  // Tiles, partially covering the images
+  status |= StreamImage<Image2DType>(directory + "/itkTIFFImageIOStreamingTestTiled2D.tif", size2D, 32, false, region2D);
+  status |= StreamImage<Image3DType>(directory + "/itkTIFFImageIOStreamingTestTiled3D.tif", size3D, 16, true, region3D);
+
+  // Bands of tile rows decoded by several work units, whose handles step
+  // from one page to the next
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+  const Image3DType::SizeType   bandsSize3D = { { 70, 90, 5 } };
+  const Image3DType::RegionType bandsRegion3D({ { 3, 20, 1 } }, { { 60, 50, 3 } });
+  status |= StreamImage<Image3DType>(
+    directory + "/itkTIFFImageIOStreamingTestTiledBands3D.tif", bandsSize3D, 16, false, bandsRegion3D);
+
+  // Tiles must be multiples of 16
+  imageIO->SetTileWidth(20);
+  imageIO->SetTileHeight(16);
+  auto image = Image2DType::New();
+  image->SetRegions(size2D);
+  image->Allocate(true);
+  auto writer = itk::ImageFileWriter<Image2DType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(directory + "/itkTIFFImageIOStreamingTestInvalidTiles.tif");
+  writer->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  // Pasting is not supported
+  imageIO->SetTileWidth(0);
+  itk::ImageIORegion pasteRegion(2);
+  pasteRegion.SetSize(0, 10);
+  pasteRegion.SetSize(1, 10);
+  writer->SetIORegion(pasteRegion);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -125,6 +125,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create an optimizer of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   TInternalComputationValueType
   GoldenSectionSearch(TInternalComputationValueType a,
                       TInternalComputationValueType b,
@@ -36,6 +36,9 @@ namespace itk
  *   focus modifying the parameter sample space.  This is why we place the burden on the user to provide
  *   the parameter samples over which to optimize.
  *
+ *   The start points are independent, and several of them may be optimized concurrently, see
+ *   SetNumberOfConcurrentStarts().
+ *
  * \ingroup ITKOptimizersv4
  */
 template <typename TInternalComputationValueType>
@@ -150,6 +153,26 @@ public:
   itkSetObjectMacro(LocalOptimizer, OptimizerType);
   itkGetModifiableObjectMacro(LocalOptimizer, OptimizerType);
 
+  /** Set/Get the number of start points which are optimized concurrently.
+   * The default, one, optimizes the start points one after another with the
+   * metric and the local optimizer. With more, each concurrent start uses its
+   * own clone of the metric and of the local optimizer (see LightObject::Clone()),
+   * and the starts run as tasks of the WorkStealingThreadPool. The metric values,
+   * the parameters and the events of the optimizer are the same as with
+   * sequential starts, but observers of the local optimizer are not invoked.
+   * The starts are optimized in batches of this number, and the iteration events
+   * of a batch are invoked once it is done. StopOptimization() from an observer
+   * of the IterationEvent skips the later batches, but the remaining starts of
+   * the current batch have already been optimized.
+   *
+   * The metric must support cloning, as the image to image metrics do, and be
+   * initialized. The clones run their own threads, so the maximum number of work
+   * units of the metric should be reduced to share the processors between the
+   * starts. Local optimizers which have a scales estimator are run sequentially,
+   * as the estimator refers to the metric. */
+  itkSetClampMacro(NumberOfConcurrentStarts, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(NumberOfConcurrentStarts, SizeValueType);
+
   inline ParameterListSizeType
   GetBestParametersIndex()
   {
@@ -164,6 +187,21 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Clone the metric and the local optimizer once per concurrent start. */
+  virtual void
+  CloneForConcurrentStarts(std::vector<MetricTypePointer> & metrics, std::vector<OptimizerPointer> & optimizers);
+
+  /** Optimize the start points from the current iteration up to, excluding, endStart
+   * concurrently with the clones, and return their metric values and optimized
+   * parameters, or whether they failed. */
+  virtual void
+  OptimizeStartsConcurrently(const std::vector<MetricTypePointer> & metrics,
+                             const std::vector<OptimizerPointer> &  optimizers,
+                             SizeValueType                          endStart,
+                             MetricValuesListType &                 metricValues,
+                             ParametersListType &                   parameters,
+                             std::vector<bool> &                    failed);
+
   /* Common variables for optimization control and reporting */
   bool                                     m_Stop{ false };
   StopConditionObjectToObjectOptimizerEnum m_StopCondition;
@@ -174,6 +212,7 @@ protected:
   MeasureType                              m_MaximumMetricValue;
   ParameterListSizeType                    m_BestParametersIndex;
   OptimizerPointer                         m_LocalOptimizer;
+  SizeValueType                            m_NumberOfConcurrentStarts{ 1 };
 };
 
 /** This helps to meet backward compatibility */
@@ -19,6 +19,8 @@
 #define itkMultiStartOptimizerv4_hxx
 
 #include "itkMultiStartOptimizerv4.h"
+#include "itkWorkStealingThreadPool.h"
+#include <atomic>
 
 namespace itk
 {
@@ -46,6 +48,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::PrintSelf(std::ost
   Superclass::PrintSelf(os, indent);
   os << indent << "Stop condition:" << this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str() << std::endl;
+  os << indent << "NumberOfConcurrentStarts: " << this->m_NumberOfConcurrentStarts << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -160,21 +163,69 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::ResumeOptimization
   this->m_StopConditionDescription << this->GetNameOfClass() << ": ";
   this->InvokeEvent(StartEvent());
 
+  /* Optimize the remaining start points concurrently, one batch of a start per clone at a time, and
+   * report them in order as below. Stopping the optimization from an observer skips the later batches. */
+  bool concurrent = this->m_NumberOfConcurrentStarts > 1 && this->m_NumberOfIterations > this->m_CurrentIteration + 1;
+  if (this->m_LocalOptimizer && this->m_LocalOptimizer->GetScalesEstimator() != nullptr)
+  {
+    concurrent = false;
+  }
+  std::vector<MetricTypePointer> concurrentMetrics;
+  std::vector<OptimizerPointer>  concurrentOptimizers;
+  SizeValueType                  batchBegin = this->m_CurrentIteration;
+  SizeValueType                  batchEnd = this->m_CurrentIteration;
+  MetricValuesListType           concurrentMetricValues;
+  ParametersListType             concurrentParameters;
+  std::vector<bool>              concurrentStartFailed;
+  if (concurrent)
+  {
+    this->CloneForConcurrentStarts(concurrentMetrics, concurrentOptimizers);
+  }
+
   this->m_Stop = false;
   while (!this->m_Stop)
   {
     /* Compute metric value */
     try
     {
-      this->m_Metric->SetParameters(this->m_ParametersList[this->m_CurrentIteration]);
-      if (this->m_LocalOptimizer)
+      if (concurrent)
       {
-        this->m_LocalOptimizer->SetMetric(this->m_Metric);
-        this->m_LocalOptimizer->StartOptimization();
-        this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        if (this->m_CurrentIteration >= batchEnd)
+        {
+          batchBegin = this->m_CurrentIteration;
+          batchEnd = std::min(batchBegin + static_cast<SizeValueType>(concurrentMetrics.size()),
+                              this->m_NumberOfIterations);
+          this->OptimizeStartsConcurrently(concurrentMetrics,
+                                           concurrentOptimizers,
+                                           batchEnd,
+                                           concurrentMetricValues,
+                                           concurrentParameters,
+                                           concurrentStartFailed);
+        }
+        const SizeValueType start = this->m_CurrentIteration - batchBegin;
+        if (concurrentStartFailed[start])
+        {
+          itkExceptionMacro("The optimization failed.");
+        }
+        if (this->m_LocalOptimizer)
+        {
+          this->m_ParametersList[this->m_CurrentIteration] = concurrentParameters[start];
+        }
+        this->m_CurrentMetricValue = concurrentMetricValues[start];
+        this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
+      }
+      else
+      {
+        this->m_Metric->SetParameters(this->m_ParametersList[this->m_CurrentIteration]);
+        if (this->m_LocalOptimizer)
+        {
+          this->m_LocalOptimizer->SetMetric(this->m_Metric);
+          this->m_LocalOptimizer->StartOptimization();
+          this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        }
+        this->m_CurrentMetricValue = this->m_Metric->GetValue();
+        this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
       }
-      this->m_CurrentMetricValue = this->m_Metric->GetValue();
-      this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
     }
     catch (ExceptionObject &)
     {
@@ -214,6 +265,100 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::ResumeOptimization
   } // while (!m_Stop)
 }
 
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>::CloneForConcurrentStarts(
+  std::vector<MetricTypePointer> & metrics,
+  std::vector<OptimizerPointer> &  optimizers)
+{
+  /* One clone of the metric and of the local optimizer per concurrent start. The clones
+   * share the images and filters of the metric, so they are initialized one at a time. */
+  const SizeValueType numberOfContexts =
+    std::min(this->m_NumberOfConcurrentStarts, this->m_NumberOfIterations - this->m_CurrentIteration);
+  metrics.assign(numberOfContexts, nullptr);
+  optimizers.assign(numberOfContexts, nullptr);
+  for (SizeValueType context = 0; context < numberOfContexts; ++context)
+  {
+    metrics[context] = dynamic_cast<MetricType *>(this->m_Metric->Clone().GetPointer());
+    if (metrics[context].IsNull())
+    {
+      itkExceptionMacro("The metric " << this->m_Metric->GetNameOfClass() << " could not be cloned.");
+    }
+    metrics[context]->Initialize();
+    if (this->m_LocalOptimizer)
+    {
+      optimizers[context] = dynamic_cast<OptimizerType *>(this->m_LocalOptimizer->Clone().GetPointer());
+      if (optimizers[context].IsNull())
+      {
+        itkExceptionMacro("The local optimizer " << this->m_LocalOptimizer->GetNameOfClass()
+                                                 << " could not be cloned.");
+      }
+      optimizers[context]->SetMetric(metrics[context]);
+    }
+  }
+}
+
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>::OptimizeStartsConcurrently(
+  const std::vector<MetricTypePointer> & metrics,
+  const std::vector<OptimizerPointer> &  optimizers,
+  SizeValueType                          endStart,
+  MetricValuesListType &                 metricValues,
+  ParametersListType &                   parameters,
+  std::vector<bool> &                    failed)
+{
+  const SizeValueType firstStart = this->m_CurrentIteration;
+  const SizeValueType numberOfStarts = endStart - firstStart;
+  const SizeValueType numberOfContexts = std::min(static_cast<SizeValueType>(metrics.size()), numberOfStarts);
+
+  /* Each task takes the next start point until there are none left, so that slow starts
+   * do not hold up the others. A failed start is recorded, as in the sequential loop. */
+  metricValues.assign(numberOfStarts, NumericTraits<MeasureType>::max());
+  parameters.assign(numberOfStarts, ParametersType());
+  std::vector<unsigned char> succeeded(numberOfStarts, 0);
+  std::atomic<SizeValueType> nextStart{ firstStart };
+
+  const auto optimizeStarts = [&](SizeValueType context) {
+    MetricType *    metric = metrics[context];
+    OptimizerType * optimizer = optimizers[context];
+    for (SizeValueType start = nextStart++; start < endStart; start = nextStart++)
+    {
+      try
+      {
+        metric->SetParameters(this->m_ParametersList[start]);
+        if (optimizer)
+        {
+          optimizer->StartOptimization();
+          parameters[start - firstStart] = metric->GetParameters();
+        }
+        metricValues[start - firstStart] = metric->GetValue();
+        succeeded[start - firstStart] = 1;
+      }
+      catch (ExceptionObject &)
+      {
+        // Reported in the order of the start points by ResumeOptimization()
+      }
+    }
+  };
+
+  const WorkStealingThreadPool::Pointer pool = WorkStealingThreadPool::GetInstance();
+  WorkStealingThreadPool::TaskGroup     group;
+  for (SizeValueType context = 0; context < numberOfContexts; ++context)
+  {
+    pool->AddWork(group, [&optimizeStarts, context]() { optimizeStarts(context); });
+  }
+  pool->Wait(group);
+
+  failed.resize(numberOfStarts);
+  for (SizeValueType start = 0; start < numberOfStarts; ++start)
+  {
+    failed[start] = !succeeded[start];
+  }
+}
+
 } // namespace itk
 
 #endif
@@ -330,6 +330,11 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings. The clone owns a clone
+   * of the moving transform, and shares the fixed transform. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   /** Verify that virtual domain and displacement field are the same size
    * and in the same physical space. */
   virtual void
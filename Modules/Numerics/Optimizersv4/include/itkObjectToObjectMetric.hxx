@@ -582,6 +582,33 @@ ObjectToObjectMetric<TFixedDimension, TMovingDimension, TVirtualImage, TParamete
   return true;
 }
 
+template <unsigned int TFixedDimension,
+          unsigned int TMovingDimension,
+          typename TVirtualImage,
+          typename TParametersValueType>
+typename LightObject::Pointer
+ObjectToObjectMetric<TFixedDimension, TMovingDimension, TVirtualImage, TParametersValueType>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetGradientSource(this->GetGradientSource());
+  rval->SetFixedTransform(this->m_FixedTransform);
+  if (this->m_MovingTransform)
+  {
+    rval->SetMovingTransform(this->m_MovingTransform->Clone());
+  }
+  if (this->m_UserHasSetVirtualDomain)
+  {
+    rval->SetVirtualDomainFromImage(this->m_VirtualImage);
+  }
+  return loPtr;
+}
+
 template <unsigned int TFixedDimension,
           unsigned int TMovingDimension,
           typename TVirtualImage,
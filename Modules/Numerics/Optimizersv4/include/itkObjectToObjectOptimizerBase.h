@@ -206,6 +206,7 @@ public:
    * \sa SetDoEstimateScales()
    */
   itkSetObjectMacro(ScalesEstimator, ScalesEstimatorType);
+  itkGetConstObjectMacro(ScalesEstimator, ScalesEstimatorType);
 
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
@@ -301,6 +302,11 @@ protected:
 
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Create an optimizer of the same type and settings. The clone shares the
+   * scales estimator, and has no metric. */
+  typename LightObject::Pointer
+  InternalClone() const override;
 };
 
 /** This helps to meet backward compatibility */
@@ -200,6 +200,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create an optimizer of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
 private:
   /** Threader for Newton step estimation. */
   typename DomainThreader<ThreadedIndexedContainerPartitioner, Self>::Pointer m_EstimateNewtonStepThreader;
@@ -166,6 +166,12 @@ public:
   /** the radius of the central region for sampling. */
   itkSetMacro(CentralRegionRadius, IndexValueType);
 
+  /** Set/Get the number of work units used to compute the shifts or the
+   * Jacobians of the sample points. Defaults to the global default number
+   * of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
   /** Estimate parameter scales */
   void
   EstimateScales(ScalesType & scales) override = 0;
@@ -197,6 +203,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create an estimator of the same type and settings, without a metric. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   /** Check the metric and the transforms. */
   bool
   CheckAndSetInputs();
@@ -336,6 +346,8 @@ private:
   // sampling strategy
   SamplingStrategyType m_SamplingStrategy;
 
+  ThreadIdType m_NumberOfWorkUnits;
+
 }; // class RegistrationParameterScalesEstimator
 } // namespace itk
 
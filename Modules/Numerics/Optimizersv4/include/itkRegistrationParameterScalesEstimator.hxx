@@ -23,6 +23,7 @@
 #include "itkCompositeTransform.h"
 #include "itkPointSet.h"
 #include "itkObjectToObjectMetric.h"
+#include "itkMultiThreaderBase.h"
 
 namespace itk
 {
@@ -42,6 +43,8 @@ RegistrationParameterScalesEstimator<TMetric>::RegistrationParameterScalesEstima
   // the default radius of the central region for sampling
   this->m_CentralRegionRadius = 5;
 
+  this->m_NumberOfWorkUnits = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
   // the metric object must be set before EstimateScales()
 }
 
@@ -692,6 +695,30 @@ RegistrationParameterScalesEstimator<TMetric>::SampleVirtualDomainFully()
   this->SampleVirtualDomainWithRegion(region);
 }
 
+/**
+ * Create an estimator of the same type and settings.
+ */
+template <typename TMetric>
+typename LightObject::Pointer
+RegistrationParameterScalesEstimator<TMetric>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_NumberOfRandomSamples = this->m_NumberOfRandomSamples;
+  rval->m_CentralRegionRadius = this->m_CentralRegionRadius;
+  rval->m_VirtualDomainPointSet = this->m_VirtualDomainPointSet;
+  rval->m_TransformForward = this->m_TransformForward;
+  rval->m_SamplingStrategy = this->m_SamplingStrategy;
+  rval->m_NumberOfWorkUnits = this->m_NumberOfWorkUnits;
+
+  return loPtr;
+}
+
 /**
  * Print the information about this class.
  */
@@ -709,6 +736,7 @@ RegistrationParameterScalesEstimator<TMetric>::PrintSelf(std::ostream & os, Inde
 
   os << indent << "m_TransformForward = " << this->m_TransformForward << std::endl;
   os << indent << "m_SamplingStrategy = " << this->m_SamplingStrategy << std::endl;
+  os << indent << "m_NumberOfWorkUnits = " << this->m_NumberOfWorkUnits << std::endl;
 
   os << indent << "m_VirtualDomainPointSet = " << this->m_VirtualDomainPointSet.GetPointer() << std::endl;
 }
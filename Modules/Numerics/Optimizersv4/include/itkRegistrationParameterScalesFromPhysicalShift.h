@@ -20,6 +20,8 @@
 
 #include "itkRegistrationParameterScalesFromShiftBase.h"
 
+#include <functional>
+
 namespace itk
 {
 
@@ -74,11 +76,43 @@ protected:
   void
   ComputeSampleShifts(const ParametersType & deltaParameters, ScalesType & sampleShifts) override;
 
+  /** A B-spline transform is linear in its parameters, so the shift of a
+   * sample point produced by a parameter is the variation times the norm of
+   * the Jacobian column of the parameter at this point. For such a transform
+   * the shifts of all the parameters are computed from the Jacobians of the
+   * sample points, concurrently, rather than by varying each parameter and
+   * transforming all the sample points in turn. Only the columns of the
+   * parameters supporting a point are nonzero, so the B-spline weights of
+   * each point are used instead of its full Jacobian when the spline order
+   * is at most 3. */
+  void
+  ComputeParameterShifts(OffsetValueType offset, ScalesType & parameterShifts) override;
+
 private:
   template <typename TTransform>
   void
   ComputeSampleShiftsInternal(const ParametersType & deltaParameters, ScalesType & sampleShifts);
 
+  template <typename TTransform>
+  void
+  ComputeParameterShiftsFromJacobians(const TTransform * transform, ScalesType & parameterShifts);
+
+  /** Update the maximum squared norms of the Jacobian columns with the
+   * B-spline weights of a range of sample points. Only the parameters of
+   * the support of each point are visited. Returns false if the transform
+   * is not a B-spline transform of order VSplineOrder. */
+  template <unsigned int VSplineOrder, typename TTransform>
+  bool
+  UpdateSquaredNormsFromBSplineWeights(const TTransform *       transform,
+                                       SizeValueType            firstSample,
+                                       SizeValueType            lastSample,
+                                       std::vector<FloatType> & squaredNorms) const;
+
+  /** Call a function with the index of each sample point, concurrently when
+   * there are enough of them. */
+  void
+  ForEachSamplePoint(const std::function<void(SizeValueType)> & function) const;
+
 }; // class RegistrationParameterScalesFromPhysicalShift
 
 } // namespace itk
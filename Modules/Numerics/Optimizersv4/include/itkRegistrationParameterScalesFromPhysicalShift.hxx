@@ -19,6 +19,7 @@
 #define itkRegistrationParameterScalesFromPhysicalShift_hxx
 
 #include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkBSplineBaseTransform.h"
 
 namespace itk
 {
@@ -54,37 +55,185 @@ RegistrationParameterScalesFromPhysicalShift<TMetric>::ComputeSampleShiftsIntern
 
   const auto numSamples = static_cast<const SizeValueType>(this->m_SamplePoints.size());
 
-  VirtualPointType    point;
-  TransformOutputType newMappedVoxel;
-
   // store the old mapped indices to reduce calls to Transform::SetParameters()
   std::vector<TransformOutputType> oldMappedVoxels(numSamples);
   sampleShifts.SetSize(numSamples);
 
   // compute the indices mapped by the old transform
-  for (SizeValueType c = 0; c < numSamples; ++c)
-  {
-    point = this->m_SamplePoints[c];
-    this->template TransformPoint<TransformOutputType>(point, oldMappedVoxels[c]);
-  }
+  this->ForEachSamplePoint([this, &oldMappedVoxels](SizeValueType c) {
+    this->template TransformPoint<TransformOutputType>(this->m_SamplePoints[c], oldMappedVoxels[c]);
+  });
 
   // Apply the delta parameters to the transform
   this->UpdateTransformParameters(deltaParameters);
 
   // compute the indices mapped by the new transform
-  for (SizeValueType c = 0; c < numSamples; ++c)
-  {
-    point = this->m_SamplePoints[c];
-    this->template TransformPoint<TransformOutputType>(point, newMappedVoxel);
+  this->ForEachSamplePoint([this, &oldMappedVoxels, &sampleShifts](SizeValueType c) {
+    TransformOutputType newMappedVoxel;
+    this->template TransformPoint<TransformOutputType>(this->m_SamplePoints[c], newMappedVoxel);
 
     // find the local shift for each sample point
     sampleShifts[c] = newMappedVoxel.EuclideanDistanceTo(oldMappedVoxels[c]);
-  }
+  });
 
   // restore the parameters in the transform
   transform->SetParameters(oldParameters);
 }
 
+template <typename TMetric>
+void
+RegistrationParameterScalesFromPhysicalShift<TMetric>::ComputeParameterShifts(OffsetValueType offset,
+                                                                              ScalesType &    parameterShifts)
+{
+  // The shifts of a composite transform are not linear in the parameters of its inner transforms
+  const auto * transform = this->GetTransform();
+  if (transform->GetTransformCategory() != MovingTransformType::TransformCategoryEnum::BSpline || offset != 0 ||
+      parameterShifts.Size() != transform->GetNumberOfParameters())
+  {
+    Superclass::ComputeParameterShifts(offset, parameterShifts);
+    return;
+  }
+
+  if (this->GetTransformForward())
+  {
+    this->ComputeParameterShiftsFromJacobians(this->m_Metric->GetMovingTransform(), parameterShifts);
+  }
+  else
+  {
+    this->ComputeParameterShiftsFromJacobians(this->m_Metric->GetFixedTransform(), parameterShifts);
+  }
+}
+
+template <typename TMetric>
+template <typename TTransform>
+void
+RegistrationParameterScalesFromPhysicalShift<TMetric>::ComputeParameterShiftsFromJacobians(
+  const TTransform * transform,
+  ScalesType &       parameterShifts)
+{
+  const SizeValueType numberOfParameters = parameterShifts.Size();
+  const auto          numberOfSamples = static_cast<SizeValueType>(this->m_SamplePoints.size());
+  const FloatType     variation = this->GetSmallParameterVariation();
+
+  // Each work unit keeps the maximum squared norms of the Jacobian columns over its range of
+  // sample points. Only the columns of the parameters supporting a point are nonzero.
+  const SizeValueType numberOfRanges =
+    std::max(std::min(static_cast<SizeValueType>(this->GetNumberOfWorkUnits()), numberOfSamples), SizeValueType{ 1 });
+  std::vector<std::vector<FloatType>> maximumSquaredNorms(numberOfRanges);
+
+  const auto computeRange = [&](SizeValueType range) {
+    std::vector<FloatType> & squaredNorms = maximumSquaredNorms[range];
+    squaredNorms.assign(numberOfParameters, NumericTraits<FloatType>::ZeroValue());
+
+    const SizeValueType firstSample = range * numberOfSamples / numberOfRanges;
+    const SizeValueType lastSample = (range + 1) * numberOfSamples / numberOfRanges;
+    if (this->template UpdateSquaredNormsFromBSplineWeights<3>(transform, firstSample, lastSample, squaredNorms) ||
+        this->template UpdateSquaredNormsFromBSplineWeights<2>(transform, firstSample, lastSample, squaredNorms) ||
+        this->template UpdateSquaredNormsFromBSplineWeights<1>(transform, firstSample, lastSample, squaredNorms))
+    {
+      return;
+    }
+
+    typename TTransform::JacobianType jacobian;
+    for (SizeValueType c = firstSample; c < lastSample; ++c)
+    {
+      transform->ComputeJacobianWithRespectToParameters(this->m_SamplePoints[c], jacobian);
+      for (SizeValueType p = 0; p < numberOfParameters; ++p)
+      {
+        FloatType squaredNorm = NumericTraits<FloatType>::ZeroValue();
+        for (unsigned int d = 0; d < jacobian.rows(); ++d)
+        {
+          squaredNorm += jacobian(d, p) * jacobian(d, p);
+        }
+        squaredNorms[p] = std::max(squaredNorms[p], squaredNorm);
+      }
+    }
+  };
+
+  if (numberOfRanges > 1)
+  {
+    MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+    multiThreader->SetMaximumNumberOfThreads(this->GetNumberOfWorkUnits());
+    multiThreader->ParallelizeArray(0, numberOfRanges, computeRange, nullptr);
+  }
+  else
+  {
+    computeRange(0);
+  }
+
+  for (SizeValueType p = 0; p < numberOfParameters; ++p)
+  {
+    FloatType squaredNorm = NumericTraits<FloatType>::ZeroValue();
+    for (const auto & squaredNorms : maximumSquaredNorms)
+    {
+      squaredNorm = std::max(squaredNorm, squaredNorms[p]);
+    }
+    parameterShifts[p] = variation * std::sqrt(squaredNorm);
+  }
+}
+
+template <typename TMetric>
+template <unsigned int VSplineOrder, typename TTransform>
+bool
+RegistrationParameterScalesFromPhysicalShift<TMetric>::UpdateSquaredNormsFromBSplineWeights(
+  const TTransform *       transform,
+  SizeValueType            firstSample,
+  SizeValueType            lastSample,
+  std::vector<FloatType> & squaredNorms) const
+{
+  using BSplineTransformType =
+    BSplineBaseTransform<typename TTransform::ParametersValueType, TTransform::InputSpaceDimension, VSplineOrder>;
+  const auto * bsplineTransform = dynamic_cast<const BSplineTransformType *>(transform);
+  if (bsplineTransform == nullptr)
+  {
+    return false;
+  }
+
+  // The Jacobian column of the parameter of support index k in dimension d
+  // has the weight of k on row d, and zeros elsewhere. Points outside of the
+  // valid region get zero weights.
+  const SizeValueType numberOfWeights = bsplineTransform->GetNumberOfWeights();
+  const SizeValueType parametersPerDimension = bsplineTransform->GetNumberOfParametersPerDimension();
+
+  typename BSplineTransformType::WeightsType             weights(numberOfWeights);
+  typename BSplineTransformType::ParameterIndexArrayType indices(numberOfWeights);
+  for (SizeValueType c = firstSample; c < lastSample; ++c)
+  {
+    bsplineTransform->ComputeJacobianFromBSplineWeightsWithRespectToPosition(this->m_SamplePoints[c], weights, indices);
+    for (SizeValueType k = 0; k < numberOfWeights; ++k)
+    {
+      const FloatType squaredNorm = static_cast<FloatType>(weights[k]) * static_cast<FloatType>(weights[k]);
+      for (unsigned int d = 0; d < TTransform::InputSpaceDimension; ++d)
+      {
+        FloatType & maximum = squaredNorms[indices[k] + d * parametersPerDimension];
+        maximum = std::max(maximum, squaredNorm);
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TMetric>
+void
+RegistrationParameterScalesFromPhysicalShift<TMetric>::ForEachSamplePoint(
+  const std::function<void(SizeValueType)> & function) const
+{
+  const auto numberOfSamples = static_cast<SizeValueType>(this->m_SamplePoints.size());
+  if (this->GetNumberOfWorkUnits() > 1 && numberOfSamples >= Superclass::SizeOfSmallDomain)
+  {
+    MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+    multiThreader->SetMaximumNumberOfThreads(this->GetNumberOfWorkUnits());
+    multiThreader->ParallelizeArray(0, numberOfSamples, function, nullptr);
+  }
+  else
+  {
+    for (SizeValueType c = 0; c < numberOfSamples; ++c)
+    {
+      function(c);
+    }
+  }
+}
+
 /** Print the information about this class */
 template <typename TMetric>
 void
@@ -94,6 +94,17 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create an estimator of the same type and settings, without a metric. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
+  /** Compute the maximum shift in voxels produced by a small variation of
+   * each of the local parameters, from the parameter at offset on. The size
+   * of parameterShifts is the number of local parameters. By default, each
+   * parameter is varied in turn. */
+  virtual void
+  ComputeParameterShifts(OffsetValueType offset, ScalesType & parameterShifts);
+
   /** Compute the shift in voxels when deltaParameters is applied onto the
    * current parameters. */
   virtual FloatType
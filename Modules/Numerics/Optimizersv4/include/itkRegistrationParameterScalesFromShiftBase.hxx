@@ -38,15 +38,10 @@ RegistrationParameterScalesFromShiftBase<TMetric>::EstimateScales(ScalesType & p
   this->SetScalesSamplingStrategy();
   this->SampleVirtualDomain();
 
-  const SizeValueType numAllPara = this->GetTransform()->GetNumberOfParameters();
   const SizeValueType numLocalPara = this->GetNumberOfLocalParameters();
 
   parameterScales.SetSize(numLocalPara);
 
-  FloatType maxShift;
-
-  ParametersType deltaParameters(numAllPara);
-
   // minNonZeroShift: the minimum non-zero shift.
   FloatType minNonZeroShift = NumericTraits<FloatType>::max();
 
@@ -70,19 +65,12 @@ RegistrationParameterScalesFromShiftBase<TMetric>::EstimateScales(ScalesType & p
   }
 
   // compute voxel shift generated from each transform parameter
+  this->ComputeParameterShifts(offset, parameterScales);
   for (SizeValueType i = 0; i < numLocalPara; ++i)
   {
-    // For local support, we need to refill deltaParameters with zeros at each loop
-    // since smoothing may change the values around the local voxel.
-    deltaParameters.Fill(NumericTraits<typename ParametersType::ValueType>::ZeroValue());
-    deltaParameters[offset + i] = this->m_SmallParameterVariation;
-
-    maxShift = this->ComputeMaximumVoxelShift(deltaParameters);
-
-    parameterScales[i] = maxShift;
-    if (maxShift > NumericTraits<FloatType>::epsilon() && maxShift < minNonZeroShift)
+    if (parameterScales[i] > NumericTraits<FloatType>::epsilon() && parameterScales[i] < minNonZeroShift)
     {
-      minNonZeroShift = maxShift;
+      minNonZeroShift = parameterScales[i];
     }
   }
 
@@ -197,6 +185,30 @@ RegistrationParameterScalesFromShiftBase<TMetric>::EstimateLocalStepScales(const
   }
 }
 
+/**
+ * Compute the maximum shift produced by a small variation of each local parameter
+ */
+template <typename TMetric>
+void
+RegistrationParameterScalesFromShiftBase<TMetric>::ComputeParameterShifts(OffsetValueType offset,
+                                                                           ScalesType &    parameterShifts)
+{
+  const SizeValueType numAllPara = this->GetTransform()->GetNumberOfParameters();
+  const SizeValueType numLocalPara = parameterShifts.Size();
+
+  ParametersType deltaParameters(numAllPara);
+
+  for (SizeValueType i = 0; i < numLocalPara; ++i)
+  {
+    // For local support, we need to refill deltaParameters with zeros at each loop
+    // since smoothing may change the values around the local voxel.
+    deltaParameters.Fill(NumericTraits<typename ParametersType::ValueType>::ZeroValue());
+    deltaParameters[offset + i] = this->m_SmallParameterVariation;
+
+    parameterShifts[i] = this->ComputeMaximumVoxelShift(deltaParameters);
+  }
+}
+
 /**
  * Compute the maximum shift when a transform is changed with deltaParameters
  */
@@ -220,6 +232,23 @@ RegistrationParameterScalesFromShiftBase<TMetric>::ComputeMaximumVoxelShift(cons
   return maxShift;
 }
 
+/** Create an estimator of the same type and settings */
+template <typename TMetric>
+typename LightObject::Pointer
+RegistrationParameterScalesFromShiftBase<TMetric>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_SmallParameterVariation = this->m_SmallParameterVariation;
+
+  return loPtr;
+}
+
 /** Print the information about this class */
 template <typename TMetric>
 void
@@ -136,6 +136,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create an optimizer of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
 
 private:
   TInternalComputationValueType m_RelaxationFactor;
@@ -268,6 +268,26 @@ RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>::EstimateLe
     this->m_LearningRate *= gradientMagnitude;
   }
 }
+
+template <typename TInternalComputationValueType>
+typename LightObject::Pointer
+RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_RelaxationFactor = this->m_RelaxationFactor;
+  rval->m_MinimumStepLength = this->m_MinimumStepLength;
+  rval->m_GradientMagnitudeTolerance = this->m_GradientMagnitudeTolerance;
+  rval->m_CurrentLearningRateRelaxation = this->m_CurrentLearningRateRelaxation;
+
+  return loPtr;
+}
+
 template <typename TInternalComputationValueType>
 void
 RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>::PrintSelf(std::ostream & os, Indent indent) const
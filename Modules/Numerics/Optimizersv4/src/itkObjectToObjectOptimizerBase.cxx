@@ -84,6 +84,30 @@ ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::PrintSelf(st
   os << indent << "DoEstimateScales: " << this->m_DoEstimateScales << std::endl;
 }
 
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+typename LightObject::Pointer
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_NumberOfWorkUnits = this->m_NumberOfWorkUnits;
+  rval->m_NumberOfIterations = this->m_NumberOfIterations;
+  rval->m_Scales = this->m_Scales;
+  rval->m_ScalesAreIdentity = this->m_ScalesAreIdentity;
+  rval->m_Weights = this->m_Weights;
+  rval->m_WeightsAreIdentity = this->m_WeightsAreIdentity;
+  rval->m_ScalesEstimator = this->m_ScalesEstimator;
+  rval->m_DoEstimateScales = this->m_DoEstimateScales;
+
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 template <typename TInternalComputationValueType>
 void
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkBSplineTransform.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/* Compare the shifts of the parameters of a B-spline transform computed
+ * from the transform Jacobians, with one and several work units, to the
+ * shifts computed by varying each parameter in turn.
+ */
+
+namespace
+{
+
+template <typename TMetric>
+class PhysicalShiftWithReferenceEstimator : public itk::RegistrationParameterScalesFromPhysicalShift<TMetric>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PhysicalShiftWithReferenceEstimator);
+
+  using Self = PhysicalShiftWithReferenceEstimator;
+  using Superclass = itk::RegistrationParameterScalesFromPhysicalShift<TMetric>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using ScalesType = typename Superclass::ScalesType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PhysicalShiftWithReferenceEstimator, RegistrationParameterScalesFromPhysicalShift);
+
+  /** Vary each parameter in turn, as the shift base class does */
+  bool m_UseReference{ false };
+
+  ScalesType m_ParameterShifts;
+
+protected:
+  PhysicalShiftWithReferenceEstimator() = default;
+
+  void
+  ComputeParameterShifts(itk::OffsetValueType offset, ScalesType & parameterShifts) override
+  {
+    if (this->m_UseReference)
+    {
+      Superclass::Superclass::ComputeParameterShifts(offset, parameterShifts);
+    }
+    else
+    {
+      Superclass::ComputeParameterShifts(offset, parameterShifts);
+    }
+    this->m_ParameterShifts = parameterShifts;
+  }
+};
+
+} // namespace
+
+int
+itkRegistrationParameterScalesFromPhysicalShiftBSplineTest(int, char *[])
+{
+  constexpr unsigned int Dimension = 2;
+  using ImageType = itk::Image<float, Dimension>;
+  using TransformType = itk::BSplineTransform<double, Dimension, 3>;
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using EstimatorType = PhysicalShiftWithReferenceEstimator<MetricType>;
+  using ScalesType = EstimatorType::ScalesType;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 100, 90 } });
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 1.0;
+  image->SetSpacing(spacing);
+  image->Allocate(true);
+
+  // A transform with parameters which do not all vanish
+  auto transform = TransformType::New();
+  transform->SetTransformDomainOrigin(image->GetOrigin());
+  TransformType::PhysicalDimensionsType physicalDimensions;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    physicalDimensions[d] = image->GetSpacing()[d] * (image->GetLargestPossibleRegion().GetSize()[d] - 1);
+  }
+  transform->SetTransformDomainPhysicalDimensions(physicalDimensions);
+  transform->SetTransformDomainMeshSize(TransformType::MeshSizeType{ { 12, 10 } });
+  transform->SetTransformDomainDirection(image->GetDirection());
+  TransformType::ParametersType parameters(transform->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters.Size(); ++p)
+  {
+    parameters[p] = 0.3 * std::sin(0.37 * p);
+  }
+  transform->SetParameters(parameters);
+
+  auto metric = MetricType::New();
+  metric->SetFixedImage(image);
+  metric->SetMovingImage(image);
+  metric->SetMovingTransform(transform);
+  metric->Initialize();
+
+  auto estimator = EstimatorType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(
+    estimator, PhysicalShiftWithReferenceEstimator, RegistrationParameterScalesFromPhysicalShift);
+  estimator->SetMetric(metric);
+  estimator->SetCentralRegionRadius(10);
+  estimator->SetNumberOfWorkUnits(0);
+  ITK_TEST_SET_GET_VALUE(1, estimator->GetNumberOfWorkUnits());
+
+  // Reference shifts and scales, from one parameter at a time
+  estimator->m_UseReference = true;
+  ScalesType     referenceScales;
+  itk::TimeProbe referenceProbe;
+  referenceProbe.Start();
+  estimator->EstimateScales(referenceScales);
+  referenceProbe.Stop();
+  const ScalesType referenceShifts = estimator->m_ParameterShifts;
+  std::cout << "Parameters: " << referenceShifts.Size() << ", reference: " << referenceProbe.GetTotal() << " s"
+            << std::endl;
+
+  unsigned int numberOfShiftedParameters = 0;
+  for (unsigned int p = 0; p < referenceShifts.Size(); ++p)
+  {
+    numberOfShiftedParameters += referenceShifts[p] > 0.0 ? 1 : 0;
+  }
+  std::cout << "Parameters which shift the central region: " << numberOfShiftedParameters << std::endl;
+  if (numberOfShiftedParameters == 0 || numberOfShiftedParameters == referenceShifts.Size())
+  {
+    std::cerr << "The central region should be supported by some of the parameters only" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  estimator->m_UseReference = false;
+  for (itk::ThreadIdType numberOfWorkUnits : { 1, 3 })
+  {
+    estimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ScalesType     scales;
+    itk::TimeProbe probe;
+    probe.Start();
+    estimator->EstimateScales(scales);
+    probe.Stop();
+    std::cout << numberOfWorkUnits << " work units: " << probe.GetTotal() << " s" << std::endl;
+
+    for (unsigned int p = 0; p < referenceShifts.Size(); ++p)
+    {
+      if (std::abs(estimator->m_ParameterShifts[p] - referenceShifts[p]) > 1e-9 * referenceShifts[p] + 1e-12)
+      {
+        std::cerr << numberOfWorkUnits << " work units: the shift " << estimator->m_ParameterShifts[p]
+                  << " of parameter " << p << " differs from " << referenceShifts[p] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    // The reference shifts are differences of transformed points, accurate to about 1e-12
+    ITK_TEST_EXPECT_EQUAL(scales.Size(), referenceScales.Size());
+    if (std::abs(scales[0] - referenceScales[0]) > 1e-9 * referenceScales[0] + 1e-12)
+    {
+      std::cerr << numberOfWorkUnits << " work units: the scales " << scales[0] << " differ from "
+                << referenceScales[0] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The step scale of a B-spline transform goes through the sample shifts
+  TransformType::ParametersType step(transform->GetNumberOfParameters());
+  step.Fill(0.1);
+  estimator->SetNumberOfWorkUnits(1);
+  const double referenceStepScale = estimator->EstimateStepScale(step);
+  estimator->SetNumberOfWorkUnits(3);
+  const double stepScale = estimator->EstimateStepScale(step);
+  ITK_TEST_EXPECT_TRUE(referenceStepScale > 0.0);
+  ITK_TEST_EXPECT_TRUE(std::abs(stepScale - referenceStepScale) <= 1e-12 * referenceStepScale);
+  ITK_TEST_EXPECT_TRUE(transform->GetParameters() == parameters);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
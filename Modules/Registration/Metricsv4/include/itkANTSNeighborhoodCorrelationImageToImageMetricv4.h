@@ -196,6 +196,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
 private:
   // Radius of the neighborhood window centered at each pixel
   RadiusType m_Radius;
@@ -103,6 +103,20 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId) override;
 
+  /** Process a scan line or a block of sampled points, evaluating the moving
+   * image at all the points at once. */
+  void
+  ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                       const std::vector<VirtualPointType> & virtualPoints,
+                       const SizeValueType                   firstSampleIdentifier,
+                       const ThreadIdType                    threadId) override;
+
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
+
   /** This function computes the local voxel-wise contribution of
    *  the metric to the global integral of the metric/derivative.
    */
@@ -120,6 +134,18 @@ protected:
                const ThreadIdType              threadId) const override;
 
 private:
+  /** Compute the moving image gradient if needed, and add the contribution of
+   * a point valid in both spaces with \c ProcessPoint. */
+  bool
+  AccumulateMappedPoint(const VirtualIndexType &       virtualIndex,
+                        const VirtualPointType &       virtualPoint,
+                        const FixedImagePointType &    mappedFixedPoint,
+                        const FixedImagePixelType &    mappedFixedPixelValue,
+                        const FixedImageGradientType & mappedFixedImageGradient,
+                        const MovingImagePointType &   mappedMovingPoint,
+                        const MovingImagePixelType &   mappedMovingPixelValue,
+                        const ThreadIdType             threadId);
+
   /*
    * the per-thread memory for computing the correlation and its derivatives
    * \bar f (CorrelationImageToImageMetricv4::m_AverageFix ) and
@@ -185,14 +185,12 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
                                            const VirtualPointType & virtualPoint,
                                            const ThreadIdType       threadId)
 {
-  FixedImagePointType     mappedFixedPoint;
-  FixedImagePixelType     mappedFixedPixelValue;
-  FixedImageGradientType  mappedFixedImageGradient;
-  MovingImagePointType    mappedMovingPoint;
-  MovingImagePixelType    mappedMovingPixelValue;
-  MovingImageGradientType mappedMovingImageGradient;
-  bool                    pointIsValid = false;
-  MeasureType             metricValueResult;
+  FixedImagePointType    mappedFixedPoint;
+  FixedImagePixelType    mappedFixedPixelValue;
+  FixedImageGradientType mappedFixedImageGradient;
+  MovingImagePointType   mappedMovingPoint;
+  MovingImagePixelType   mappedMovingPixelValue;
+  bool                   pointIsValid = false;
 
   /* Transform the point into fixed and moving spaces, and evaluate.
    * Different behavior with pre-warping enabled is handled transparently.
@@ -225,11 +223,6 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
   {
     pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateMovingPoint(
       virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
-    if (pointIsValid && this->m_CorrelationAssociate->GetComputeDerivative() &&
-        this->m_CorrelationAssociate->GetGradientSourceIncludesMoving())
-    {
-      this->m_CorrelationAssociate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
-    }
   }
   catch (ExceptionObject & exc)
   {
@@ -243,10 +236,96 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
     return pointIsValid;
   }
 
+  return this->AccumulateMappedPoint(virtualIndex,
+                                     virtualPoint,
+                                     mappedFixedPoint,
+                                     mappedFixedPixelValue,
+                                     mappedFixedImageGradient,
+                                     mappedMovingPoint,
+                                     mappedMovingPixelValue,
+                                     threadId);
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
+void
+CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
+  TDomainPartitioner,
+  TImageToImageMetric,
+  TCorrelationMetric>::ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                                            const std::vector<VirtualPointType> & virtualPoints,
+                                            const SizeValueType                   firstSampleIdentifier,
+                                            const ThreadIdType                    threadId)
+{
+  if (!this->CanProcessVirtualPointsInBatches())
+  {
+    Superclass::ProcessVirtualPoints(virtualIndices, virtualPoints, firstSampleIdentifier, threadId);
+    return;
+  }
+
+  std::vector<MovingImagePointType> mappedMovingPoints;
+  std::vector<MovingImagePixelType> mappedMovingPixelValues;
+  std::vector<bool>                 movingPointIsValid;
+  try
+  {
+    this->m_CorrelationAssociate->TransformAndEvaluateMovingPoints(
+      virtualPoints, mappedMovingPoints, mappedMovingPixelValues, movingPointIsValid);
+  }
+  catch (ExceptionObject & exc)
+  {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+  }
+
+  FixedImagePointType    mappedFixedPoint;
+  FixedImagePixelType    mappedFixedPixelValue;
+  FixedImageGradientType mappedFixedImageGradient;
+  for (size_t i = 0; i < virtualPoints.size(); ++i)
+  {
+    if (movingPointIsValid[i] &&
+        this->EvaluateFixedPoint(virtualPoints[i], mappedFixedPoint, mappedFixedPixelValue, mappedFixedImageGradient))
+    {
+      this->AccumulateMappedPoint(virtualIndices[i],
+                                  virtualPoints[i],
+                                  mappedFixedPoint,
+                                  mappedFixedPixelValue,
+                                  mappedFixedImageGradient,
+                                  mappedMovingPoints[i],
+                                  mappedMovingPixelValues[i],
+                                  threadId);
+    }
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
+bool
+CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
+  TDomainPartitioner,
+  TImageToImageMetric,
+  TCorrelationMetric>::AccumulateMappedPoint(const VirtualIndexType &       virtualIndex,
+                                             const VirtualPointType &       virtualPoint,
+                                             const FixedImagePointType &    mappedFixedPoint,
+                                             const FixedImagePixelType &    mappedFixedPixelValue,
+                                             const FixedImageGradientType & mappedFixedImageGradient,
+                                             const MovingImagePointType &   mappedMovingPoint,
+                                             const MovingImagePixelType &   mappedMovingPixelValue,
+                                             const ThreadIdType             threadId)
+{
+  MovingImageGradientType mappedMovingImageGradient;
+  bool                    pointIsValid = false;
+  MeasureType             metricValueResult;
+
   /* Call the user method in derived classes to do the specific
    * calculations for value and derivative. */
   try
   {
+    if (this->m_CorrelationAssociate->GetComputeDerivative() &&
+        this->m_CorrelationAssociate->GetGradientSourceIncludesMoving())
+    {
+      this->m_CorrelationAssociate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
+    }
+
     pointIsValid = this->ProcessPoint(virtualIndex,
                                       virtualPoint,
                                       mappedFixedPoint,
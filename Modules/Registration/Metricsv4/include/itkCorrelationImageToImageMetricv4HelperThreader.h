@@ -101,6 +101,19 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId) override;
 
+  /** Sum the values of a scan line or a block of sampled points, evaluating
+   * the moving image at all the points at once. */
+  void
+  ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                       const std::vector<VirtualPointType> & virtualPoints,
+                       const SizeValueType                   firstSampleIdentifier,
+                       const ThreadIdType                    threadId) override;
+
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
 
   /**
    * Not using. All processing is done in ProcessVirtualPoint.
@@ -172,6 +172,49 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
   return pointIsValid;
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
+void
+CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageMetric, TCorrelationMetric>::
+  ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                       const std::vector<VirtualPointType> & virtualPoints,
+                       const SizeValueType                   firstSampleIdentifier,
+                       const ThreadIdType                    threadId)
+{
+  if (!this->CanProcessVirtualPointsInBatches())
+  {
+    Superclass::ProcessVirtualPoints(virtualIndices, virtualPoints, firstSampleIdentifier, threadId);
+    return;
+  }
+
+  std::vector<MovingImagePointType> mappedMovingPoints;
+  std::vector<MovingImagePixelType> mappedMovingPixelValues;
+  std::vector<bool>                 movingPointIsValid;
+  FixedImagePointType               mappedFixedPoint;
+  FixedImagePixelType               mappedFixedPixelValue;
+  try
+  {
+    this->m_CorrelationAssociate->TransformAndEvaluateMovingPoints(
+      virtualPoints, mappedMovingPoints, mappedMovingPixelValues, movingPointIsValid);
+    for (size_t i = 0; i < virtualPoints.size(); ++i)
+    {
+      if (movingPointIsValid[i] && this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint(
+                                     virtualPoints[i], mappedFixedPoint, mappedFixedPixelValue))
+      {
+        this->m_CorrelationMetricPerThreadVariables[threadId].FixSum += mappedFixedPixelValue;
+        this->m_CorrelationMetricPerThreadVariables[threadId].MovSum += mappedMovingPixelValues[i];
+        this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
+      }
+    }
+  }
+  catch (ExceptionObject & exc)
+  {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+  }
+}
+
 } // end namespace itk
 
 #endif
@@ -140,6 +140,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
 private:
   /** Threshold below which the denominator term is considered zero.
    *  Fixed programmatically in constructor. */
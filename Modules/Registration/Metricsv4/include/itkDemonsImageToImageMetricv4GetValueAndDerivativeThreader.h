@@ -93,6 +93,13 @@ protected:
                DerivativeType &                localDerivativeReturn,
                const ThreadIdType              threadId) const override;
 
+  /** Evaluate the moving image at a scan line or block of samples at once. */
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
+
 private:
   /** Internal pointer to the Mattes metric object in use by this threader.
    *  This will avoid costly dynamic casting in tight loops. */
@@ -31,6 +31,7 @@
 #include "itkPointSet.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDefaultImageToImageMetricTraitsv4.h"
+#include <vector>
 
 namespace itk
 {
@@ -563,6 +564,32 @@ public:
   itkSetMacro(FloatingPointCorrectionResolution, DerivativeValueType);
   itkGetConstMacro(FloatingPointCorrectionResolution, DerivativeValueType);
 
+  /** Set/Get the option for caching the fixed image samples of the virtual
+   * domain across evaluations. False by default.
+   * When on, the mapped fixed point, the fixed image value and, if the
+   * gradient source includes the fixed image, the fixed image gradient at
+   * each point of the virtual domain, or of the virtual sampled point set,
+   * are computed once, and reused by the following evaluations. The cache is
+   * rebuilt when the fixed transform, the fixed image, its interpolator,
+   * gradient filter or calculator, the fixed image mask, the virtual domain
+   * or the metric settings are modified, and on each call to Initialize().
+   * This saves the evaluation of the fixed image at each iteration of a
+   * registration in which the fixed transform is constant, which is the
+   * usual case, at the cost of memory linear in the number of points. See
+   * GetFixedSampleCacheMemorySize().
+   *
+   * \note The cache is used by the metrics which process the points with
+   * the batched evaluation of the default threaders, like the mean squares,
+   * Mattes mutual information, joint histogram mutual information and
+   * demons metrics. */
+  itkSetMacro(UseFixedSampleCache, bool);
+  itkGetConstReferenceMacro(UseFixedSampleCache, bool);
+  itkBooleanMacro(UseFixedSampleCache);
+
+  /** Get the memory held by the fixed sample cache, in bytes. */
+  SizeValueType
+  GetFixedSampleCacheMemorySize() const;
+
   /* Initialize the metric before calling GetValue or GetDerivative.
    * Derived classes must call this Superclass version if they override
    * this to perform their own initialization.
@@ -634,6 +661,35 @@ protected:
   typename ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartitioner, Self>::Pointer
     m_SparseGetValueAndDerivativeThreader;
 
+  /** A point of the virtual domain mapped into the fixed image, with the
+   * fixed image value and gradient there. */
+  struct FixedSampleType
+  {
+    FixedImagePointType    MappedPoint;
+    FixedImagePixelType    PixelValue;
+    FixedImageGradientType Gradient;
+    bool                   IsValid;
+  };
+
+  /** Get the cached fixed sample of a point of the virtual domain. The point
+   * is identified by the offset of its index in the virtual region with dense
+   * sampling, and by its identifier in the virtual sampled point set with
+   * sparse sampling. Returns nullptr when the cache is not in use. */
+  const FixedSampleType *
+  GetCachedFixedSample(const SizeValueType sampleIdentifier) const
+  {
+    if (this->m_FixedSampleCache.empty())
+    {
+      return nullptr;
+    }
+    return &this->m_FixedSampleCache[sampleIdentifier];
+  }
+
+  /** Build the fixed sample cache if it is in use and missing or out of
+   * date, or release it if it is not in use. Called before each evaluation. */
+  void
+  UpdateFixedSampleCache() const;
+
   /** Perform any initialization required before each evaluation of
    * \c GetValueAndDerivative. This is distinct from Initialize, which
    * is called only once before a number of iterations, e.g. before
@@ -659,6 +715,17 @@ protected:
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const;
 
+  /** Transform and evaluate a set of points, typically a scan line, from
+   * VirtualImage domain to MovingImage domain. The mapped points that pass the
+   * mask and buffer checks of TransformAndEvaluateMovingPoint are interpolated
+   * together through InterpolateImageFunction::EvaluateAtContinuousIndices.
+   * The returned vectors are resized to the number of \c virtualPoints. */
+  void
+  TransformAndEvaluateMovingPoints(const std::vector<VirtualPointType> & virtualPoints,
+                                   std::vector<MovingImagePointType> &   mappedMovingPoints,
+                                   std::vector<MovingImagePixelType> &   mappedMovingPixelValues,
+                                   std::vector<bool> &                   pointIsValid) const;
+
   /** Compute image derivatives for a Fixed point. */
   virtual void
   ComputeFixedImageGradientAtPoint(const FixedImagePointType & mappedPoint, FixedImageGradientType & gradient) const;
@@ -757,12 +824,24 @@ protected:
   FixedSampledPointSet */
   bool m_UseVirtualSampledPointSet;
 
+  /** Fixed sample cache, and the time it was built. */
+  bool                                 m_UseFixedSampleCache;
+  mutable std::vector<FixedSampleType> m_FixedSampleCache;
+  mutable TimeStamp                    m_FixedSampleCacheTime;
+
   ImageToImageMetricv4();
   ~ImageToImageMetricv4() override = default;
 
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings, which can be evaluated
+   * concurrently with this one once initialized. The clone shares the
+   * images, interpolators, masks, sampled point sets and gradient filters
+   * and calculators, which are only read during the evaluation. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
 private:
   /** Map the fixed point set samples to the virtual domain */
   void
@@ -24,6 +24,8 @@
 #include "itkCompositeTransform.h"
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkIdentityTransform.h"
+#include "itkMultiThreaderBase.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -67,6 +69,7 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   this->m_UseMovingImageGradientFilter = true;
   this->m_UseSampledPointSet = false;
   this->m_UseVirtualSampledPointSet = false;
+  this->m_UseFixedSampleCache = false;
 
   this->m_FloatingPointCorrectionResolution = 1e6;
   this->m_UseFloatingPointCorrection = false;
@@ -192,6 +195,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
   }
+
+  /* The fixed samples are computed again at the next evaluation. */
+  this->m_FixedSampleCache.clear();
 }
 
 template <typename TFixedImage,
@@ -262,6 +268,8 @@ void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   GetValueAndDerivativeExecute() const
 {
+  this->UpdateFixedSampleCache();
+
   if (this->m_UseSampledPointSet) // sparse sampling
   {
     SizeValueType numberOfPoints = this->GetNumberOfDomainPoints();
@@ -303,6 +311,95 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  UpdateFixedSampleCache() const
+{
+  if (!this->m_UseFixedSampleCache)
+  {
+    if (this->m_FixedSampleCache.capacity() > 0)
+    {
+      std::vector<FixedSampleType>().swap(this->m_FixedSampleCache);
+    }
+    return;
+  }
+
+  /* The cache is up to date when none of the objects the fixed samples
+   * depend on was modified since it was built. */
+  const bool       computeGradient = this->GetGradientSourceIncludesFixed();
+  ModifiedTimeType sourceTime = std::max({ this->GetMTime(),
+                                           this->m_FixedTransform->GetMTime(),
+                                           this->m_FixedImage->GetMTime(),
+                                           this->m_FixedInterpolator->GetMTime(),
+                                           this->m_VirtualImage->GetMTime() });
+  if (this->m_FixedImageMask)
+  {
+    sourceTime = std::max(sourceTime, this->m_FixedImageMask->GetMTime());
+  }
+  if (this->m_UseSampledPointSet)
+  {
+    sourceTime = std::max(sourceTime, this->m_VirtualSampledPointSet->GetMTime());
+  }
+  if (computeGradient)
+  {
+    sourceTime = std::max(sourceTime,
+                          this->m_UseFixedImageGradientFilter ? this->m_FixedImageGradientInterpolator->GetMTime()
+                                                              : this->m_FixedImageGradientCalculator->GetMTime());
+  }
+  const SizeValueType numberOfSamples = this->GetNumberOfDomainPoints();
+  if (this->m_FixedSampleCache.size() == numberOfSamples && sourceTime < this->m_FixedSampleCacheTime.GetMTime())
+  {
+    return;
+  }
+
+  itkDebugMacro("Build the fixed sample cache of " << numberOfSamples << " points");
+  this->m_FixedSampleCache.resize(numberOfSamples);
+  const VirtualImageType * virtualImage = this->m_VirtualImage;
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->SetMaximumNumberOfThreads(this->GetMaximumNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSamples,
+    [this, virtualImage, computeGradient](SizeValueType sampleIdentifier) {
+      VirtualPointType virtualPoint;
+      if (this->m_UseSampledPointSet)
+      {
+        virtualPoint = this->m_VirtualSampledPointSet->GetPoint(sampleIdentifier);
+      }
+      else
+      {
+        virtualImage->TransformIndexToPhysicalPoint(
+          virtualImage->ComputeIndex(static_cast<OffsetValueType>(sampleIdentifier)), virtualPoint);
+      }
+      FixedSampleType & sample = this->m_FixedSampleCache[sampleIdentifier];
+      sample.IsValid = this->TransformAndEvaluateFixedPoint(virtualPoint, sample.MappedPoint, sample.PixelValue);
+      if (sample.IsValid && computeGradient)
+      {
+        this->ComputeFixedImageGradientAtPoint(sample.MappedPoint, sample.Gradient);
+      }
+    },
+    nullptr);
+  this->m_FixedSampleCacheTime.Modified();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+SizeValueType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  GetFixedSampleCacheMemorySize() const
+{
+  return static_cast<SizeValueType>(this->m_FixedSampleCache.capacity() * sizeof(FixedSampleType));
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -395,6 +492,72 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return pointIsValid;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  TransformAndEvaluateMovingPoints(const std::vector<VirtualPointType> & virtualPoints,
+                                   std::vector<MovingImagePointType> &   mappedMovingPoints,
+                                   std::vector<MovingImagePixelType> &   mappedMovingPixelValues,
+                                   std::vector<bool> &                   pointIsValid) const
+{
+  using ContinuousIndexType = typename MovingInterpolatorType::ContinuousIndexType;
+  using BatchOutputType = typename MovingInterpolatorType::OutputType;
+
+  const SizeValueType numberOfPoints = virtualPoints.size();
+  mappedMovingPoints.resize(numberOfPoints);
+  mappedMovingPixelValues.resize(numberOfPoints);
+  pointIsValid.resize(numberOfPoints);
+
+  // The continuous indices of the valid points, one array per dimension
+  std::vector<CoordinateRepresentationType>                 coordinates(MovingImageDimension * numberOfPoints);
+  typename MovingInterpolatorType::ContinuousIndexBatchType batchIndices;
+  for (unsigned int d = 0; d < MovingImageDimension; ++d)
+  {
+    batchIndices[d] = coordinates.data() + d * numberOfPoints;
+  }
+
+  typename MovingTransformType::OutputPointType localVirtualPoint;
+  ContinuousIndexType                           continuousIndex;
+  SizeValueType                                 numberOfValidPoints = 0;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    mappedMovingPixelValues[i] = NumericTraits<MovingImagePixelType>::ZeroValue();
+
+    localVirtualPoint.CastFrom(virtualPoints[i]);
+    mappedMovingPoints[i].CastFrom(this->m_MovingTransform->TransformPoint(localVirtualPoint));
+
+    // check against the mask if one is assigned, then against the image buffer
+    pointIsValid[i] =
+      (!this->m_MovingImageMask || this->m_MovingImageMask->IsInsideInWorldSpace(mappedMovingPoints[i])) &&
+      this->m_MovingInterpolator->IsInsideBuffer(mappedMovingPoints[i]);
+    if (pointIsValid[i])
+    {
+      this->m_MovingInterpolator->ConvertPointToContinuousIndex(mappedMovingPoints[i], continuousIndex);
+      for (unsigned int d = 0; d < MovingImageDimension; ++d)
+      {
+        coordinates[d * numberOfPoints + numberOfValidPoints] = continuousIndex[d];
+      }
+      ++numberOfValidPoints;
+    }
+  }
+
+  std::vector<BatchOutputType> values(numberOfValidPoints);
+  this->m_MovingInterpolator->EvaluateAtContinuousIndices(batchIndices, numberOfValidPoints, values.data());
+
+  SizeValueType valid = 0;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    if (pointIsValid[i])
+    {
+      mappedMovingPixelValues[i] = values[valid++];
+    }
+  }
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -658,6 +821,48 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetFixedImage(this->m_FixedImage);
+  rval->SetMovingImage(this->m_MovingImage);
+  rval->SetFixedInterpolator(this->m_FixedInterpolator);
+  rval->SetMovingInterpolator(this->m_MovingInterpolator);
+  rval->SetFixedImageMask(this->m_FixedImageMask);
+  rval->SetMovingImageMask(this->m_MovingImageMask);
+  rval->SetFixedSampledPointSet(this->m_FixedSampledPointSet);
+  rval->SetUseSampledPointSet(this->m_UseSampledPointSet);
+  if (this->m_UseVirtualSampledPointSet)
+  {
+    rval->SetVirtualSampledPointSet(this->m_VirtualSampledPointSet);
+    rval->SetUseVirtualSampledPointSet(true);
+  }
+  rval->SetFixedImageGradientFilter(this->m_FixedImageGradientFilter);
+  rval->SetMovingImageGradientFilter(this->m_MovingImageGradientFilter);
+  rval->SetFixedImageGradientCalculator(this->m_FixedImageGradientCalculator);
+  rval->SetMovingImageGradientCalculator(this->m_MovingImageGradientCalculator);
+  rval->SetUseFixedImageGradientFilter(this->m_UseFixedImageGradientFilter);
+  rval->SetUseMovingImageGradientFilter(this->m_UseMovingImageGradientFilter);
+  rval->SetUseFloatingPointCorrection(this->m_UseFloatingPointCorrection);
+  rval->SetFloatingPointCorrectionResolution(this->m_FloatingPointCorrectionResolution);
+  rval->SetUseFixedSampleCache(this->m_UseFixedSampleCache);
+  rval->SetMaximumNumberOfWorkUnits(this->GetMaximumNumberOfWorkUnits());
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -674,7 +879,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
      << indent << "GetUseFixedImageGradientFilter: " << this->GetUseFixedImageGradientFilter() << std::endl
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
-     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
+     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl
+     << indent << "UseFixedSampleCache: " << this->GetUseFixedSampleCache() << std::endl
+     << indent << "FixedSampleCacheMemorySize: " << this->GetFixedSampleCacheMemorySize() << std::endl;
 
   itkPrintSelfObjectMacro(FixedImage);
   itkPrintSelfObjectMacro(MovingImage);
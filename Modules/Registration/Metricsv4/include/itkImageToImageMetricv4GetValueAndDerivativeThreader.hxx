@@ -18,8 +18,9 @@
 #ifndef itkImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 #define itkImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 
-#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -31,13 +32,25 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<
   TImageToImageMetricv4>::ThreadedExecution(const DomainType & imageSubRegion, const ThreadIdType threadId)
 {
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
-  using IteratorType = ImageRegionConstIteratorWithIndex<VirtualImageType>;
-  VirtualPointType virtualPoint;
-  for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); ++it)
+  using IteratorType = ImageScanlineConstIterator<VirtualImageType>;
+  std::vector<VirtualIndexType> virtualIndices;
+  std::vector<VirtualPointType> virtualPoints;
+  for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); it.NextLine())
   {
-    const VirtualIndexType & virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    // Process the virtual domain one scan line at a time, so that the moving
+    // image is interpolated in batches
+    virtualIndices.clear();
+    virtualPoints.clear();
+    VirtualIndexType    virtualIndex = it.GetIndex();
+    VirtualPointType    virtualPoint;
+    const SizeValueType lineOffset = virtualImage->ComputeOffset(virtualIndex);
+    for (; !it.IsAtEndOfLine(); ++it, ++virtualIndex[0])
+    {
+      virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoint);
+      virtualIndices.push_back(virtualIndex);
+      virtualPoints.push_back(virtualPoint);
+    }
+    this->ProcessVirtualPoints(virtualIndices, virtualPoints, lineOffset, threadId);
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
@@ -54,11 +67,26 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartit
   const ElementIdentifierType             begin = indexSubRange[0];
   const ElementIdentifierType             end = indexSubRange[1];
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
-  for (ElementIdentifierType i = begin; i <= end; ++i)
+
+  // Process the sampled points in blocks of consecutive points, so that the
+  // moving image is interpolated in batches
+  constexpr ElementIdentifierType blockSize = 256;
+  std::vector<VirtualIndexType>   virtualIndices;
+  std::vector<VirtualPointType>   virtualPoints;
+  virtualIndices.reserve(std::min(blockSize, end - begin + 1));
+  virtualPoints.reserve(std::min(blockSize, end - begin + 1));
+  for (ElementIdentifierType blockBegin = begin; blockBegin <= end; blockBegin += blockSize)
   {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
-    const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    virtualIndices.clear();
+    virtualPoints.clear();
+    const ElementIdentifierType blockEnd = std::min(end, blockBegin + (blockSize - 1));
+    for (ElementIdentifierType i = blockBegin; i <= blockEnd; ++i)
+    {
+      const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
+      virtualIndices.push_back(virtualImage->TransformPhysicalPointToIndex(virtualPoint));
+      virtualPoints.push_back(virtualPoint);
+    }
+    this->ProcessVirtualPoints(virtualIndices, virtualPoints, blockBegin, threadId);
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
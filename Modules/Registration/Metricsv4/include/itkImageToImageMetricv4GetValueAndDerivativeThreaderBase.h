@@ -20,6 +20,7 @@
 
 #include "itkDomainThreader.h"
 #include "itkCompensatedSummation.h"
+#include <vector>
 
 namespace itk
 {
@@ -36,8 +37,14 @@ namespace itk
  *
  *  The \c ThreadedExecution in
  *  ImageToImageMetricv4GetValueAndDerivativeThreader calls \c
- *  ProcessVirtualPoint on every point in the virtual image domain.  \c
- *  ProcessVirtualPoint calls \c ProcessPoint on each point.
+ *  ProcessVirtualPoints on every scan line of a dense virtual domain, and on
+ *  consecutive blocks of the points of a sampled point set. It calls \c
+ *  ProcessPoint on each point.
+ *
+ *  With global transforms, the derivatives of the points are summed in
+ *  blocks of \c DerivativeBlockSize points, and each block sum is added to
+ *  the compensated sum of its thread. Summing plain blocks vectorizes, and
+ *  keeps the compensated summation off the per point path.
  *
  * \ingroup ITKMetricsv4 */
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
@@ -120,6 +127,53 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId);
 
+  /** Method called by the threaders to process a scan line of a dense
+   * virtual domain, or a block of sampled points. By default, each point is
+   * processed by \c ProcessVirtualPoint. When \c
+   * CanProcessVirtualPointsInBatches is true, the moving image is evaluated
+   * at all the points at once through \c TransformAndEvaluateMovingPoints,
+   * then each point is processed as by \c ProcessVirtualPoint. The points
+   * are consecutive samples of the domain, and \c firstSampleIdentifier
+   * identifies the first one for the fixed sample cache of the metric: the
+   * offset of its index in the virtual region, or its identifier in the
+   * virtual sampled point set. */
+  virtual void
+  ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                       const std::vector<VirtualPointType> & virtualPoints,
+                       const SizeValueType                   firstSampleIdentifier,
+                       const ThreadIdType                    threadId);
+
+  /** Whether \c ProcessVirtualPoints evaluates the moving image at all the
+   * points at once, instead of calling \c ProcessVirtualPoint for each. The
+   * threaders of the metrics which only specialize \c ProcessPoint return
+   * true. A class derived from them which overrides \c ProcessVirtualPoint
+   * must return false. */
+  virtual bool
+  CanProcessVirtualPointsInBatches() const
+  {
+    return false;
+  }
+
+  /** Transform a virtual point into the fixed space, evaluate the fixed image
+   * there and, if needed, its gradient. */
+  bool
+  EvaluateFixedPoint(const VirtualPointType & virtualPoint,
+                     FixedImagePointType &    mappedFixedPoint,
+                     FixedImagePixelType &    mappedFixedPixelValue,
+                     FixedImageGradientType & mappedFixedImageGradient) const;
+
+  /** Compute the moving image gradient if needed, call \c ProcessPoint for
+   * points valid in both spaces, and store its results. */
+  bool
+  ProcessMappedPoint(const VirtualIndexType &       virtualIndex,
+                     const VirtualPointType &       virtualPoint,
+                     const FixedImagePointType &    mappedFixedPoint,
+                     const FixedImagePixelType &    mappedFixedPixelValue,
+                     const FixedImageGradientType & mappedFixedImageGradient,
+                     const MovingImagePointType &   mappedMovingPoint,
+                     const MovingImagePixelType &   mappedMovingPixelValue,
+                     const ThreadIdType             threadId);
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
@@ -168,6 +222,14 @@ protected:
   virtual void
   StorePointDerivativeResult(const VirtualIndexType & virtualIndex, const ThreadIdType threadId);
 
+  /** Number of points of a derivative block. */
+  static constexpr SizeValueType DerivativeBlockSize = 32;
+
+  /** Add the derivative block sum of a thread to its compensated sum, and
+   * start a new block. */
+  void
+  FlushDerivativeBlock(const ThreadIdType threadId);
+
   struct GetValueAndDerivativePerThreadStruct
   {
     /** Intermediary threaded metric value storage. */
@@ -176,6 +238,11 @@ protected:
     DerivativeType Derivatives;
     /** Intermediary threaded metric value storage. This is used only with global transforms. */
     CompensatedDerivativeType CompensatedDerivatives;
+    /** Sum of the derivatives of the current block of points, not yet added
+     * to CompensatedDerivatives. This is used only with global transforms. */
+    DerivativeType BlockDerivatives;
+    /** Number of points of the current block. */
+    SizeValueType NumberOfBlockPoints;
     /** Intermediary threaded metric value storage. */
     DerivativeType LocalDerivatives;
     /** Intermediary threaded metric value storage. */
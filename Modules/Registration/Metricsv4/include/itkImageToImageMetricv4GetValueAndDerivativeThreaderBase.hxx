@@ -90,6 +90,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
          * Use a CompensatedSummation value to provide for better consistency between
          * different number of threads. */
         this->m_GetValueAndDerivativePerThreadVariables[i].CompensatedDerivatives.resize(globalDerivativeSize);
+        this->m_GetValueAndDerivativePerThreadVariables[i].BlockDerivatives.SetSize(globalDerivativeSize);
       }
     }
   }
@@ -114,6 +115,9 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
         {
           this->m_GetValueAndDerivativePerThreadVariables[thread].CompensatedDerivatives[p].ResetToZero();
         }
+        this->m_GetValueAndDerivativePerThreadVariables[thread].BlockDerivatives.Fill(
+          NumericTraits<DerivativeValueType>::ZeroValue());
+        this->m_GetValueAndDerivativePerThreadVariables[thread].NumberOfBlockPoints = 0;
       }
     }
   }
@@ -140,6 +144,11 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
     if (this->m_Associate->m_MovingTransform->GetTransformCategory() !=
         MovingTransformType::TransformCategoryEnum::DisplacementField)
     {
+      /* Add the partial blocks of the threads */
+      for (ThreadIdType i = 0; i < numThreadsUsed; ++i)
+      {
+        this->FlushDerivativeBlock(i);
+      }
       for (NumberOfParametersType p = 0; p < this->m_Associate->GetNumberOfParameters(); ++p)
       {
         /* Use a compensated sum to be ready for when there is a very large number of threads */
@@ -187,17 +196,127 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   const VirtualPointType & virtualPoint,
   const ThreadIdType       threadId)
 {
-  FixedImagePointType     mappedFixedPoint;
-  FixedImagePixelType     mappedFixedPixelValue;
-  FixedImageGradientType  mappedFixedImageGradient;
-  MovingImagePointType    mappedMovingPoint;
-  MovingImagePixelType    mappedMovingPixelValue;
-  MovingImageGradientType mappedMovingImageGradient;
-  bool                    pointIsValid = false;
-  MeasureType             metricValueResult;
+  FixedImagePointType    mappedFixedPoint;
+  FixedImagePixelType    mappedFixedPixelValue;
+  FixedImageGradientType mappedFixedImageGradient;
+  MovingImagePointType   mappedMovingPoint;
+  MovingImagePixelType   mappedMovingPixelValue;
+  bool                   pointIsValid = false;
+
+  /* Transform the point into fixed and moving spaces, and evaluate. */
+  if (!this->EvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue, mappedFixedImageGradient))
+  {
+    return false;
+  }
+
+  try
+  {
+    pointIsValid =
+      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+  }
+  catch (ExceptionObject & exc)
+  {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+  }
+  if (!pointIsValid)
+  {
+    return pointIsValid;
+  }
+
+  return this->ProcessMappedPoint(virtualIndex,
+                                  virtualPoint,
+                                  mappedFixedPoint,
+                                  mappedFixedPixelValue,
+                                  mappedFixedImageGradient,
+                                  mappedMovingPoint,
+                                  mappedMovingPixelValue,
+                                  threadId);
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
+  ProcessVirtualPoints(const std::vector<VirtualIndexType> & virtualIndices,
+                       const std::vector<VirtualPointType> & virtualPoints,
+                       const SizeValueType                   firstSampleIdentifier,
+                       const ThreadIdType                    threadId)
+{
+  if (!this->CanProcessVirtualPointsInBatches())
+  {
+    for (size_t i = 0; i < virtualPoints.size(); ++i)
+    {
+      this->ProcessVirtualPoint(virtualIndices[i], virtualPoints[i], threadId);
+    }
+    return;
+  }
 
-  /* Transform the point into fixed and moving spaces, and evaluate.
-   * Do this in a try block to catch exceptions and print more useful info
+  std::vector<MovingImagePointType> mappedMovingPoints;
+  std::vector<MovingImagePixelType> mappedMovingPixelValues;
+  std::vector<bool>                 movingPointIsValid;
+  try
+  {
+    this->m_Associate->TransformAndEvaluateMovingPoints(
+      virtualPoints, mappedMovingPoints, mappedMovingPixelValues, movingPointIsValid);
+  }
+  catch (ExceptionObject & exc)
+  {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+  }
+
+  FixedImagePointType    mappedFixedPoint;
+  FixedImagePixelType    mappedFixedPixelValue;
+  FixedImageGradientType mappedFixedImageGradient;
+  for (size_t i = 0; i < virtualPoints.size(); ++i)
+  {
+    // A point is skipped when either of its mappings is invalid
+    if (!movingPointIsValid[i])
+    {
+      continue;
+    }
+    bool fixedPointIsValid;
+    if (const auto * fixedSample = this->m_Associate->GetCachedFixedSample(firstSampleIdentifier + i))
+    {
+      fixedPointIsValid = fixedSample->IsValid;
+      mappedFixedPoint = fixedSample->MappedPoint;
+      mappedFixedPixelValue = fixedSample->PixelValue;
+      mappedFixedImageGradient = fixedSample->Gradient;
+    }
+    else
+    {
+      fixedPointIsValid =
+        this->EvaluateFixedPoint(virtualPoints[i], mappedFixedPoint, mappedFixedPixelValue, mappedFixedImageGradient);
+    }
+    if (fixedPointIsValid)
+    {
+      this->ProcessMappedPoint(virtualIndices[i],
+                               virtualPoints[i],
+                               mappedFixedPoint,
+                               mappedFixedPixelValue,
+                               mappedFixedImageGradient,
+                               mappedMovingPoints[i],
+                               mappedMovingPixelValues[i],
+                               threadId);
+    }
+  }
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::EvaluateFixedPoint(
+  const VirtualPointType & virtualPoint,
+  FixedImagePointType &    mappedFixedPoint,
+  FixedImagePixelType &    mappedFixedPixelValue,
+  FixedImageGradientType & mappedFixedImageGradient) const
+{
+  bool pointIsValid = false;
+
+  /* Do this in a try block to catch exceptions and print more useful info
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
@@ -217,17 +336,28 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
     ExceptionObject err(__FILE__, __LINE__, msg);
     throw err;
   }
-  if (!pointIsValid)
-  {
-    return pointIsValid;
-  }
+  return pointIsValid;
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::ProcessMappedPoint(
+  const VirtualIndexType &       virtualIndex,
+  const VirtualPointType &       virtualPoint,
+  const FixedImagePointType &    mappedFixedPoint,
+  const FixedImagePixelType &    mappedFixedPixelValue,
+  const FixedImageGradientType & mappedFixedImageGradient,
+  const MovingImagePointType &   mappedMovingPoint,
+  const MovingImagePixelType &   mappedMovingPixelValue,
+  const ThreadIdType             threadId)
+{
+  MovingImageGradientType mappedMovingImageGradient;
+  bool                    pointIsValid = false;
+  MeasureType             metricValueResult;
 
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
-    if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesMoving())
+    if (this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesMoving())
     {
       this->m_Associate->ComputeMovingImageGradientAtPoint(mappedMovingPoint, mappedMovingImageGradient);
     }
@@ -239,10 +369,6 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
     ExceptionObject err(__FILE__, __LINE__, msg);
     throw err;
   }
-  if (!pointIsValid)
-  {
-    return pointIsValid;
-  }
 
   /* Call the user method in derived classes to do the specific
    * calculations for value and derivative. */
@@ -301,10 +427,19 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
           static_cast<DerivativeValueType>(test / correctionResolution);
       }
     }
+    /* Sum the derivatives of a block of points, before adding the sum to the
+     * compensated sum. */
+    AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId];
+    DerivativeValueType * const       blockDerivatives = threadVariables.BlockDerivatives.data_block();
+    const DerivativeValueType * const localDerivatives = threadVariables.LocalDerivatives.data_block();
     for (NumberOfParametersType p = 0; p < this->m_CachedNumberOfParameters; ++p)
     {
-      this->m_GetValueAndDerivativePerThreadVariables[threadId].CompensatedDerivatives[p] +=
-        this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives[p];
+      blockDerivatives[p] += localDerivatives[p];
+    }
+    if (++threadVariables.NumberOfBlockPoints == DerivativeBlockSize)
+    {
+      this->FlushDerivativeBlock(threadId);
     }
   }
   else
@@ -335,6 +470,25 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   }
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::FlushDerivativeBlock(
+  const ThreadIdType threadId)
+{
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  if (threadVariables.NumberOfBlockPoints == 0)
+  {
+    return;
+  }
+  for (NumberOfParametersType p = 0; p < this->m_CachedNumberOfParameters; ++p)
+  {
+    threadVariables.CompensatedDerivatives[p] += threadVariables.BlockDerivatives[p];
+    threadVariables.BlockDerivatives[p] = NumericTraits<DerivativeValueType>::ZeroValue();
+  }
+  threadVariables.NumberOfBlockPoints = 0;
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 bool
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::GetComputeDerivative()
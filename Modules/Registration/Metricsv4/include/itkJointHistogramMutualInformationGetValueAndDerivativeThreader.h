@@ -102,6 +102,12 @@ protected:
                DerivativeType &                localDerivativeReturn,
                const ThreadIdType              threadId) const override;
 
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
+
   inline InternalComputationValueType
   ComputeFixedImageMarginalPDFDerivative(const MarginalPDFPointType & margPDFpoint, const ThreadIdType threadId) const;
 
@@ -210,6 +210,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   /** Count of the number of valid histogram points. */
   SizeValueType m_JointHistogramTotalCount{ 0 };
 
@@ -419,6 +419,30 @@ JointHistogramMutualInformationImageToImageMetricv4<
   jointPDFpoint[1] = b;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+JointHistogramMutualInformationImageToImageMetricv4<TFixedImage,
+                                                    TMovingImage,
+                                                    TVirtualImage,
+                                                    TInternalComputationValueType,
+                                                    TMetricTraits>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetNumberOfHistogramBins(this->m_NumberOfHistogramBins);
+  rval->SetVarianceForJointPDFSmoothing(this->m_VarianceForJointPDFSmoothing);
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -64,10 +64,10 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
- * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
- * and threader::AfterThreadedExecution().
+ * For global transforms, the derivative is either computed from the
+ * derivatives of the joint PDF with respect to the transform parameters, or
+ * directly from the samples in a second pass over the domain. See
+ * SetUseExplicitPDFDerivatives().
  *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
@@ -157,9 +157,38 @@ public:
   itkSetClampMacro(NumberOfHistogramBins, SizeValueType, 5, NumericTraits<SizeValueType>::max());
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
 
+  /** Select how the derivative is computed for transforms with global
+   * support. The choice is a trade-off between computation speed and memory.
+   *
+   * UseExplicitPDFDerivatives = True (the default) computes the derivatives
+   * of each one of the joint PDF bins with respect to each one of the
+   * transform parameters while building the joint PDF, and then accumulates
+   * them in the metric derivative with a bin-specific weight. The derivatives
+   * of the joint PDF are stored in an array of (number of histogram bins)^2
+   * times the number of transform parameters values. This is well suited for
+   * transforms with a small number of parameters.
+   *
+   * UseExplicitPDFDerivatives = False builds the joint PDF and the weights of
+   * its bins in a first pass over the samples, and accumulates the weighted
+   * contribution of each sample to the metric derivative in a second pass.
+   * Each thread only stores its partial derivative. This is well suited for
+   * transforms with a large number of parameters, such as BSplineTransform.
+   *
+   * Transforms with local support, like displacement fields, always use the
+   * second method, in a single pass. */
+  itkSetMacro(UseExplicitPDFDerivatives, bool);
+  itkGetConstReferenceMacro(UseExplicitPDFDerivatives, bool);
+  itkBooleanMacro(UseExplicitPDFDerivatives);
+
   void
   Initialize() override;
 
+  /** With implicit PDF derivatives and a global transform, the samples are
+   * processed twice: once for the joint PDF and the value, then once for the
+   * derivative. */
+  void
+  GetValueAndDerivative(MeasureType & value, DerivativeType & derivative) const override;
+
   /** The marginal PDFs are stored as std::vector. */
   // NOTE:  floating point precision is not as stable.
   // Double precision proves faster and more robust in real-world testing.
@@ -186,8 +215,8 @@ public:
   /**
    * Get the internal JointPDFDeriviative image that was used in
    * creating the metric derivative value.
-   * This is only created when a global support transform is used, and
-   * derivatives are requested.
+   * This is only created when a global support transform is used,
+   * derivatives are requested and UseExplicitPDFDerivatives is on.
    */
   const typename JointPDFDerivativesType::Pointer
   GetJointPDFDerivatives() const
@@ -223,6 +252,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Create a metric of the same type and settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   using JointPDFIndexType = typename JointPDFType::IndexType;
   using JointPDFValueType = typename JointPDFType::PixelType;
   using JointPDFRegionType = typename JointPDFType::RegionType;
@@ -259,6 +292,13 @@ protected:
   typename CubicBSplineFunctionType::Pointer           m_CubicBSplineKernel;
   typename CubicBSplineDerivativeFunctionType::Pointer m_CubicBSplineDerivativeKernel;
 
+  /** Compute the derivative from the joint PDF derivatives. */
+  bool m_UseExplicitPDFDerivatives{ true };
+
+  /** Whether the threaders run the derivative pass of the implicit PDF
+   * derivatives. */
+  mutable bool m_ImplicitPDFDerivativesPass{ false };
+
   /** Helper array for storing the values of the JointPDF ratios. */
   using PRatioType = PDFValueType;
   using PRatioArrayType = std::vector<PRatioType>;
@@ -377,6 +417,14 @@ private:
   /** Perform the final step in computing results */
   virtual void
   ComputeResults() const;
+
+  /** Scale the joint PDF derivatives and sum them, weighted by the pRatio of
+   * their bin, in the derivative. The parameters are processed in parallel
+   * blocks of ParameterBlockSize. */
+  void
+  ComputeDerivativeFromJointPDFDerivatives() const;
+
+  static constexpr SizeValueType ParameterBlockSize = 256;
 };
 
 } // end namespace itk
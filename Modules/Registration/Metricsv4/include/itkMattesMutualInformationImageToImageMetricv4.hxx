@@ -20,6 +20,7 @@
 
 #include "itkMattesMutualInformationImageToImageMetricv4.h"
 #include "itkCompensatedSummation.h"
+#include "itkMultiThreaderBase.h"
 #include <mutex>
 
 namespace itk
@@ -288,12 +289,50 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::FinalizeThread(const ThreadIdType threadId)
 {
-  if (this->GetComputeDerivative() && (!this->HasLocalSupport()))
+  if (this->GetComputeDerivative() && (!this->HasLocalSupport()) && this->m_UseExplicitPDFDerivatives &&
+      !this->m_ImplicitPDFDerivativesPass)
   {
     this->m_ThreaderDerivativeManager[threadId].BlockAndReduce();
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::GetValueAndDerivative(MeasureType &    value,
+                                                                                  DerivativeType & derivative) const
+{
+  if (this->m_UseExplicitPDFDerivatives || this->HasLocalSupport())
+  {
+    Superclass::GetValueAndDerivative(value, derivative);
+    return;
+  }
+
+  // First pass: the joint PDF, the value and the pRatio of the bins.
+  this->GetValue();
+
+  // Second pass: the contribution of each sample to the derivative,
+  // weighted by the pRatio of the bins of its Parzen window.
+  this->m_ImplicitPDFDerivativesPass = true;
+  try
+  {
+    Superclass::GetValueAndDerivative(value, derivative);
+  }
+  catch (...)
+  {
+    this->m_ImplicitPDFDerivativesPass = false;
+    throw;
+  }
+  this->m_ImplicitPDFDerivativesPass = false;
+}
+
 
 template <typename TFixedImage,
           typename TMovingImage,
@@ -364,6 +403,10 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   static constexpr PDFValueType closeToZero = std::numeric_limits<PDFValueType>::epsilon();
   const PDFValueType            nFactor = 1.0 / (this->m_MovingImageBinSize * this->GetNumberOfValidPoints());
 
+  // The pRatio of the bins is stored when the derivative, or the implicit
+  // PDF derivatives of the next pass, need it.
+  const bool storePRatio = !this->m_PRatioArray.empty();
+
   auto const temp_num_histogram_bins = this->m_NumberOfHistogramBins;
   /**
    * Compute the metric by double summation over histogram.
@@ -394,30 +437,12 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
           const PDFValueType pRatio = std::log(jointPDFValue / movingImageMarginalPDF);
           sum += jointPDFValue * (pRatio - logfixedImageMarginalPDFValue);
 
-          if (this->GetComputeDerivative())
+          if (storePRatio)
           {
-            if (!this->HasLocalSupport())
-            {
-              // Collect global derivative contributions
-              JointPDFValueType const * derivPtr = this->m_JointPDFDerivatives->GetBufferPointer() +
-                                                   (fixedIndex * this->m_JointPDFDerivatives->GetOffsetTable()[2]) +
-                                                   (movingIndex * this->m_JointPDFDerivatives->GetOffsetTable()[1]);
-              // move joint pdf derivative pointer to the right position
-              for (unsigned int parameter = 0, lastParameter = this->GetNumberOfLocalParameters();
-                   parameter < lastParameter;
-                   ++parameter, derivPtr++)
-              {
-                // Ref: eqn 23 of Thevenaz & Unser paper [3]
-                (*(this->m_DerivativeResult))[parameter] += (*derivPtr) * pRatio;
-              } // end for-loop over parameters
-            }
-            else
-            {
-              // Collect the pRatio per pdf indices.
-              // Will be applied subsequently to local-support derivative
-              const OffsetValueType index = movingIndex + (fixedIndex * this->m_NumberOfHistogramBins);
-              this->m_PRatioArray[index] = pRatio * nFactor;
-            }
+            // Collect the pRatio per pdf indices.
+            // Will be applied subsequently to the derivative
+            const OffsetValueType index = movingIndex + (fixedIndex * this->m_NumberOfHistogramBins);
+            this->m_PRatioArray[index] = pRatio;
           }
         } // end if( jointPDFValue > closeToZero && movingImageMarginalPDF > closeToZero )
       }   // end for-loop over moving index
@@ -428,7 +453,11 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   // contributions, in the local-support case.
   if (this->GetComputeDerivative())
   {
-    if (this->HasLocalSupport())
+    if (!this->HasLocalSupport())
+    {
+      this->ComputeDerivativeFromJointPDFDerivatives();
+    }
+    else
     {
       for (SizeValueType i = 0, derivativeSize = this->m_DerivativeResult->Size(); i < derivativeSize; ++i)
       {
@@ -439,7 +468,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
           // Note: in old v3 metric ComputeDerivatives, derivativeContribution is subtracted in global case,
           // but added in "local" (implicit) case. These operations have been switched to minimize the metric.
           const SizeValueType pRatioIndex = this->m_JointPdfIndex1DArray[i] + bin;
-          (*(this->m_DerivativeResult))[i] -= m_LocalDerivativeByParzenBin[bin][i] * this->m_PRatioArray[pRatioIndex];
+          (*(this->m_DerivativeResult))[i] -=
+            m_LocalDerivativeByParzenBin[bin][i] * (this->m_PRatioArray[pRatioIndex] * nFactor);
         }
       }
     }
@@ -449,6 +479,57 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   this->m_Value = static_cast<MeasureType>(-1.0 * sum);
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::ComputeDerivativeFromJointPDFDerivatives() const
+{
+  // NOTE:  Negative 1 so that accumulators can all be positive accumulators
+  const PDFValueType nFactor = -1.0 / (this->m_MovingImageBinSize * this->GetNumberOfValidPoints());
+
+  const SizeValueType numberOfBins = this->m_NumberOfHistogramBins * this->m_NumberOfHistogramBins;
+  const SizeValueType numberOfParameters = this->GetNumberOfLocalParameters();
+  const SizeValueType numberOfBlocks = (numberOfParameters + ParameterBlockSize - 1) / ParameterBlockSize;
+
+  // Each block of parameters is scaled and collected over all the bins,
+  // independently of the other blocks.
+  const auto collectBlock = [this, nFactor, numberOfBins, numberOfParameters](SizeValueType block) {
+    const SizeValueType firstParameter = block * ParameterBlockSize;
+    const SizeValueType lastParameter = std::min(firstParameter + ParameterBlockSize, numberOfParameters);
+    DerivativeValueType * const derivative = this->m_DerivativeResult->data_block();
+
+    JointPDFDerivativesValueType * derivPtr = this->m_JointPDFDerivatives->GetBufferPointer();
+    for (SizeValueType bin = 0; bin < numberOfBins; ++bin, derivPtr += numberOfParameters)
+    {
+      const PDFValueType pRatio = this->m_PRatioArray[bin];
+      for (SizeValueType parameter = firstParameter; parameter < lastParameter; ++parameter)
+      {
+        derivPtr[parameter] *= nFactor;
+        // Ref: eqn 23 of Thevenaz & Unser paper [3]
+        derivative[parameter] += derivPtr[parameter] * pRatio;
+      }
+    }
+  };
+
+  if (numberOfBlocks > 1)
+  {
+    MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+    multiThreader->SetMaximumNumberOfThreads(this->GetMaximumNumberOfWorkUnits());
+    multiThreader->ParallelizeArray(0, numberOfBlocks, collectBlock, nullptr);
+  }
+  else if (numberOfBlocks == 1)
+  {
+    collectBlock(0);
+  }
+}
+
 
 template <typename TFixedImage,
           typename TMovingImage,
@@ -493,6 +574,30 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
 }
 
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->SetNumberOfHistogramBins(this->m_NumberOfHistogramBins);
+  rval->SetUseExplicitPDFDerivatives(this->m_UseExplicitPDFDerivatives);
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -506,6 +611,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TMetricTraits>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "UseExplicitPDFDerivatives: " << (this->m_UseExplicitPDFDerivatives ? "On" : "Off") << std::endl;
 }
 
 template <typename TFixedImage,
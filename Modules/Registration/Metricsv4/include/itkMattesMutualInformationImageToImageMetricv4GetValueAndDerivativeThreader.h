@@ -114,6 +114,13 @@ protected:
                DerivativeType &                localDerivativeReturn,
                const ThreadIdType              threadId) const override;
 
+  /** The moving image is evaluated in batches of points. */
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
+
   /** Compute PDF derivative contribution for each parameter of a displacement field. */
   virtual void
   ComputePDFDerivativesLocalSupportTransform(const JacobianType &            jacobian,
@@ -45,6 +45,14 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
     itkExceptionMacro("Dynamic casting of associate pointer failed.");
   }
 
+  /* The derivative pass of the implicit PDF derivatives uses the joint PDF
+   * and the pRatio of the first pass, and the per-thread derivatives of the
+   * superclass. */
+  if (this->m_MattesAssociate->m_ImplicitPDFDerivativesPass)
+  {
+    return;
+  }
+
   /* Porting: these next blocks of code are from MattesMutualImageToImageMetric::Initialize */
 
   /*
@@ -137,8 +145,17 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   //
   if (!this->m_MattesAssociate->GetComputeDerivative())
   {
-    // We only need these if we're computing derivatives.
-    this->m_MattesAssociate->m_PRatioArray.clear();
+    // We only need these if we're computing derivatives, or the implicit
+    // PDF derivatives in the next pass.
+    if (!this->m_MattesAssociate->m_UseExplicitPDFDerivatives && !this->m_MattesAssociate->HasLocalSupport())
+    {
+      this->m_MattesAssociate->m_PRatioArray.assign(
+        this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins, 0.0);
+    }
+    else
+    {
+      this->m_MattesAssociate->m_PRatioArray.clear();
+    }
     this->m_MattesAssociate->m_JointPdfIndex1DArray.clear();
     this->m_MattesAssociate->m_LocalDerivativeByParzenBin.clear();
     this->m_MattesAssociate->m_JointPDFDerivatives = nullptr;
@@ -167,8 +184,9 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   }
   if (this->m_MattesAssociate->GetComputeDerivative() && !this->m_MattesAssociate->HasLocalSupport())
   {
+    this->m_MattesAssociate->m_PRatioArray.assign(
+      this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins, 0.0);
     // Don't need this with global transforms
-    this->m_MattesAssociate->m_PRatioArray.clear();
     this->m_MattesAssociate->m_JointPdfIndex1DArray.clear();
     this->m_MattesAssociate->m_LocalDerivativeByParzenBin.clear();
 
@@ -241,8 +259,8 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
                                                 const MovingImagePointType &,
                                                 const MovingImagePixelType &    movingImageValue,
                                                 const MovingImageGradientType & movingImageGradient,
-                                                MeasureType &,
-                                                DerivativeType &,
+                                                MeasureType &      metricValueReturn,
+                                                DerivativeType &   localDerivativeReturn,
                                                 const ThreadIdType threadId) const
 {
   const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
@@ -285,6 +303,45 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   const OffsetValueType fixedImageParzenWindowIndex =
     this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex(fixedImageValue);
 
+  if (this->m_MattesAssociate->m_ImplicitPDFDerivativesPass)
+  {
+    // The derivative of the joint PDF with respect to the parameters is
+    // never stored: the contribution of this point is the derivative of its
+    // Parzen window, weighted by the pRatio of the affected bins.
+    const PDFValueType * pRatioPtr = this->m_MattesAssociate->m_PRatioArray.data() +
+                                     (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins) +
+                                     pdfMovingIndex;
+    PDFValueType movingImageParzenWindowArg =
+      static_cast<PDFValueType>(pdfMovingIndex) - static_cast<PDFValueType>(movingImageParzenWindowTerm);
+    PDFValueType weight = 0.0;
+    for (; pdfMovingIndex <= pdfMovingIndexMax; ++pdfMovingIndex, ++pRatioPtr, movingImageParzenWindowArg += 1.0)
+    {
+      weight +=
+        *pRatioPtr * this->m_MattesAssociate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
+    }
+    weight /= this->m_MattesAssociate->m_MovingImageBinSize;
+
+    JacobianType & jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
+    JacobianType & jacobianPositional =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
+    this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParametersCachedTemporaries(
+      virtualPoint, jacobian, jacobianPositional);
+    for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement; ++mu)
+    {
+      PDFValueType innerProduct = 0.0;
+      for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+      {
+        innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+      }
+      localDerivativeReturn[mu] = -weight * innerProduct;
+    }
+
+    // The value is the one of the first pass; the superclass sums the
+    // derivatives and averages them over the valid points.
+    metricValueReturn = NumericTraits<MeasureType>::ZeroValue();
+    return true;
+  }
+
   // Since a zero-order BSpline (box car) kernel is used for
   // the fixed image marginal pdf, we need only increment the
   // fixedImageParzenWindowIndex by value of 1.0.
@@ -435,6 +492,14 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   TImageToImageMetric,
   TMattesMutualInformationMetric>::AfterThreadedExecution()
 {
+  if (this->m_MattesAssociate->m_ImplicitPDFDerivativesPass)
+  {
+    const MeasureType value = this->m_MattesAssociate->m_Value;
+    Superclass::AfterThreadedExecution();
+    this->m_MattesAssociate->m_Value = value;
+    return;
+  }
+
   const ThreadIdType localNumberOfWorkUnitsUsed = this->GetNumberOfWorkUnitsUsed();
   /* Store the number of valid points in the enclosing class
    * m_NumberOfValidPoints by collecting the valid points per thread.
@@ -451,32 +516,9 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
   /* Post-processing that is common the GetValue and GetValueAndDerivative */
   this->m_MattesAssociate->GetValueCommonAfterThreadedExecution();
 
-  if (this->m_MattesAssociate->GetComputeDerivative() && (!this->m_MattesAssociate->HasLocalSupport()))
-  {
-    // This entire block of code is used to accumulate the per-thread buffers
-    // into 1 thread.
-    // For this thread, how many histogram elements are there?
-    const NumberOfParametersType rowSize =
-      this->GetCachedNumberOfLocalParameters() * this->m_MattesAssociate->m_NumberOfHistogramBins;
-    const SizeValueType histogramTotalElementsSize = rowSize * this->m_MattesAssociate->m_NumberOfHistogramBins;
-
-    // NOTE:  Negative 1 so that accumulators can all be positive accumulators
-    const PDFValueType nFactor =
-      -1.0 / (this->m_MattesAssociate->m_MovingImageBinSize * this->m_MattesAssociate->GetNumberOfValidPoints());
-
-    JointPDFDerivativesValueType * const accumulatorPdfDPtrStart =
-      this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer();
-    JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
-    JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd =
-      accumulatorPdfDPtrStart + histogramTotalElementsSize;
-    while (accumulatorPdfDPtr < tempThreadPdfDPtrEnd)
-    {
-      *(accumulatorPdfDPtr++) *= nFactor;
-    }
-  }
-
   // Collect and compute results.
-  // Value and derivative are stored in member vars.
+  // Value and derivative are stored in member vars. The joint PDF
+  // derivatives of global transforms are scaled while they are collected.
   this->m_MattesAssociate->ComputeResults();
 }
 
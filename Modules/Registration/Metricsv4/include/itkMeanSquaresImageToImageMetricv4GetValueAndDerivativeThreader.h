@@ -82,6 +82,14 @@ protected:
                MeasureType &                   metricValueReturn,
                DerivativeType &                localDerivativeReturn,
                const ThreadIdType              threadId) const override;
+
+  /** Each scan line or block of samples is interpolated in the moving image
+   * at once. */
+  bool
+  CanProcessVirtualPointsInBatches() const override
+  {
+    return true;
+  }
 };
 
 } // end namespace itk
@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Compare the derivatives of a metric with a global transform, summed in
+ * blocks of points before the compensated summation, to the compensated
+ * summation of each point, with one and several work units.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using TransformType = itk::AffineTransform<double, Dimension>;
+using BaseMetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using CompensatedSummationType = itk::CompensatedSummation<double>;
+
+/** Threader which also adds the derivative of each point to a compensated
+ * reference sum. */
+template <typename TDomainPartitioner>
+class ReferenceSummationThreader
+  : public itk::MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
+                                                                            BaseMetricType::Superclass,
+                                                                            BaseMetricType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ReferenceSummationThreader);
+
+  using Self = ReferenceSummationThreader;
+  using Superclass = itk::MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
+                                                                                        BaseMetricType::Superclass,
+                                                                                        BaseMetricType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using VirtualIndexType = typename Superclass::VirtualIndexType;
+  using DerivativeType = typename Superclass::DerivativeType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ReferenceSummationThreader, MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader);
+
+  /** Average of the derivatives of the points, and average of their absolute
+   * values, for the tolerance. */
+  DerivativeType m_ReferenceDerivative;
+  DerivativeType m_AbsoluteDerivative;
+
+protected:
+  ReferenceSummationThreader() = default;
+
+  void
+  BeforeThreadedExecution() override
+  {
+    Superclass::BeforeThreadedExecution();
+    const auto numberOfParameters = this->m_Associate->GetNumberOfParameters();
+    m_ReferenceSums.assign(this->GetNumberOfWorkUnitsUsed(), std::vector<CompensatedSummationType>(numberOfParameters));
+    m_AbsoluteSums.assign(this->GetNumberOfWorkUnitsUsed(), std::vector<double>(numberOfParameters, 0.0));
+  }
+
+  void
+  StorePointDerivativeResult(const VirtualIndexType & virtualIndex, const itk::ThreadIdType threadId) override
+  {
+    Superclass::StorePointDerivativeResult(virtualIndex, threadId);
+    const DerivativeType & localDerivatives =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives;
+    for (unsigned int p = 0; p < localDerivatives.Size(); ++p)
+    {
+      m_ReferenceSums[threadId][p] += localDerivatives[p];
+      m_AbsoluteSums[threadId][p] += std::abs(localDerivatives[p]);
+    }
+  }
+
+  void
+  AfterThreadedExecution() override
+  {
+    Superclass::AfterThreadedExecution();
+    const auto numberOfParameters = this->m_Associate->GetNumberOfParameters();
+    const auto numberOfValidPoints = static_cast<double>(this->m_Associate->GetNumberOfValidPoints());
+    m_ReferenceDerivative.SetSize(numberOfParameters);
+    m_AbsoluteDerivative.SetSize(numberOfParameters);
+    for (unsigned int p = 0; p < numberOfParameters; ++p)
+    {
+      CompensatedSummationType sum;
+      double                   absoluteSum = 0.0;
+      for (unsigned int i = 0; i < m_ReferenceSums.size(); ++i)
+      {
+        sum += m_ReferenceSums[i][p].GetSum();
+        absoluteSum += m_AbsoluteSums[i][p];
+      }
+      m_ReferenceDerivative[p] = sum.GetSum() / numberOfValidPoints;
+      m_AbsoluteDerivative[p] = absoluteSum / numberOfValidPoints;
+    }
+  }
+
+private:
+  std::vector<std::vector<CompensatedSummationType>> m_ReferenceSums;
+  std::vector<std::vector<double>>                   m_AbsoluteSums;
+};
+
+/** Mean squares metric with the reference threaders. */
+class ReferenceSummationMetric : public BaseMetricType
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ReferenceSummationMetric);
+
+  using Self = ReferenceSummationMetric;
+  using Superclass = BaseMetricType;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+  using DenseThreaderType =
+    ReferenceSummationThreader<itk::ThreadedImageRegionPartitioner<Superclass::VirtualImageDimension>>;
+  using SparseThreaderType = ReferenceSummationThreader<itk::ThreadedIndexedContainerPartitioner>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ReferenceSummationMetric, MeanSquaresImageToImageMetricv4);
+
+  const DenseThreaderType *
+  GetDenseThreader() const
+  {
+    return m_DenseThreader;
+  }
+  const SparseThreaderType *
+  GetSparseThreader() const
+  {
+    return m_SparseThreader;
+  }
+
+protected:
+  ReferenceSummationMetric()
+  {
+    m_DenseThreader = DenseThreaderType::New();
+    m_SparseThreader = SparseThreaderType::New();
+    this->m_DenseGetValueAndDerivativeThreader = m_DenseThreader;
+    this->m_SparseGetValueAndDerivativeThreader = m_SparseThreader;
+  }
+  ~ReferenceSummationMetric() override = default;
+
+private:
+  DenseThreaderType::Pointer  m_DenseThreader;
+  SparseThreaderType::Pointer m_SparseThreader;
+};
+
+ImageType::Pointer
+MakeImage(double shift)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { 160, 150 } });
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - 80.0 - shift;
+    const double y = it.GetIndex()[1] - 75.0 + 0.5 * shift;
+    it.Set(static_cast<float>(1000.0 * std::exp(-(x * x + 2.0 * y * y) / 2000.0) + 20.0 * std::sin(0.7 * x) +
+                              3.0 * x));
+  }
+  return image;
+}
+
+} // namespace
+
+int
+itkImageToImageMetricv4DerivativeSummationTest(int, char *[])
+{
+  const auto fixedImage = MakeImage(0.0);
+  const auto movingImage = MakeImage(3.5);
+
+  auto transform = TransformType::New();
+  auto parameters = transform->GetParameters();
+  parameters[0] = 1.02;
+  parameters[1] = 0.03;
+  parameters[4] = 1.7;
+  parameters[5] = -0.6;
+  transform->SetParameters(parameters);
+
+  using PointSetType = ReferenceSummationMetric::FixedSampledPointSetType;
+  auto          pointSet = PointSetType::New();
+  unsigned long pointId = 0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    if ((it.GetIndex()[0] + 2 * it.GetIndex()[1]) % 3 == 0)
+    {
+      PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      pointSet->SetPoint(pointId++, point);
+    }
+  }
+
+  int status = EXIT_SUCCESS;
+  for (bool useSampling : { false, true })
+  {
+    ReferenceSummationMetric::DerivativeType firstDerivative;
+    for (itk::ThreadIdType numberOfWorkUnits : { 1, 5 })
+    {
+      auto metric = ReferenceSummationMetric::New();
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetMovingTransform(transform);
+      metric->SetMaximumNumberOfWorkUnits(numberOfWorkUnits);
+      if (useSampling)
+      {
+        metric->SetFixedSampledPointSet(pointSet);
+        metric->SetUseSampledPointSet(true);
+      }
+      ITK_TRY_EXPECT_NO_EXCEPTION(metric->Initialize());
+
+      ReferenceSummationMetric::MeasureType    value;
+      ReferenceSummationMetric::DerivativeType derivative;
+      metric->GetValueAndDerivative(value, derivative);
+      std::cout << (useSampling ? "Sparse, " : "Dense, ") << numberOfWorkUnits
+                << " work units: " << metric->GetNumberOfValidPoints() << " points, derivative " << derivative
+                << std::endl;
+      ITK_TEST_EXPECT_TRUE(metric->GetNumberOfValidPoints() > 1000);
+
+      const auto & reference = useSampling ? metric->GetSparseThreader()->m_ReferenceDerivative
+                                           : metric->GetDenseThreader()->m_ReferenceDerivative;
+      const auto & absolute = useSampling ? metric->GetSparseThreader()->m_AbsoluteDerivative
+                                          : metric->GetDenseThreader()->m_AbsoluteDerivative;
+      if (firstDerivative.Size() == 0)
+      {
+        firstDerivative = derivative;
+      }
+      for (unsigned int p = 0; p < derivative.Size(); ++p)
+      {
+        // The plain sum of a block of n points is within (n - 1) epsilon of
+        // the sum of the absolute values of its terms
+        const double tolerance = 1e-13 * absolute[p];
+        if (std::abs(derivative[p] - reference[p]) > tolerance ||
+            std::abs(derivative[p] - firstDerivative[p]) > 2.0 * tolerance)
+        {
+          std::cerr << "The derivative " << derivative[p] << " of parameter " << p << " differs from the per point sum "
+                    << reference[p] << " or from the single work unit sum " << firstDerivative[p]
+                    << " by more than " << tolerance << std::endl;
+          status = EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Compare the values and derivatives of metrics evaluated with and without
+ * the fixed sample cache, with dense and sparse sampling, over several
+ * moving transform parameters and after a change of the fixed transform.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using MovingTransformType = itk::AffineTransform<double, Dimension>;
+using FixedTransformType = itk::TranslationTransform<double, Dimension>;
+using GradientSourceEnum = itk::ObjectToObjectMetricBaseTemplateEnums::GradientSource;
+
+ImageType::Pointer
+MakeImage(double shift)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { 48, 41 } });
+  image->SetRegions(region);
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.2;
+  spacing[1] = 0.9;
+  image->SetSpacing(spacing);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - 24.0 - shift;
+    const double y = it.GetIndex()[1] - 20.0 + 0.5 * shift;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + 2.0 * y * y) / 150.0) + 0.3 * x));
+  }
+  return image;
+}
+
+template <typename TMetric>
+int
+CompareCachedToUncached(const std::string & name,
+                        GradientSourceEnum  gradientSource,
+                        bool                useSampling,
+                        bool                useGradientFilter)
+{
+  std::cout << name << (useSampling ? ", sparse" : ", dense")
+            << (useGradientFilter ? ", gradient filter" : ", gradient calculator") << std::endl;
+
+  const auto fixedImage = MakeImage(0.0);
+  const auto movingImage = MakeImage(2.5);
+
+  typename TMetric::Pointer metrics[2];
+  auto                      movingTransform = MovingTransformType::New();
+  auto                      fixedTransform = FixedTransformType::New();
+  fixedTransform->SetIdentity();
+
+  using PointSetType = typename TMetric::FixedSampledPointSetType;
+  auto          pointSet = PointSetType::New();
+  unsigned long pointId = 0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    if ((it.GetIndex()[0] + 3 * it.GetIndex()[1]) % 5 == 0)
+    {
+      typename PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      pointSet->SetPoint(pointId++, point);
+    }
+  }
+
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    metrics[n] = TMetric::New();
+    metrics[n]->SetFixedImage(fixedImage);
+    metrics[n]->SetMovingImage(movingImage);
+    metrics[n]->SetFixedTransform(fixedTransform);
+    metrics[n]->SetMovingTransform(movingTransform);
+    metrics[n]->SetGradientSource(gradientSource);
+    metrics[n]->SetUseFixedImageGradientFilter(useGradientFilter);
+    metrics[n]->SetUseFixedSampleCache(n == 1);
+    if (useSampling)
+    {
+      metrics[n]->SetFixedSampledPointSet(pointSet);
+      metrics[n]->SetUseSampledPointSet(true);
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(metrics[n]->Initialize());
+  }
+  ITK_TEST_EXPECT_TRUE(metrics[1]->GetUseFixedSampleCache());
+  ITK_TEST_EXPECT_EQUAL(metrics[1]->GetFixedSampleCacheMemorySize(), 0u);
+
+  const auto compare = [&metrics](const std::string & step) {
+    typename TMetric::MeasureType    values[2];
+    typename TMetric::DerivativeType derivatives[2];
+    for (unsigned int n = 0; n < 2; ++n)
+    {
+      metrics[n]->GetValueAndDerivative(values[n], derivatives[n]);
+    }
+    if (metrics[0]->GetNumberOfValidPoints() == 0 ||
+        metrics[0]->GetNumberOfValidPoints() != metrics[1]->GetNumberOfValidPoints() ||
+        std::abs(values[0] - values[1]) > 1e-10 * (1.0 + std::abs(values[0])))
+    {
+      std::cerr << step << ": the value with the cache " << values[1] << " differs from " << values[0] << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int p = 0; p < derivatives[0].size(); ++p)
+    {
+      if (std::abs(derivatives[0][p] - derivatives[1][p]) > 1e-10 * (1.0 + std::abs(derivatives[0][p])))
+      {
+        std::cerr << step << ": the derivative with the cache " << derivatives[1] << " differs from "
+                  << derivatives[0] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    return EXIT_SUCCESS;
+  };
+
+  // Iterations of a registration
+  for (unsigned int iteration = 0; iteration < 3; ++iteration)
+  {
+    if (compare("Iteration " + std::to_string(iteration)) != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+    MovingTransformType::ParametersType parameters = movingTransform->GetParameters();
+    for (unsigned int p = 0; p < parameters.size(); ++p)
+    {
+      parameters[p] += (p < 4 ? 0.01 : 0.4) * (p % 2 == 0 ? 1.0 : -1.0);
+    }
+    movingTransform->SetParameters(parameters);
+  }
+  ITK_TEST_EXPECT_TRUE(metrics[1]->GetFixedSampleCacheMemorySize() > 0);
+
+  // The cache follows the fixed transform
+  typename FixedTransformType::OutputVectorType offset;
+  offset[0] = 1.3;
+  offset[1] = -0.7;
+  fixedTransform->Translate(offset);
+  if (compare("Fixed transform") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // And is released when it is not in use
+  metrics[1]->SetUseFixedSampleCache(false);
+  if (compare("Without the cache") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_EQUAL(metrics[1]->GetFixedSampleCacheMemorySize(), 0u);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkImageToImageMetricv4FixedSampleCacheTest(int, char *[])
+{
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using MattesMetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+  auto metric = MeanSquaresMetricType::New();
+  ITK_TEST_SET_GET_BOOLEAN(metric, UseFixedSampleCache, false);
+
+  int status = EXIT_SUCCESS;
+  for (bool useSampling : { false, true })
+  {
+    status |= CompareCachedToUncached<MeanSquaresMetricType>(
+      "Mean squares", GradientSourceEnum::GRADIENT_SOURCE_BOTH, useSampling, true);
+    status |= CompareCachedToUncached<MeanSquaresMetricType>(
+      "Mean squares", GradientSourceEnum::GRADIENT_SOURCE_BOTH, useSampling, false);
+    status |= CompareCachedToUncached<MattesMetricType>(
+      "Mattes mutual information", GradientSourceEnum::GRADIENT_SOURCE_MOVING, useSampling, true);
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Compare the values and derivatives of the Mattes mutual information metric
+ * computed with explicit and implicit PDF derivatives, for a transform with
+ * few parameters and a B-spline transform, with dense and sparse sampling.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+ImageType::Pointer
+MakeImage(double shift)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { 53, 47 } });
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - 26.0 - shift;
+    const double y = it.GetIndex()[1] - 23.0 + 0.5 * shift;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + 2.0 * y * y) / 200.0) + 0.4 * x + 10.0 * std::sin(0.2 * y)));
+  }
+  return image;
+}
+
+int
+CompareExplicitToImplicit(const std::string & name, MetricType::MovingTransformType * transform, bool useSampling)
+{
+  std::cout << name << (useSampling ? ", sparse" : ", dense") << std::endl;
+
+  const auto fixedImage = MakeImage(0.0);
+  const auto movingImage = MakeImage(3.0);
+
+  auto          pointSet = MetricType::FixedSampledPointSetType::New();
+  unsigned long pointId = 0;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    if ((it.GetIndex()[0] + 2 * it.GetIndex()[1]) % 3 == 0)
+    {
+      MetricType::FixedSampledPointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      pointSet->SetPoint(pointId++, point);
+    }
+  }
+
+  MetricType::Pointer metrics[2];
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    metrics[n] = MetricType::New();
+    metrics[n]->SetFixedImage(fixedImage);
+    metrics[n]->SetMovingImage(movingImage);
+    metrics[n]->SetMovingTransform(transform);
+    metrics[n]->SetNumberOfHistogramBins(32);
+    metrics[n]->SetUseExplicitPDFDerivatives(n == 0);
+    if (useSampling)
+    {
+      metrics[n]->SetFixedSampledPointSet(pointSet);
+      metrics[n]->SetUseSampledPointSet(true);
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(metrics[n]->Initialize());
+  }
+
+  for (unsigned int iteration = 0; iteration < 3; ++iteration)
+  {
+    MetricType::MeasureType    values[2];
+    MetricType::DerivativeType derivatives[2];
+    for (unsigned int n = 0; n < 2; ++n)
+    {
+      metrics[n]->GetValueAndDerivative(values[n], derivatives[n]);
+    }
+    if (std::abs(values[0] - values[1]) > 1e-12 * (1.0 + std::abs(values[0])) ||
+        std::abs(metrics[1]->GetValue() - values[0]) > 1e-12 * (1.0 + std::abs(values[0])))
+    {
+      std::cerr << "Iteration " << iteration << ": the value with implicit PDF derivatives " << values[1]
+                << " differs from " << values[0] << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (metrics[0]->GetNumberOfValidPoints() != metrics[1]->GetNumberOfValidPoints())
+    {
+      std::cerr << "Iteration " << iteration << ": the numbers of valid points differ" << std::endl;
+      return EXIT_FAILURE;
+    }
+    const double scale = derivatives[0].inf_norm();
+    if (scale == 0.0 || derivatives[1].size() != derivatives[0].size())
+    {
+      std::cerr << "Iteration " << iteration << ": unexpected derivative " << derivatives[0] << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int p = 0; p < derivatives[0].size(); ++p)
+    {
+      if (std::abs(derivatives[0][p] - derivatives[1][p]) > 1e-10 * scale)
+      {
+        std::cerr << "Iteration " << iteration << ": the derivative " << p << " with implicit PDF derivatives "
+                  << derivatives[1][p] << " differs from " << derivatives[0][p] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Take a step along the derivative, as a registration would
+    MetricType::DerivativeType update = derivatives[0];
+    update *= -0.5 / scale;
+    transform->UpdateTransformParameters(update);
+  }
+
+  ITK_TEST_EXPECT_TRUE(metrics[0]->GetJointPDFDerivatives().IsNotNull());
+  ITK_TEST_EXPECT_TRUE(metrics[1]->GetJointPDFDerivatives().IsNull());
+  ITK_TEST_EXPECT_TRUE(metrics[1]->GetJointPDF().IsNotNull());
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkMattesMutualInformationImageToImageMetricv4PDFDerivativesTest(int, char *[])
+{
+  auto metric = MetricType::New();
+  ITK_TEST_SET_GET_BOOLEAN(metric, UseExplicitPDFDerivatives, true);
+
+  int status = EXIT_SUCCESS;
+  for (bool useSampling : { false, true })
+  {
+    auto affine = itk::AffineTransform<double, Dimension>::New();
+    affine->Rotate2D(0.05);
+    status |= CompareExplicitToImplicit("Affine transform", affine, useSampling);
+
+    using BSplineTransformType = itk::BSplineTransform<double, Dimension, 3>;
+    auto                                         bspline = BSplineTransformType::New();
+    BSplineTransformType::PhysicalDimensionsType domainSize;
+    BSplineTransformType::MeshSizeType           meshSize;
+    domainSize[0] = 52.0;
+    domainSize[1] = 46.0;
+    meshSize.Fill(5);
+    bspline->SetTransformDomainPhysicalDimensions(domainSize);
+    bspline->SetTransformDomainMeshSize(meshSize);
+    BSplineTransformType::ParametersType parameters(bspline->GetNumberOfParameters());
+    for (unsigned int i = 0; i < parameters.size(); ++i)
+    {
+      parameters[i] = 0.8 * std::sin(0.9 * i);
+    }
+    bspline->SetParametersByValue(parameters);
+    status |= CompareExplicitToImplicit("B-spline transform", bspline, useSampling);
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
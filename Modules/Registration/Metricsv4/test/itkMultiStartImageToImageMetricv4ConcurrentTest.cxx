@@ -0,0 +1,242 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMultiStartOptimizerv4.h"
+#include "itkRegularStepGradientDescentOptimizerv4.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkCommand.h"
+#include "itkTestingMacros.h"
+
+/* Compare the results of MultiStartOptimizerv4 with sequential and
+ * concurrent start points, including a start point which fails, and
+ * check the settings of the clones of metrics and local optimizers.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using MultiStartType = itk::MultiStartOptimizerv4;
+
+ImageType::Pointer
+MakeImage(double shiftX, double shiftY)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { 48, 44 } });
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - 24.0 - shiftX;
+    const double y = it.GetIndex()[1] - 22.0 - shiftY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + y * y) / 80.0) + 40.0 * std::exp(-(x * x) / 400.0)));
+  }
+  return image;
+}
+
+struct MultiStartResult
+{
+  MultiStartType::MetricValuesListType  metricValues;
+  MultiStartType::ParametersListType    parameters;
+  MultiStartType::ParameterListSizeType bestIndex;
+  unsigned int                          numberOfIterationEvents;
+  unsigned int                          stopAfterIterationEvents;
+};
+
+template <typename TMetric>
+MultiStartResult
+RunMultiStart(itk::SizeValueType numberOfConcurrentStarts, unsigned int stopAfterIterationEvents = 0)
+{
+  auto transform = TransformType::New();
+  auto metric = TMetric::New();
+  metric->SetFixedImage(MakeImage(0.0, 0.0));
+  metric->SetMovingImage(MakeImage(3.0, -2.0));
+  metric->SetMovingTransform(transform);
+  metric->SetMaximumNumberOfWorkUnits(1);
+  metric->Initialize();
+
+  auto localOptimizer = itk::RegularStepGradientDescentOptimizerv4<double>::New();
+  localOptimizer->SetLearningRate(1.0);
+  localOptimizer->SetNumberOfIterations(40);
+  localOptimizer->SetMinimumStepLength(1e-4);
+  localOptimizer->SetReturnBestParametersAndValue(true);
+
+  // Start points around the solution, and one which leaves the moving image
+  MultiStartType::ParametersListType parametersList;
+  for (int n = 0; n < 7; ++n)
+  {
+    TransformType::ParametersType parameters(Dimension);
+    parameters[0] = -4.0 + 1.5 * n;
+    parameters[1] = 3.0 - n;
+    parametersList.push_back(parameters);
+  }
+  TransformType::ParametersType outside(Dimension);
+  outside.Fill(1000.0);
+  parametersList.insert(parametersList.begin() + 3, outside);
+
+  auto multiStart = MultiStartType::New();
+  multiStart->SetMetric(metric);
+  multiStart->SetLocalOptimizer(localOptimizer);
+  multiStart->SetParametersList(parametersList);
+  multiStart->SetNumberOfConcurrentStarts(numberOfConcurrentStarts);
+
+  MultiStartResult result;
+  result.numberOfIterationEvents = 0;
+  result.stopAfterIterationEvents = stopAfterIterationEvents;
+  auto command = itk::CStyleCommand::New();
+  command->SetClientData(&result);
+  command->SetCallback([](itk::Object * caller, const itk::EventObject &, void * clientData) {
+    auto * runResult = static_cast<MultiStartResult *>(clientData);
+    if (++runResult->numberOfIterationEvents == runResult->stopAfterIterationEvents)
+    {
+      static_cast<MultiStartType *>(caller)->StopOptimization();
+    }
+  });
+  multiStart->AddObserver(itk::IterationEvent(), command);
+
+  multiStart->StartOptimization();
+
+  result.metricValues = multiStart->GetMetricValuesList();
+  result.parameters = multiStart->GetParametersList();
+  result.bestIndex = multiStart->GetBestParametersIndex();
+  if (transform->GetParameters() != multiStart->GetBestParameters())
+  {
+    std::cerr << "The transform does not have the best parameters" << std::endl;
+    result.numberOfIterationEvents = 0;
+  }
+  return result;
+}
+
+template <typename TMetric>
+int
+CompareSequentialToConcurrent(const std::string & name)
+{
+  std::cout << name << std::endl;
+  const MultiStartResult expected = RunMultiStart<TMetric>(1);
+  if (expected.numberOfIterationEvents != 8 || expected.bestIndex == 3)
+  {
+    std::cerr << name << ": unexpected sequential results" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (itk::SizeValueType numberOfConcurrentStarts : { 3, 16 })
+  {
+    const MultiStartResult result = RunMultiStart<TMetric>(numberOfConcurrentStarts);
+    if (result.bestIndex != expected.bestIndex || result.metricValues.size() != expected.metricValues.size() ||
+        result.numberOfIterationEvents != expected.numberOfIterationEvents)
+    {
+      std::cerr << name << ", " << numberOfConcurrentStarts << " concurrent starts: the best start "
+                << result.bestIndex << " differs from " << expected.bestIndex << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int n = 0; n < expected.metricValues.size(); ++n)
+    {
+      if (std::abs(result.metricValues[n] - expected.metricValues[n]) >
+          1e-10 * (1.0 + std::abs(expected.metricValues[n])))
+      {
+        std::cerr << name << ", " << numberOfConcurrentStarts << " concurrent starts: the metric value "
+                  << result.metricValues[n] << " differs from " << expected.metricValues[n] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    for (unsigned int n = 0; n < expected.parameters.size(); ++n)
+    {
+      for (unsigned int p = 0; p < Dimension; ++p)
+      {
+        if (std::abs(result.parameters[n][p] - expected.parameters[n][p]) > 1e-8)
+        {
+          std::cerr << name << ", " << numberOfConcurrentStarts << " concurrent starts: the parameters "
+                    << result.parameters[n] << " differ from " << expected.parameters[n] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/* StopOptimization() from an iteration observer ends the concurrent starts as the sequential ones */
+int
+StopFromObserver()
+{
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  const MultiStartResult expected = RunMultiStart<MetricType>(1, 2);
+  const MultiStartResult result = RunMultiStart<MetricType>(3, 2);
+  if (expected.metricValues.size() != 2 || result.metricValues.size() != 2 || result.numberOfIterationEvents != 2 ||
+      result.bestIndex != expected.bestIndex)
+  {
+    std::cerr << "Stopping from an observer: " << result.metricValues.size() << " metric values and "
+              << result.numberOfIterationEvents << " iteration events, instead of 2" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkMultiStartImageToImageMetricv4ConcurrentTest(int, char *[])
+{
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using MattesMetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+  auto multiStart = MultiStartType::New();
+  ITK_TEST_SET_GET_VALUE(1, multiStart->GetNumberOfConcurrentStarts());
+  multiStart->SetNumberOfConcurrentStarts(0);
+  ITK_TEST_SET_GET_VALUE(1, multiStart->GetNumberOfConcurrentStarts());
+
+  // The clones have the settings of the originals, and their own moving transform
+  auto transform = TransformType::New();
+  auto metric = MattesMetricType::New();
+  metric->SetFixedImage(MakeImage(0.0, 0.0));
+  metric->SetMovingImage(MakeImage(1.0, 1.0));
+  metric->SetMovingTransform(transform);
+  metric->SetNumberOfHistogramBins(17);
+  metric->SetUseExplicitPDFDerivatives(false);
+  metric->SetUseFixedImageGradientFilter(false);
+  metric->SetMaximumNumberOfWorkUnits(2);
+  const MattesMetricType::Pointer metricClone = metric->Clone();
+  ITK_TEST_EXPECT_EQUAL(metricClone->GetNumberOfHistogramBins(), 17u);
+  ITK_TEST_EXPECT_TRUE(!metricClone->GetUseExplicitPDFDerivatives());
+  ITK_TEST_EXPECT_TRUE(!metricClone->GetUseFixedImageGradientFilter());
+  ITK_TEST_EXPECT_EQUAL(metricClone->GetMaximumNumberOfWorkUnits(), 2u);
+  ITK_TEST_EXPECT_TRUE(metricClone->GetFixedImage() == metric->GetFixedImage());
+  ITK_TEST_EXPECT_TRUE(metricClone->GetMovingTransform() != metric->GetMovingTransform());
+  ITK_TEST_EXPECT_TRUE(metricClone->GetMovingTransform()->GetParameters() == transform->GetParameters());
+
+  auto optimizer = itk::RegularStepGradientDescentOptimizerv4<double>::New();
+  optimizer->SetLearningRate(0.25);
+  optimizer->SetNumberOfIterations(13);
+  optimizer->SetRelaxationFactor(0.7);
+  const itk::RegularStepGradientDescentOptimizerv4<double>::Pointer optimizerClone = optimizer->Clone();
+  ITK_TEST_EXPECT_EQUAL(optimizerClone->GetLearningRate(), 0.25);
+  ITK_TEST_EXPECT_EQUAL(optimizerClone->GetNumberOfIterations(), 13u);
+  ITK_TEST_EXPECT_EQUAL(optimizerClone->GetRelaxationFactor(), 0.7);
+
+  int status = EXIT_SUCCESS;
+  status |= CompareSequentialToConcurrent<MeanSquaresMetricType>("Mean squares");
+  status |= CompareSequentialToConcurrent<MattesMetricType>("Mattes mutual information");
+  status |= StopFromObserver();
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_h
+#define itkBatchImageRegistrationMethodv4_h
+
+#include "itkObject.h"
+
+#include "itkImageToImageMetricv4.h"
+#include "itkObjectToObjectOptimizerBase.h"
+#include "itkRegistrationParameterScalesEstimator.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class BatchImageRegistrationMethodv4
+ * \brief Register many independent pairs of small images with the same settings.
+ *
+ * ImageRegistrationMethodv4 is set up for each pair of images it registers,
+ * which for small images, such as the tiles of a mosaic, may take longer than
+ * the optimization itself. This class registers a batch of image pairs with
+ * one metric, optimizer and initial transform, which are set once:
+ *
+ *   \li The metric, the optimizer and the initial transform are cloned (see
+ *       LightObject::Clone()) for each registration which runs concurrently,
+ *       and these clones are reused from one pair to the next, and from one
+ *       call of StartRegistration() to the next while the settings do not
+ *       change. The interpolators, gradient filters and gradient calculators
+ *       of the metric are created anew for each clone, with their default
+ *       settings.
+ *   \li The optional scales estimator is cloned as well, and replaces the
+ *       scales estimator of the optimizer. When EstimateScalesOnce is on, the
+ *       default, the scales are estimated with the first pair and used for
+ *       all the pairs, which assumes that the images of the pairs have the
+ *       same size and spacing. When the estimation throws an exception for a
+ *       pair, that pair is marked as failed and the next pair is used. The
+ *       estimator is still used by the optimizer for the learning rate.
+ *   \li The pairs are distributed over NumberOfWorkUnits concurrent
+ *       registrations, or one per pair when there are fewer pairs, which run
+ *       as tasks of the WorkStealingThreadPool. When there is more than one,
+ *       each registration runs in a single thread.
+ *
+ * Each registration starts from the parameters of the initial transform, and
+ * its results are available by pair index. The registration of a pair which
+ * throws an exception is marked as failed, and does not stop the batch.
+ *
+ * Masks, sampled point sets and virtual domains set on the metric are shared
+ * by all the pairs. Multiple levels and stages are not supported: use
+ * ImageRegistrationMethodv4 for those.
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TTransform = Transform<double, TFixedImage::ImageDimension, TFixedImage::ImageDimension>,
+          typename TVirtualImage = TFixedImage>
+class ITK_TEMPLATE_EXPORT BatchImageRegistrationMethodv4 : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(BatchImageRegistrationMethodv4);
+
+  /** Standard class type aliases. */
+  using Self = BatchImageRegistrationMethodv4;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** ImageDimension constants */
+  static constexpr unsigned int ImageDimension = TFixedImage::ImageDimension;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BatchImageRegistrationMethodv4, Object);
+
+  /** Input type alias for the images and transforms. */
+  using FixedImageType = TFixedImage;
+  using FixedImageConstPointer = typename FixedImageType::ConstPointer;
+  using FixedImagesContainerType = std::vector<FixedImageConstPointer>;
+  using MovingImageType = TMovingImage;
+  using MovingImageConstPointer = typename MovingImageType::ConstPointer;
+  using MovingImagesContainerType = std::vector<MovingImageConstPointer>;
+  using VirtualImageType = TVirtualImage;
+
+  using TransformType = TTransform;
+  using TransformPointer = typename TransformType::Pointer;
+  using RealType = typename TransformType::ScalarType;
+  using ParametersType = typename TransformType::ParametersType;
+  using ParametersContainerType = std::vector<ParametersType>;
+
+  using ImageMetricType = ImageToImageMetricv4<FixedImageType, MovingImageType, VirtualImageType, RealType>;
+  using ImageMetricPointer = typename ImageMetricType::Pointer;
+  using MeasureType = typename ImageMetricType::MeasureType;
+  using MeasuresContainerType = std::vector<MeasureType>;
+
+  using OptimizerType = ObjectToObjectOptimizerBaseTemplate<RealType>;
+  using OptimizerPointer = typename OptimizerType::Pointer;
+  using ScalesType = typename OptimizerType::ScalesType;
+
+  using ScalesEstimatorType = RegistrationParameterScalesEstimator<ImageMetricType>;
+  using ScalesEstimatorPointer = typename ScalesEstimatorType::Pointer;
+
+  /** Add a pair of images to register. */
+  void
+  AddImagePair(const FixedImageType * fixedImage, const MovingImageType * movingImage);
+
+  /** Set the pair of images of an index, adding pairs up to it if needed. */
+  void
+  SetImagePair(SizeValueType index, const FixedImageType * fixedImage, const MovingImageType * movingImage);
+
+  /** Get the images of a pair. */
+  const FixedImageType *
+  GetFixedImage(SizeValueType index) const;
+  const MovingImageType *
+  GetMovingImage(SizeValueType index) const;
+
+  /** Get the number of pairs of images to register. */
+  SizeValueType
+  GetNumberOfImagePairs() const
+  {
+    return static_cast<SizeValueType>(this->m_FixedImages.size());
+  }
+
+  /** Remove all the pairs of images, and the results of their registration. */
+  void
+  ClearImagePairs();
+
+  /** Set/Get the metric. Defaults to Mattes mutual information. */
+  itkSetObjectMacro(Metric, ImageMetricType);
+  itkGetModifiableObjectMacro(Metric, ImageMetricType);
+
+  /** Set/Get the optimizer. Defaults to gradient descent. */
+  itkSetObjectMacro(Optimizer, OptimizerType);
+  itkGetModifiableObjectMacro(Optimizer, OptimizerType);
+
+  /** Set/Get the scales estimator. Defaults to scales from physical shifts. */
+  itkSetObjectMacro(ScalesEstimator, ScalesEstimatorType);
+  itkGetModifiableObjectMacro(ScalesEstimator, ScalesEstimatorType);
+
+  /** Set/Get the transform which each registration starts from. Required. */
+  itkSetObjectMacro(InitialTransform, TransformType);
+  itkGetModifiableObjectMacro(InitialTransform, TransformType);
+
+  /** Set/Get whether the scales are estimated once for the batch, rather
+   * than for each pair. Default is on. */
+  itkSetMacro(EstimateScalesOnce, bool);
+  itkGetConstMacro(EstimateScalesOnce, bool);
+  itkBooleanMacro(EstimateScalesOnce);
+
+  /** Set/Get the number of registrations which run concurrently. Defaults to
+   * the global default number of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** Register all the pairs of images. */
+  virtual void
+  StartRegistration();
+
+  /** Get the parameters of the transform found for a pair. */
+  const ParametersType &
+  GetTransformParameters(SizeValueType index) const;
+
+  /** Get the metric value at the last iteration of the registration of a pair. */
+  MeasureType
+  GetMetricValue(SizeValueType index) const;
+
+  /** Whether the registration of a pair threw an exception. */
+  bool
+  GetRegistrationFailed(SizeValueType index) const;
+
+  /** Get the number of registrations of the last batch which failed. */
+  itkGetConstMacro(NumberOfFailedRegistrations, SizeValueType);
+
+  /** Get the scales used by the last batch when EstimateScalesOnce is on. */
+  itkGetConstReferenceMacro(Scales, ScalesType);
+
+protected:
+  BatchImageRegistrationMethodv4();
+  ~BatchImageRegistrationMethodv4() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The objects used by one of the concurrent registrations. */
+  struct RegistrationContext
+  {
+    ImageMetricPointer     metric;
+    TransformPointer       transform;
+    OptimizerPointer       optimizer;
+    ScalesEstimatorPointer scalesEstimator;
+  };
+
+  /** Create the clones of the metric, the optimizer, the transform and the
+   * scales estimator for a concurrent registration. */
+  virtual RegistrationContext
+  CreateRegistrationContext(bool concurrent) const;
+
+  /** Register a pair of images with the objects of a context. */
+  virtual void
+  RegisterImagePair(RegistrationContext & context, SizeValueType index);
+
+private:
+  /** Create an object of the same type, with its default settings. */
+  template <typename TObject>
+  static typename TObject::Pointer
+  CreateAnotherOf(TObject * object)
+  {
+    if (object == nullptr)
+    {
+      return nullptr;
+    }
+    return dynamic_cast<TObject *>(object->CreateAnother().GetPointer());
+  }
+
+  /** Whether the contexts are older than the settings. */
+  bool
+  RegistrationContextsAreOutOfDate(SizeValueType numberOfContexts) const;
+
+  FixedImagesContainerType  m_FixedImages;
+  MovingImagesContainerType m_MovingImages;
+
+  ImageMetricPointer     m_Metric;
+  OptimizerPointer       m_Optimizer;
+  ScalesEstimatorPointer m_ScalesEstimator;
+  TransformPointer       m_InitialTransform;
+  bool                   m_EstimateScalesOnce{ true };
+  ThreadIdType           m_NumberOfWorkUnits;
+
+  std::vector<RegistrationContext> m_RegistrationContexts;
+  TimeStamp                        m_RegistrationContextsTime;
+
+  ScalesType              m_Scales;
+  ParametersContainerType m_TransformParameters;
+  MeasuresContainerType   m_MetricValues;
+  std::vector<bool>       m_RegistrationFailed;
+  SizeValueType           m_NumberOfFailedRegistrations{ 0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkBatchImageRegistrationMethodv4.hxx"
+#endif
+
+#endif
@@ -0,0 +1,412 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_hxx
+#define itkBatchImageRegistrationMethodv4_hxx
+
+#include "itkBatchImageRegistrationMethodv4.h"
+
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <atomic>
+
+namespace itk
+{
+/**
+ * Constructor
+ */
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::BatchImageRegistrationMethodv4()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+{
+  using DefaultMetricType =
+    MattesMutualInformationImageToImageMetricv4<FixedImageType, MovingImageType, VirtualImageType, RealType>;
+  typename DefaultMetricType::Pointer mutualInformationMetric = DefaultMetricType::New();
+  mutualInformationMetric->SetNumberOfHistogramBins(20);
+  mutualInformationMetric->SetUseMovingImageGradientFilter(false);
+  mutualInformationMetric->SetUseFixedImageGradientFilter(false);
+  this->m_Metric = mutualInformationMetric;
+
+  using DefaultScalesEstimatorType = RegistrationParameterScalesFromPhysicalShift<ImageMetricType>;
+  typename DefaultScalesEstimatorType::Pointer scalesEstimator = DefaultScalesEstimatorType::New();
+  scalesEstimator->SetTransformForward(true);
+  this->m_ScalesEstimator = scalesEstimator;
+
+  using DefaultOptimizerType = GradientDescentOptimizerv4Template<RealType>;
+  typename DefaultOptimizerType::Pointer optimizer = DefaultOptimizerType::New();
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetNumberOfIterations(100);
+  this->m_Optimizer = optimizer;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::AddImagePair(
+  const FixedImageType *  fixedImage,
+  const MovingImageType * movingImage)
+{
+  this->SetImagePair(this->GetNumberOfImagePairs(), fixedImage, movingImage);
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::SetImagePair(
+  SizeValueType           index,
+  const FixedImageType *  fixedImage,
+  const MovingImageType * movingImage)
+{
+  if (fixedImage == nullptr || movingImage == nullptr)
+  {
+    itkExceptionMacro("The images of pair " << index << " must be set.");
+  }
+  if (index >= this->GetNumberOfImagePairs())
+  {
+    this->m_FixedImages.resize(index + 1);
+    this->m_MovingImages.resize(index + 1);
+  }
+  // The pairs are not settings of the registrations, and do not modify this object
+  this->m_FixedImages[index] = fixedImage;
+  this->m_MovingImages[index] = movingImage;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+auto
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::GetFixedImage(
+  SizeValueType index) const -> const FixedImageType *
+{
+  if (index >= this->GetNumberOfImagePairs())
+  {
+    itkExceptionMacro("There is no image pair " << index << '.');
+  }
+  return this->m_FixedImages[index];
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+auto
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::GetMovingImage(
+  SizeValueType index) const -> const MovingImageType *
+{
+  if (index >= this->GetNumberOfImagePairs())
+  {
+    itkExceptionMacro("There is no image pair " << index << '.');
+  }
+  return this->m_MovingImages[index];
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::ClearImagePairs()
+{
+  this->m_FixedImages.clear();
+  this->m_MovingImages.clear();
+  this->m_TransformParameters.clear();
+  this->m_MetricValues.clear();
+  this->m_RegistrationFailed.clear();
+  this->m_NumberOfFailedRegistrations = 0;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+auto
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::GetTransformParameters(
+  SizeValueType index) const -> const ParametersType &
+{
+  if (index >= this->m_TransformParameters.size())
+  {
+    itkExceptionMacro("Image pair " << index << " has not been registered.");
+  }
+  return this->m_TransformParameters[index];
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+auto
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::GetMetricValue(
+  SizeValueType index) const -> MeasureType
+{
+  if (index >= this->m_MetricValues.size())
+  {
+    itkExceptionMacro("Image pair " << index << " has not been registered.");
+  }
+  return this->m_MetricValues[index];
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+bool
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::GetRegistrationFailed(
+  SizeValueType index) const
+{
+  if (index >= this->m_RegistrationFailed.size())
+  {
+    itkExceptionMacro("Image pair " << index << " has not been registered.");
+  }
+  return this->m_RegistrationFailed[index];
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+bool
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::
+  RegistrationContextsAreOutOfDate(SizeValueType numberOfContexts) const
+{
+  if (this->m_RegistrationContexts.size() != numberOfContexts)
+  {
+    return true;
+  }
+  // The parameters of the initial transform are copied at each pair, and may change
+  const ModifiedTimeType contextsTime = this->m_RegistrationContextsTime.GetMTime();
+  return this->GetMTime() > contextsTime || this->m_Metric->GetMTime() > contextsTime ||
+         this->m_Optimizer->GetMTime() > contextsTime ||
+         (this->m_ScalesEstimator && this->m_ScalesEstimator->GetMTime() > contextsTime);
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+auto
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::CreateRegistrationContext(
+  bool concurrent) const -> RegistrationContext
+{
+  RegistrationContext context;
+
+  /* The interpolators, gradient filters and gradient calculators are set up for the
+   * images of each pair, so the clone of the metric must not share them. */
+  context.metric = dynamic_cast<ImageMetricType *>(this->m_Metric->Clone().GetPointer());
+  if (context.metric.IsNull())
+  {
+    itkExceptionMacro("The metric " << this->m_Metric->GetNameOfClass() << " could not be cloned.");
+  }
+  context.metric->SetFixedInterpolator(CreateAnotherOf(this->m_Metric->GetModifiableFixedInterpolator()));
+  context.metric->SetMovingInterpolator(CreateAnotherOf(this->m_Metric->GetModifiableMovingInterpolator()));
+  context.metric->SetFixedImageGradientFilter(
+    CreateAnotherOf(this->m_Metric->GetModifiableFixedImageGradientFilter()));
+  context.metric->SetMovingImageGradientFilter(
+    CreateAnotherOf(this->m_Metric->GetModifiableMovingImageGradientFilter()));
+  context.metric->SetFixedImageGradientCalculator(
+    CreateAnotherOf(this->m_Metric->GetModifiableFixedImageGradientCalculator()));
+  context.metric->SetMovingImageGradientCalculator(
+    CreateAnotherOf(this->m_Metric->GetModifiableMovingImageGradientCalculator()));
+
+  context.transform = dynamic_cast<TransformType *>(this->m_InitialTransform->Clone().GetPointer());
+  if (context.transform.IsNull())
+  {
+    itkExceptionMacro("The transform " << this->m_InitialTransform->GetNameOfClass() << " could not be cloned.");
+  }
+  context.metric->SetMovingTransform(context.transform);
+
+  context.optimizer = dynamic_cast<OptimizerType *>(this->m_Optimizer->Clone().GetPointer());
+  if (context.optimizer.IsNull())
+  {
+    itkExceptionMacro("The optimizer " << this->m_Optimizer->GetNameOfClass() << " could not be cloned.");
+  }
+  context.optimizer->SetMetric(context.metric);
+
+  if (this->m_ScalesEstimator)
+  {
+    context.scalesEstimator = dynamic_cast<ScalesEstimatorType *>(this->m_ScalesEstimator->Clone().GetPointer());
+    if (context.scalesEstimator.IsNull())
+    {
+      itkExceptionMacro("The scales estimator " << this->m_ScalesEstimator->GetNameOfClass()
+                                                << " could not be cloned.");
+    }
+    context.scalesEstimator->SetMetric(context.metric);
+  }
+  context.optimizer->SetScalesEstimator(context.scalesEstimator);
+
+  if (concurrent)
+  {
+    context.metric->SetMaximumNumberOfWorkUnits(1);
+    context.optimizer->SetNumberOfWorkUnits(1);
+    if (context.scalesEstimator)
+    {
+      context.scalesEstimator->SetNumberOfWorkUnits(1);
+    }
+  }
+  return context;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::RegisterImagePair(
+  RegistrationContext & context,
+  SizeValueType         index)
+{
+  context.metric->SetFixedImage(this->m_FixedImages[index]);
+  context.metric->SetMovingImage(this->m_MovingImages[index]);
+  context.transform->SetFixedParameters(this->m_InitialTransform->GetFixedParameters());
+  context.transform->SetParameters(this->m_InitialTransform->GetParameters());
+  context.metric->Initialize();
+
+  context.optimizer->StartOptimization();
+
+  this->m_TransformParameters[index] = context.transform->GetParameters();
+  this->m_MetricValues[index] = context.optimizer->GetValue();
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::StartRegistration()
+{
+  if (this->m_Metric.IsNull() || this->m_Optimizer.IsNull())
+  {
+    itkExceptionMacro("The metric and the optimizer must be set.");
+  }
+  if (this->m_InitialTransform.IsNull())
+  {
+    itkExceptionMacro("The initial transform must be set.");
+  }
+
+  const SizeValueType numberOfPairs = this->GetNumberOfImagePairs();
+  this->m_TransformParameters.assign(numberOfPairs, this->m_InitialTransform->GetParameters());
+  this->m_MetricValues.assign(numberOfPairs, NumericTraits<MeasureType>::max());
+  this->m_RegistrationFailed.assign(numberOfPairs, true);
+  this->m_NumberOfFailedRegistrations = numberOfPairs;
+  if (numberOfPairs == 0)
+  {
+    return;
+  }
+
+  /* One registration per work unit, but no more than the pairs. The clones are
+   * kept from one batch to the next, until the settings change */
+  const SizeValueType numberOfTasks = std::min(static_cast<SizeValueType>(this->m_NumberOfWorkUnits), numberOfPairs);
+  if (this->RegistrationContextsAreOutOfDate(numberOfTasks))
+  {
+    this->m_RegistrationContexts.clear();
+    for (SizeValueType task = 0; task < numberOfTasks; ++task)
+    {
+      this->m_RegistrationContexts.push_back(this->CreateRegistrationContext(numberOfTasks > 1));
+    }
+    this->m_RegistrationContextsTime.Modified();
+  }
+
+  /* The scales depend on the geometry of the images and on the transform, which
+   * are the same for all the pairs, rather than on the intensities. They are
+   * estimated with the first pair for which the estimation succeeds, and the
+   * pairs before it are marked as failed, without being registered */
+  SizeValueType firstPair = 0;
+  if (this->m_EstimateScalesOnce && this->m_ScalesEstimator)
+  {
+    // The gradient descent optimizers estimate their maximum step size along with the scales
+    using GradientDescentOptimizerType = GradientDescentOptimizerv4Template<RealType>;
+    const auto * gradientDescentOptimizer =
+      dynamic_cast<const GradientDescentOptimizerType *>(this->m_Optimizer.GetPointer());
+    const bool estimateMaximumStepSize =
+      gradientDescentOptimizer != nullptr &&
+      gradientDescentOptimizer->GetMaximumStepSizeInPhysicalUnits() <= NumericTraits<RealType>::epsilon();
+    RealType maximumStepSize = 0;
+
+    RegistrationContext & context = this->m_RegistrationContexts[0];
+    for (; firstPair < numberOfPairs; ++firstPair)
+    {
+      try
+      {
+        context.metric->SetFixedImage(this->m_FixedImages[firstPair]);
+        context.metric->SetMovingImage(this->m_MovingImages[firstPair]);
+        context.transform->SetFixedParameters(this->m_InitialTransform->GetFixedParameters());
+        context.transform->SetParameters(this->m_InitialTransform->GetParameters());
+        context.metric->Initialize();
+        context.scalesEstimator->EstimateScales(this->m_Scales);
+        if (estimateMaximumStepSize)
+        {
+          maximumStepSize = context.scalesEstimator->EstimateMaximumStepSize();
+        }
+        break;
+      }
+      catch (ExceptionObject &)
+      {
+        // Counted below
+      }
+    }
+
+    for (auto & registrationContext : this->m_RegistrationContexts)
+    {
+      registrationContext.optimizer->SetScales(this->m_Scales);
+      registrationContext.optimizer->SetDoEstimateScales(false);
+      if (estimateMaximumStepSize)
+      {
+        dynamic_cast<GradientDescentOptimizerType *>(registrationContext.optimizer.GetPointer())
+          ->SetMaximumStepSizeInPhysicalUnits(maximumStepSize);
+      }
+    }
+  }
+
+  /* Each task takes the next pair until there are none left */
+  std::vector<unsigned char> succeeded(numberOfPairs, 0);
+  std::atomic<SizeValueType> nextPair{ firstPair };
+  const auto                 registerImagePairs = [&](SizeValueType contextIndex) {
+    RegistrationContext & context = this->m_RegistrationContexts[contextIndex];
+    for (SizeValueType pair = nextPair++; pair < numberOfPairs; pair = nextPair++)
+    {
+      try
+      {
+        this->RegisterImagePair(context, pair);
+        succeeded[pair] = 1;
+      }
+      catch (ExceptionObject &)
+      {
+        // Counted below
+      }
+    }
+  };
+
+  if (numberOfTasks == 1)
+  {
+    registerImagePairs(0);
+  }
+  else
+  {
+    const WorkStealingThreadPool::Pointer pool = WorkStealingThreadPool::GetInstance();
+    WorkStealingThreadPool::TaskGroup     group;
+    for (SizeValueType task = 0; task < numberOfTasks; ++task)
+    {
+      pool->AddWork(group, [&registerImagePairs, task]() { registerImagePairs(task); });
+    }
+    pool->Wait(group);
+  }
+
+  this->m_NumberOfFailedRegistrations = 0;
+  for (SizeValueType pair = 0; pair < numberOfPairs; ++pair)
+  {
+    this->m_RegistrationFailed[pair] = !succeeded[pair];
+    this->m_NumberOfFailedRegistrations += succeeded[pair] ? 0 : 1;
+  }
+  if (this->m_NumberOfFailedRegistrations > 0)
+  {
+    itkWarningMacro("The registration of " << this->m_NumberOfFailedRegistrations << " of " << numberOfPairs
+                                           << " image pairs failed.");
+  }
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+BatchImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>::PrintSelf(std::ostream & os,
+                                                                                                Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfImagePairs: " << this->GetNumberOfImagePairs() << std::endl;
+  itkPrintSelfObjectMacro(Metric);
+  itkPrintSelfObjectMacro(Optimizer);
+  itkPrintSelfObjectMacro(ScalesEstimator);
+  itkPrintSelfObjectMacro(InitialTransform);
+  os << indent << "EstimateScalesOnce: " << this->m_EstimateScalesOnce << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "NumberOfFailedRegistrations: " << this->m_NumberOfFailedRegistrations << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkRegularStepGradientDescentOptimizerv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Report the throughput, in pairs per second, of the registration of many
+ * small image pairs with one ImageRegistrationMethodv4 per pair, and with
+ * BatchImageRegistrationMethodv4 with one and all the work units.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+using OptimizerType = itk::RegularStepGradientDescentOptimizerv4<double>;
+using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+
+constexpr unsigned int NumberOfIterations = 100;
+
+OptimizerType::Pointer
+MakeOptimizer()
+{
+  auto optimizer = OptimizerType::New();
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetMinimumStepLength(1e-3);
+  optimizer->SetNumberOfIterations(NumberOfIterations);
+  return optimizer;
+}
+
+ImageType::Pointer
+MakeTile(unsigned int tileSize, double shiftX, double shiftY)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { tileSize, tileSize } });
+  image->SetRegions(region);
+  image->Allocate();
+  const double center = 0.5 * tileSize;
+  const double width = 0.05 * tileSize * tileSize;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - center - shiftX;
+    const double y = it.GetIndex()[1] - center - shiftY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + 1.5 * y * y) / width) +
+                              30.0 * std::exp(-((x - 4.0) * (x - 4.0) + y * y) / (0.3 * width))));
+  }
+  return image;
+}
+
+void
+ReportThroughput(const char * name, unsigned int numberOfPairs, const itk::TimeProbe & probe)
+{
+  std::cout << name << ": " << probe.GetTotal() << " s, " << numberOfPairs / probe.GetTotal() << " pairs/s"
+            << std::endl;
+}
+
+} // namespace
+
+int
+itkBatchImageRegistrationMethodv4SpeedTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " numberOfPairs tileSize" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto numberOfPairs = static_cast<unsigned int>(std::stoi(argv[1]));
+  const auto tileSize = static_cast<unsigned int>(std::stoi(argv[2]));
+  std::cout << "pairs: " << numberOfPairs << ", tile size: " << tileSize << std::endl;
+
+  std::vector<ImageType::Pointer> fixedImages;
+  std::vector<ImageType::Pointer> movingImages;
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    fixedImages.push_back(MakeTile(tileSize, 0.0, 0.0));
+    movingImages.push_back(MakeTile(tileSize, 2.0 * std::sin(1.3 * pair), -1.5 * std::cos(0.7 * pair)));
+  }
+
+  // One registration method per pair
+  std::vector<TransformType::ParametersType> perPairParameters;
+  itk::TimeProbe                             perPairProbe;
+  perPairProbe.Start();
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    auto metric = MetricType::New();
+    metric->SetNumberOfHistogramBins(20);
+    metric->SetUseFixedImageGradientFilter(false);
+    metric->SetUseMovingImageGradientFilter(false);
+
+    auto scalesEstimator = ScalesEstimatorType::New();
+    scalesEstimator->SetMetric(metric);
+    scalesEstimator->SetTransformForward(true);
+
+    const OptimizerType::Pointer optimizer = MakeOptimizer();
+    optimizer->SetScalesEstimator(scalesEstimator);
+
+    using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+    auto registration = RegistrationType::New();
+    registration->SetFixedImage(fixedImages[pair]);
+    registration->SetMovingImage(movingImages[pair]);
+    registration->SetMetric(metric);
+    registration->SetOptimizer(optimizer);
+    registration->SetNumberOfLevels(1);
+    registration->SetShrinkFactorsPerLevel(RegistrationType::ShrinkFactorsArrayType(1, 1));
+    registration->SetSmoothingSigmasPerLevel(RegistrationType::SmoothingSigmasArrayType(1, 0.0));
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+    perPairParameters.push_back(registration->GetTransform()->GetParameters());
+  }
+  perPairProbe.Stop();
+  ReportThroughput("ImageRegistrationMethodv4 per pair", numberOfPairs, perPairProbe);
+
+  // One batch, with one and all the work units
+  using BatchRegistrationType = itk::BatchImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+  auto batchRegistration = BatchRegistrationType::New();
+  auto transform = TransformType::New();
+  transform->SetIdentity();
+  batchRegistration->SetInitialTransform(transform);
+  batchRegistration->SetOptimizer(MakeOptimizer());
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    batchRegistration->AddImagePair(fixedImages[pair], movingImages[pair]);
+  }
+
+  std::vector<itk::ThreadIdType> numbersOfWorkUnits{ 1 };
+  if (batchRegistration->GetNumberOfWorkUnits() > 1)
+  {
+    numbersOfWorkUnits.push_back(batchRegistration->GetNumberOfWorkUnits());
+  }
+  for (itk::ThreadIdType numberOfWorkUnits : numbersOfWorkUnits)
+  {
+    batchRegistration->SetNumberOfWorkUnits(numberOfWorkUnits);
+    itk::TimeProbe batchProbe;
+    batchProbe.Start();
+    ITK_TRY_EXPECT_NO_EXCEPTION(batchRegistration->StartRegistration());
+    batchProbe.Stop();
+    const std::string name = "BatchImageRegistrationMethodv4, " + std::to_string(numberOfWorkUnits) + " work units";
+    ReportThroughput(name.c_str(), numberOfPairs, batchProbe);
+    ITK_TEST_EXPECT_EQUAL(batchRegistration->GetNumberOfFailedRegistrations(), 0u);
+  }
+
+  // The batch finds the translations of the separate registrations
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    for (unsigned int p = 0; p < Dimension; ++p)
+    {
+      if (std::abs(batchRegistration->GetTransformParameters(pair)[p] - perPairParameters[pair][p]) > 0.05)
+      {
+        std::cerr << "Pair " << pair << ": the batch registration " << batchRegistration->GetTransformParameters(pair)
+                  << " differs from " << perPairParameters[pair] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
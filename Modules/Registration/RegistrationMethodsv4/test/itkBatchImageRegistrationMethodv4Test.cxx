@@ -0,0 +1,270 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMetaDataObject.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkRegularStepGradientDescentOptimizerv4.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Register a batch of tile pairs with known translations, with one and
+ * several concurrent registrations, including a pair which does not overlap,
+ * for which the mutual information fails.
+ */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::BatchImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+
+ImageType::Pointer
+MakeTile(unsigned int seed, double shiftX, double shiftY)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(ImageType::SizeType{ { 40, 36 } });
+  image->SetRegions(region);
+  image->Allocate();
+  const double centerX = 18.0 + (seed % 5);
+  const double centerY = 16.0 + (seed % 3);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - centerX - shiftX;
+    const double y = it.GetIndex()[1] - centerY - shiftY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + 1.5 * y * y) / 60.0) +
+                              30.0 * std::exp(-((x - 6.0) * (x - 6.0) + y * y) / 20.0)));
+  }
+  return image;
+}
+
+double
+ShiftX(unsigned int pair)
+{
+  return 2.5 * std::sin(1.3 * pair);
+}
+
+double
+ShiftY(unsigned int pair)
+{
+  return -2.0 * std::cos(0.7 * pair);
+}
+
+/** Registration which counts the contexts it creates. */
+class ContextCountingRegistration : public RegistrationType
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ContextCountingRegistration);
+
+  using Self = ContextCountingRegistration;
+  using Superclass = RegistrationType;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ContextCountingRegistration, BatchImageRegistrationMethodv4);
+
+  mutable unsigned int m_NumberOfCreatedContexts{ 0 };
+
+protected:
+  ContextCountingRegistration() = default;
+  ~ContextCountingRegistration() override = default;
+
+  RegistrationContext
+  CreateRegistrationContext(bool concurrent) const override
+  {
+    ++m_NumberOfCreatedContexts;
+    return Superclass::CreateRegistrationContext(concurrent);
+  }
+};
+
+using PhysicalShiftScalesEstimatorType =
+  itk::RegistrationParameterScalesFromPhysicalShift<RegistrationType::ImageMetricType>;
+
+/** Scales estimator which fails for the fixed images flagged in their meta data. */
+class FailingScalesEstimator : public PhysicalShiftScalesEstimatorType
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FailingScalesEstimator);
+
+  using Self = FailingScalesEstimator;
+  using Superclass = PhysicalShiftScalesEstimatorType;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(FailingScalesEstimator, RegistrationParameterScalesFromPhysicalShift);
+
+  void
+  EstimateScales(ScalesType & scales) override
+  {
+    if (this->m_Metric->GetFixedImage()->GetMetaDataDictionary().HasKey("FailScales"))
+    {
+      itkExceptionMacro("The scales of this pair cannot be estimated.");
+    }
+    Superclass::EstimateScales(scales);
+  }
+
+protected:
+  FailingScalesEstimator() = default;
+  ~FailingScalesEstimator() override = default;
+};
+
+int
+CheckRegistrations(const RegistrationType * registration, unsigned int outsidePair, bool outsidePairFails)
+{
+  ITK_TEST_EXPECT_EQUAL(registration->GetNumberOfFailedRegistrations(), outsidePairFails ? 1u : 0u);
+  for (unsigned int pair = 0; pair < registration->GetNumberOfImagePairs(); ++pair)
+  {
+    if (pair == outsidePair)
+    {
+      ITK_TEST_EXPECT_EQUAL(registration->GetRegistrationFailed(pair), outsidePairFails);
+      continue;
+    }
+    const RegistrationType::ParametersType & parameters = registration->GetTransformParameters(pair);
+    if (registration->GetRegistrationFailed(pair) || std::abs(parameters[0] - ShiftX(pair)) > 0.1 ||
+        std::abs(parameters[1] - ShiftY(pair)) > 0.1)
+    {
+      std::cerr << "Pair " << pair << ": the translation " << parameters << " differs from (" << ShiftX(pair) << ", "
+                << ShiftY(pair) << ")" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int
+itkBatchImageRegistrationMethodv4Test(int, char *[])
+{
+  auto registration = RegistrationType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(registration, BatchImageRegistrationMethodv4, Object);
+  ITK_TEST_SET_GET_BOOLEAN(registration, EstimateScalesOnce, true);
+
+  // The initial transform is required
+  registration->AddImagePair(MakeTile(0, 0.0, 0.0), MakeTile(0, 1.0, 1.0));
+  ITK_TRY_EXPECT_EXCEPTION(registration->StartRegistration());
+  ITK_TRY_EXPECT_EXCEPTION(registration->GetTransformParameters(1));
+  registration->ClearImagePairs();
+  ITK_TEST_EXPECT_EQUAL(registration->GetNumberOfImagePairs(), 0u);
+
+  auto transform = TransformType::New();
+  transform->SetIdentity();
+  registration->SetInitialTransform(transform);
+
+  auto optimizer = itk::RegularStepGradientDescentOptimizerv4<double>::New();
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetMinimumStepLength(1e-3);
+  optimizer->SetNumberOfIterations(200);
+  registration->SetOptimizer(optimizer);
+
+  constexpr unsigned int numberOfPairs = 13;
+  constexpr unsigned int outsidePair = 5;
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    const ImageType::Pointer moving = MakeTile(pair, ShiftX(pair), ShiftY(pair));
+    if (pair == outsidePair)
+    {
+      ImageType::PointType origin;
+      origin.Fill(1000.0);
+      moving->SetOrigin(origin);
+    }
+    registration->AddImagePair(MakeTile(pair, 0.0, 0.0), moving);
+  }
+  ITK_TEST_EXPECT_EQUAL(registration->GetNumberOfImagePairs(), numberOfPairs);
+
+  // Mattes mutual information, the default metric
+  registration->SetNumberOfWorkUnits(1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->StartRegistration());
+  ITK_TEST_EXPECT_TRUE(registration->GetScales().Size() == 2);
+  int status = CheckRegistrations(registration, outsidePair, true);
+
+  RegistrationType::ParametersContainerType sequentialParameters;
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    sequentialParameters.push_back(registration->GetTransformParameters(pair));
+  }
+
+  registration->SetNumberOfWorkUnits(4);
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->StartRegistration());
+  status |= CheckRegistrations(registration, outsidePair, true);
+  for (unsigned int pair = 0; pair < numberOfPairs; ++pair)
+  {
+    for (unsigned int p = 0; p < Dimension; ++p)
+    {
+      if (std::abs(registration->GetTransformParameters(pair)[p] - sequentialParameters[pair][p]) > 1e-6)
+      {
+        std::cerr << "Pair " << pair << ": the concurrent registration " << registration->GetTransformParameters(pair)
+                  << " differs from " << sequentialParameters[pair] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Another metric, with scales estimated at each pair, and a second batch
+  registration->SetMetric(itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>::New());
+  registration->EstimateScalesOnceOff();
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->StartRegistration());
+  status |= CheckRegistrations(registration, outsidePair, false);
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->StartRegistration());
+  status |= CheckRegistrations(registration, outsidePair, false);
+  ITK_TEST_EXPECT_TRUE(registration->GetMetricValue(0) < registration->GetMetricValue(outsidePair));
+
+  // No more registrations than pairs, kept for the next batch of as many pairs
+  auto counting = ContextCountingRegistration::New();
+  counting->SetInitialTransform(transform);
+  counting->SetOptimizer(optimizer);
+  counting->SetNumberOfWorkUnits(4);
+  for (unsigned int pair = 0; pair < 2; ++pair)
+  {
+    counting->AddImagePair(MakeTile(pair, 0.0, 0.0), MakeTile(pair, ShiftX(pair), ShiftY(pair)));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(counting->StartRegistration());
+  ITK_TEST_EXPECT_EQUAL(counting->m_NumberOfCreatedContexts, 2u);
+  ITK_TRY_EXPECT_NO_EXCEPTION(counting->StartRegistration());
+  ITK_TEST_EXPECT_EQUAL(counting->m_NumberOfCreatedContexts, 2u);
+  status |= CheckRegistrations(counting, numberOfPairs, false);
+
+  // A first pair for which the scales cannot be estimated fails alone, and the next pair is used
+  auto failingFirstPair = RegistrationType::New();
+  failingFirstPair->SetInitialTransform(transform);
+  failingFirstPair->SetOptimizer(optimizer);
+  failingFirstPair->SetScalesEstimator(FailingScalesEstimator::New());
+  failingFirstPair->SetNumberOfWorkUnits(2);
+  for (unsigned int pair = 0; pair < 4; ++pair)
+  {
+    const ImageType::Pointer fixed = MakeTile(pair, 0.0, 0.0);
+    if (pair == 0)
+    {
+      itk::EncapsulateMetaData<bool>(fixed->GetMetaDataDictionary(), "FailScales", true);
+    }
+    failingFirstPair->AddImagePair(fixed, MakeTile(pair, ShiftX(pair), ShiftY(pair)));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(failingFirstPair->StartRegistration());
+  ITK_TEST_EXPECT_TRUE(failingFirstPair->GetScales().Size() == 2);
+  status |= CheckRegistrations(failingFirstPair, 0, true);
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}